@@ -1,5 +1,6 @@
 #include "HktGraph.h"
 #include "HktBehavior.h"
+#include "Serialization/MemoryWriter.h"
 
 struct FTagNode
 {
@@ -103,4 +104,38 @@ void FHktGraph::RemoveBehavior(const IHktBehavior& InBehavior)
 void FHktGraph::RemoveSubject(FHktId InSubjectId)
 {
 	Context->SubjectNodes.Remove(InSubjectId);
+}
+
+void FHktGraph::CaptureSubjectStates(TMap<FHktId, TArray<uint8>>& OutStates) const
+{
+	check(Context);
+
+	// Subject별로 Behavior를 모음
+	TMap<FHktId, TArray<const IHktBehavior*>> BehaviorsBySubject;
+	for (const auto& Elem : Context->Behaviors)
+	{
+		BehaviorsBySubject.FindOrAdd(Elem.Value->GetSubjectId()).Add(Elem.Value.Get());
+	}
+
+	for (auto& Elem : BehaviorsBySubject)
+	{
+		// TMap 순회 순서와 무관하게 같은 상태는 같은 바이트가 되도록 Behavior ID 순으로 정렬
+		Elem.Value.Sort([](const IHktBehavior& A, const IHktBehavior& B)
+			{
+				return A.GetBehaviorId() < B.GetBehaviorId();
+			});
+
+		TArray<uint8>& State = OutStates.Add(Elem.Key);
+		FMemoryWriter Writer(State);
+
+		int32 NumBehaviors = Elem.Value.Num();
+		Writer << NumBehaviors;
+		for (const IHktBehavior* Behavior : Elem.Value)
+		{
+			FHktId BehaviorId = Behavior->GetBehaviorId();
+			int32 TypeId = Behavior->GetTypeId();
+			TArray<uint8> Payload = Behavior->SerializeFlagment();
+			Writer << BehaviorId << TypeId << Payload;
+		}
+	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "HktDef.h"
+#include "HktStructSerializer.h"
 
 
 class IHktBehavior
@@ -12,6 +13,8 @@ public:
 	virtual FHktId GetBehaviorId() const = 0;
 	virtual FHktTagContainer GetTags() const = 0;
     virtual FName GetAssetName() const = 0;
+	// Flagment 데이터를 바이트 배열로 직렬화 (스냅샷 복제에 사용)
+	virtual TArray<uint8> SerializeFlagment() const = 0;
 };
 
 
@@ -81,6 +84,11 @@ public:
 		return Flagment.GetAssetName();
     }
 
+    virtual TArray<uint8> SerializeFlagment() const override
+    {
+		return FHktStructSerializer::SerializeStructToBytes(Flagment);
+    }
+
     FORCEINLINE const TFlagment& GetFlagment() const { return Flagment; }
 
 protected:
@@ -16,6 +16,9 @@ public:
 	void RemoveBehavior(const IHktBehavior& InBehavior);
 	void RemoveSubject(FHktId InSubjectId);
 
+	// Subject별로 보유한 Behavior들의 상태를 직렬화 (Subject ID -> 상태). 상태가 같으면 항상 같은 바이트가 나옴
+	void CaptureSubjectStates(TMap<FHktId, TArray<uint8>>& OutStates) const;
+
 private:
 	struct FContext;
 	TUniquePtr<FContext> Context;
@@ -20,14 +20,25 @@ public:
     {
 		TArray<uint8> OutBytes;
         FMemoryWriter Writer(OutBytes, true); // true = bIsPersistent
-        FStructOnScope StructOnScope(TBaseStructure<T>::Get());
-        *reinterpret_cast<T*>(StructOnScope.GetStructMemory()) = InStruct;
-
-        StructOnScope.GetStruct()->SerializeTaggedProperties(Writer, StructOnScope.GetStructMemory(), nullptr, nullptr);
+        SerializeStructToArchive(Writer, InStruct);
 
         return OutBytes;
     }
 
+    /**
+     * @brief UStruct를 주어진 아카이브에 바로 직렬화합니다. (예: 전송 버퍼에 직접 쓰는 FHktPacketWriter)
+     * @param Ar 저장용 아카이브
+     * @param InStruct 직렬화할 UStruct 객체의 참조
+     */
+    template<typename T>
+    static void SerializeStructToArchive(FArchive& Ar, const T& InStruct)
+    {
+        check(Ar.IsSaving());
+        // 저장 시에는 구조체를 수정하지 않으므로 임시 복사본 없이 원본 메모리를 그대로 직렬화
+        UScriptStruct* Struct = TBaseStructure<T>::Get();
+        Struct->SerializeTaggedProperties(Ar, reinterpret_cast<uint8*>(const_cast<T*>(&InStruct)), nullptr, nullptr);
+    }
+
     /**
      * @brief TArray<uint8>를 UStruct로 역직렬화합니다.
      * @param InBytes 역직렬화할 데이터 배열
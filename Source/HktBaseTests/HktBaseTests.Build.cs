@@ -13,7 +13,8 @@ public class HktBaseTests : ModuleRules
             {
                 "Core",
                 "HktBase",
-                "HktCustomNet"
+                "HktCustomNet",
+                "HktENet"
                 // ... add other public dependencies that you statically link with here ...
             }
         );
@@ -23,6 +24,8 @@ public class HktBaseTests : ModuleRules
             {
                 "CoreUObject",
                 "Engine",
+                "Networking",
+                "Sockets",
             }
         );
     }
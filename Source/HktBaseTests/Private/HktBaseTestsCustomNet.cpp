@@ -2,6 +2,23 @@
 #include "HAL/PlatformProcess.h"
 #include "HktReliableUdpServer.h"
 #include "HktReliableUdpClient.h"
+#include "HktSnapshot.h"
+#include "HktInterestGrid.h"
+#include "HktReplicationPrioritizer.h"
+#include "HktPacketWriter.h"
+#include "HktMtuProber.h"
+#include "HktTrafficCapture.h"
+#include "HktLoopbackTransport.h"
+#include "HktNetClock.h"
+#include "HktBulkTransfer.h"
+#include "HktSourceRateLimiter.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "HktStructSerializer.h"
+#include "SocketSubsystem.h"
+#include "HktGraph.h"
+#include "HktBehaviorFactory.h"
+#include "HktFlagments.h"
 #include "Misc/AutomationTest.h"
 
 // 간단한 서버-클라 연결 테스트
@@ -170,3 +187,2126 @@ bool FHktCustomNetDataTransmissionTest::RunTest(const FString& Parameters)
 
     return true;
 }
+
+
+// 스냅샷 델타 인코딩/디코딩 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetSnapshotDeltaTest, "HktCustomNet.SnapshotDelta", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetSnapshotDeltaTest::RunTest(const FString& Parameters)
+{
+    const int32 NumEntities = 1000;
+    const int32 StateSize = 32;
+
+    // 1. 기준 스냅샷 생성
+    FHktSnapshotFrame Baseline;
+    Baseline.GroupId = 1;
+    Baseline.SnapshotId = 1;
+    for (int32 i = 0; i < NumEntities; ++i)
+    {
+        TArray<uint8> State;
+        State.Init((uint8)i, StateSize);
+        Baseline.Entities.Add(i, HktSnapshot::MakeState(MoveTemp(State)));
+    }
+
+    // 2. 10개 변경, 1개 삭제, 1개 추가
+    FHktSnapshotFrame Current = Baseline;
+    Current.SnapshotId = 2;
+    for (int32 i = 0; i < 10; ++i)
+    {
+        TArray<uint8> State;
+        State.Init(0xFF, StateSize);
+        Current.Entities.Add(i * 7, HktSnapshot::MakeState(MoveTemp(State)));
+    }
+    Current.Entities.Remove(500);
+    Current.Entities.Add(NumEntities + 1, HktSnapshot::MakeState(TArray<uint8>({ 1, 2, 3 })));
+
+    // 3. 델타 크기는 변경량에 비례해야 함
+    const TArray<uint8> Full = HktSnapshot::EncodeDelta(Current, nullptr);
+    const TArray<uint8> Delta = HktSnapshot::EncodeDelta(Current, &Baseline);
+    TestTrue(TEXT("Delta should be much smaller than a full snapshot"), Delta.Num() * 20 < Full.Num());
+
+    // 4. 기준 스냅샷에 델타를 적용하면 원래 스냅샷이 복원되어야 함
+    FHktSnapshotFrame Decoded;
+    if (!TestTrue(TEXT("Delta should decode"), HktSnapshot::DecodeDelta(Delta.GetData(), Delta.Num(), &Baseline, Decoded)))
+    {
+        return false;
+    }
+    TestEqual(TEXT("Snapshot id should match"), Decoded.SnapshotId, Current.SnapshotId);
+    TestEqual(TEXT("Entity count should match"), Decoded.Entities.Num(), Current.Entities.Num());
+    for (const auto& Elem : Current.Entities)
+    {
+        const FHktSnapshotState* DecodedState = Decoded.Entities.Find(Elem.Key);
+        TestTrue(FString::Printf(TEXT("Entity %llu should match"), Elem.Key), DecodedState && HktSnapshot::IsSameState(*DecodedState, Elem.Value));
+    }
+
+    // 5. 기준이 맞지 않으면 복원하지 않아야 함
+    FHktSnapshotFrame WrongBaseline;
+    WrongBaseline.SnapshotId = 99;
+    TestFalse(TEXT("Delta must not decode against a wrong baseline"), HktSnapshot::DecodeDelta(Delta.GetData(), Delta.Num(), &WrongBaseline, Decoded));
+
+    return true;
+}
+
+// FHktGraph 상태를 그룹 스냅샷으로 복제하는 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetSnapshotReplicationTest, "HktCustomNet.SnapshotReplication", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetSnapshotReplicationTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12347;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const int32 GroupId = 3;
+
+    auto AddMoveBehavior = [](FHktGraph& Graph, int64 BehaviorId, int64 SubjectId, const FVector& Location)
+    {
+        FMoveFlagment Flagment;
+        Flagment.TargetLocation = Location;
+        Flagment.Speed = 1.0f;
+
+        FHktBehaviorResponseHeader ResponseHeader;
+        ResponseHeader.BehaviorInstanceId = BehaviorId;
+        ResponseHeader.SubjectId = SubjectId;
+        ResponseHeader.FlagmentTypeId = GetBehaviorTypeId<FMoveFlagment>();
+        ResponseHeader.FlagmentPayload = FHktStructSerializer::SerializeStructToBytes(Flagment);
+        Graph.AddBehavior(FHktBehaviorFactory::CreateBehavior(ResponseHeader));
+    };
+
+    // 1. 서버 측 그래프 구성
+    FHktGraph Graph;
+    AddMoveBehavior(Graph, 1, 10, FVector(1, 0, 0));
+    AddMoveBehavior(Graph, 2, 20, FVector(2, 0, 0));
+
+    // 2. 서버 생성, 그래프를 스냅샷 공급자로 설정
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetSnapshotProvider([&Graph](int32 InGroupId, TMap<uint64, FHktSnapshotState>& OutEntities)
+        {
+            TMap<FHktId, TArray<uint8>> States;
+            Graph.CaptureSubjectStates(States);
+            for (auto& Elem : States)
+            {
+                OutEntities.Add((uint64)Elem.Key, HktSnapshot::MakeState(MoveTemp(Elem.Value)));
+            }
+        });
+    Server->EnableGroupSnapshots(GroupId, 0.05f);
+    Server->Start();
+
+    // 3. 클라이언트 연결 및 그룹 참여
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    TestTrue("Client Connect call should succeed", Client->Connect(ServerIp, Port, HktReliableUdp::ClientPort + 2));
+
+    const float TickRate = 0.01f;
+    float ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !Client->IsConnected())
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+    Client->JoinGroup(GroupId);
+
+    // 클라이언트가 받은 스냅샷이 서버 그래프의 현재 상태와 같아질 때까지 대기
+    auto WaitForMatchingSnapshot = [&](const TCHAR* What)
+    {
+        TMap<FHktId, TArray<uint8>> Expected;
+        Graph.CaptureSubjectStates(Expected);
+
+        bool bMatched = false;
+        ElapsedTime = 0.0f;
+        while (ElapsedTime < 5.0f && !bMatched)
+        {
+            Server->Tick();
+            Client->Tick();
+
+            FHktSnapshotFrame Frame;
+            while (Client->PollSnapshot(Frame))
+            {
+                bMatched = Frame.GroupId == GroupId && Frame.Entities.Num() == Expected.Num();
+                for (const auto& Elem : Expected)
+                {
+                    const FHktSnapshotState* State = Frame.Entities.Find((uint64)Elem.Key);
+                    bMatched = bMatched && State && State->IsValid() && **State == Elem.Value;
+                }
+            }
+
+            FPlatformProcess::Sleep(TickRate);
+            ElapsedTime += TickRate;
+        }
+        TestTrue(What, bMatched);
+    };
+
+    // 4. 최초 전체 스냅샷 수신
+    WaitForMatchingSnapshot(TEXT("Client should receive the initial snapshot"));
+
+    // 5. 상태 변경이 델타로 반영되어야 함
+    AddMoveBehavior(Graph, 3, 20, FVector(3, 0, 0));
+    AddMoveBehavior(Graph, 4, 30, FVector(4, 0, 0));
+    Graph.RemoveBehavior(1);
+    WaitForMatchingSnapshot(TEXT("Client should receive the updated snapshot"));
+
+    // 6. 정리
+    Client->Disconnect();
+    Server->Stop();
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+// 관심 영역 격자의 반경 검색과 셀 경계 Hysteresis 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetInterestGridTest, "HktCustomNet.InterestGrid", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetInterestGridTest::RunTest(const FString& Parameters)
+{
+    const float CellSize = 1000.0f;
+    const float Hysteresis = 100.0f;
+    FHktInterestGrid Grid(CellSize, Hysteresis);
+
+    // 1. 반경 검색은 셀이 아니라 실제 거리로 판정해야 함
+    Grid.Update(1, FVector(0, 0, 0));
+    Grid.Update(2, FVector(450, 0, 0));
+    Grid.Update(3, FVector(1500, 0, 0));
+    Grid.Update(4, FVector(-5000, -5000, 0));
+
+    TArray<uint64> Ids;
+    Grid.QueryRadius(FVector(0, 0, 0), 500.0f, Ids);
+    Ids.Sort();
+    TestEqual(TEXT("Only nearby subjects should be found"), Ids, TArray<uint64>({ 1, 2 }));
+
+    Ids.Reset();
+    Grid.QueryRadius(FVector(1000, 0, 0), 600.0f, Ids);
+    Ids.Sort();
+    TestEqual(TEXT("Query should span neighbouring cells"), Ids, TArray<uint64>({ 2, 3 }));
+
+    // 2. 셀 경계를 Hysteresis 안에서 오가면 셀이 바뀌지 않아야 함
+    Grid.Update(5, FVector(990, 500, 0));
+    const int64 CellChangesBefore = Grid.GetNumCellChanges();
+    for (int32 i = 0; i < 100; ++i)
+    {
+        Grid.Update(5, FVector((i % 2) ? 1050.0f : 950.0f, 500, 0));
+    }
+    TestEqual(TEXT("Jitter at a cell edge should not change cells"), Grid.GetNumCellChanges(), CellChangesBefore);
+
+    // 셀 밖에 머물러 있어도 검색에는 포함되어야 함
+    Ids.Reset();
+    Grid.QueryRadius(FVector(1300, 500, 0), 300.0f, Ids);
+    TestTrue(TEXT("Subject outside its cell should still be found"), Ids.Contains(5));
+
+    // 3. Hysteresis를 넘어서면 셀을 옮겨야 함
+    Grid.Update(5, FVector(1200, 500, 0));
+    TestEqual(TEXT("Leaving the hysteresis band should change cells"), Grid.GetNumCellChanges(), CellChangesBefore + 1);
+
+    // 4. 제거된 개체는 검색되지 않아야 함
+    Grid.Remove(2);
+    Ids.Reset();
+    Grid.QueryRadius(FVector(0, 0, 0), 500.0f, Ids);
+    TestEqual(TEXT("Removed subject should not be found"), Ids, TArray<uint64>({ 1 }));
+    TestEqual(TEXT("Grid should track remaining subjects"), Grid.Num(), 4);
+
+    return true;
+}
+
+// 관심 위치 기반 그룹 브로드캐스트 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetInterestBroadcastTest, "HktCustomNet.InterestBroadcast", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetInterestBroadcastTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12348;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const int32 GroupId = 4;
+    const uint16 NearPort = HktReliableUdp::ClientPort + 3;
+    const uint16 FarPort = HktReliableUdp::ClientPort + 4;
+
+    auto MakeClientAddr = [&ServerIp](uint16 ClientPort)
+    {
+        TSharedPtr<FInternetAddr> Addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+        bool bIsValid = false;
+        Addr->SetIp(*ServerIp, bIsValid);
+        Addr->SetPort(ClientPort);
+        return Addr;
+    };
+
+    // 1. 서버와 클라이언트 두 개 연결 후 같은 그룹에 참여
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> NearClient = MakeUnique<FHktReliableUdpClient>();
+    TUniquePtr<FHktReliableUdpClient> FarClient = MakeUnique<FHktReliableUdpClient>();
+    TestTrue("NearClient Connect call", NearClient->Connect(ServerIp, Port, NearPort));
+    TestTrue("FarClient Connect call", FarClient->Connect(ServerIp, Port, FarPort));
+
+    auto TickAll = [&](float Duration, TFunctionRef<bool()> IsDone)
+    {
+        const float TickRate = 0.01f;
+        float ElapsedTime = 0.0f;
+        while (ElapsedTime < Duration && !IsDone())
+        {
+            Server->Tick();
+            NearClient->Tick();
+            FarClient->Tick();
+            FPlatformProcess::Sleep(TickRate);
+            ElapsedTime += TickRate;
+        }
+    };
+
+    TickAll(5.0f, [&]() { return NearClient->IsConnected() && FarClient->IsConnected(); });
+    TestTrue("NearClient should be connected", NearClient->IsConnected());
+    TestTrue("FarClient should be connected", FarClient->IsConnected());
+
+    NearClient->JoinGroup(GroupId);
+    FarClient->JoinGroup(GroupId);
+    TickAll(0.5f, []() { return false; });
+
+    // 2. 관심 위치 설정 후 반경 브로드캐스트
+    Server->SetClientInterestLocation(MakeClientAddr(NearPort), FVector(100, 0, 0));
+    Server->SetClientInterestLocation(MakeClientAddr(FarPort), FVector(50000, 0, 0));
+
+    const TArray<uint8> Data = { 'n', 'e', 'a', 'r' };
+    const int32 NumRecipients = Server->BroadcastToGroupInRadius(GroupId, FVector::ZeroVector, 1000.0f, Data);
+    TestEqual("Only the nearby client should be a recipient", NumRecipients, 1);
+
+    // 3. 가까운 클라이언트만 받아야 함
+    TArray<uint8> NearData, FarData;
+    bool bNearReceived = false;
+    bool bFarReceived = false;
+    TickAll(1.0f, [&]()
+        {
+            bNearReceived |= NearClient->Poll(NearData);
+            bFarReceived |= FarClient->Poll(FarData);
+            return false;
+        });
+    TestTrue("Nearby client should receive the broadcast", bNearReceived && NearData == Data);
+    TestFalse("Distant client should not receive the broadcast", bFarReceived);
+
+    // 4. 정리
+    NearClient->Disconnect();
+    FarClient->Disconnect();
+    Server->Stop();
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+// 거리/관련도/경과 시간에 따른 복제 우선순위 선택 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetReplicationPriorityTest, "HktCustomNet.ReplicationPriority", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetReplicationPriorityTest::RunTest(const FString& Parameters)
+{
+    const FVector ViewLocation = FVector::ZeroVector;
+    auto MakeCandidate = [](uint64 Id, const FVector& Location, float Relevance, int32 Size)
+    {
+        FHktReplicationCandidate Candidate;
+        Candidate.SubjectId = Id;
+        Candidate.Subject.Location = Location;
+        Candidate.Subject.Relevance = Relevance;
+        Candidate.Size = Size;
+        return Candidate;
+    };
+
+    // 1. 같은 조건이면 가까운 개체가 먼저, 관련도가 높으면 먼 개체도 앞설 수 있음
+    {
+        FHktReplicationPrioritizer Prioritizer(1000.0f);
+        TArray<FHktReplicationCandidate> Candidates;
+        Candidates.Add(MakeCandidate(1, FVector(10000, 0, 0), 1.0f, 100));
+        Candidates.Add(MakeCandidate(2, FVector(100, 0, 0), 1.0f, 100));
+        Candidates.Add(MakeCandidate(3, FVector(10000, 0, 0), 50.0f, 100));
+
+        TArray<int32> Selected;
+        Prioritizer.Select(&ViewLocation, Candidates, 0.1f, 200, Selected);
+        TestEqual(TEXT("Budget should limit selection"), Selected.Num(), 2);
+        TestEqual(TEXT("Highly relevant subject should come first"), Selected.Num() > 0 ? Candidates[Selected[0]].SubjectId : 0, (uint64)3);
+        TestEqual(TEXT("Nearby subject should come next"), Selected.Num() > 1 ? Candidates[Selected[1]].SubjectId : 0, (uint64)2);
+        TestTrue(TEXT("Unsent subject should keep its priority"), Prioritizer.GetPriority(1) > 0.0f);
+        TestEqual(TEXT("Sent subject priority should be reset"), Prioritizer.GetPriority(2), 0.0f);
+    }
+
+    // 2. 멀리 있는 개체도 오래 기다리면 결국 선택되어야 함
+    {
+        FHktReplicationPrioritizer Prioritizer(1000.0f);
+        int32 TicksUntilFarSent = INDEX_NONE;
+        for (int32 Tick = 0; Tick < 100 && TicksUntilFarSent == INDEX_NONE; ++Tick)
+        {
+            // 가까운 개체는 매번 변경되어 후보로 들어옴
+            TArray<FHktReplicationCandidate> Candidates;
+            Candidates.Add(MakeCandidate(1, FVector(9000, 0, 0), 1.0f, 100));
+            Candidates.Add(MakeCandidate(2, FVector(0, 0, 0), 1.0f, 100));
+
+            TArray<int32> Selected;
+            Prioritizer.Select(&ViewLocation, Candidates, 0.1f, 100, Selected);
+            if (Selected.Num() > 0 && Candidates[Selected[0]].SubjectId == 1)
+            {
+                TicksUntilFarSent = Tick;
+            }
+        }
+        TestTrue(TEXT("Stale distant subject should eventually be sent"), TicksUntilFarSent != INDEX_NONE);
+    }
+
+    // 3. 예산보다 큰 개체도 가장 높은 우선순위면 선택되어야 함
+    {
+        FHktReplicationPrioritizer Prioritizer;
+        TArray<FHktReplicationCandidate> Candidates;
+        Candidates.Add(MakeCandidate(1, FVector::ZeroVector, 1.0f, 5000));
+
+        TArray<int32> Selected;
+        Prioritizer.Select(nullptr, Candidates, 0.1f, 1000, Selected);
+        TestEqual(TEXT("Oversized top candidate should not starve"), Selected.Num(), 1);
+    }
+
+    return true;
+}
+
+// 전송 버퍼에 바로 직렬화하는 FHktPacketWriter 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetPacketWriterTest, "HktCustomNet.PacketWriter", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetPacketWriterTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12349;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 5;
+
+    FSampleFlagment Flagment;
+    Flagment.StrData = TEXT("HktCustomNetPacketWriterTest");
+
+    // 1. Writer로 직렬화한 결과는 기존 바이트 배열 직렬화와 같아야 함
+    {
+        FHktPacketWriter Writer;
+        FHktStructSerializer::SerializeStructToArchive(Writer, Flagment);
+        const TArray<uint8> Expected = FHktStructSerializer::SerializeStructToBytes(Flagment);
+        TestTrue(TEXT("Writer payload should match byte serialization"), TArray<uint8>(Writer.GetPayload()) == Expected);
+
+        // 헤더 자리는 페이로드 앞에 비워져 있어야 함
+        const TArray<uint8> Buffer = Writer.TakeBuffer();
+        TestEqual(TEXT("Buffer should reserve header space"), Buffer.Num(), FHktPacketWriter::HeaderSize + Expected.Num());
+        TestEqual(TEXT("Writer should be empty after taking its buffer"), Writer.GetPayloadSize(), 0);
+    }
+
+    // 2. 서버 -> 클라이언트 전송
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    TestTrue("Client Connect call should succeed", Client->Connect(ServerIp, Port, ClientPort));
+
+    const float TickRate = 0.01f;
+    float ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !Client->IsConnected())
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    ClientAddr->SetIp(*ServerIp, bIsValid);
+    ClientAddr->SetPort(ClientPort);
+
+    FHktPacketWriter Writer;
+    FHktStructSerializer::SerializeStructToArchive(Writer, Flagment);
+    Server->SendTo(ClientAddr, Writer);
+
+    TArray<uint8> Received;
+    bool bReceived = false;
+    ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !bReceived)
+    {
+        Server->Tick();
+        Client->Tick();
+        bReceived = Client->Poll(Received);
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Client should receive the written packet", bReceived);
+
+    FSampleFlagment ReceivedFlagment;
+    FHktStructSerializer::DeserializeStructFromBytes(Received, ReceivedFlagment);
+    TestEqual("Received struct should match", ReceivedFlagment.StrData, Flagment.StrData);
+
+    // 3. 같은 Writer를 다시 써서 클라이언트 -> 서버 전송. Ack를 받아 연결이 유지되어야 함
+    FHktStructSerializer::SerializeStructToArchive(Writer, Flagment);
+    Client->Send(Writer);
+    ElapsedTime = 0.0f;
+    while (ElapsedTime < 0.5f)
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Client should still be connected", Client->IsConnected());
+
+    // 4. 정리
+    Client->Disconnect();
+    Server->Stop();
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+// 경로 MTU 탐색 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetPathMtuTest, "HktCustomNet.PathMtu", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetPathMtuTest::RunTest(const FString& Parameters)
+{
+    // 1. 1400바이트까지만 통과하는 가상 경로에서 탐색
+    {
+        const int32 SimulatedMtu = 1400;
+        FHktMtuProber Prober;
+        TestEqual(TEXT("MTU should start at the safe size"), Prober.GetPathMtu(), FHktMtuProber::SafeMtu);
+
+        double Now = 1.0;
+        Prober.Start(Now);
+        int32 NumProbes = 0;
+        while (Prober.IsSearching() && NumProbes < 100)
+        {
+            const int32 ProbeSize = Prober.Tick(Now);
+            if (ProbeSize > 0)
+            {
+                ++NumProbes;
+                if (ProbeSize <= SimulatedMtu)
+                {
+                    Prober.OnProbeAcked(ProbeSize);
+                }
+            }
+            Now += 0.1;
+        }
+
+        TestFalse(TEXT("Search should finish"), Prober.IsSearching());
+        TestTrue(TEXT("Discovered MTU should not exceed the path"), Prober.GetPathMtu() <= SimulatedMtu);
+        TestTrue(TEXT("Discovered MTU should be within the search granularity"), Prober.GetPathMtu() > SimulatedMtu - FHktMtuProber::SearchGranularity);
+    }
+
+    // 2. 루프백에서 실제 탐침. DF를 쓸 수 없는 환경에서는 안전한 크기를 유지해야 함
+    const uint16 Port = 12354;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 6;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetMtuDiscoveryEnabled(true);
+    TArray<int32> ServerReceivedSizes;
+    Server->SetDataReceivedCallback([&ServerReceivedSizes](const TSharedPtr<FInternetAddr>& ClientAddr, TConstArrayView<uint8> Payload)
+    {
+        ServerReceivedSizes.Add(Payload.Num());
+    });
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetMtuDiscoveryEnabled(true);
+    TestTrue("Client Connect call should succeed", Client->Connect(ServerIp, Port, ClientPort));
+
+    TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    ClientAddr->SetIp(*ServerIp, bIsValid);
+    ClientAddr->SetPort(ClientPort);
+
+    const float TickRate = 0.01f;
+    float ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !(Client->IsConnected() && Client->GetPathMtu() == FHktMtuProber::MaxMtu && Server->GetPathMtu(ClientAddr) == FHktMtuProber::MaxMtu))
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    // 루프백은 이더넷 MTU보다 크므로 탐색이 켜져 있으면 최대 크기까지 확인되어야 함
+    const int32 ExpectedClientMtu = Client->IsMtuDiscoveryActive() ? FHktMtuProber::MaxMtu : FHktMtuProber::SafeMtu;
+    const int32 ExpectedServerMtu = Server->IsMtuDiscoveryActive() ? FHktMtuProber::MaxMtu : FHktMtuProber::SafeMtu;
+    TestEqual("Client path MTU", Client->GetPathMtu(), ExpectedClientMtu);
+    TestEqual("Server path MTU", Server->GetPathMtu(ClientAddr), ExpectedServerMtu);
+    AddInfo(FString::Printf(TEXT("PMTUD active (server/client): %d/%d, MTU: %d/%d"),
+        (int32)Server->IsMtuDiscoveryActive(), (int32)Client->IsMtuDiscoveryActive(), Server->GetPathMtu(ClientAddr), Client->GetPathMtu()));
+
+    // 3. 탐색 중에는 DF 때문에 조각나지 않으므로 경로 MTU보다 큰 데이터는 재전송 목록에 넣지 않고 거부해야 함.
+    //    루프백 장치 MTU는 64K라 커널은 거부하지 않으므로 크기 검사로만 걸러짐
+    if (Server->IsMtuDiscoveryActive() && Client->IsMtuDiscoveryActive())
+    {
+        const int32 OversizedBytes = 4000;
+        ServerReceivedSizes.Reset();
+        TArray<uint8> Oversized;
+        Oversized.SetNumZeroed(OversizedBytes);
+        AddExpectedError(TEXT("exceeds the path MTU"), EAutomationExpectedErrorFlags::Contains, 2);
+        Client->Send(Oversized);
+        Server->SendTo(ClientAddr, Oversized);
+        Client->Send(TArray<uint8>({ 1 }));
+        Server->SendTo(ClientAddr, TArray<uint8>({ 2 }));
+
+        TArray<uint8> ClientReceived;
+        bool bClientReceived = false;
+        ElapsedTime = 0.0f;
+        while (ElapsedTime < 5.0f && !(bClientReceived && ServerReceivedSizes.Num() > 0))
+        {
+            Server->Tick();
+            Client->Tick();
+            bClientReceived = bClientReceived || Client->Poll(ClientReceived);
+            FPlatformProcess::Sleep(TickRate);
+            ElapsedTime += TickRate;
+        }
+        TestTrue("Server should only receive the small packet", ServerReceivedSizes.Num() == 1 && ServerReceivedSizes[0] == 1);
+        TestTrue("Client should only receive the small packet", bClientReceived && ClientReceived.Num() == 1 && ClientReceived[0] == 2);
+        TestTrue("Rejecting an oversized packet should not drop the connection", Client->IsConnected() && Server->GetNumConnections() == 1);
+    }
+
+    // 4. 정리
+    Client->Disconnect();
+    Server->Stop();
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+// 수신 트래픽 캡처 후 소켓 없는 서버로 재생하는 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetTrafficCaptureTest, "HktCustomNet.TrafficCapture", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetTrafficCaptureTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12355;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 7;
+    const int32 GroupId = 7;
+    const int32 NumMessages = 5;
+    const FString CapturePath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("HktCapture"), TEXT(".bin"));
+
+    // 1. 캡처하면서 연결, 그룹 참가, 데이터 전송
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    TestTrue("Capture should start", Server->StartCapture(CapturePath, 1024 * 1024));
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    TestTrue("Client Connect call should succeed", Client->Connect(ServerIp, Port, ClientPort));
+
+    const float TickRate = 0.01f;
+    float ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !Client->IsConnected())
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    Client->JoinGroup(GroupId);
+    for (int32 Index = 0; Index < NumMessages; ++Index)
+    {
+        TArray<uint8> Message;
+        Message.Add((uint8)Index);
+        Client->Send(Message);
+    }
+
+    ElapsedTime = 0.0f;
+    while (ElapsedTime < 0.5f)
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+
+    // 연결 해제 전에 캡처를 끝내 재생 결과에 연결이 남아 있도록 함
+    Server->StopCapture();
+    TestFalse("Capture should be stopped", Server->IsCapturing());
+    Client->Disconnect();
+    Server->Stop();
+
+    // 2. 캡처 파일 재생. Start하지 않은 서버는 소켓이 없으므로 아무것도 보내지 않음
+    FHktTrafficReplay Replay;
+    TestTrue("Capture file should load", Replay.Load(CapturePath));
+    // ConnectResponse + JoinGroup + Data
+    TestTrue("Capture should contain the handshake, join and data packets", Replay.GetNumDatagrams() >= 2 + NumMessages);
+
+    FHktReliableUdpServer ReplayServer(Port);
+    const FHktTrafficReplayStats Stats = Replay.Replay(ReplayServer);
+    TestEqual("All captured datagrams should be replayed", Stats.NumDatagrams, Replay.GetNumDatagrams());
+    TestTrue("Replay should tick the server", Stats.NumTicks > 0);
+    TestEqual("Replayed connection should be established", ReplayServer.GetNumConnections(), 1);
+    AddInfo(FString::Printf(TEXT("Replayed %d datagrams (%lld bytes) recorded over %.3fs in %.3fs with %d ticks"),
+        Stats.NumDatagrams, Stats.NumBytes, Stats.RecordedSeconds, Stats.WallSeconds, Stats.NumTicks));
+
+    // 3. 정리
+    IFileManager::Get().Delete(*CapturePath);
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+
+// 압축 패킷 헤더(v2) 인코딩과 버전 협상 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetHeaderV2Test, "HktCustomNet.HeaderV2", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetHeaderV2Test::RunTest(const FString& Parameters)
+{
+    // 1. 시퀀스 순환 비교와 16비트 복원
+    TestTrue(TEXT("0 should be newer than 0xFFFFFFFF"), HktSequence::IsNewer(0u, 0xFFFFFFFFu));
+    TestFalse(TEXT("0xFFFFFFFF should be older than 0"), HktSequence::IsNewer(0xFFFFFFFFu, 0u));
+    TestEqual(TEXT("Expand16 across the 16-bit wrap"), HktSequence::Expand16(0x0002, 0x0001FFFEu), 0x00020002u);
+    TestEqual(TEXT("Expand16 of an older sequence"), HktSequence::Expand16(0xFFF0, 0x00020005u), 0x0001FFF0u);
+
+    // 2. v2 인코딩 크기와 왕복
+    {
+        uint8 Buffer[HktPacketHeader::MaxSize];
+
+        FPacketHeader DataHeader;
+        DataHeader.Type = EPacketType::Data;
+        DataHeader.Sequence = 0x00012345;
+        DataHeader.LastAckedSequence = 0x00010100;
+        DataHeader.AckBitfield = 0xFFFFFFFF;
+        TestEqual(TEXT("Lossless data header should be 6 bytes"), HktPacketHeader::Encode(DataHeader, HktPacketHeader::Version2, Buffer), 6);
+
+        FPacketHeader Decoded;
+        uint8 Version = 0;
+        TestEqual(TEXT("Decode should consume the whole header"), HktPacketHeader::Decode(Buffer, 6, 0x00012340, 0x00010105, Decoded, &Version), 6);
+        TestEqual(TEXT("Decoded version"), (int32)Version, (int32)HktPacketHeader::Version2);
+        TestEqual(TEXT("Decoded sequence"), Decoded.Sequence, DataHeader.Sequence);
+        TestEqual(TEXT("Decoded ack"), Decoded.LastAckedSequence, DataHeader.LastAckedSequence);
+        TestEqual(TEXT("Decoded ack bits"), Decoded.AckBitfield, DataHeader.AckBitfield);
+
+        // 손실이 있으면 누락 비트만큼 커짐
+        DataHeader.AckBitfield = 0xFFFFFFFF & ~(1u << 3);
+        const int32 LossySize = HktPacketHeader::Encode(DataHeader, HktPacketHeader::Version2, Buffer);
+        TestEqual(TEXT("One missing packet should add one byte"), LossySize, 7);
+        HktPacketHeader::Decode(Buffer, LossySize, 0x00012340, 0x00010105, Decoded);
+        TestEqual(TEXT("Lossy ack bits should round-trip"), Decoded.AckBitfield, DataHeader.AckBitfield);
+
+        FPacketHeader AckHeader;
+        AckHeader.Type = EPacketType::Ack;
+        AckHeader.LastAckedSequence = 7;
+        AckHeader.AckBitfield = 0x3F;
+        TestEqual(TEXT("Pure ack header should be 4 bytes"), HktPacketHeader::Encode(AckHeader, HktPacketHeader::Version2, Buffer), 4);
+
+        // EncodeInPlace는 헤더 자리 끝에 맞춰 씀
+        const int32 Offset = HktPacketHeader::EncodeInPlace(AckHeader, HktPacketHeader::Version2, Buffer);
+        TestEqual(TEXT("In-place header should end at the reserved space"), Offset, HktPacketHeader::MaxSize - 4);
+
+        // v1은 그대로 해석되어야 함
+        TestEqual(TEXT("v1 header size"), HktPacketHeader::Encode(DataHeader, HktPacketHeader::Version1, Buffer), (int32)sizeof(FPacketHeader));
+        TestEqual(TEXT("v1 decode"), HktPacketHeader::Decode(Buffer, sizeof(FPacketHeader), 0, 0, Decoded, &Version), (int32)sizeof(FPacketHeader));
+        TestEqual(TEXT("v1 decoded version"), (int32)Version, (int32)HktPacketHeader::Version1);
+        TestEqual(TEXT("v1 decoded sequence"), Decoded.Sequence, DataHeader.Sequence);
+
+        TestEqual(TEXT("Truncated header should be rejected"), HktPacketHeader::Decode(Buffer, 1, 0, 0, Decoded), 0);
+    }
+
+    // 3. 최대 버전이 다른 두 클라이언트와의 협상 및 데이터 전달
+    const uint16 Port = 12356;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPortV2 = HktReliableUdp::ClientPort + 8;
+    const uint16 ClientPortV1 = HktReliableUdp::ClientPort + 9;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> ClientV2 = MakeUnique<FHktReliableUdpClient>();
+    TestTrue("ClientV2 Connect call", ClientV2->Connect(ServerIp, Port, ClientPortV2));
+    TUniquePtr<FHktReliableUdpClient> ClientV1 = MakeUnique<FHktReliableUdpClient>();
+    ClientV1->SetMaxHeaderVersion(HktPacketHeader::Version1);
+    TestTrue("ClientV1 Connect call", ClientV1->Connect(ServerIp, Port, ClientPortV1));
+
+    const float TickRate = 0.01f;
+    float ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && (!ClientV2->IsConnected() || !ClientV1->IsConnected()))
+    {
+        Server->Tick();
+        ClientV2->Tick();
+        ClientV1->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("ClientV2 should be connected", ClientV2->IsConnected());
+    TestTrue("ClientV1 should be connected", ClientV1->IsConnected());
+
+    TSharedPtr<FInternetAddr> AddrV2 = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    TSharedPtr<FInternetAddr> AddrV1 = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    AddrV2->SetIp(*ServerIp, bIsValid);
+    AddrV2->SetPort(ClientPortV2);
+    AddrV1->SetIp(*ServerIp, bIsValid);
+    AddrV1->SetPort(ClientPortV1);
+
+    TestEqual("ClientV2 negotiated version", (int32)ClientV2->GetHeaderVersion(), (int32)HktPacketHeader::Version2);
+    TestEqual("Server version for ClientV2", (int32)Server->GetHeaderVersion(AddrV2), (int32)HktPacketHeader::Version2);
+    TestEqual("ClientV1 negotiated version", (int32)ClientV1->GetHeaderVersion(), (int32)HktPacketHeader::Version1);
+    TestEqual("Server version for ClientV1", (int32)Server->GetHeaderVersion(AddrV1), (int32)HktPacketHeader::Version1);
+
+    // 협상된 버전으로 양쪽 모두 데이터가 전달되어야 함
+    TArray<uint8> Data = { 1, 2, 3, 4, 5 };
+    Server->SendTo(AddrV2, Data);
+    Server->SendTo(AddrV1, Data);
+
+    TArray<uint8> ReceivedV2, ReceivedV1;
+    bool bReceivedV2 = false;
+    bool bReceivedV1 = false;
+    ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && (!bReceivedV2 || !bReceivedV1))
+    {
+        Server->Tick();
+        ClientV2->Tick();
+        ClientV1->Tick();
+        bReceivedV2 = bReceivedV2 || ClientV2->Poll(ReceivedV2);
+        bReceivedV1 = bReceivedV1 || ClientV1->Poll(ReceivedV1);
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("ClientV2 should receive data", bReceivedV2 && ReceivedV2 == Data);
+    TestTrue("ClientV1 should receive data", bReceivedV1 && ReceivedV1 == Data);
+
+    // 4. 정리
+    ClientV2->Disconnect();
+    ClientV1->Disconnect();
+    Server->Stop();
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+
+// 같은 프로세스 안의 루프백 전송과 가상 시계 테스트
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetLoopbackTest, "HktCustomNet.Loopback", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetLoopbackTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12357;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPortA = HktReliableUdp::ClientPort + 11;
+    const uint16 ClientPortB = HktReliableUdp::ClientPort + 12;
+
+    // 1. 같은 포트는 한 엔드포인트만 바인딩할 수 있어야 함
+    {
+        TUniquePtr<FHktLoopbackEndpoint> First = FHktLoopbackEndpoint::Bind(Port);
+        TUniquePtr<FHktLoopbackEndpoint> Second = FHktLoopbackEndpoint::Bind(Port);
+        TestTrue(TEXT("First bind should succeed"), First.IsValid());
+        TestFalse(TEXT("Second bind on the same port should fail"), Second.IsValid());
+    }
+
+    // 2. 가상 시계로 실제 대기 없이 진행
+    HktNetClock::EnableVirtualTime();
+
+    // 링크 대역폭을 정하면 데이터그램이 크기 / 대역폭만큼씩 차례로 도착
+    {
+        TUniquePtr<FHktLoopbackEndpoint> Sender = FHktLoopbackEndpoint::Bind(ClientPortA);
+        TUniquePtr<FHktLoopbackEndpoint> Receiver = FHktLoopbackEndpoint::Bind(Port);
+        FHktLoopbackEndpoint::SetLinkBandwidth(Port, 1000);
+        const uint8 Payload[100] = {};
+        Sender->SendTo(Payload, sizeof(Payload), *Receiver->GetAddress());
+        Sender->SendTo(Payload, sizeof(Payload), *Receiver->GetAddress());
+
+        FHktLoopbackDatagram Datagram;
+        TestFalse(TEXT("Datagram should still be on the link"), Receiver->Receive(Datagram));
+        HktNetClock::Advance(0.15);
+        TestTrue(TEXT("First datagram should arrive after size / bandwidth"), Receiver->Receive(Datagram));
+        HktPacketPool::Release(MoveTemp(Datagram.Data));
+        TestFalse(TEXT("Second datagram should queue behind the first"), Receiver->Receive(Datagram));
+        HktNetClock::Advance(0.1);
+        TestTrue(TEXT("Second datagram should arrive after the link drains"), Receiver->Receive(Datagram));
+        HktPacketPool::Release(MoveTemp(Datagram.Data));
+        FHktLoopbackEndpoint::SetLinkBandwidth(Port, 0);
+    }
+
+    const double WallStart = FPlatformTime::Seconds();
+    const double VirtualStart = HktNetClock::Seconds();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> ClientA = MakeUnique<FHktReliableUdpClient>();
+    ClientA->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("ClientA Connect call", ClientA->Connect(ServerIp, Port, ClientPortA));
+    TUniquePtr<FHktReliableUdpClient> ClientB = MakeUnique<FHktReliableUdpClient>();
+    ClientB->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("ClientB Connect call", ClientB->Connect(ServerIp, Port, ClientPortB));
+
+    auto TickAll = [&](bool bTickB)
+    {
+        Server->Tick();
+        ClientA->Tick();
+        if (bTickB)
+        {
+            ClientB->Tick();
+        }
+        HktNetClock::Advance(FrameTime);
+    };
+
+    // 메모리 큐는 즉시 전달되므로 몇 프레임 안에 핸드셰이크가 끝나야 함
+    for (int32 Frame = 0; Frame < 10 && (!ClientA->IsConnected() || !ClientB->IsConnected()); ++Frame)
+    {
+        TickAll(true);
+    }
+    TestTrue("ClientA should be connected", ClientA->IsConnected());
+    TestTrue("ClientB should be connected", ClientB->IsConnected());
+    TestEqual("Server should have two connections", Server->GetNumConnections(), 2);
+
+    // 3. 그룹 브로드캐스트
+    const int32 GroupId = 1;
+    ClientA->JoinGroup(GroupId);
+    ClientB->JoinGroup(GroupId);
+    TickAll(true);
+
+    TArray<uint8> BroadcastData = { 10, 20, 30 };
+    Server->BroadcastToGroup(GroupId, BroadcastData);
+    TArray<uint8> ReceivedA, ReceivedB;
+    bool bReceivedA = false;
+    bool bReceivedB = false;
+    for (int32 Frame = 0; Frame < 10 && (!bReceivedA || !bReceivedB); ++Frame)
+    {
+        TickAll(true);
+        bReceivedA = bReceivedA || ClientA->Poll(ReceivedA);
+        bReceivedB = bReceivedB || ClientB->Poll(ReceivedB);
+    }
+    TestTrue("ClientA should receive the broadcast", bReceivedA && ReceivedA == BroadcastData);
+    TestTrue("ClientB should receive the broadcast", bReceivedB && ReceivedB == BroadcastData);
+
+    // 4. B가 멈춘 채로 타임아웃 시간을 가상으로 흘려보냄. A는 주기적으로 보내서 연결을 유지
+    const int32 TimeoutFrames = (int32)(6.0 / FrameTime);
+    for (int32 Frame = 0; Frame < TimeoutFrames; ++Frame)
+    {
+        if (Frame % 6 == 0)
+        {
+            ClientA->Send(TArray<uint8>({ 1 }));
+        }
+        TickAll(false);
+    }
+    TestTrue("ClientA should stay connected", ClientA->IsConnected());
+    TestEqual("Server should drop the silent client", Server->GetNumConnections(), 1);
+
+    const double VirtualElapsed = HktNetClock::Seconds() - VirtualStart;
+    const double WallElapsed = FPlatformTime::Seconds() - WallStart;
+    AddInfo(FString::Printf(TEXT("Simulated %.2f s of network time in %.3f s"), VirtualElapsed, WallElapsed));
+    TestTrue("Virtual time should run ahead of wall time", VirtualElapsed > WallElapsed);
+
+    // 5. 정리
+    ClientA->Disconnect();
+    ClientB->Disconnect();
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetSessionResumeTest, "HktCustomNet.SessionResume", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetSessionResumeTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12358;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPortA = HktReliableUdp::ClientPort + 13;
+    const uint16 ClientPortB = HktReliableUdp::ClientPort + 14;
+    const int32 GroupId = 1;
+
+    // 1. 루프백 + 가상 시계로 타임아웃과 유예 시간을 실제로 기다리지 않고 재현
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPortA));
+
+    auto TickAll = [&](bool bTickClient)
+    {
+        Server->Tick();
+        if (bTickClient)
+        {
+            Client->Tick();
+        }
+        HktNetClock::Advance(FrameTime);
+    };
+
+    // 지정한 시간 안에 데이터를 받으면 true
+    auto WaitForData = [&](const TArray<uint8>& Expected, double Seconds)
+    {
+        TArray<uint8> Received;
+        for (int32 Frame = 0; Frame < (int32)(Seconds / FrameTime); ++Frame)
+        {
+            TickAll(true);
+            if (Client->Poll(Received))
+            {
+                return Received == Expected;
+            }
+        }
+        return false;
+    };
+
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        TickAll(true);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+    Client->JoinGroup(GroupId);
+    TickAll(true);
+
+    // 2. 브로드캐스트가 도착하기 전에 로컬 포트를 바꿈. 이전 포트로 간 패킷은 사라지지만 재개 후 재전송되어야 함
+    const TArray<uint8> BeforeRebind = { 1, 2, 3 };
+    Server->BroadcastToGroup(GroupId, BeforeRebind);
+    TickAll(false);
+    TestTrue("Rebind should succeed", Client->Rebind(ClientPortB));
+    TestTrue("Data sent before the rebind should be redelivered", WaitForData(BeforeRebind, 0.5));
+    TestFalse("Client should not be resuming anymore", Client->IsResuming());
+    TestEqual("Server should keep a single connection", Server->GetNumConnections(), 1);
+
+    // 그룹 소속도 그대로 유지
+    const TArray<uint8> AfterRebind = { 4, 5, 6 };
+    Server->BroadcastToGroup(GroupId, AfterRebind);
+    TestTrue("Group membership should survive the rebind", WaitForData(AfterRebind, 0.5));
+
+    // 3. 클라이언트가 멈추면 서버는 연결을 끊지 않고 세션을 중단함
+    for (int32 Frame = 0; Frame < (int32)(6.0 / FrameTime); ++Frame)
+    {
+        TickAll(false);
+    }
+    TestEqual("Server should suspend the silent session", Server->GetNumSuspendedSessions(), 1);
+    TestEqual("Suspended session should not count as a connection", Server->GetNumConnections(), 0);
+
+    // 중단 중에 보낸 데이터는 재개 후 전달되어야 함
+    const TArray<uint8> WhileSuspended = { 7, 8, 9 };
+    Server->BroadcastToGroup(GroupId, WhileSuspended);
+    TestTrue("Data sent while suspended should be delivered after resume", WaitForData(WhileSuspended, 3.0));
+    TestEqual("Session should be resumed", Server->GetNumSuspendedSessions(), 0);
+    TestEqual("Resumed session should count as a connection", Server->GetNumConnections(), 1);
+
+    // 4. 유예 시간이 지나면 세션이 사라지고 재개 요청은 거부됨
+    Server->SetSessionGracePeriod(1.0f);
+    for (int32 Frame = 0; Frame < (int32)(8.0 / FrameTime); ++Frame)
+    {
+        TickAll(false);
+    }
+    TestEqual("Expired session should be removed", Server->GetNumSuspendedSessions(), 0);
+    for (int32 Frame = 0; Frame < (int32)(3.0 / FrameTime) && Client->IsConnected(); ++Frame)
+    {
+        TickAll(true);
+    }
+    TestFalse("Client should be told that the session is gone", Client->IsConnected());
+
+    // 5. 정리
+    Client->Disconnect();
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetBulkTransferTest, "HktCustomNet.BulkTransfer", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetBulkTransferTest::RunTest(const FString& Parameters)
+{
+    TArray<uint8> Blob;
+    Blob.SetNumUninitialized(1024 * 1024);
+    for (int32 i = 0; i < Blob.Num(); ++i)
+    {
+        Blob[i] = (uint8)(i * 31 + (i >> 8));
+    }
+
+    // 1. 송신/수신 측만으로 손실 복구 확인. 일곱 번째 청크마다 버려도 마지막 Ack 지점부터 다시 보내 완성되어야 함
+    {
+        FHktBulkSender Sender;
+        FHktBulkReceiver Receiver;
+        Sender.Add(7, TArray<uint8>(Blob), 0);
+
+        double Now = 1.0;
+        int64 NumChunks = 0;
+        bool bCompleted = false;
+        TArray<uint8> Received;
+        TArray<uint32> Completed;
+        for (int32 Step = 0; Step < 20000 && !bCompleted; ++Step)
+        {
+            Sender.Refill(Now, 16 * 1024 * 1024, 0);
+            FHktBulkChunkHeader ChunkHeader;
+            const uint8* ChunkData;
+            int32 ChunkSize;
+            TArray<FHktBulkAck> Acks;
+            while (Sender.NextChunk(Now, 1100, ChunkHeader, ChunkData, ChunkSize))
+            {
+                if (++NumChunks % 7 == 0)
+                {
+                    continue;
+                }
+                FHktBulkAck Ack;
+                bool bChunkCompleted = false;
+                if (Receiver.OnChunk(ChunkHeader, ChunkData, ChunkSize, Ack, bChunkCompleted, Received))
+                {
+                    Acks.Add(Ack);
+                    bCompleted |= bChunkCompleted;
+                }
+            }
+            Now += 0.01;
+            for (const FHktBulkAck& Ack : Acks)
+            {
+                Sender.OnAck(Ack, Now, Completed);
+            }
+        }
+        TestTrue("Lossy transfer should complete", bCompleted && Received == Blob);
+        TestTrue("Sender should report completion", Completed.Num() == 1 && Completed[0] == 7);
+        TestFalse("Sender should have no transfers left", Sender.HasTransfers());
+    }
+
+    // 2. 루프백 연결로 전송. 대역폭 제한 안에서 게임플레이 데이터와 함께 보냄
+    const uint16 Port = 12359;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 15;
+    const int32 Bandwidth = 256 * 1024;
+
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->SetSendBandwidth(Bandwidth);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPort));
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    ClientAddr->SetIp(*ServerIp, bIsValid);
+    ClientAddr->SetPort(ClientPort);
+
+    TArray<TPair<uint32, bool>> ServerCompleted;
+    Server->SetBulkCompleteCallback([&ServerCompleted](const TSharedPtr<FInternetAddr>&, uint32 TransferId, bool bSucceeded)
+        {
+            ServerCompleted.Emplace(TransferId, bSucceeded);
+        });
+    uint32 ReceivedTransferId = 0;
+    uint32 ReceivedStartOffset = 0;
+    TArray<uint8> ReceivedBlob;
+    Client->SetBulkReceivedCallback([&](uint32 TransferId, uint32 StartOffset, TArray<uint8>&& Data)
+        {
+            ReceivedTransferId = TransferId;
+            ReceivedStartOffset = StartOffset;
+            ReceivedBlob = MoveTemp(Data);
+        });
+
+    // 전송이 끝날 때까지 걸린 가상 시간을 반환
+    auto RunTransfer = [&](uint32 TransferId)
+    {
+        const double StartTime = HktNetClock::Seconds();
+        int32 GameplayReceived = 0;
+        TArray<uint8> Received;
+        for (int32 Frame = 0; Frame < (int32)(30.0 / FrameTime) && ReceivedTransferId != TransferId; ++Frame)
+        {
+            Server->SendTo(ClientAddr, TArray<uint8>({ (uint8)Frame }));
+            Server->Tick();
+            Client->Tick();
+            while (Client->Poll(Received))
+            {
+                ++GameplayReceived;
+            }
+            HktNetClock::Advance(FrameTime);
+        }
+        TestTrue("Gameplay data should keep flowing during the transfer", GameplayReceived > 0);
+        return HktNetClock::Seconds() - StartTime;
+    };
+
+    TArray<uint8> BlobCopy = Blob;
+    const uint32 TransferId = Server->SendBulk(ClientAddr, MoveTemp(BlobCopy));
+    TestTrue("SendBulk should return a transfer id", TransferId != 0);
+    uint32 AckedBytes = 0;
+    uint32 TotalBytes = 0;
+    TestTrue("Progress should be available", Server->GetBulkProgress(ClientAddr, TransferId, AckedBytes, TotalBytes) && TotalBytes == (uint32)Blob.Num());
+
+    const double Elapsed = RunTransfer(TransferId);
+    AddInfo(FString::Printf(TEXT("1 MB bulk transfer took %.2f s of network time at %d KB/s"), Elapsed, Bandwidth / 1024));
+    TestTrue("Client should receive the whole blob", ReceivedTransferId == TransferId && ReceivedStartOffset == 0 && ReceivedBlob == Blob);
+    TestTrue("Server should report success", ServerCompleted.Num() == 1 && ServerCompleted[0].Key == TransferId && ServerCompleted[0].Value);
+    TestTrue("Transfer should respect the bandwidth limit", Elapsed >= 0.9 * Blob.Num() / Bandwidth);
+    TestFalse("Finished transfer should have no progress", Server->GetBulkProgress(ClientAddr, TransferId, AckedBytes, TotalBytes));
+
+    // 3. 받는 쪽이 앞부분을 이미 가지고 있다면 StartOffset부터 이어서 보냄
+    const uint32 StartOffset = Blob.Num() / 2;
+    BlobCopy = Blob;
+    const uint32 ResumedId = Server->SendBulk(ClientAddr, MoveTemp(BlobCopy), StartOffset);
+    RunTransfer(ResumedId);
+    TestTrue("Resumed transfer should deliver only the remaining part",
+        ReceivedTransferId == ResumedId && ReceivedStartOffset == StartOffset && ReceivedBlob.Num() == Blob.Num() - (int32)StartOffset
+        && FMemory::Memcmp(ReceivedBlob.GetData(), Blob.GetData() + StartOffset, ReceivedBlob.Num()) == 0);
+
+    // 4. 클라이언트가 연결을 끊으면 진행 중인 전송은 실패로 통지
+    BlobCopy = Blob;
+    const uint32 AbortedId = Server->SendBulk(ClientAddr, MoveTemp(BlobCopy));
+    Server->Tick();
+    Client->Disconnect();
+    for (int32 Frame = 0; Frame < 10; ++Frame)
+    {
+        Server->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestTrue("Aborted transfer should be reported as failed", ServerCompleted.Num() == 3 && ServerCompleted[2].Key == AbortedId && !ServerCompleted[2].Value);
+
+    // 5. 정리
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetTickBudgetTest, "HktCustomNet.TickBudget", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetTickBudgetTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12361;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 17;
+    const int32 NumMessages = 100;
+    const int32 MaxPackets = 10;
+
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    // 1. 루프백 연결
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPort));
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+    TestFalse("Unbounded tick should not exhaust the budget", Client->GetLastTickStats().bBudgetExhausted);
+
+    TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    ClientAddr->SetIp(*ServerIp, bIsValid);
+    ClientAddr->SetPort(ClientPort);
+
+    // 2. 클라이언트: 한 번에 몰려온 데이터는 패킷 예산만큼만 처리하고 나머지는 이월
+    for (int32 i = 0; i < NumMessages; ++i)
+    {
+        Server->SendTo(ClientAddr, TArray<uint8>({ (uint8)i }));
+    }
+    Client->Tick(FHktNetTickBudget(0.0, MaxPackets));
+    TArray<uint8> Received;
+    int32 NumReceived = 0;
+    while (Client->Poll(Received))
+    {
+        ++NumReceived;
+    }
+    TestEqual("Client should process only the packet budget", Client->GetLastTickStats().ProcessedPackets, MaxPackets);
+    TestEqual("Client should deliver only the processed packets", NumReceived, MaxPackets);
+    TestEqual("Client should carry the rest over", Client->GetLastTickStats().BacklogPackets, NumMessages - MaxPackets);
+    TestTrue("Client budget should be exhausted", Client->GetLastTickStats().bBudgetExhausted);
+
+    // 3. 데이터가 밀려 있어도 제어 패킷(서버의 Ack)을 먼저 처리
+    Client->Send(TArray<uint8>({ 0xAB }));
+    Server->Tick();
+    const int32 BacklogBefore = Client->GetBacklogSize();
+    Client->Tick(FHktNetTickBudget(0.0, 1));
+    int32 NumDataInControlTick = 0;
+    while (Client->Poll(Received))
+    {
+        ++NumDataInControlTick;
+    }
+    TestTrue("Server ack should have been queued", BacklogBefore > NumMessages - MaxPackets);
+    TestEqual("Control packet should be processed before the data backlog", NumDataInControlTick, 0);
+
+    // 4. 이월된 패킷은 이후 Tick에서 순서대로 모두 처리되고, 대기 시간이 통계에 나타남
+    HktNetClock::Advance(0.1);
+    Client->Tick(FHktNetTickBudget(0.0, MaxPackets));
+    TestTrue("Backlog age should grow while packets wait", Client->GetLastTickStats().BacklogAge >= 0.1);
+    for (int32 Frame = 0; Frame < NumMessages && Client->GetBacklogSize() > 0; ++Frame)
+    {
+        Client->Tick(FHktNetTickBudget(0.0, MaxPackets));
+    }
+    int32 Expected = MaxPackets;
+    bool bInOrder = true;
+    while (Client->Poll(Received))
+    {
+        bInOrder &= Received.Num() == 1 && Received[0] == (uint8)Expected;
+        ++Expected;
+    }
+    TestEqual("Client should eventually deliver every message", Expected, NumMessages);
+    TestTrue("Carried over messages should stay in order", bInOrder);
+    TestEqual("Client backlog should be drained", Client->GetLastTickStats().BacklogPackets, 0);
+    TestEqual("Client backlog age should be zero when drained", Client->GetLastTickStats().BacklogAge, 0.0);
+
+    // 5. 서버: 같은 방식으로 예산을 넘는 수신 패킷을 이월. 그동안 쌓인 클라이언트의 Ack부터 비움
+    Server->Tick();
+    for (int32 i = 0; i < NumMessages; ++i)
+    {
+        Client->Send(TArray<uint8>({ (uint8)i }));
+    }
+    Server->Tick(FHktNetTickBudget(0.0, MaxPackets));
+    TestEqual("Server should process only the packet budget", Server->GetLastTickStats().ProcessedPackets, MaxPackets);
+    TestEqual("Server should carry the rest over", Server->GetLastTickStats().BacklogPackets, NumMessages - MaxPackets);
+    TestTrue("Server budget should be exhausted", Server->GetLastTickStats().bBudgetExhausted);
+    for (int32 Frame = 0; Frame < NumMessages && Server->GetBacklogSize() > 0; ++Frame)
+    {
+        Server->Tick(FHktNetTickBudget(0.0, MaxPackets));
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestEqual("Server backlog should be drained", Server->GetBacklogSize(), 0);
+    TestTrue("Connection should survive the backlog", Client->IsConnected() && Server->GetNumConnections() == 1);
+
+    // 6. 정리
+    Client->Disconnect();
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetReceiveRateLimitTest, "HktCustomNet.ReceiveRateLimit", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetReceiveRateLimitTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12362;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 18;
+    const uint16 AttackerPort = HktReliableUdp::ClientPort + 19;
+
+    auto MakeAddr = [&ServerIp](uint16 AddrPort)
+    {
+        TSharedRef<FInternetAddr> Addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+        bool bIsValid = false;
+        Addr->SetIp(*ServerIp, bIsValid);
+        Addr->SetPort(AddrPort);
+        return Addr;
+    };
+
+    // 1. 토큰 버킷: 주소마다 Burst개까지 받고 이후에는 초당 Rate개씩 회복
+    {
+        FHktSourceRateLimiter Limiter;
+        Limiter.Configure(10.0, 5.0, 2);
+        TSharedRef<FInternetAddr> AddrA = MakeAddr(1000);
+        TSharedRef<FInternetAddr> AddrB = MakeAddr(1001);
+        TSharedRef<FInternetAddr> AddrC = MakeAddr(1002);
+
+        int32 NumAllowed = 0;
+        for (int32 i = 0; i < 8; ++i)
+        {
+            NumAllowed += Limiter.Consume(*AddrA, 1.0) == FHktSourceRateLimiter::EResult::Allowed ? 1 : 0;
+        }
+        TestEqual("Burst should be allowed at once", NumAllowed, 5);
+        NumAllowed = 0;
+        for (int32 i = 0; i < 5; ++i)
+        {
+            NumAllowed += Limiter.Consume(*AddrB, 1.0) == FHktSourceRateLimiter::EResult::Allowed ? 1 : 0;
+        }
+        TestEqual("Other sources should have their own bucket", NumAllowed, 5);
+        TestTrue("Tokens should refill over time", Limiter.Consume(*AddrA, 1.1) == FHktSourceRateLimiter::EResult::Allowed);
+        TestTrue("Refill should be limited by the rate", Limiter.Consume(*AddrA, 1.1) == FHktSourceRateLimiter::EResult::RateLimited);
+        TestTrue("New sources beyond the table size should be rejected", Limiter.Consume(*AddrC, 1.1) == FHktSourceRateLimiter::EResult::TooManySources);
+        // 충분히 조용했던 주소는 정리되어 새 주소가 들어올 자리가 생김
+        TestTrue("Idle sources should be pruned", Limiter.Consume(*AddrC, 3.0) == FHktSourceRateLimiter::EResult::Allowed);
+        TestTrue("Pruned table should stay within its size", Limiter.GetNumSources() <= 2);
+
+        // 면제된 주소는 토큰과 상관없이 받고, 건 횟수만큼 풀어야 다시 제한됨
+        Limiter.QueueExemption(*AddrA, true);
+        Limiter.QueueExemption(*AddrA, true);
+        Limiter.QueueExemption(*AddrA, false);
+        NumAllowed = 0;
+        for (int32 i = 0; i < 20; ++i)
+        {
+            NumAllowed += Limiter.Consume(*AddrA, 3.0) == FHktSourceRateLimiter::EResult::Allowed ? 1 : 0;
+        }
+        TestEqual("Exempt sources should not be limited", NumAllowed, 20);
+        Limiter.QueueExemption(*AddrA, false);
+        NumAllowed = 0;
+        for (int32 i = 0; i < 20; ++i)
+        {
+            NumAllowed += Limiter.Consume(*AddrA, 3.0) == FHktSourceRateLimiter::EResult::Allowed ? 1 : 0;
+        }
+        TestEqual("Sources should be limited again once the exemption ends", NumAllowed, 5);
+    }
+
+    // 2. 헤더 검사: 크기, 버전, 종류 범위
+    {
+        FPacketHeader Header;
+        Header.Type = EPacketType::Ping;
+        uint8 Packet[HktPacketHeader::MaxSize];
+        EPacketType Type;
+        const int32 V1Size = HktPacketHeader::Encode(Header, HktPacketHeader::Version1, Packet);
+        TestTrue("v1 header should be valid", HktPacketHeader::Validate(Packet, V1Size, Type) && Type == EPacketType::Ping);
+        TestFalse("Truncated v1 header should be rejected", HktPacketHeader::Validate(Packet, V1Size - 1, Type));
+
+        Header.Type = EPacketType::Data;
+        Header.Sequence = 5;
+        Header.LastAckedSequence = 3;
+        const int32 V2Size = HktPacketHeader::Encode(Header, HktPacketHeader::Version2, Packet);
+        TestTrue("v2 header should be valid", HktPacketHeader::Validate(Packet, V2Size, Type) && Type == EPacketType::Data);
+        TestFalse("Truncated v2 header should be rejected", HktPacketHeader::Validate(Packet, V2Size - 1, Type));
+
+        Packet[0] = 0x3F;
+        TestFalse("Unknown packet type should be rejected", HktPacketHeader::Validate(Packet, V1Size, Type));
+        Packet[0] = 0xC0;
+        TestFalse("Unknown header version should be rejected", HktPacketHeader::Validate(Packet, V1Size, Type));
+    }
+
+    // 3. 서버: 쓰레기와 폭주는 처리 큐에 들어가기 전에 버림
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->SetReceiveRateLimit(100, 20);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPort));
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    TUniquePtr<FHktLoopbackEndpoint> Attacker = FHktLoopbackEndpoint::Bind(AttackerPort);
+    TSharedRef<FInternetAddr> ServerAddr = MakeAddr(Port);
+    TArray<uint8> Garbage;
+    Garbage.Init(0xFF, 32);
+    for (int32 i = 0; i < 50; ++i)
+    {
+        Attacker->SendTo(Garbage.GetData(), Garbage.Num(), *ServerAddr);
+    }
+    FPacketHeader PingHeader;
+    PingHeader.Type = EPacketType::Ping;
+    for (int32 i = 0; i < 200; ++i)
+    {
+        Attacker->SendTo(reinterpret_cast<const uint8*>(&PingHeader), sizeof(FPacketHeader), *ServerAddr);
+    }
+    Server->Tick(FHktNetTickBudget(0.0, 1));
+
+    const FHktReceiveDropStats Drops = Server->GetReceiveDropStats();
+    TestEqual("Garbage should be counted as malformed", Drops.Malformed, (int64)50);
+    TestEqual("Flood beyond the burst should be rate limited", Drops.RateLimited, (int64)(200 - 20));
+    TestTrue("Only the burst should reach the processing queue", Server->GetBacklogSize() < 20);
+
+    // 4. 폭주한 주소가 막혀도 정상 클라이언트는 계속 통신
+    Client->Send(TArray<uint8>({ 1, 2, 3 }));
+    for (int32 Frame = 0; Frame < 30; ++Frame)
+    {
+        // 한도 안의 속도로 보내는 주소는 다시 받아줌
+        HktNetClock::Advance(FrameTime);
+        Attacker->SendTo(reinterpret_cast<const uint8*>(&PingHeader), sizeof(FPacketHeader), *ServerAddr);
+        Server->Tick();
+        Client->Tick();
+    }
+    TestTrue("Legitimate client should stay connected", Client->IsConnected() && Server->GetNumConnections() == 1);
+    TestEqual("Sources within the limit should not be dropped", Server->GetReceiveDropStats().RateLimited, Drops.RateLimited);
+
+    // 연결된 클라이언트는 한도를 넘는 속도로 보내도 버리지 않음
+    for (int32 i = 0; i < 50; ++i)
+    {
+        Client->Send(TArray<uint8>({ (uint8)i }));
+    }
+    Server->Tick();
+    TestEqual("Connected clients should be exempt from the source limit", Server->GetReceiveDropStats().RateLimited, Drops.RateLimited);
+
+    // 연결이 끊기면 면제도 끝나므로 같은 주소에서 한도를 넘겨 보내면 버림
+    Client->Disconnect();
+    for (int32 Frame = 0; Frame < 5; ++Frame)
+    {
+        Server->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestEqual("Client should be disconnected", Server->GetNumConnections(), 0);
+    Client.Reset();
+    TUniquePtr<FHktLoopbackEndpoint> FormerClient = FHktLoopbackEndpoint::Bind(ClientPort);
+    for (int32 i = 0; i < 50; ++i)
+    {
+        FormerClient->SendTo(reinterpret_cast<const uint8*>(&PingHeader), sizeof(FPacketHeader), *ServerAddr);
+    }
+    Server->Tick();
+    TestEqual("Disconnected clients should be limited again", Server->GetReceiveDropStats().RateLimited, Drops.RateLimited + 50 - 20);
+
+    // 5. 정리
+    FormerClient.Reset();
+    Attacker.Reset();
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetParallelBroadcastTest, "HktCustomNet.ParallelBroadcast", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetParallelBroadcastTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12363;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const int32 NumClients = 200;
+    const int32 NumMessages = 10;
+    const int32 GroupId = 7;
+
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    // 1. 여러 작업으로 나뉠 만큼의 루프백 클라이언트를 한 그룹에 넣음
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->SetParallelBroadcast(1, 4);
+    Server->Start();
+
+    TArray<TUniquePtr<FHktReliableUdpClient>> Clients;
+    TArray<TSharedPtr<FInternetAddr>> ClientAddrs;
+    for (int32 i = 0; i < NumClients; ++i)
+    {
+        const uint16 ClientPort = HktReliableUdp::ClientPort + 100 + i;
+        TUniquePtr<FHktReliableUdpClient>& Client = Clients.Add_GetRef(MakeUnique<FHktReliableUdpClient>());
+        Client->SetTransport(EHktNetTransport::Loopback);
+        Client->Connect(ServerIp, Port, ClientPort);
+
+        TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+        bool bIsValid = false;
+        ClientAddr->SetIp(*ServerIp, bIsValid);
+        ClientAddr->SetPort(ClientPort);
+        ClientAddrs.Add(ClientAddr);
+    }
+
+    auto TickAll = [&]()
+    {
+        Server->Tick();
+        for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+        {
+            Client->Tick();
+        }
+        HktNetClock::Advance(FrameTime);
+    };
+    for (int32 Frame = 0; Frame < 10 && Server->GetNumConnections() < NumClients; ++Frame)
+    {
+        TickAll();
+    }
+    if (!TestEqual("All clients should be connected", Server->GetNumConnections(), NumClients))
+    {
+        Server->Stop();
+        HktNetClock::DisableVirtualTime();
+        return false;
+    }
+    for (const TSharedPtr<FInternetAddr>& ClientAddr : ClientAddrs)
+    {
+        Server->JoinGroup(ClientAddr, GroupId);
+    }
+
+    // 2. 병렬 브로드캐스트. 제외한 클라이언트 외에는 모두 보낸 순서대로 한 번씩 받아야 함
+    for (int32 i = 0; i < NumMessages; ++i)
+    {
+        Server->BroadcastToGroup(GroupId, TArray<uint8>({ (uint8)i }), ClientAddrs[0]);
+    }
+    TickAll();
+
+    bool bAllInOrder = true;
+    int32 NumExcludedReceived = 0;
+    TArray<uint8> Received;
+    for (int32 i = 0; i < NumClients; ++i)
+    {
+        int32 Expected = 0;
+        while (Clients[i]->Poll(Received))
+        {
+            bAllInOrder &= Received.Num() == 1 && Received[0] == (uint8)Expected;
+            ++Expected;
+        }
+        if (i == 0)
+        {
+            NumExcludedReceived = Expected;
+        }
+        else
+        {
+            bAllInOrder &= Expected == NumMessages;
+        }
+    }
+    TestTrue("Every member should receive every broadcast in order", bAllInOrder);
+    TestEqual("Excluded member should receive nothing", NumExcludedReceived, 0);
+
+    // 3. 연결별 시퀀스가 어긋났다면 Ack가 맞지 않아 재전송이 이어지고 클라이언트가 중복을 받게 됨
+    for (int32 Frame = 0; Frame < 30; ++Frame)
+    {
+        TickAll();
+    }
+    int32 NumDuplicates = 0;
+    for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+    {
+        while (Client->Poll(Received))
+        {
+            ++NumDuplicates;
+        }
+    }
+    TestEqual("Broadcasts should not be delivered twice", NumDuplicates, 0);
+    TestEqual("All connections should survive", Server->GetNumConnections(), NumClients);
+
+    // 4. 정리
+    for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+    {
+        Client->Disconnect();
+    }
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetGroupHierarchyTest, "HktCustomNet.GroupHierarchy", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetGroupHierarchyTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12365;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const int32 NumClients = 3;
+    const int32 WorldGroup = 1;
+    const int32 ZoneGroup = 2;
+    const int32 PartyGroup = 3;
+
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    // 1. 루프백 클라이언트 3개 연결
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->Start();
+
+    TArray<TUniquePtr<FHktReliableUdpClient>> Clients;
+    TArray<TSharedPtr<FInternetAddr>> ClientAddrs;
+    for (int32 i = 0; i < NumClients; ++i)
+    {
+        const uint16 ClientPort = HktReliableUdp::ClientPort + 22 + i;
+        TUniquePtr<FHktReliableUdpClient>& Client = Clients.Add_GetRef(MakeUnique<FHktReliableUdpClient>());
+        Client->SetTransport(EHktNetTransport::Loopback);
+        Client->Connect(ServerIp, Port, ClientPort);
+
+        TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+        bool bIsValid = false;
+        ClientAddr->SetIp(*ServerIp, bIsValid);
+        ClientAddr->SetPort(ClientPort);
+        ClientAddrs.Add(ClientAddr);
+    }
+
+    auto TickAll = [&]()
+    {
+        Server->Tick();
+        for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+        {
+            Client->Tick();
+        }
+        HktNetClock::Advance(FrameTime);
+    };
+    for (int32 Frame = 0; Frame < 10 && Server->GetNumConnections() < NumClients; ++Frame)
+    {
+        TickAll();
+    }
+    TestEqual("All clients should be connected", Server->GetNumConnections(), NumClients);
+
+    // 클라이언트별로 받은 메시지 수
+    auto CountReceived = [&]()
+    {
+        TickAll();
+        TArray<int32> Counts;
+        TArray<uint8> Received;
+        for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+        {
+            int32& Count = Counts.Add_GetRef(0);
+            while (Client->Poll(Received))
+            {
+                ++Count;
+            }
+        }
+        return Counts;
+    };
+
+    // 2. 월드 > 지역 > 파티 계층. 0번은 세 그룹 모두에, 1번은 지역에, 2번은 파티에만 참여
+    TestTrue("Zone should be added under world", Server->AddSubgroup(WorldGroup, ZoneGroup));
+    TestTrue("Party should be added under zone", Server->AddSubgroup(ZoneGroup, PartyGroup));
+    TestFalse("Cycles should be rejected", Server->AddSubgroup(PartyGroup, WorldGroup));
+    Server->JoinGroup(ClientAddrs[0], WorldGroup);
+    Server->JoinGroup(ClientAddrs[0], ZoneGroup);
+    Server->JoinGroup(ClientAddrs[0], PartyGroup);
+    Server->JoinGroup(ClientAddrs[1], ZoneGroup);
+    Server->JoinGroup(ClientAddrs[2], PartyGroup);
+
+    // 3. 상위 그룹으로 보내면 하위 그룹 구성원도 받고, 여러 그룹에 속한 클라이언트도 한 번만 받음
+    Server->BroadcastToGroup(WorldGroup, TArray<uint8>({ 1 }));
+    TestTrue("World broadcast should reach every member once", CountReceived() == TArray<int32>({ 1, 1, 1 }));
+
+    Server->BroadcastToGroups({ ZoneGroup, PartyGroup }, TArray<uint8>({ 2 }));
+    TestTrue("Overlapping groups should be deduplicated", CountReceived() == TArray<int32>({ 1, 1, 1 }));
+
+    Server->BroadcastToGroups({ PartyGroup }, TArray<uint8>({ 3 }), ClientAddrs[0]);
+    TestTrue("Leaf group broadcast should reach only its members", CountReceived() == TArray<int32>({ 0, 0, 1 }));
+
+    // 4. 계층을 끊으면 직접 참여한 구성원만 받음
+    Server->RemoveSubgroup(WorldGroup, ZoneGroup);
+    Server->BroadcastToGroup(WorldGroup, TArray<uint8>({ 4 }));
+    TestTrue("Detached subgroups should no longer inherit", CountReceived() == TArray<int32>({ 1, 0, 0 }));
+
+    // 5. 나간 연결의 번호를 새 연결이 다시 써도 중복 제거가 맞아야 함
+    Clients[1]->Disconnect();
+    for (int32 Frame = 0; Frame < 10 && Server->GetNumConnections() == NumClients; ++Frame)
+    {
+        TickAll();
+    }
+    TestEqual("Client should be disconnected", Server->GetNumConnections(), NumClients - 1);
+    Clients[1] = MakeUnique<FHktReliableUdpClient>();
+    Clients[1]->SetTransport(EHktNetTransport::Loopback);
+    Clients[1]->Connect(ServerIp, Port, HktReliableUdp::ClientPort + 23);
+    for (int32 Frame = 0; Frame < 10 && Server->GetNumConnections() < NumClients; ++Frame)
+    {
+        TickAll();
+    }
+    TestEqual("Client should reconnect", Server->GetNumConnections(), NumClients);
+    Server->JoinGroup(ClientAddrs[1], ZoneGroup);
+    Server->BroadcastToGroups({ ZoneGroup, PartyGroup }, TArray<uint8>({ 5 }));
+    TestTrue("Reused connection slots should be deduplicated", CountReceived() == TArray<int32>({ 1, 1, 1 }));
+
+    // 6. 정리
+    for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+    {
+        Client->Disconnect();
+    }
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetCollapseKeyTest, "HktCustomNet.CollapseKey", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetCollapseKeyTest::RunTest(const FString& Parameters)
+{
+    // 1. 대기 목록: 같은 키의 새 패킷이 이전 패킷을 대체하고, 다른 키와 키 없는 패킷은 그대로 둠
+    const uint64 MoveKey = HktCollapseKey::Make(42, 1);
+    const uint64 OtherKey = HktCollapseKey::Make(43, 1);
+    TestTrue("Different subjects should have different keys", MoveKey != OtherKey);
+    TestTrue("Different types should have different keys", MoveKey != HktCollapseKey::Make(42, 2));
+
+    TMap<uint32, FPendingPacket> Pending;
+    TMap<uint64, uint32> CollapseKeys;
+    auto AddPending = [&](uint32 Sequence, uint64 Key)
+    {
+        FPendingPacket Packet(TArray<uint8>({ (uint8)Sequence }), 0.0);
+        Packet.CollapseKey = Key;
+        return HktPendingPackets::Add(Pending, CollapseKeys, Sequence, MoveTemp(Packet));
+    };
+    TestFalse("First update should not supersede", AddPending(1, MoveKey));
+    TestFalse("Unkeyed packet should not supersede", AddPending(2, HktCollapseKey::None));
+    TestFalse("Other subject should not supersede", AddPending(3, OtherKey));
+    TestTrue("Second update should supersede the first", AddPending(4, MoveKey));
+    TestTrue("Third update should supersede the second", AddPending(5, MoveKey));
+    TestFalse("Superseded packet should no longer be pending", Pending.Contains(1) || Pending.Contains(4));
+    TestTrue("Latest update and other packets should remain", Pending.Contains(2) && Pending.Contains(3) && Pending.Contains(5));
+
+    // 2. 대체된 패킷의 늦은 Ack는 무시되고, 최신 패킷의 Ack는 색인도 비움
+    TestFalse("Ack for a superseded packet should be ignored", HktPendingPackets::Remove(Pending, CollapseKeys, 4));
+    TestTrue("Key should still point to the latest update", CollapseKeys.FindRef(MoveKey) == 5);
+    TestTrue("Ack for the latest update should remove it", HktPendingPackets::Remove(Pending, CollapseKeys, 5));
+    TestFalse("Acked key should be removed from the index", CollapseKeys.Contains(MoveKey));
+    TestFalse("Update after ack should not supersede", AddPending(6, MoveKey));
+
+    // 3. 서버와 클라이언트: Ack 전에 같은 키로 보낸 메시지는 대체됨
+    const uint16 Port = 12366;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 25;
+    const int32 NumUpdates = 5;
+
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPort));
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    ClientAddr->SetIp(*ServerIp, bIsValid);
+    ClientAddr->SetPort(ClientPort);
+
+    // 받는 쪽이 Tick하지 않는 동안 같은 키로 여러 번 보냄
+    for (int32 i = 0; i < NumUpdates; ++i)
+    {
+        Server->SendTo(ClientAddr, TArray<uint8>({ (uint8)i }), MoveKey);
+        Server->SendTo(ClientAddr, TArray<uint8>({ (uint8)(100 + i) }));
+        Client->Send(TArray<uint8>({ (uint8)i }), MoveKey);
+    }
+    TestEqual("Server should supersede all but the latest update", Server->GetNumSupersededPackets(), (int64)(NumUpdates - 1));
+    TestEqual("Client should supersede all but the latest update", Client->GetNumSupersededPackets(), (int64)(NumUpdates - 1));
+
+    // 이미 보낸 메시지는 그대로 도착하고, 키 없는 메시지는 모두 신뢰성 있게 전달됨
+    int32 NumKeyed = 0;
+    int32 NumUnkeyed = 0;
+    for (int32 Frame = 0; Frame < 30; ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+        TArray<uint8> Received;
+        while (Client->Poll(Received))
+        {
+            (Received[0] >= 100 ? NumUnkeyed : NumKeyed)++;
+        }
+    }
+    TestEqual("Every sent update should arrive once", NumKeyed, NumUpdates);
+    TestEqual("Unkeyed messages should all arrive", NumUnkeyed, NumUpdates);
+    TestTrue("Connection should stay healthy", Client->IsConnected() && Server->GetNumConnections() == 1);
+
+    // 4. 정리
+    Client->Disconnect();
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetDisconnectOrderingTest, "HktCustomNet.DisconnectOrdering", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetDisconnectOrderingTest::RunTest(const FString& Parameters)
+{
+    // 1. 제어 큐 분류: Ack/핸드셰이크/재개만 먼저 처리하고, 연결 해제와 그룹 요청은 데이터와 순서를 지킴
+    TestTrue("Ack should be a control packet", HktPacketHeader::IsControlType(EPacketType::Ack));
+    TestTrue("Resume should be a control packet", HktPacketHeader::IsControlType(EPacketType::Resume));
+    TestFalse("Disconnect should stay in order with data", HktPacketHeader::IsControlType(EPacketType::Disconnect));
+    TestFalse("JoinGroup should stay in order with data", HktPacketHeader::IsControlType(EPacketType::JoinGroup));
+    TestFalse("LeaveGroup should stay in order with data", HktPacketHeader::IsControlType(EPacketType::LeaveGroup));
+
+    // 2. 서버와 클라이언트 연결
+    const uint16 Port = 12367;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 26;
+    const int32 NumMessages = 3;
+
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    TArray<uint8> ReceivedValues;
+    Server->SetDataReceivedCallback([&ReceivedValues](const TSharedPtr<FInternetAddr>& ClientAddr, TConstArrayView<uint8> Payload)
+    {
+        if (Payload.Num() > 0)
+        {
+            ReceivedValues.Add(Payload[0]);
+        }
+    });
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPort));
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    // 3. 서버가 Tick하기 전에 데이터를 보내고 바로 연결 해제. 데이터가 먼저 전달되어야 함
+    for (int32 i = 0; i < NumMessages; ++i)
+    {
+        Client->Send(TArray<uint8>({ (uint8)i }));
+    }
+    Client->Disconnect();
+
+    for (int32 Frame = 0; Frame < 5; ++Frame)
+    {
+        Server->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestEqual("Data sent before Disconnect should be delivered", ReceivedValues.Num(), NumMessages);
+    for (int32 i = 0; i < ReceivedValues.Num(); ++i)
+    {
+        TestEqual("Data should be delivered in order", (int32)ReceivedValues[i], i);
+    }
+    TestEqual("Connection should be closed after the data", Server->GetNumConnections(), 0);
+
+    // 4. 정리
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetDuplicateDeliveryTest, "HktCustomNet.DuplicateDelivery", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetDuplicateDeliveryTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12364;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 29;
+
+    // 1. 서버와 클라이언트 연결
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    TArray<uint8> ServerReceived;
+    Server->SetDataReceivedCallback([&ServerReceived](const TSharedPtr<FInternetAddr>& ClientAddr, TConstArrayView<uint8> Payload)
+    {
+        if (Payload.Num() > 0)
+        {
+            ServerReceived.Add(Payload[0]);
+        }
+    });
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPort));
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    ClientAddr->SetIp(*ServerIp, bIsValid);
+    ClientAddr->SetPort(ClientPort);
+
+    TArray<uint8> ClientReceived;
+    auto TickAll = [&](int32 NumFrames)
+    {
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            Server->Tick();
+            Client->Tick();
+            TArray<uint8> Payload;
+            while (Client->Poll(Payload))
+            {
+                if (Payload.Num() > 0)
+                {
+                    ClientReceived.Add(Payload[0]);
+                }
+            }
+            HktNetClock::Advance(FrameTime);
+        }
+    };
+
+    // 2. 서버의 Ack가 사라지면 클라이언트가 재전송하지만 서버 콜백은 한 번만 불려야 함
+    Client->Send(TArray<uint8>({ 1 }));
+    FHktLoopbackEndpoint::SetLinkDown(ClientPort, true);
+    Server->Tick();
+    FHktLoopbackEndpoint::SetLinkDown(ClientPort, false);
+    TestEqual("Server should receive the first transmission", ServerReceived.Num(), 1);
+
+    TickAll((int32)(1.0 / FrameTime));
+    TestEqual("Retransmitted data should not be delivered again on the server", ServerReceived.Num(), 1);
+
+    // 3. 반대 방향: 클라이언트의 Ack가 사라져도 Poll로는 한 번만 나와야 함
+    Server->SendTo(ClientAddr, TArray<uint8>({ 2 }));
+    FHktLoopbackEndpoint::SetLinkDown(Port, true);
+    TickAll(1);
+    FHktLoopbackEndpoint::SetLinkDown(Port, false);
+    TestEqual("Client should receive the first transmission", ClientReceived.Num(), 1);
+
+    TickAll((int32)(1.0 / FrameTime));
+    TestEqual("Retransmitted data should not be delivered again on the client", ClientReceived.Num(), 1);
+
+    // 4. 중복을 걸러낸 뒤에도 이어지는 데이터는 정상 전달
+    Client->Send(TArray<uint8>({ 3 }));
+    Server->SendTo(ClientAddr, TArray<uint8>({ 4 }));
+    TickAll(5);
+    TestEqual("Later data should reach the server once", ServerReceived, TArray<uint8>({ 1, 3 }));
+    TestEqual("Later data should reach the client once", ClientReceived, TArray<uint8>({ 2, 4 }));
+    TestTrue("Client should stay connected", Client->IsConnected());
+
+    // 5. 정리
+    Client->Disconnect();
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetSuspendedBacklogTest, "HktCustomNet.SuspendedBacklog", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetSuspendedBacklogTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12368;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 27;
+    const int32 GroupId = 1;
+    const int32 NumMessages = 20;
+    const int32 MessageSize = 200;
+
+    // 1. 재전송 대역폭을 낮게 잡아 재개 후 밀린 패킷이 여러 Tick에 나누어 나가는지 확인
+    HktNetClock::EnableVirtualTime();
+    const double FrameTime = 1.0 / 60.0;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->SetSendBandwidth(4 * 1024);
+    Server->SetMaxSuspendedPendingPackets(NumMessages);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    TestTrue("Client Connect call", Client->Connect(ServerIp, Port, ClientPort));
+
+    auto TickAll = [&](bool bTickClient)
+    {
+        Server->Tick();
+        if (bTickClient)
+        {
+            Client->Tick();
+        }
+        HktNetClock::Advance(FrameTime);
+    };
+    auto Suspend = [&]()
+    {
+        for (int32 Frame = 0; Frame < (int32)(6.0 / FrameTime); ++Frame)
+        {
+            TickAll(false);
+        }
+    };
+
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        TickAll(true);
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+    Client->JoinGroup(GroupId);
+    TickAll(true);
+
+    // 2. 중단 중에 한도만큼 보낸 데이터는 재개 후 모두 도착하지만 한 Tick에 몰리지 않음
+    Suspend();
+    TestEqual("Server should suspend the silent session", Server->GetNumSuspendedSessions(), 1);
+    for (int32 i = 0; i < NumMessages; ++i)
+    {
+        TArray<uint8> Message;
+        Message.SetNumZeroed(MessageSize);
+        Message[0] = (uint8)i;
+        Server->BroadcastToGroup(GroupId, Message);
+    }
+
+    int32 NumReceived = 0;
+    int32 MaxReceivedPerFrame = 0;
+    bool bReceivedInOrder = true;
+    for (int32 Frame = 0; Frame < (int32)(5.0 / FrameTime) && NumReceived < NumMessages; ++Frame)
+    {
+        TickAll(true);
+        int32 ReceivedThisFrame = 0;
+        TArray<uint8> Received;
+        while (Client->Poll(Received))
+        {
+            // 허용량에 나뉘어 나가도 오래된 패킷부터 재전송됨
+            bReceivedInOrder &= Received.Num() > 0 && Received[0] == (uint8)(NumReceived + ReceivedThisFrame);
+            ++ReceivedThisFrame;
+        }
+        NumReceived += ReceivedThisFrame;
+        MaxReceivedPerFrame = FMath::Max(MaxReceivedPerFrame, ReceivedThisFrame);
+    }
+    TestEqual("Every message sent while suspended should arrive after resume", NumReceived, NumMessages);
+    TestTrue("Backlog should be paced over several ticks", MaxReceivedPerFrame < NumMessages / 2);
+    TestTrue("Backlog should be resent oldest first", bReceivedInOrder);
+    TestEqual("Session should be resumed", Server->GetNumConnections(), 1);
+
+    // 3. 한도를 넘게 쌓이면 세션을 버리고, 재개 요청은 거부됨
+    Suspend();
+    TestEqual("Server should suspend the silent session again", Server->GetNumSuspendedSessions(), 1);
+    for (int32 i = 0; i <= NumMessages; ++i)
+    {
+        Server->BroadcastToGroup(GroupId, TArray<uint8>({ (uint8)i }));
+    }
+    TickAll(false);
+    TestEqual("Overflowing session should be dropped", Server->GetNumSuspendedSessions(), 0);
+    for (int32 Frame = 0; Frame < (int32)(3.0 / FrameTime) && Client->IsConnected(); ++Frame)
+    {
+        TickAll(true);
+    }
+    TestFalse("Client should be told that the session is gone", Client->IsConnected());
+
+    // 4. 정리
+    Client->Disconnect();
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+// 이더넷 MTU(1472바이트 페이로드)보다 큰 데이터 패킷이 기본 설정의 실제 소켓에서 양방향으로 전달되는지 확인.
+// 경로 MTU 탐색은 기본으로 꺼져 있어 커널이 조각내어 보냄
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetLargeDatagramTest, "HktCustomNet.LargeDatagram", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktCustomNetLargeDatagramTest::RunTest(const FString& Parameters)
+{
+    const uint16 Port = 12369;
+    const FString ServerIp = TEXT("127.0.0.1");
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 28;
+    const int32 PayloadSize = 4000;
+
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    TArray<uint8> ServerReceived;
+    Server->SetDataReceivedCallback([&ServerReceived](const TSharedPtr<FInternetAddr>& ClientAddr, TConstArrayView<uint8> Payload)
+    {
+        ServerReceived = TArray<uint8>(Payload.GetData(), Payload.Num());
+    });
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    TestTrue("Client Connect call should succeed", Client->Connect(ServerIp, Port, ClientPort));
+    TestFalse("Server MTU discovery should be off by default", Server->IsMtuDiscoveryActive());
+    TestFalse("Client MTU discovery should be off by default", Client->IsMtuDiscoveryActive());
+
+    TSharedPtr<FInternetAddr> ClientAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    bool bIsValid = false;
+    ClientAddr->SetIp(*ServerIp, bIsValid);
+    ClientAddr->SetPort(ClientPort);
+
+    const float TickRate = 0.01f;
+    float ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !Client->IsConnected())
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Client should be connected", Client->IsConnected());
+
+    TArray<uint8> Payload;
+    Payload.SetNumUninitialized(PayloadSize);
+    for (int32 i = 0; i < PayloadSize; ++i)
+    {
+        Payload[i] = (uint8)(i * 31);
+    }
+    Client->Send(Payload);
+    Server->SendTo(ClientAddr, Payload);
+
+    TArray<uint8> ClientReceived;
+    bool bClientReceived = false;
+    ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !(bClientReceived && ServerReceived.Num() > 0))
+    {
+        Server->Tick();
+        Client->Tick();
+        bClientReceived = bClientReceived || Client->Poll(ClientReceived);
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestEqual("Server should receive the large payload intact", ServerReceived, Payload);
+    TestTrue("Client should receive the large payload", bClientReceived);
+    TestEqual("Client should receive the large payload intact", ClientReceived, Payload);
+    TestTrue("Connection should stay up", Client->IsConnected() && Server->GetNumConnections() == 1);
+
+    Client->Disconnect();
+    Server->Stop();
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
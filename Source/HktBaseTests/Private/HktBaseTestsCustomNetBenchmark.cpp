@@ -0,0 +1,668 @@
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HktReliableUdpServer.h"
+#include "HktReliableUdpClient.h"
+#include "HktNetClock.h"
+#include "HktInterestGrid.h"
+#include "HktReplicationPrioritizer.h"
+#include "HktFlagments.h"
+#include "HktStructSerializer.h"
+#include "Common/UdpSocketBuilder.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+
+namespace HktCustomNetBenchmark
+{
+    TSharedRef<FInternetAddr> MakeLoopbackAddr(uint16 Port)
+    {
+        TSharedRef<FInternetAddr> Addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+        bool bIsValid = false;
+        Addr->SetIp(TEXT("127.0.0.1"), bIsValid);
+        Addr->SetPort(Port);
+        return Addr;
+    }
+
+    TArray<uint8> MakeRawPacket(EPacketType Type, const void* Payload, int32 PayloadSize)
+    {
+        FPacketHeader Header;
+        Header.Type = Type;
+
+        TArray<uint8> Packet;
+        Packet.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FPacketHeader));
+        Packet.Append(static_cast<const uint8*>(Payload), PayloadSize);
+        return Packet;
+    }
+}
+
+// 위조된 주소에서 Connect가 폭주할 때 서버 Tick 시간과 연결 테이블 크기를 측정
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetConnectFloodBenchmark, "HktCustomNet.Benchmark.ConnectFlood", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktCustomNetConnectFloodBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace HktCustomNetBenchmark;
+
+    const uint16 Port = 12350;
+    const int32 NumFloodSockets = 32;
+    const int32 NumFloodPackets = 20000;
+    const int32 PacketsPerTick = 500;
+
+    // 1. 서버 생성 및 시작
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->Start();
+    FPlatformProcess::Sleep(0.1f);
+
+    // 2. 서로 다른 포트에서 패킷을 보낼 소켓들 생성 (주소 위조를 흉내냄)
+    TSharedRef<FInternetAddr> ServerAddr = MakeLoopbackAddr(Port);
+    TArray<FSocket*> FloodSockets;
+    for (int32 i = 0; i < NumFloodSockets; ++i)
+    {
+        FloodSockets.Add(FUdpSocketBuilder(TEXT("HktConnectFloodSocket")).AsNonBlocking().BoundToPort(0));
+    }
+
+    auto RunFlood = [&](const TCHAR* Label, const TArray<uint8>& FloodPacket)
+    {
+        double TotalTickTime = 0.0;
+        double MaxTickTime = 0.0;
+        int32 NumTicks = 0;
+
+        for (int32 Sent = 0; Sent < NumFloodPackets;)
+        {
+            for (int32 i = 0; i < PacketsPerTick && Sent < NumFloodPackets; ++i, ++Sent)
+            {
+                int32 BytesSent = 0;
+                FloodSockets[Sent % NumFloodSockets]->SendTo(FloodPacket.GetData(), FloodPacket.Num(), BytesSent, *ServerAddr);
+            }
+
+            const double TickStart = FPlatformTime::Seconds();
+            Server->Tick();
+            const double TickTime = FPlatformTime::Seconds() - TickStart;
+
+            TotalTickTime += TickTime;
+            MaxTickTime = FMath::Max(MaxTickTime, TickTime);
+            ++NumTicks;
+
+            FPlatformProcess::Sleep(0.001f);
+        }
+
+        const FHktReceiveDropStats Drops = Server->GetReceiveDropStats();
+        AddInfo(FString::Printf(TEXT("[%s] %d packets, %d ticks, avg tick %.4f ms, max tick %.4f ms, connections %d, dropped (malformed %lld, rate limited %lld)"),
+            Label, NumFloodPackets, NumTicks, TotalTickTime * 1000.0 / NumTicks, MaxTickTime * 1000.0, Server->GetNumConnections(), Drops.Malformed, Drops.RateLimited));
+        TestEqual(FString::Printf(TEXT("[%s] flood must not create connection state"), Label), Server->GetNumConnections(), 0);
+    };
+
+    // 3. 쿠키 크기만큼 패딩된 Connect 폭주
+    FHktConnectCookie EmptyCookie;
+    RunFlood(TEXT("Connect"), MakeRawPacket(EPacketType::Connect, &EmptyCookie, sizeof(FHktConnectCookie)));
+
+    // 4. 위조된 쿠키를 담은 ConnectResponse 폭주
+    FHktConnectCookie ForgedCookie;
+    ForgedCookie.IssuedAt = (uint32)FPlatformTime::Seconds();
+    for (uint8& Byte : ForgedCookie.Mac)
+    {
+        Byte = (uint8)FMath::RandRange(0, 255);
+    }
+    RunFlood(TEXT("ForgedConnectResponse"), MakeRawPacket(EPacketType::ConnectResponse, &ForgedCookie, sizeof(FHktConnectCookie)));
+
+    // 4-1. 헤더를 해석할 수 없는 쓰레기 패킷 폭주. 수신 스레드에서 큐에 넣기 전에 버려져야 함
+    TArray<uint8> Garbage;
+    Garbage.Init(0xFF, 64);
+    RunFlood(TEXT("Garbage"), Garbage);
+    TestTrue("Garbage should be dropped on the receiver thread", Server->GetReceiveDropStats().Malformed > 0);
+
+    // 5. 폭주 이후에도 정상 클라이언트는 연결되어야 함
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    TestTrue("Client Connect call should succeed", Client->Connect(TEXT("127.0.0.1"), Port, HktReliableUdp::ClientPort + 10));
+
+    const float TickRate = 0.01f;
+    float ElapsedTime = 0.0f;
+    while (ElapsedTime < 5.0f && !Client->IsConnected())
+    {
+        Server->Tick();
+        Client->Tick();
+        FPlatformProcess::Sleep(TickRate);
+        ElapsedTime += TickRate;
+    }
+    TestTrue("Legitimate client should connect after the flood", Client->IsConnected());
+    TestEqual("Only the legitimate client should hold connection state", Server->GetNumConnections(), 1);
+
+    // 6. 정리
+    for (FSocket* Socket : FloodSockets)
+    {
+        if (Socket)
+        {
+            Socket->Close();
+            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+        }
+    }
+    Client->Disconnect();
+    Server->Stop();
+
+    // Give sockets time to close
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+// 루프백에서 UDP GSO/GRO 사용 여부에 따른 대량 전송 처리량과 바이트당 전송 비용 측정
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetUdpOffloadBenchmark, "HktCustomNet.Benchmark.UdpOffload", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktCustomNetUdpOffloadBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace HktCustomNetBenchmark;
+
+    const int32 PayloadSize = 1200;
+    const int32 BurstSize = 32;
+    const int32 NumBursts = 512;
+
+    TArray<TArray<uint8>> Burst;
+    Burst.SetNum(BurstSize);
+    for (TArray<uint8>& Payload : Burst)
+    {
+        Payload.SetNumZeroed(PayloadSize);
+    }
+
+    auto RunMode = [&](bool bOffload, uint16 Port, uint16 ClientPort)
+    {
+        // 1. 서버와 클라이언트 생성 및 연결
+        TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+        Server->SetUdpOffloadEnabled(bOffload);
+        // 클라이언트가 몰아서 보내는 Ack가 수신 한도에 걸려 재전송이 섞이지 않도록 송신 경로만 측정
+        Server->SetReceiveRateLimit(0, 0);
+        Server->Start();
+
+        TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+        Client->SetUdpOffloadEnabled(bOffload);
+        Client->Connect(TEXT("127.0.0.1"), Port, ClientPort);
+
+        const float TickRate = 0.01f;
+        float ElapsedTime = 0.0f;
+        while (ElapsedTime < 5.0f && !Client->IsConnected())
+        {
+            Server->Tick();
+            Client->Tick();
+            FPlatformProcess::Sleep(TickRate);
+            ElapsedTime += TickRate;
+        }
+        if (!TestTrue(TEXT("Client should be connected"), Client->IsConnected()))
+        {
+            Client->Disconnect();
+            Server->Stop();
+            return;
+        }
+
+        // 2. 같은 크기의 데이터그램 묶음을 반복 전송하며 전송 호출에 든 시간과 수신량 측정
+        TSharedPtr<FInternetAddr> ClientAddr = MakeLoopbackAddr(ClientPort);
+        const int64 BytesToSend = (int64)NumBursts * BurstSize * PayloadSize;
+        int64 BytesReceived = 0;
+        uint64 SendCycles = 0;
+        TArray<uint8> Received;
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumBursts; ++i)
+        {
+            const uint64 SendStart = FPlatformTime::Cycles64();
+            Server->SendBurstTo(ClientAddr, Burst);
+            SendCycles += FPlatformTime::Cycles64() - SendStart;
+
+            Client->Tick();
+            while (Client->Poll(Received))
+            {
+                BytesReceived += Received.Num();
+            }
+        }
+
+        // 3. 남은 데이터 수신 대기
+        const double DrainDeadline = FPlatformTime::Seconds() + 2.0;
+        while (BytesReceived < BytesToSend && FPlatformTime::Seconds() < DrainDeadline)
+        {
+            Client->Tick();
+            while (Client->Poll(Received))
+            {
+                BytesReceived += Received.Num();
+            }
+            FPlatformProcess::Sleep(0.001f);
+        }
+        const double Elapsed = FPlatformTime::Seconds() - StartTime;
+        const double SendSeconds = FPlatformTime::ToSeconds64(SendCycles);
+
+        AddInfo(FString::Printf(TEXT("[Offload %s, GSO %d, GRO %d] sent %.1f MB, received %.1f MB in %.3f s (%.1f MB/s), send path %.3f ns/byte"),
+            bOffload ? TEXT("on") : TEXT("off"), (int32)Server->IsSendOffloadActive(), (int32)Client->IsReceiveOffloadActive(),
+            BytesToSend / (1024.0 * 1024.0), BytesReceived / (1024.0 * 1024.0), Elapsed, BytesReceived / (1024.0 * 1024.0) / Elapsed,
+            SendSeconds * 1e9 / BytesToSend));
+
+        // 4. 정리
+        Client->Disconnect();
+        Server->Stop();
+        FPlatformProcess::Sleep(0.1f);
+    };
+
+    RunMode(false, 12351, HktReliableUdp::ClientPort + 20);
+    RunMode(true, 12352, HktReliableUdp::ClientPort + 21);
+
+    return true;
+}
+
+// 열린 공간의 대규모 그룹에서 관심 영역 필터링 유무에 따른 브로드캐스트 팬아웃과 대역폭 비교
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetInterestFanOutBenchmark, "HktCustomNet.Benchmark.InterestFanOut", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktCustomNetInterestFanOutBenchmark::RunTest(const FString& Parameters)
+{
+    const int32 NumSubjects = 2000;
+    const int32 NumTicks = 60;
+    const float TickRate = 20.0f;
+    const float WorldSize = 40000.0f;
+    const float RelevanceRadius = 3000.0f;
+    const float MoveSpeed = 600.0f; // 초당 이동 거리
+
+    // 1. 개체 배치. 각 개체는 매 틱 자신의 FMoveFlagment를 그룹에 브로드캐스트한다고 가정
+    FRandomStream Random(1234);
+    TArray<FMoveFlagment> Subjects;
+    Subjects.SetNum(NumSubjects);
+    for (FMoveFlagment& Subject : Subjects)
+    {
+        Subject.TargetLocation = FVector(Random.FRandRange(0.0f, WorldSize), Random.FRandRange(0.0f, WorldSize), 0.0f);
+        Subject.Speed = MoveSpeed;
+    }
+    const int32 MessageSize = sizeof(FPacketHeader) + FHktStructSerializer::SerializeStructToBytes(Subjects[0]).Num();
+
+    auto RunMode = [&](bool bFilter, float Hysteresis)
+    {
+        FHktInterestGrid Grid(RelevanceRadius, Hysteresis);
+        FRandomStream MoveRandom(5678);
+        TArray<FVector> Locations;
+        for (int32 i = 0; i < NumSubjects; ++i)
+        {
+            Locations.Add(Subjects[i].TargetLocation);
+            Grid.Update(i, Locations[i]);
+        }
+
+        int64 TotalFanOut = 0;
+        uint64 QueryCycles = 0;
+        TArray<uint64> Recipients;
+        for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+        {
+            // 2. 이동 후 격자 갱신
+            for (int32 i = 0; i < NumSubjects; ++i)
+            {
+                Locations[i] += MoveRandom.GetUnitVector().GetSafeNormal2D() * (MoveSpeed / TickRate);
+                Grid.Update(i, Locations[i]);
+            }
+
+            // 3. 개체마다 수신자 결정
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            for (int32 i = 0; i < NumSubjects; ++i)
+            {
+                if (bFilter)
+                {
+                    Recipients.Reset();
+                    Grid.QueryRadius(Locations[i], RelevanceRadius, Recipients);
+                    TotalFanOut += Recipients.Num() - 1;
+                }
+                else
+                {
+                    TotalFanOut += NumSubjects - 1;
+                }
+            }
+            QueryCycles += FPlatformTime::Cycles64() - StartCycles;
+        }
+
+        const double FanOutPerMessage = (double)TotalFanOut / ((double)NumSubjects * NumTicks);
+        const double BytesPerSecond = (double)TotalFanOut * MessageSize / (NumTicks / TickRate);
+        AddInfo(FString::Printf(TEXT("[%s, hysteresis %.0f] %d subjects: fan-out %.1f per message, %.2f MB/s at %.0f Hz, selection %.3f ms/tick, %lld cell changes"),
+            bFilter ? TEXT("radius filter") : TEXT("no filter"), Hysteresis, NumSubjects, FanOutPerMessage, BytesPerSecond / (1024.0 * 1024.0), TickRate,
+            FPlatformTime::ToMilliseconds64(QueryCycles) / NumTicks, Grid.GetNumCellChanges()));
+        return FanOutPerMessage;
+    };
+
+    const double FullFanOut = RunMode(false, 0.0f);
+    RunMode(true, 0.0f);
+    const double FilteredFanOut = RunMode(true, RelevanceRadius * 0.1f);
+    TestTrue(TEXT("Radius filtering should reduce fan-out"), FilteredFanOut < FullFanOut * 0.5);
+
+    return true;
+}
+
+// 수천 개의 변경된 개체 중 클라이언트별 예산만큼 고르는 비용 측정
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetReplicationPriorityBenchmark, "HktCustomNet.Benchmark.ReplicationPriority", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktCustomNetReplicationPriorityBenchmark::RunTest(const FString& Parameters)
+{
+    const int32 NumClients = 100;
+    const int32 NumTicks = 20;
+    const int32 ByteBudget = 1200;
+    const float WorldSize = 40000.0f;
+
+    FRandomStream Random(4321);
+    for (int32 NumSubjects : { 1000, 4000, 16000 })
+    {
+        TArray<FHktReplicationCandidate> Candidates;
+        Candidates.SetNum(NumSubjects);
+        for (int32 i = 0; i < NumSubjects; ++i)
+        {
+            Candidates[i].SubjectId = i;
+            Candidates[i].Subject.Location = FVector(Random.FRandRange(0.0f, WorldSize), Random.FRandRange(0.0f, WorldSize), 0.0f);
+            Candidates[i].Size = 24 + Random.RandHelper(40);
+        }
+
+        TArray<FHktReplicationPrioritizer> Prioritizers;
+        TArray<FVector> ViewLocations;
+        for (int32 Client = 0; Client < NumClients; ++Client)
+        {
+            Prioritizers.Emplace(2000.0f);
+            ViewLocations.Add(FVector(Random.FRandRange(0.0f, WorldSize), Random.FRandRange(0.0f, WorldSize), 0.0f));
+        }
+
+        int64 TotalSelected = 0;
+        TArray<int32> Selected;
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+        {
+            for (int32 Client = 0; Client < NumClients; ++Client)
+            {
+                Selected.Reset();
+                Prioritizers[Client].Select(&ViewLocations[Client], Candidates, 0.05f, ByteBudget, Selected);
+                TotalSelected += Selected.Num();
+            }
+        }
+        const double ElapsedMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+        AddInfo(FString::Printf(TEXT("[%d subjects] %.4f ms per client selection, %.1f subjects selected per client (budget %d bytes)"),
+            NumSubjects, ElapsedMs / (NumTicks * NumClients), (double)TotalSelected / (NumTicks * NumClients), ByteBudget));
+    }
+
+    return true;
+}
+
+// 여러 스레드가 동시에 서로 다른 클라이언트로 SendTo를 호출할 때의 처리량 측정 (연결별 잠금의 확장성)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetSendContentionBenchmark, "HktCustomNet.Benchmark.SendContention", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktCustomNetSendContentionBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace HktCustomNetBenchmark;
+
+    const uint16 Port = 12353;
+    const int32 NumClients = 8;
+    const int32 MessagesPerThread = 20000;
+
+    // 1. 서버와 클라이언트들 연결. 클라이언트가 몰아서 보내는 Ack가 수신 한도에 걸리지 않도록 제한을 끔
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetReceiveRateLimit(0, 0);
+    Server->Start();
+
+    TArray<TUniquePtr<FHktReliableUdpClient>> Clients;
+    TArray<TSharedPtr<FInternetAddr>> ClientAddrs;
+    for (int32 i = 0; i < NumClients; ++i)
+    {
+        const uint16 ClientPort = HktReliableUdp::ClientPort + 30 + i;
+        TUniquePtr<FHktReliableUdpClient>& Client = Clients.Add_GetRef(MakeUnique<FHktReliableUdpClient>());
+        TestTrue(TEXT("Client Connect call should succeed"), Client->Connect(TEXT("127.0.0.1"), Port, ClientPort));
+        ClientAddrs.Add(MakeLoopbackAddr(ClientPort));
+    }
+
+    const double ConnectDeadline = FPlatformTime::Seconds() + 5.0;
+    while (Server->GetNumConnections() < NumClients && FPlatformTime::Seconds() < ConnectDeadline)
+    {
+        Server->Tick();
+        for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+        {
+            Client->Tick();
+        }
+        FPlatformProcess::Sleep(0.01f);
+    }
+    if (!TestEqual(TEXT("All clients should be connected"), Server->GetNumConnections(), NumClients))
+    {
+        return false;
+    }
+
+    // 2. 스레드 수를 늘려가며 각 스레드가 자기 클라이언트에게 동시에 전송
+    TArray<uint8> Payload;
+    Payload.Init(0xAB, 64);
+    double SingleThreadRate = 0.0;
+    for (int32 NumThreads = 1; NumThreads <= NumClients; NumThreads *= 2)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        ParallelFor(NumThreads, [&](int32 ThreadIndex)
+            {
+                for (int32 i = 0; i < MessagesPerThread; ++i)
+                {
+                    Server->SendTo(ClientAddrs[ThreadIndex], Payload);
+                }
+            }, EParallelForFlags::Unbalanced);
+        const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+        const double Rate = NumThreads * MessagesPerThread / Elapsed;
+        SingleThreadRate = NumThreads == 1 ? Rate : SingleThreadRate;
+        AddInfo(FString::Printf(TEXT("[%d threads] %.0f SendTo/s (%.2fx single thread)"), NumThreads, Rate, Rate / SingleThreadRate));
+
+        // 다음 측정 전에 클라이언트 수신 큐를 비움
+        TArray<uint8> Received;
+        for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+        {
+            Client->Tick();
+            while (Client->Poll(Received))
+            {
+            }
+        }
+    }
+
+    // 3. 정리
+    for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+    {
+        Client->Disconnect();
+    }
+    Server->Stop();
+    FPlatformProcess::Sleep(0.1f);
+
+    return true;
+}
+
+// 50MB 벌크 전송 중 게임플레이 메시지 지연과 벌크 처리량 측정 (루프백 전송 + 가상 시계).
+// 클라이언트 쪽 링크를 송신 대역폭과 같은 용량으로 모의하므로, 벌크가 링크를 채우면 게임플레이 메시지가 링크 큐에서 기다린 시간이 지연에 나타남
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetBulkTransferBenchmark, "HktCustomNet.Benchmark.BulkTransfer", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktCustomNetBulkTransferBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace HktCustomNetBenchmark;
+
+    const uint16 Port = 12360;
+    const uint16 ClientPort = HktReliableUdp::ClientPort + 16;
+    const int32 BulkSize = 50 * 1024 * 1024;
+    const int32 Bandwidth = 16 * 1024 * 1024;
+    const int32 BaselineFrames = 120;
+    const double FrameTime = 1.0 / 60.0;
+
+    // 1. 루프백 서버와 클라이언트 연결. 서버 -> 클라이언트 링크는 Bandwidth 바이트/초로 흘러감
+    HktNetClock::EnableVirtualTime();
+    FHktLoopbackEndpoint::SetLinkBandwidth(ClientPort, Bandwidth);
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->SetSendBandwidth(Bandwidth);
+    Server->Start();
+
+    TUniquePtr<FHktReliableUdpClient> Client = MakeUnique<FHktReliableUdpClient>();
+    Client->SetTransport(EHktNetTransport::Loopback);
+    Client->Connect(TEXT("127.0.0.1"), Port, ClientPort);
+    for (int32 Frame = 0; Frame < 10 && !Client->IsConnected(); ++Frame)
+    {
+        Server->Tick();
+        Client->Tick();
+        HktNetClock::Advance(FrameTime);
+    }
+    if (!TestTrue(TEXT("Client should be connected"), Client->IsConnected()))
+    {
+        Server->Stop();
+        FHktLoopbackEndpoint::SetLinkBandwidth(ClientPort, 0);
+        HktNetClock::DisableVirtualTime();
+        return false;
+    }
+
+    TSharedPtr<FInternetAddr> ClientAddr = MakeLoopbackAddr(ClientPort);
+    bool bBulkReceived = false;
+    Client->SetBulkReceivedCallback([&bBulkReceived](uint32, uint32, TArray<uint8>&&)
+        {
+            bBulkReceived = true;
+        });
+
+    // 매 프레임 보낸 시각을 담은 게임플레이 메시지를 보내고, 받은 시각과의 차이를 지연으로 기록
+    auto RunFrames = [&](const TCHAR* Label, int32 MaxFrames, TFunctionRef<bool()> IsDone)
+    {
+        double TotalLatency = 0.0;
+        double MaxLatency = 0.0;
+        int32 NumMessages = 0;
+        int32 NumFrames = 0;
+        TArray<uint8> Received;
+        for (; NumFrames < MaxFrames && !IsDone(); ++NumFrames)
+        {
+            const double SentAt = HktNetClock::Seconds();
+            TArray<uint8> Message;
+            Message.Append(reinterpret_cast<const uint8*>(&SentAt), sizeof(double));
+            Server->SendTo(ClientAddr, Message);
+
+            Server->Tick();
+            Client->Tick();
+            while (Client->Poll(Received))
+            {
+                if (Received.Num() == sizeof(double))
+                {
+                    double MessageSentAt;
+                    FMemory::Memcpy(&MessageSentAt, Received.GetData(), sizeof(double));
+                    const double Latency = HktNetClock::Seconds() - MessageSentAt;
+                    TotalLatency += Latency;
+                    MaxLatency = FMath::Max(MaxLatency, Latency);
+                    ++NumMessages;
+                }
+            }
+            HktNetClock::Advance(FrameTime);
+        }
+
+        AddInfo(FString::Printf(TEXT("[%s] %d frames, %d gameplay messages, avg latency %.2f ms, max latency %.2f ms"),
+            Label, NumFrames, NumMessages, NumMessages > 0 ? TotalLatency * 1000.0 / NumMessages : 0.0, MaxLatency * 1000.0));
+        return NumFrames;
+    };
+
+    // 2. 벌크 전송 없이 기준 지연 측정
+    RunFrames(TEXT("Gameplay only"), BaselineFrames, []() { return false; });
+
+    // 3. 50MB 전송 중 지연과 처리량 측정
+    TArray<uint8> Blob;
+    Blob.SetNumZeroed(BulkSize);
+    Server->SendBulk(ClientAddr, MoveTemp(Blob));
+
+    const double WallStart = FPlatformTime::Seconds();
+    const double VirtualStart = HktNetClock::Seconds();
+    const int32 MaxFrames = (int32)(4.0 * BulkSize / Bandwidth / FrameTime);
+    RunFrames(TEXT("Gameplay + 50 MB bulk"), MaxFrames, [&bBulkReceived]() { return bBulkReceived; });
+    const double VirtualElapsed = HktNetClock::Seconds() - VirtualStart;
+    const double WallElapsed = FPlatformTime::Seconds() - WallStart;
+
+    AddInfo(FString::Printf(TEXT("Bulk: %.1f MB in %.2f s of network time (%.2f MB/s, limit %.2f MB/s), %.2f s wall time"),
+        BulkSize / (1024.0 * 1024.0), VirtualElapsed, BulkSize / (1024.0 * 1024.0) / VirtualElapsed, Bandwidth / (1024.0 * 1024.0), WallElapsed));
+    TestTrue(TEXT("Bulk transfer should complete"), bBulkReceived);
+
+    // 4. 정리
+    Client->Disconnect();
+    Server->Stop();
+    FHktLoopbackEndpoint::SetLinkBandwidth(ClientPort, 0);
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
+
+// 그룹 크기와 작업 수에 따른 브로드캐스트 한 번의 지연 (루프백 전송, 모든 전송이 끝날 때까지)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktCustomNetParallelBroadcastBenchmark, "HktCustomNet.Benchmark.ParallelBroadcast", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktCustomNetParallelBroadcastBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace HktCustomNetBenchmark;
+
+    const uint16 Port = 12364;
+    const uint16 FirstClientPort = 40000;
+    const int32 NumBroadcasts = 20;
+    const TArray<int32> GroupSizes = { 1000, 4000, 8000 };
+    const double FrameTime = 1.0 / 60.0;
+
+    // 1. 가장 큰 그룹 크기만큼 루프백 클라이언트 연결. 그룹 크기별로 앞쪽 클라이언트들을 그룹에 넣음
+    HktNetClock::EnableVirtualTime();
+    TUniquePtr<FHktReliableUdpServer> Server = MakeUnique<FHktReliableUdpServer>(Port);
+    Server->SetTransport(EHktNetTransport::Loopback);
+    Server->Start();
+
+    const int32 NumClients = GroupSizes.Last();
+    TArray<TUniquePtr<FHktReliableUdpClient>> Clients;
+    for (int32 i = 0; i < NumClients; ++i)
+    {
+        TUniquePtr<FHktReliableUdpClient>& Client = Clients.Add_GetRef(MakeUnique<FHktReliableUdpClient>());
+        Client->SetTransport(EHktNetTransport::Loopback);
+        Client->Connect(TEXT("127.0.0.1"), Port, FirstClientPort + i);
+    }
+
+    // 클라이언트가 받은 패킷을 비우고 Ack를 서버에 반영
+    TArray<uint8> Received;
+    auto TickAll = [&]()
+    {
+        for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+        {
+            Client->Tick();
+            while (Client->Poll(Received))
+            {
+            }
+        }
+        Server->Tick();
+        HktNetClock::Advance(FrameTime);
+    };
+    for (int32 Frame = 0; Frame < 10 && Server->GetNumConnections() < NumClients; ++Frame)
+    {
+        TickAll();
+    }
+    if (!TestEqual(TEXT("All clients should be connected"), Server->GetNumConnections(), NumClients))
+    {
+        Server->Stop();
+        HktNetClock::DisableVirtualTime();
+        return false;
+    }
+    for (int32 i = 0; i < NumClients; ++i)
+    {
+        for (int32 GroupSize : GroupSizes)
+        {
+            if (i < GroupSize)
+            {
+                Server->JoinGroup(MakeLoopbackAddr(FirstClientPort + i), GroupSize);
+            }
+        }
+    }
+
+    // 2. 그룹 크기마다 작업 수를 늘려가며 측정
+    TArray<uint8> Payload;
+    Payload.Init(0xCD, 64);
+    for (int32 GroupSize : GroupSizes)
+    {
+        double SerialLatency = 0.0;
+        for (int32 NumTasks : { 1, 2, 4, 8 })
+        {
+            Server->SetParallelBroadcast(NumTasks > 1 ? 1 : 0, NumTasks);
+
+            double TotalLatency = 0.0;
+            double MaxLatency = 0.0;
+            for (int32 i = 0; i < NumBroadcasts; ++i)
+            {
+                const double StartTime = FPlatformTime::Seconds();
+                Server->BroadcastToGroup(GroupSize, Payload);
+                const double Latency = FPlatformTime::Seconds() - StartTime;
+                TotalLatency += Latency;
+                MaxLatency = FMath::Max(MaxLatency, Latency);
+            }
+            TickAll();
+
+            const double AvgLatency = TotalLatency / NumBroadcasts;
+            SerialLatency = NumTasks == 1 ? AvgLatency : SerialLatency;
+            AddInfo(FString::Printf(TEXT("[%d members, %d tasks] avg %.3f ms, max %.3f ms per broadcast (%.2fx serial)"),
+                GroupSize, NumTasks, AvgLatency * 1000.0, MaxLatency * 1000.0, SerialLatency / AvgLatency));
+        }
+    }
+
+    // 3. 정리
+    for (TUniquePtr<FHktReliableUdpClient>& Client : Clients)
+    {
+        Client->Disconnect();
+    }
+    Server->Stop();
+    HktNetClock::DisableVirtualTime();
+
+    return true;
+}
@@ -0,0 +1,525 @@
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+#include "ENetManager.h"
+#include "Misc/AutomationTest.h"
+
+namespace HktENetTests
+{
+    // 조건이 참이 될 때까지 호스트들을 Tick. 제한 시간 안에 참이 되면 true
+    bool TickUntil(TArrayView<FENetManager* const> Managers, TFunctionRef<bool()> Condition, double Seconds = 5.0)
+    {
+        for (const double Deadline = FPlatformTime::Seconds() + Seconds; FPlatformTime::Seconds() < Deadline;)
+        {
+            for (FENetManager* Manager : Managers)
+            {
+                Manager->Tick();
+            }
+            if (Condition())
+            {
+                return true;
+            }
+            FPlatformProcess::Sleep(0.001f);
+        }
+        return false;
+    }
+
+    // 서버를 열고 클라이언트를 하나씩 연결. OutServerPeers[i]가 Clients[i]에 해당하는 서버 쪽 Peer
+    bool StartServerWithClients(FENetManager& Server, TArrayView<FENetManager> Clients, uint16 Port, TArray<ENetPeer*>& OutServerPeers)
+    {
+        Server.OnClientConnected.AddLambda([&OutServerPeers](ENetPeer* Peer) { OutServerPeers.Add(Peer); });
+        if (!Server.StartServer(Port, Clients.Num() + 1))
+        {
+            return false;
+        }
+
+        TArray<FENetManager*> Managers = { &Server };
+        for (FENetManager& Client : Clients)
+        {
+            Managers.Add(&Client);
+        }
+        for (int32 i = 0; i < Clients.Num(); ++i)
+        {
+            if (!Clients[i].StartClient(TEXT("127.0.0.1"), Port) || !TickUntil(Managers, [&]() { return OutServerPeers.Num() == i + 1; }))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// 서비스 스레드 모드의 송수신과, 끊긴 연결의 자리에 새 연결이 들어왔을 때 이전 연결로 보낸 패킷이 새 연결에 가지 않는지 확인
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetServiceThreadTest, "HktENet.ServiceThread", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktENetServiceThreadTest::RunTest(const FString& Parameters)
+{
+    using namespace HktENetTests;
+    const uint16 Port = 12372;
+    const int32 NumPackets = 50;
+
+    // 1. 양쪽 모두 서비스 스레드로 연결하고 주고받음
+    {
+        FENetManager Server;
+        FENetManager Client;
+        Server.SetServiceThread(true);
+        Client.SetServiceThread(true);
+        ENetPeer* ClientPeer = nullptr;
+        bool bClientConnected = false;
+        TArray<uint8> ServerReceived;
+        TArray<uint8> ClientReceived;
+        Server.OnClientConnected.AddLambda([&ClientPeer](ENetPeer* Peer) { ClientPeer = Peer; });
+        Server.OnPacketReceived.AddLambda([&ServerReceived](ENetPeer*, const TArray<uint8>& Data) { ServerReceived.Add(Data[0]); });
+        Client.OnClientConnected.AddLambda([&bClientConnected](ENetPeer*) { bClientConnected = true; });
+        Client.OnPacketReceived.AddLambda([&ClientReceived](ENetPeer*, const TArray<uint8>& Data) { ClientReceived.Add(Data[0]); });
+        if (!Server.StartServer(Port, 4) || !Client.StartClient(TEXT("127.0.0.1"), Port))
+        {
+            AddError(TEXT("Failed to start ENet hosts"));
+            return false;
+        }
+        TestTrue(TEXT("Service threads should run"), Server.IsServiceThreadRunning() && Client.IsServiceThreadRunning());
+        FENetManager* Managers[] = { &Server, &Client };
+        TestTrue(TEXT("Both sides should see the connection"), TickUntil(Managers, [&]() { return ClientPeer && bClientConnected; }));
+
+        for (int32 i = 0; i < NumPackets; ++i)
+        {
+            Client.SendPacketToServer({ (uint8)i });
+            Server.SendPacketToPeer(ClientPeer, { (uint8)(100 + i) });
+        }
+        TestTrue(TEXT("Every packet should arrive"), TickUntil(Managers, [&]() { return ServerReceived.Num() == NumPackets && ClientReceived.Num() == NumPackets; }));
+        bool bInOrder = true;
+        for (int32 i = 0; i < ServerReceived.Num() && i < ClientReceived.Num(); ++i)
+        {
+            bInOrder &= ServerReceived[i] == i && ClientReceived[i] == 100 + i;
+        }
+        TestTrue(TEXT("Reliable packets should arrive in order"), bInOrder);
+
+        Client.Stop();
+        Server.Stop();
+    }
+
+    // 2. 자리가 하나뿐인 서버에서 연결이 끊기고 새 연결이 같은 자리에 들어옴. 서버의 Tick은 그 사이 멈춰 있음
+    {
+        FENetManager Server;
+        FENetManager ClientA;
+        FENetManager ClientB;
+        Server.SetServiceThread(true);
+        TArray<ENetPeer*> ServerConnects;
+        int32 NumServerDisconnects = 0;
+        ENetPeer* PeerOfA = nullptr;
+        bool bConnectedB = false;
+        TArray<uint8> ReceivedB;
+        Server.OnClientConnected.AddLambda([&ServerConnects](ENetPeer* Peer) { ServerConnects.Add(Peer); });
+        Server.OnClientDisconnected.AddLambda([&NumServerDisconnects](ENetPeer*) { ++NumServerDisconnects; });
+        ClientA.OnClientConnected.AddLambda([&PeerOfA](ENetPeer* Peer) { PeerOfA = Peer; });
+        ClientB.OnClientConnected.AddLambda([&bConnectedB](ENetPeer*) { bConnectedB = true; });
+        ClientB.OnPacketReceived.AddLambda([&ReceivedB](ENetPeer*, const TArray<uint8>& Data) { ReceivedB.Add(Data[0]); });
+        if (!Server.StartServer(Port, 1) || !ClientA.StartClient(TEXT("127.0.0.1"), Port))
+        {
+            AddError(TEXT("Failed to start ENet hosts"));
+            return false;
+        }
+        FENetManager* ServerAndA[] = { &Server, &ClientA };
+        TestTrue(TEXT("First client should connect"), TickUntil(ServerAndA, [&]() { return PeerOfA && ServerConnects.Num() == 1; }));
+        ENetPeer* const Slot = ServerConnects.Num() > 0 ? ServerConnects[0] : nullptr;
+
+        // A가 바로 끊고 B가 연결. 서버 네트워크 스레드만 돌고 있으므로 Tick 스레드는 아직 A의 연결로 알고 있음
+        enet_peer_disconnect_now(PeerOfA, 0);
+        if (!ClientB.StartClient(TEXT("127.0.0.1"), Port))
+        {
+            AddError(TEXT("Failed to start second client"));
+            return false;
+        }
+        FENetManager* OnlyB[] = { &ClientB };
+        TestTrue(TEXT("Second client should connect while the server is not ticking"), TickUntil(OnlyB, [&]() { return bConnectedB; }));
+
+        // A에게 보내려던 패킷은 같은 자리의 B에게 가면 안 됨
+        Server.SendPacketToPeer(Slot, { 1 });
+        TickUntil(OnlyB, [&]() { return ReceivedB.Num() > 0; }, 0.3);
+        TestEqual(TEXT("Packet meant for the old connection should not reach the new one"), ReceivedB.Num(), 0);
+
+        // 서버가 끊김과 새 연결을 순서대로 받은 뒤에는 같은 자리로 B에게 보낼 수 있음
+        FENetManager* ServerAndB[] = { &Server, &ClientB };
+        TestTrue(TEXT("Server should see the disconnect and the new connection"), TickUntil(ServerAndB, [&]() { return NumServerDisconnects == 1 && ServerConnects.Num() == 2; }));
+        TestTrue(TEXT("New connection should reuse the slot"), ServerConnects.Num() == 2 && ServerConnects[1] == Slot);
+        Server.SendPacketToPeer(Slot, { 2 });
+        TestTrue(TEXT("Packet to the new connection should arrive"), TickUntil(ServerAndB, [&]() { return ReceivedB.Num() > 0; }));
+        TestTrue(TEXT("Only the new packet should arrive"), ReceivedB.Num() == 1 && ReceivedB[0] == 2);
+
+        ClientB.Stop();
+        ClientA.Stop();
+        Server.Stop();
+    }
+
+    return true;
+}
+
+// 그룹 계층과 여러 그룹 합집합 전송: 여러 경로로 닿는 Peer도 한 번만 받고, 연속 호출에도 중복 제거가 유지되는지 확인
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetGroupHierarchyTest, "HktENet.GroupHierarchy", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktENetGroupHierarchyTest::RunTest(const FString& Parameters)
+{
+    using namespace HktENetTests;
+    const uint16 Port = 12373;
+    const FName World(TEXT("World"));
+    const FName Region(TEXT("Region"));
+    const FName Party(TEXT("Party"));
+    const FName Other(TEXT("Other"));
+
+    FENetManager Server;
+    FENetManager Clients[3];
+    TArray<ENetPeer*> ServerPeers;
+    TArray<uint8> Received[3];
+    for (int32 i = 0; i < 3; ++i)
+    {
+        Clients[i].OnPacketReceived.AddLambda([&Received, i](ENetPeer*, const TArray<uint8>& Data) { Received[i].Add(Data[0]); });
+    }
+    if (!StartServerWithClients(Server, Clients, Port, ServerPeers))
+    {
+        AddError(TEXT("Failed to connect ENet hosts"));
+        return false;
+    }
+    FENetManager* Managers[] = { &Server, &Clients[0], &Clients[1], &Clients[2] };
+
+    // World > Region > Party. 0은 Party, 1은 Region과 Party 모두, 2는 계층 밖의 Other
+    TestTrue(TEXT("World > Region should be accepted"), Server.AddSubgroup(World, Region));
+    TestTrue(TEXT("Region > Party should be accepted"), Server.AddSubgroup(Region, Party));
+    TestFalse(TEXT("Party > World would create a cycle"), Server.AddSubgroup(Party, World));
+    Server.AddPeerToGroup(ServerPeers[0], Party);
+    Server.AddPeerToGroup(ServerPeers[1], Region);
+    Server.AddPeerToGroup(ServerPeers[1], Party);
+    Server.AddPeerToGroup(ServerPeers[2], Other);
+
+    // 1. 상위 그룹과 하위 그룹을 함께 지정해도 한 번씩만 받음
+    Server.SendPacketToGroups({ World, Party }, { 1 });
+    // 2. 바로 이어서 보내도 이전 호출의 중복 표시가 남아 있지 않음
+    Server.SendPacketToGroups({ World }, { 2 });
+    // 3. Party를 떼어 내면 World로 보낸 패킷은 Region의 구성원만 받음
+    Server.RemoveSubgroup(Region, Party);
+    Server.SendPacketToGroup(World, { 3 });
+    // 4. 계층과 무관한 그룹들의 합집합
+    Server.SendPacketToGroups({ Other, Party }, { 4 });
+
+    // 신뢰성 있는 패킷은 순서대로 오므로 마지막 패킷까지 오면 그 앞의 잘못된 전송도 이미 도착했음
+    TestTrue(TEXT("Last packet should reach every client"), TickUntil(Managers, [&]() { return Received[0].Contains(4) && Received[1].Contains(4) && Received[2].Contains(4); }));
+    TestEqual(TEXT("Party member should get the union packets once"), Received[0], TArray<uint8>({ 1, 2, 4 }));
+    TestEqual(TEXT("Member of two groups should get each packet once"), Received[1], TArray<uint8>({ 1, 2, 3, 4 }));
+    TestEqual(TEXT("Peer outside the hierarchy should only get its own group"), Received[2], TArray<uint8>({ 4 }));
+
+    for (FENetManager& Client : Clients)
+    {
+        Client.Stop();
+    }
+    Server.Stop();
+    return true;
+}
+
+// 수신 콜백에서 가져간 패킷은 콜백이 끝난 뒤에도 유효하고, 가져가지 않은 패킷은 Tick이 해제하는지 확인
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetTakeReceivedPacketTest, "HktENet.TakeReceivedPacket", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktENetTakeReceivedPacketTest::RunTest(const FString& Parameters)
+{
+    using namespace HktENetTests;
+    const uint16 Port = 12374;
+    const int32 NumPackets = 50;
+
+    FENetManager Server;
+    FENetManager Client;
+    TArray<ENetPeer*> ServerPeers;
+    FENetPacketHandle Held;
+    bool bSecondTakeEmpty = false;
+    int32 NumReceived = 0;
+    Client.OnPacketViewReceived.AddLambda([&](ENetPeer*, TArrayView<const uint8> Data)
+    {
+        ++NumReceived;
+        // 첫 패킷만 가져가고 나머지는 Tick이 해제하도록 둠
+        if (Data[0] == 1)
+        {
+            Held = Client.TakeReceivedPacket();
+            bSecondTakeEmpty = !Client.TakeReceivedPacket().IsValid();
+        }
+    });
+    if (!StartServerWithClients(Server, MakeArrayView(&Client, 1), Port, ServerPeers))
+    {
+        AddError(TEXT("Failed to connect ENet hosts"));
+        return false;
+    }
+    FENetManager* Managers[] = { &Server, &Client };
+    auto Settle = [&Managers]() { TickUntil(Managers, []() { return false; }, 0.1); };
+    Settle();
+    TestFalse(TEXT("Taking outside the callback should return an empty handle"), Client.TakeReceivedPacket().IsValid());
+
+    TArray<uint8> Kept;
+    Kept.Add(1);
+    for (int32 i = 1; i < 64; ++i)
+    {
+        Kept.Add((uint8)(i * 7));
+    }
+    const int64 LiveBefore = HktENetAllocator::GetStats().LiveAllocations;
+    Server.SendPacketToPeer(ServerPeers[0], Kept);
+    for (int32 i = 0; i < NumPackets; ++i)
+    {
+        Server.SendPacketToPeer(ServerPeers[0], { 2, (uint8)i });
+    }
+    TestTrue(TEXT("Every packet should arrive and be acknowledged"), TickUntil(Managers, [&]() { return NumReceived == NumPackets + 1 && Server.GetChannelStats(0).QueuedPackets == 0; }));
+    Settle();
+
+    // 가져간 패킷은 뒤이은 수신과 Tick에도 그대로 남아 있음
+    TestTrue(TEXT("Taken packet should stay valid after the callback"), Held.IsValid());
+    TestTrue(TEXT("Taking twice in one callback should return an empty handle"), bSecondTakeEmpty);
+    const TArrayView<const uint8> HeldData = Held.GetData();
+    TestTrue(TEXT("Taken packet should keep its data"), HeldData.Num() == Kept.Num() && FMemory::Memcmp(HeldData.GetData(), Kept.GetData(), Kept.Num()) == 0);
+
+    // 가져가지 않은 패킷이 새면 살아 있는 할당이 패킷 수만큼 늘어남. 가져간 패킷 하나 몫만 남아야 함
+    const int64 LiveHeld = HktENetAllocator::GetStats().LiveAllocations;
+    TestTrue(TEXT("Untaken packets should be freed by Tick"), LiveHeld - LiveBefore < NumPackets / 2);
+    Held.Reset();
+    TestTrue(TEXT("Releasing the handle should free the packet"), HktENetAllocator::GetStats().LiveAllocations < LiveHeld);
+    TestFalse(TEXT("Released handle should be empty"), Held.IsValid());
+
+    Client.Stop();
+    Server.Stop();
+    return true;
+}
+
+// 그룹 전송은 패킷 하나를 모든 구성원이 공유하고, 보내지 못한 Peer가 섞여 있거나 모두 실패해도 패킷이 한 번만 해제되는지 확인
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetSharedPacketTest, "HktENet.SharedPacket", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktENetSharedPacketTest::RunTest(const FString& Parameters)
+{
+    using namespace HktENetTests;
+    const uint16 Port = 12375;
+    const FName All(TEXT("All"));
+    const FName Gone(TEXT("Gone"));
+
+    FENetManager Server;
+    FENetManager Clients[3];
+    TArray<ENetPeer*> ServerPeers;
+    TArray<uint8> Received[3];
+    for (int32 i = 0; i < 3; ++i)
+    {
+        Clients[i].OnPacketReceived.AddLambda([&Received, i](ENetPeer*, const TArray<uint8>& Data) { Received[i].Add(Data[0]); });
+    }
+    if (!StartServerWithClients(Server, Clients, Port, ServerPeers))
+    {
+        AddError(TEXT("Failed to connect ENet hosts"));
+        return false;
+    }
+    FENetManager* Managers[] = { &Server, &Clients[0], &Clients[1], &Clients[2] };
+    for (ENetPeer* Peer : ServerPeers)
+    {
+        Server.AddPeerToGroup(Peer, All);
+    }
+
+    // 1. 세 구성원에게 보내도 패킷은 하나. 모든 구성원의 Ack를 받은 뒤 한 번 해제됨
+    const int64 SentBefore = Server.GetChannelStats(0).PacketsSent;
+    Server.SendPacketToGroup(All, { 1 });
+    TestEqual(TEXT("Group send should create one packet"), Server.GetChannelStats(0).PacketsSent - SentBefore, (int64)1);
+    TestEqual(TEXT("Shared packet should be queued once"), Server.GetChannelStats(0).QueuedPackets, 1);
+    TestTrue(TEXT("Every member should receive the shared packet"), TickUntil(Managers, [&]() { return Received[0].Num() == 1 && Received[1].Num() == 1 && Received[2].Num() == 1; }));
+    TestTrue(TEXT("Shared packet should be released after every ack"), TickUntil(Managers, [&]() { return Server.GetChannelStats(0).QueuedPackets == 0; }));
+
+    // 2. 서버 쪽에서 연결을 바로 끊으면 끊김 이벤트 없이 그룹에 남아 있으므로 그 Peer로는 보내지 못함
+    enet_peer_disconnect_now(ServerPeers[2], 0);
+    Server.AddPeerToGroup(ServerPeers[2], Gone);
+    Server.SendPacketToGroup(All, { 2 });
+    TestEqual(TEXT("Packet should be held only by the live members"), Server.GetChannelStats(0).QueuedPackets, 1);
+    TestTrue(TEXT("Live members should receive the packet"), TickUntil(Managers, [&]() { return Received[0].Num() == 2 && Received[1].Num() == 2; }));
+    TestTrue(TEXT("Partially sent packet should be released once"), TickUntil(Managers, [&]() { return Server.GetChannelStats(0).QueuedPackets == 0; }));
+
+    // 3. 어느 Peer에도 들어가지 않은 패킷은 바로 해제됨. 두 번 해제되면 대기 수가 음수가 됨
+    const int64 SentBeforeFailed = Server.GetChannelStats(0).PacketsSent;
+    Server.SendPacketToPeer(ServerPeers[2], { 3 });
+    Server.SendPacketToGroup(Gone, { 4 });
+    TestEqual(TEXT("Failed sends should still create their packets"), Server.GetChannelStats(0).PacketsSent - SentBeforeFailed, (int64)2);
+    TestEqual(TEXT("Failed sends should free their packets immediately"), Server.GetChannelStats(0).QueuedPackets, 0);
+    TestTrue(TEXT("Disconnected member should only have the first packet"), Received[2].Num() == 1);
+
+    for (FENetManager& Client : Clients)
+    {
+        Client.Stop();
+    }
+    Server.Stop();
+    return true;
+}
+
+// 그룹 참여/탈퇴/연결 종료를 임의 순서로 섞어도 그룹 배열과 Peer 소속 사이의 역참조가 어긋나지 않는지 확인
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetGroupMembershipTest, "HktENet.GroupMembership", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktENetGroupMembershipTest::RunTest(const FString& Parameters)
+{
+    using namespace HktENetTests;
+    const uint16 Port = 12376;
+    const int32 NumClients = 4;
+    const int32 NumOperations = 500;
+    const FName Groups[] = { FName(TEXT("A")), FName(TEXT("B")), FName(TEXT("C")) };
+
+    FENetManager Server;
+    FENetManager Clients[NumClients];
+    TArray<ENetPeer*> ServerPeers;
+    TArray<ENetPeer*> Disconnected;
+    Server.OnClientDisconnected.AddLambda([&Disconnected](ENetPeer* Peer) { Disconnected.Add(Peer); });
+    if (!StartServerWithClients(Server, Clients, Port, ServerPeers))
+    {
+        AddError(TEXT("Failed to connect ENet hosts"));
+        return false;
+    }
+    FENetManager* Managers[] = { &Server, &Clients[0], &Clients[1], &Clients[2], &Clients[3] };
+
+    // 기대하는 소속 (그룹명 -> Peer 집합)과 실제 상태를 비교
+    TMap<FName, TSet<ENetPeer*>> Expected;
+    auto MatchesExpected = [&]() -> bool
+    {
+        for (const FName& Group : Groups)
+        {
+            const TSet<ENetPeer*>& ExpectedMembers = Expected.FindOrAdd(Group);
+            const TArrayView<ENetPeer* const> Members = Server.GetGroupMembers(Group);
+            // 수가 같고 기대한 Peer가 모두 들어 있으면 중복도 없음
+            if (Members.Num() != ExpectedMembers.Num())
+            {
+                return false;
+            }
+            for (ENetPeer* Peer : ServerPeers)
+            {
+                if (Members.Contains(Peer) != ExpectedMembers.Contains(Peer) || Server.IsPeerInGroup(Peer, Group) != ExpectedMembers.Contains(Peer))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    // 1. 참여와 탈퇴를 섞어서 반복. 이미 속한 그룹에 다시 참여하거나 속하지 않은 그룹에서 탈퇴해도 무시됨
+    FRandomStream Random(1234);
+    bool bConsistent = true;
+    for (int32 Op = 0; Op < NumOperations && bConsistent; ++Op)
+    {
+        ENetPeer* Peer = ServerPeers[Random.RandHelper(NumClients)];
+        const FName& Group = Groups[Random.RandHelper(UE_ARRAY_COUNT(Groups))];
+        if (Random.FRand() < 0.55f)
+        {
+            Server.AddPeerToGroup(Peer, Group);
+            Expected.FindOrAdd(Group).Add(Peer);
+        }
+        else
+        {
+            Server.RemovePeerFromGroup(Peer, Group);
+            Expected.FindOrAdd(Group).Remove(Peer);
+        }
+        bConsistent = MatchesExpected();
+    }
+    TestTrue(TEXT("Membership should match after random joins and leaves"), bConsistent);
+
+    // 2. 모두 모든 그룹에 넣은 뒤 중간 Peer부터 연결을 끊어 그룹 가운데의 빈자리가 채워지는 경우를 만듦
+    for (ENetPeer* Peer : ServerPeers)
+    {
+        for (const FName& Group : Groups)
+        {
+            Server.AddPeerToGroup(Peer, Group);
+            Expected.FindOrAdd(Group).Add(Peer);
+        }
+    }
+    TestTrue(TEXT("Membership should match after everyone joins"), MatchesExpected());
+
+    const int32 DisconnectOrder[] = { 1, 3, 0, 2 };
+    for (int32 ClientIndex : DisconnectOrder)
+    {
+        ENetPeer* Peer = ServerPeers[ClientIndex];
+        enet_peer_disconnect(Peer, 0);
+        const int32 NumDisconnected = Disconnected.Num();
+        if (!TickUntil(Managers, [&]() { return Disconnected.Num() > NumDisconnected; }))
+        {
+            AddError(FString::Printf(TEXT("Client %d did not disconnect"), ClientIndex));
+            break;
+        }
+        for (TPair<FName, TSet<ENetPeer*>>& Pair : Expected)
+        {
+            Pair.Value.Remove(Peer);
+        }
+        TestTrue(FString::Printf(TEXT("Membership should match after client %d disconnects"), ClientIndex), MatchesExpected());
+    }
+    for (const FName& Group : Groups)
+    {
+        TestEqual(TEXT("Groups should be empty after every disconnect"), Server.GetGroupMembers(Group).Num(), 0);
+    }
+
+    for (FENetManager& Client : Clients)
+    {
+        Client.Stop();
+    }
+    Server.Stop();
+    return true;
+}
+
+// 트래픽 종류별로 설정한 채널에 패킷이 기록되고, Ack를 받거나 호스트를 멈추면 대기 패킷과 ENet 할당이 모두 정리되는지 확인
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetTrafficClassTest, "HktENet.TrafficClass", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FHktENetTrafficClassTest::RunTest(const FString& Parameters)
+{
+    using namespace HktENetTests;
+    const uint16 Port = 12377;
+    const EENetTrafficClass Classes[] = { EENetTrafficClass::Default, EENetTrafficClass::Input, EENetTrafficClass::State, EENetTrafficClass::Chat, EENetTrafficClass::Bulk };
+    const int32 NumClasses = UE_ARRAY_COUNT(Classes);
+    const int64 LiveBaseline = HktENetAllocator::GetStats().LiveAllocations;
+
+    {
+        FENetManager Server;
+        FENetManager Client;
+        // 채팅을 기본 채널 밖으로 옮김. 양쪽 설정이 같아야 하며 채널 수는 가장 큰 채널 번호를 따름
+        Server.SetTrafficClass(EENetTrafficClass::Chat, 6, ENET_PACKET_FLAG_RELIABLE);
+        Client.SetTrafficClass(EENetTrafficClass::Chat, 6, ENET_PACKET_FLAG_RELIABLE);
+        TArray<uint8> Received;
+        Server.OnPacketReceived.AddLambda([&Received](ENetPeer*, const TArray<uint8>& Data) { Received.Add(Data[0]); });
+        TArray<ENetPeer*> ServerPeers;
+        if (!StartServerWithClients(Server, MakeArrayView(&Client, 1), Port, ServerPeers))
+        {
+            AddError(TEXT("Failed to connect ENet hosts"));
+            return false;
+        }
+        FENetManager* Managers[] = { &Server, &Client };
+        TestEqual(TEXT("Channel count should follow the highest configured channel"), Client.GetChannelCount(), 7);
+
+        // 1. 종류마다 하나씩 보내면 각자의 채널에만 기록됨
+        for (int32 i = 0; i < NumClasses; ++i)
+        {
+            Client.SendPacketToServer({ (uint8)i }, Classes[i]);
+        }
+        for (int32 i = 0; i < NumClasses; ++i)
+        {
+            const uint8 ChannelID = Client.GetTrafficClassConfig(Classes[i]).ChannelID;
+            TestEqual(FString::Printf(TEXT("Class %d should send on channel %d"), i, ChannelID), Client.GetChannelStats(ChannelID).PacketsSent, (int64)1);
+        }
+        TestEqual(TEXT("Unused channel should stay empty"), Client.GetChannelStats(5).PacketsSent, (int64)0);
+        TestEqual(TEXT("Moved class should leave its default channel"), Client.GetChannelStats(3).PacketsSent, (int64)0);
+
+        // 2. 모두 도착하고 Ack되면 채널마다 대기 패킷이 0이 되고 지연 시간이 기록됨
+        TestTrue(TEXT("Every class should arrive"), TickUntil(Managers, [&]() { return Received.Num() == NumClasses; }));
+        bool bDrained = TickUntil(Managers, [&]()
+        {
+            for (int32 ChannelID = 0; ChannelID < Client.GetChannelCount(); ++ChannelID)
+            {
+                if (Client.GetChannelStats(ChannelID).QueuedPackets != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        });
+        TestTrue(TEXT("Every channel should drain"), bDrained);
+        for (int32 i = 0; i < NumClasses; ++i)
+        {
+            const FENetChannelStats Stats = Client.GetChannelStats(Client.GetTrafficClassConfig(Classes[i]).ChannelID);
+            TestTrue(FString::Printf(TEXT("Class %d should record its latency"), i), Stats.MaxLatency > 0.0 && Stats.AverageLatency <= Stats.MaxLatency);
+        }
+
+        // 3. 서버가 Tick하지 않는 동안 보낸 신뢰 패킷은 Ack를 못 받은 채 남음. Stop이 호스트와 함께 해제
+        for (int32 i = 0; i < 20; ++i)
+        {
+            Client.SendPacketToServer({ 100 }, EENetTrafficClass::Bulk);
+        }
+        FENetManager* OnlyClient[] = { &Client };
+        TickUntil(OnlyClient, []() { return false; }, 0.05);
+        TestTrue(TEXT("Unacknowledged packets should still be queued"), Client.GetChannelStats(4).QueuedPackets > 0);
+        Client.Stop();
+        Server.Stop();
+        TestEqual(TEXT("Stats should be cleared after Stop"), Client.GetChannelStats(4).QueuedPackets, 0);
+    }
+
+    TestEqual(TEXT("Every ENet allocation should be freed after Stop"), HktENetAllocator::GetStats().LiveAllocations, LiveBaseline);
+    return true;
+}
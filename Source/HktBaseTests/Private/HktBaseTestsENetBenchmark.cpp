@@ -0,0 +1,288 @@
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "ENetManager.h"
+#include "HktBehaviorHeader.h"
+#include "HktFlagments.h"
+#include "HktStructSerializer.h"
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+
+namespace HktENetBenchmark
+{
+    // 한 프레임에 모아 보내는 행동 요청들. 이동이 대부분이고 가끔 점프와 공격이 섞임
+    TArray<uint8> MakeBehaviorPacket(FRandomStream& Random, int32 NumRequests)
+    {
+        TArray<uint8> Packet;
+        for (int32 i = 0; i < NumRequests; ++i)
+        {
+            FHktBehaviorRequestHeader Request;
+            Request.SubjectId = 1000 + Random.RandHelper(64);
+            Request.SyncGroupId = 1;
+            const int32 Kind = Random.RandHelper(10);
+            if (Kind < 8)
+            {
+                FMoveFlagment Move;
+                Move.TargetLocation = FVector(Random.FRandRange(0.0f, 40000.0f), Random.FRandRange(0.0f, 40000.0f), 0.0f);
+                Move.Speed = 600.0f;
+                Request.FlagmentTypeId = 1;
+                Request.FlagmentPayload = FHktStructSerializer::SerializeStructToBytes(Move);
+            }
+            else if (Kind < 9)
+            {
+                FJumpFlagment Jump;
+                Jump.JumpHeight = 300.0f;
+                Request.FlagmentTypeId = 2;
+                Request.FlagmentPayload = FHktStructSerializer::SerializeStructToBytes(Jump);
+            }
+            else
+            {
+                FAttackFlagment Attack;
+                Attack.SkillId = Random.RandHelper(8);
+                Attack.TargetActorId = 1000 + Random.RandHelper(64);
+                Request.FlagmentTypeId = 3;
+                Request.FlagmentPayload = FHktStructSerializer::SerializeStructToBytes(Attack);
+            }
+            Packet.Append(FHktStructSerializer::SerializeStructToBytes(Request));
+        }
+        return Packet;
+    }
+}
+
+// 압축 방식별 행동 패킷 압축률, 패킷당 압축/해제 시간, 루프백 연결의 처리량 비교
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetCompressionBenchmark, "HktENet.Benchmark.Compression", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktENetCompressionBenchmark::RunTest(const FString& Parameters)
+{
+    using namespace HktENetBenchmark;
+
+    const int32 NumPackets = 2000;
+    const int32 RequestsPerPacket = 8;
+    const uint16 Port = 12370;
+    // 대역폭이 제한된 링크에서의 처리량 추정에 쓰는 송신 대역폭 (바이트/초)
+    const double LinkBytesPerSecond = 1024.0 * 1024.0 / 8.0;
+
+    FRandomStream Random(1234);
+    TArray<TArray<uint8>> Packets;
+    int64 RawBytes = 0;
+    for (int32 i = 0; i < NumPackets; ++i)
+    {
+        Packets.Add(MakeBehaviorPacket(Random, RequestsPerPacket));
+        RawBytes += Packets.Last().Num();
+    }
+    AddInfo(FString::Printf(TEXT("%d packets, %.0f bytes per packet on average"), NumPackets, (double)RawBytes / NumPackets));
+
+    const EENetCompression Codecs[] = { EENetCompression::None, EENetCompression::RangeCoder, EENetCompression::LZ4, EENetCompression::Oodle };
+    const TCHAR* CodecNames[] = { TEXT("none"), TEXT("range coder"), TEXT("LZ4"), TEXT("Oodle") };
+    double BaselineSeconds = 0.0;
+
+    for (int32 CodecIndex = 0; CodecIndex < UE_ARRAY_COUNT(Codecs); ++CodecIndex)
+    {
+        const EENetCompression Codec = Codecs[CodecIndex];
+
+        // 1. 코덱만 측정: 패킷 하나씩 압축하고 다시 풀어 원본과 비교
+        int64 WireBytes = RawBytes;
+        double CompressNs = 0.0;
+        double DecompressNs = 0.0;
+        if (Codec != EENetCompression::None)
+        {
+            ENetCompressor Compressor;
+            if (!HktENetCompression::CreateCompressor(Codec, Compressor))
+            {
+                AddInfo(FString::Printf(TEXT("[%s] not available in this build"), CodecNames[CodecIndex]));
+                continue;
+            }
+
+            TArray<uint8> Compressed;
+            TArray<uint8> Decompressed;
+            Compressed.SetNumUninitialized(4096);
+            Decompressed.SetNumUninitialized(4096);
+            uint64 CompressCycles = 0;
+            uint64 DecompressCycles = 0;
+            bool bRoundTrip = true;
+            WireBytes = 0;
+            for (const TArray<uint8>& Packet : Packets)
+            {
+                ENetBuffer Buffer;
+                Buffer.data = const_cast<uint8*>(Packet.GetData());
+                Buffer.dataLength = Packet.Num();
+
+                uint64 StartCycles = FPlatformTime::Cycles64();
+                const size_t CompressedSize = Compressor.compress(Compressor.context, &Buffer, 1, Packet.Num(), Compressed.GetData(), Packet.Num());
+                CompressCycles += FPlatformTime::Cycles64() - StartCycles;
+                if (CompressedSize == 0)
+                {
+                    // ENet도 줄어들지 않는 패킷은 그대로 보냄
+                    WireBytes += Packet.Num();
+                    continue;
+                }
+                WireBytes += CompressedSize;
+
+                StartCycles = FPlatformTime::Cycles64();
+                const size_t DecompressedSize = Compressor.decompress(Compressor.context, Compressed.GetData(), CompressedSize, Decompressed.GetData(), Decompressed.Num());
+                DecompressCycles += FPlatformTime::Cycles64() - StartCycles;
+                bRoundTrip &= DecompressedSize == (size_t)Packet.Num() && FMemory::Memcmp(Decompressed.GetData(), Packet.GetData(), Packet.Num()) == 0;
+            }
+            Compressor.destroy(Compressor.context);
+
+            TestTrue(FString::Printf(TEXT("%s should round-trip every packet"), CodecNames[CodecIndex]), bRoundTrip);
+            CompressNs = FPlatformTime::ToMilliseconds64(CompressCycles) * 1e6 / NumPackets;
+            DecompressNs = FPlatformTime::ToMilliseconds64(DecompressCycles) * 1e6 / NumPackets;
+        }
+
+        // 2. 루프백 연결로 모든 패킷을 신뢰 전송하고 다 받을 때까지의 시간과 실제 송신 바이트 측정
+        FENetManager Server;
+        FENetManager Client;
+        Server.SetCompression(Codec);
+        Client.SetCompression(Codec);
+        int32 NumReceived = 0;
+        bool bConnected = false;
+        Server.OnPacketViewReceived.AddLambda([&NumReceived](ENetPeer*, TArrayView<const uint8>) { ++NumReceived; });
+        Client.OnClientConnected.AddLambda([&bConnected](ENetPeer*) { bConnected = true; });
+        if (!Server.StartServer(Port, 4) || !Client.StartClient(TEXT("127.0.0.1"), Port))
+        {
+            AddError(TEXT("Failed to start ENet hosts"));
+            return false;
+        }
+        for (double Deadline = FPlatformTime::Seconds() + 5.0; !bConnected && FPlatformTime::Seconds() < Deadline;)
+        {
+            Server.Tick();
+            Client.Tick();
+        }
+        TestTrue(TEXT("Client should connect"), bConnected);
+
+        const uint32 SentBefore = Client.GetTotalSentBytes();
+        const double StartTime = FPlatformTime::Seconds();
+        const double Deadline = StartTime + 30.0;
+        int32 NumSent = 0;
+        while (NumReceived < NumPackets && FPlatformTime::Seconds() < Deadline)
+        {
+            for (int32 i = 0; i < 100 && NumSent < NumPackets; ++i, ++NumSent)
+            {
+                Client.SendPacketToServer(Packets[NumSent]);
+            }
+            Client.Tick();
+            Server.Tick();
+        }
+        const double Elapsed = FPlatformTime::Seconds() - StartTime;
+        const uint32 SocketBytes = Client.GetTotalSentBytes() - SentBefore;
+        TestEqual(FString::Printf(TEXT("%s should deliver every packet"), CodecNames[CodecIndex]), NumReceived, NumPackets);
+        Client.Stop();
+        Server.Stop();
+
+        if (Codec == EENetCompression::None)
+        {
+            BaselineSeconds = Elapsed;
+        }
+        // 링크 대역폭이 병목이면 보낸 바이트가 줄어든 만큼 처리량이 늘고, 코덱 시간이 병목이 되면 그만큼 제한됨
+        const double LinkSeconds = SocketBytes / LinkBytesPerSecond;
+        const double CodecSeconds = (CompressNs + DecompressNs) * NumPackets * 1e-9;
+        AddInfo(FString::Printf(TEXT("[%s] ratio %.3f, compress %.0f ns/packet, decompress %.0f ns/packet; loopback %.1f ms (%.2fx of uncompressed), %u socket bytes; at 1 Mbps %.0f packets/s"),
+            CodecNames[CodecIndex], (double)WireBytes / RawBytes, CompressNs, DecompressNs,
+            Elapsed * 1000.0, BaselineSeconds > 0.0 ? Elapsed / BaselineSeconds : 1.0, SocketBytes,
+            NumPackets / FMath::Max(LinkSeconds, CodecSeconds)));
+    }
+
+    return true;
+}
+
+// 시스템 malloc과 크기별 풀 할당기의 ENet 할당 비용과 루프백 패킷 처리율 비교
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHktENetAllocatorBenchmark, "HktENet.Benchmark.Allocator", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FHktENetAllocatorBenchmark::RunTest(const FString& Parameters)
+{
+    const int32 NumThreads = 4;
+    const int32 NumAllocsPerThread = 200000;
+    const int32 NumPackets = 20000;
+    const int32 PacketSize = 200;
+    const uint16 Port = 12371;
+
+    const HktENetAllocator::EMode PreviousMode = HktENetAllocator::GetMode();
+    const int64 LiveAllocationsBefore = HktENetAllocator::GetStats().LiveAllocations;
+    const ENetCallbacks& Callbacks = HktENetAllocator::GetCallbacks();
+    const HktENetAllocator::EMode Modes[] = { HktENetAllocator::EMode::System, HktENetAllocator::EMode::Pooled };
+    const TCHAR* ModeNames[] = { TEXT("system malloc"), TEXT("pooled") };
+    double PacketRates[UE_ARRAY_COUNT(Modes)] = {};
+
+    for (int32 ModeIndex = 0; ModeIndex < UE_ARRAY_COUNT(Modes); ++ModeIndex)
+    {
+        HktENetAllocator::SetMode(Modes[ModeIndex]);
+
+        // 1. ENet과 비슷한 크기(패킷 구조체, 명령, 패킷 데이터)를 여러 스레드에서 할당/해제
+        const double AllocStart = FPlatformTime::Seconds();
+        ParallelFor(NumThreads, [&](int32 ThreadIndex)
+        {
+            const size_t Sizes[] = { 48, 96, 200, 1200 };
+            TArray<void*> Live;
+            Live.Reserve(64);
+            for (int32 i = 0; i < NumAllocsPerThread; ++i)
+            {
+                Live.Add(Callbacks.malloc(Sizes[(i + ThreadIndex) % UE_ARRAY_COUNT(Sizes)]));
+                if (Live.Num() == 64)
+                {
+                    for (void* Memory : Live)
+                    {
+                        Callbacks.free(Memory);
+                    }
+                    Live.Reset();
+                }
+            }
+            for (void* Memory : Live)
+            {
+                Callbacks.free(Memory);
+            }
+        });
+        const double AllocNs = (FPlatformTime::Seconds() - AllocStart) * 1e9 / ((double)NumThreads * NumAllocsPerThread);
+
+        // 2. 루프백 연결로 신뢰 패킷을 보내고 받는 처리율과 패킷당 할당 수
+        FENetManager Server;
+        FENetManager Client;
+        int32 NumReceived = 0;
+        bool bConnected = false;
+        Server.OnPacketViewReceived.AddLambda([&NumReceived](ENetPeer*, TArrayView<const uint8>) { ++NumReceived; });
+        Client.OnClientConnected.AddLambda([&bConnected](ENetPeer*) { bConnected = true; });
+        if (!Server.StartServer(Port, 4) || !Client.StartClient(TEXT("127.0.0.1"), Port))
+        {
+            AddError(TEXT("Failed to start ENet hosts"));
+            HktENetAllocator::SetMode(PreviousMode);
+            return false;
+        }
+        for (double Deadline = FPlatformTime::Seconds() + 5.0; !bConnected && FPlatformTime::Seconds() < Deadline;)
+        {
+            Server.Tick();
+            Client.Tick();
+        }
+        TestTrue(TEXT("Client should connect"), bConnected);
+
+        TArray<uint8> Payload;
+        Payload.SetNumZeroed(PacketSize);
+        const FENetAllocatorStats StatsBefore = HktENetAllocator::GetStats();
+        const double StartTime = FPlatformTime::Seconds();
+        const double Deadline = StartTime + 30.0;
+        int32 NumSent = 0;
+        while (NumReceived < NumPackets && FPlatformTime::Seconds() < Deadline)
+        {
+            for (int32 i = 0; i < 100 && NumSent < NumPackets; ++i, ++NumSent)
+            {
+                Client.SendPacketToServer(Payload);
+            }
+            Client.Tick();
+            Server.Tick();
+        }
+        const double Elapsed = FPlatformTime::Seconds() - StartTime;
+        const FENetAllocatorStats StatsAfter = HktENetAllocator::GetStats();
+        TestEqual(FString::Printf(TEXT("%s should deliver every packet"), ModeNames[ModeIndex]), NumReceived, NumPackets);
+        Client.Stop();
+        Server.Stop();
+
+        PacketRates[ModeIndex] = NumReceived / Elapsed;
+        const int64 Allocations = StatsAfter.Allocations - StatsBefore.Allocations;
+        AddInfo(FString::Printf(TEXT("[%s] %.1f ns per alloc/free with %d threads; loopback %.0f packets/s, %.1f allocations and %.0f bytes per packet, %.0f%% from pools"),
+            ModeNames[ModeIndex], AllocNs, NumThreads, PacketRates[ModeIndex],
+            (double)Allocations / NumPackets, (double)(StatsAfter.TotalBytes - StatsBefore.TotalBytes) / NumPackets,
+            Allocations > 0 ? 100.0 * (StatsAfter.PooledAllocations - StatsBefore.PooledAllocations) / Allocations : 0.0));
+    }
+    HktENetAllocator::SetMode(PreviousMode);
+
+    AddInfo(FString::Printf(TEXT("Pooled packet rate is %.2fx of system malloc"), PacketRates[0] > 0.0 ? PacketRates[1] / PacketRates[0] : 0.0));
+    TestEqual(TEXT("Every ENet allocation made by the benchmark should be freed"), HktENetAllocator::GetStats().LiveAllocations, LiveAllocationsBefore);
+
+    return true;
+}
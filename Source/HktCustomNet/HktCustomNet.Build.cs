@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 using UnrealBuildTool;
+using System.IO;
 
 public class HktCustomNet : ModuleRules
 {
@@ -16,6 +17,17 @@ public class HktCustomNet : ModuleRules
                 "Sockets"
             }
         );
+
+        // Linux에서는 UDP GSO/GRO 오프로드를 위해 FSocketBSD의 네이티브 소켓 핸들에 접근
+        if (Target.Platform == UnrealTargetPlatform.Linux)
+        {
+            PrivateIncludePaths.Add(Path.Combine(EngineDirectory, "Source", "Runtime", "Sockets", "Private"));
+            PrivateDefinitions.Add("HKT_WITH_UDP_OFFLOAD=1");
+        }
+        else
+        {
+            PrivateDefinitions.Add("HKT_WITH_UDP_OFFLOAD=0");
+        }
     }
 }
 
@@ -0,0 +1,209 @@
+#include "HktBulkTransfer.h"
+
+void FHktBulkSender::Add(uint32 TransferId, TArray<uint8>&& Data, uint32 StartOffset)
+{
+    check(StartOffset < (uint32)Data.Num());
+
+    FTransfer& Transfer = Transfers.AddDefaulted_GetRef();
+    Transfer.TransferId = TransferId;
+    Transfer.Data = MoveTemp(Data);
+    Transfer.StartOffset = StartOffset;
+    Transfer.AckedOffset = StartOffset;
+    Transfer.NextOffset = StartOffset;
+}
+
+void FHktBulkSender::Refill(double Now, int32 BytesPerSecond, int64 GameplayBytesSent)
+{
+    // 보낼 것이 없는 동안에는 크레딧을 쌓지 않음. 전송이 시작되면 그 시점부터 계산
+    if (!HasTransfers() || LastRefillTime == 0.0)
+    {
+        Credit = 0.0;
+        LastRefillTime = Now;
+        LastGameplayBytesSent = GameplayBytesSent;
+        return;
+    }
+
+    // 게임플레이가 쓴 만큼 빼므로 게임플레이가 대역폭을 다 쓰면 크레딧이 음수가 되어 벌크는 멈춤
+    Credit += (Now - LastRefillTime) * BytesPerSecond - (double)(GameplayBytesSent - LastGameplayBytesSent);
+    Credit = FMath::Clamp(Credit, -(double)BytesPerSecond, BytesPerSecond * MaxBurstTime);
+    LastRefillTime = Now;
+    LastGameplayBytesSent = GameplayBytesSent;
+}
+
+bool FHktBulkSender::NextChunk(double Now, int32 MaxChunkSize, FHktBulkChunkHeader& OutHeader, const uint8*& OutData, int32& OutSize)
+{
+    if (Transfers.Num() == 0 || Credit <= 0.0 || MaxChunkSize <= 0)
+    {
+        return false;
+    }
+
+    FTransfer& Transfer = Transfers[0];
+    const uint32 TotalSize = (uint32)Transfer.Data.Num();
+
+    // Ack가 진전되지 않으면 보낸 것 중 일부가 사라졌다고 보고 창을 줄여 마지막 Ack 지점부터 다시 보냄
+    if (Transfer.NextOffset > Transfer.AckedOffset && Now - LastProgressTime > RetransmitTimeout)
+    {
+        SlowStartThreshold = FMath::Max(Window / 2, MinWindow);
+        Window = SlowStartThreshold;
+        Transfer.NextOffset = Transfer.AckedOffset;
+        LastProgressTime = Now;
+    }
+
+    const int64 InFlight = (int64)Transfer.NextOffset - Transfer.AckedOffset;
+    if (Transfer.NextOffset >= TotalSize || InFlight >= Window)
+    {
+        return false;
+    }
+    if (InFlight == 0)
+    {
+        LastProgressTime = Now;
+    }
+
+    OutSize = (int32)FMath::Min<uint32>((uint32)MaxChunkSize, TotalSize - Transfer.NextOffset);
+    OutData = Transfer.Data.GetData() + Transfer.NextOffset;
+    OutHeader.TransferId = Transfer.TransferId;
+    OutHeader.TotalSize = TotalSize;
+    OutHeader.StartOffset = Transfer.StartOffset;
+    OutHeader.Offset = Transfer.NextOffset;
+
+    Transfer.NextOffset += (uint32)OutSize;
+    Credit -= OutSize + sizeof(FHktBulkChunkHeader);
+    ChunkSize = MaxChunkSize;
+    return true;
+}
+
+void FHktBulkSender::OnAck(const FHktBulkAck& Ack, double Now, TArray<uint32>& OutCompleted)
+{
+    // 진행 중인 전송의 새 Ack만 반영. 이전 전송의 중복 Ack는 무시
+    if (Transfers.Num() == 0 || Transfers[0].TransferId != Ack.TransferId)
+    {
+        return;
+    }
+
+    FTransfer& Transfer = Transfers[0];
+    const uint32 TotalSize = (uint32)Transfer.Data.Num();
+    if (Ack.AckedOffset <= Transfer.AckedOffset || Ack.AckedOffset > TotalSize)
+    {
+        return;
+    }
+
+    const int32 AckedBytes = (int32)(Ack.AckedOffset - Transfer.AckedOffset);
+    Transfer.AckedOffset = Ack.AckedOffset;
+    Transfer.NextOffset = FMath::Max(Transfer.NextOffset, Transfer.AckedOffset);
+    LastProgressTime = Now;
+
+    // 느린 시작 구간에서는 Ack된 만큼, 이후에는 왕복마다 청크 하나만큼 창을 키움
+    if (Window < SlowStartThreshold)
+    {
+        Window += AckedBytes;
+    }
+    else
+    {
+        Window += FMath::Max<int32>(1, (int32)((int64)AckedBytes * ChunkSize / Window));
+    }
+    Window = FMath::Min(Window, MaxWindow);
+
+    if (Transfer.AckedOffset == TotalSize)
+    {
+        OutCompleted.Add(Transfer.TransferId);
+        Transfers.RemoveAt(0);
+    }
+}
+
+void FHktBulkSender::Abort(TArray<uint32>& OutAborted)
+{
+    for (const FTransfer& Transfer : Transfers)
+    {
+        OutAborted.Add(Transfer.TransferId);
+    }
+    Transfers.Reset();
+    Window = InitialWindow;
+    SlowStartThreshold = MaxWindow;
+}
+
+bool FHktBulkSender::GetProgress(uint32 TransferId, uint32& OutAckedBytes, uint32& OutTotalBytes) const
+{
+    for (const FTransfer& Transfer : Transfers)
+    {
+        if (Transfer.TransferId == TransferId)
+        {
+            OutAckedBytes = Transfer.AckedOffset;
+            OutTotalBytes = (uint32)Transfer.Data.Num();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FHktBulkReceiver::OnChunk(const FHktBulkChunkHeader& Header, const uint8* Data, int32 Size, FHktBulkAck& OutAck, bool& bOutCompleted, TArray<uint8>& OutData)
+{
+    OutAck.TransferId = Header.TransferId;
+    bOutCompleted = false;
+
+    // 완료 Ack가 사라져 송신 측이 다시 보낸 청크. 완료를 다시 알림
+    for (const TPair<uint32, uint32>& Done : Completed)
+    {
+        if (Done.Key == Header.TransferId)
+        {
+            OutAck.AckedOffset = Done.Value;
+            return true;
+        }
+    }
+
+    if (Size <= 0 || Header.TotalSize > MaxTransferSize || Header.Offset < Header.StartOffset
+        || (uint64)Header.Offset + (uint64)Size > (uint64)Header.TotalSize)
+    {
+        return false;
+    }
+
+    FIncoming* Transfer = Incoming.Find(Header.TransferId);
+    if (!Transfer)
+    {
+        if (Incoming.Num() >= MaxIncomingTransfers)
+        {
+            return false;
+        }
+        Transfer = &Incoming.Add(Header.TransferId);
+        Transfer->TotalSize = Header.TotalSize;
+        Transfer->StartOffset = Header.StartOffset;
+        Transfer->ReceivedOffset = Header.StartOffset;
+        Transfer->Data.Reserve(Header.TotalSize - Header.StartOffset);
+    }
+    else if (Transfer->TotalSize != Header.TotalSize || Transfer->StartOffset != Header.StartOffset)
+    {
+        return false;
+    }
+
+    // 순서대로 도착한 청크만 이어 붙임
+    if (Header.Offset == Transfer->ReceivedOffset)
+    {
+        Transfer->Data.Append(Data, Size);
+        Transfer->ReceivedOffset += (uint32)Size;
+    }
+    OutAck.AckedOffset = Transfer->ReceivedOffset;
+
+    if (Transfer->ReceivedOffset == Transfer->TotalSize)
+    {
+        OutData = MoveTemp(Transfer->Data);
+        bOutCompleted = true;
+        if (Completed.Num() >= MaxCompletedHistory)
+        {
+            Completed.RemoveAt(0);
+        }
+        Completed.Emplace(Header.TransferId, Header.TotalSize);
+        Incoming.Remove(Header.TransferId);
+    }
+    return true;
+}
+
+uint32 FHktBulkReceiver::GetReceivedOffset(uint32 TransferId) const
+{
+    const FIncoming* Transfer = Incoming.Find(TransferId);
+    return Transfer ? Transfer->ReceivedOffset : 0;
+}
+
+void FHktBulkReceiver::Reset()
+{
+    Incoming.Reset();
+    Completed.Reset();
+}
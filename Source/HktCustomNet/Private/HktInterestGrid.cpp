@@ -0,0 +1,120 @@
+#include "HktInterestGrid.h"
+
+FHktInterestGrid::FHktInterestGrid(float InCellSize, float InHysteresis)
+    : CellSize(FMath::Max(InCellSize, 1.0f))
+    , Hysteresis(FMath::Clamp(InHysteresis, 0.0f, InCellSize * 0.5f))
+{
+}
+
+void FHktInterestGrid::Update(uint64 Id, const FVector& Location)
+{
+    FEntry* Entry = Entries.Find(Id);
+    if (Entry == nullptr)
+    {
+        FEntry& NewEntry = Entries.Add(Id);
+        NewEntry.Location = Location;
+        NewEntry.Cell = ToCell(Location);
+        AddToCell(Id, NewEntry);
+        return;
+    }
+
+    Entry->Location = Location;
+
+    // 현재 셀을 Hysteresis만큼 넓힌 영역 안이면 셀을 유지
+    const float MinX = Entry->Cell.X * CellSize - Hysteresis;
+    const float MinY = Entry->Cell.Y * CellSize - Hysteresis;
+    const float MaxX = (Entry->Cell.X + 1) * CellSize + Hysteresis;
+    const float MaxY = (Entry->Cell.Y + 1) * CellSize + Hysteresis;
+    if (Location.X >= MinX && Location.X < MaxX && Location.Y >= MinY && Location.Y < MaxY)
+    {
+        return;
+    }
+
+    RemoveFromCell(*Entry);
+    Entry->Cell = ToCell(Location);
+    AddToCell(Id, *Entry);
+    ++NumCellChanges;
+}
+
+void FHktInterestGrid::Remove(uint64 Id)
+{
+    FEntry Entry;
+    if (Entries.RemoveAndCopyValue(Id, Entry))
+    {
+        RemoveFromCell(Entry);
+    }
+}
+
+void FHktInterestGrid::Reset()
+{
+    Entries.Reset();
+    Cells.Reset();
+    NumCellChanges = 0;
+}
+
+void FHktInterestGrid::QueryRadius(const FVector& Center, float Radius, TArray<uint64>& OutIds) const
+{
+    // 개체는 자기 셀에서 최대 Hysteresis만큼 벗어나 있을 수 있으므로 그만큼 더 넓게 검색
+    const float Reach = Radius + Hysteresis;
+    const FIntPoint MinCell = ToCell(FVector(Center.X - Reach, Center.Y - Reach, 0.0f));
+    const FIntPoint MaxCell = ToCell(FVector(Center.X + Reach, Center.Y + Reach, 0.0f));
+    const float RadiusSquared = Radius * Radius;
+
+    for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+    {
+        for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+        {
+            const TArray<uint64>* CellIds = Cells.Find(FIntPoint(CellX, CellY));
+            if (CellIds == nullptr)
+            {
+                continue;
+            }
+
+            for (uint64 Id : *CellIds)
+            {
+                const FEntry& Entry = Entries.FindChecked(Id);
+                if (FVector::DistSquared(Entry.Location, Center) <= RadiusSquared)
+                {
+                    OutIds.Add(Id);
+                }
+            }
+        }
+    }
+}
+
+const FVector* FHktInterestGrid::FindLocation(uint64 Id) const
+{
+    const FEntry* Entry = Entries.Find(Id);
+    return Entry ? &Entry->Location : nullptr;
+}
+
+FIntPoint FHktInterestGrid::ToCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FHktInterestGrid::AddToCell(uint64 Id, FEntry& Entry)
+{
+    TArray<uint64>& CellIds = Cells.FindOrAdd(Entry.Cell);
+    Entry.IndexInCell = CellIds.Add(Id);
+}
+
+void FHktInterestGrid::RemoveFromCell(const FEntry& Entry)
+{
+    TArray<uint64>* CellIds = Cells.Find(Entry.Cell);
+    if (CellIds == nullptr || !CellIds->IsValidIndex(Entry.IndexInCell))
+    {
+        return;
+    }
+
+    // 마지막 원소를 빈자리로 옮기고, 옮겨진 개체의 인덱스를 갱신
+    CellIds->RemoveAtSwap(Entry.IndexInCell);
+    if (CellIds->IsValidIndex(Entry.IndexInCell))
+    {
+        Entries.FindChecked((*CellIds)[Entry.IndexInCell]).IndexInCell = Entry.IndexInCell;
+    }
+    else if (CellIds->Num() == 0)
+    {
+        Cells.Remove(Entry.Cell);
+    }
+}
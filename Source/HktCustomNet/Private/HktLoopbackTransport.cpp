@@ -0,0 +1,161 @@
+#include "HktLoopbackTransport.h"
+#include "HktPacketWriter.h"
+#include "HktNetClock.h"
+#include "SocketSubsystem.h"
+#include "Misc/ScopeRWLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHktLoopback, Log, All);
+
+namespace HktLoopback
+{
+    // 포트 -> 엔드포인트. 송신은 읽기 잠금만 잡으므로 엔드포인트 등록/해제 때만 경쟁함
+    struct FRegistry
+    {
+        FRWLock Lock;
+        TMap<uint16, FHktLoopbackEndpoint*> Endpoints;
+        // 포트별 수신 링크 대역폭. 엔드포인트를 다시 바인딩해도 적용되도록 따로 둠
+        TMap<uint16, int32> LinkBandwidths;
+        // 수신 링크가 끊긴 포트
+        TSet<uint16> DownLinks;
+    };
+
+    static FRegistry& GetRegistry()
+    {
+        static FRegistry Registry;
+        return Registry;
+    }
+}
+
+TUniquePtr<FHktLoopbackEndpoint> FHktLoopbackEndpoint::Bind(uint16 Port)
+{
+    TSharedRef<FInternetAddr> Address = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+    Address->SetLoopbackAddress();
+    Address->SetPort(Port);
+
+    HktLoopback::FRegistry& Registry = HktLoopback::GetRegistry();
+    FWriteScopeLock Lock(Registry.Lock);
+    if (Registry.Endpoints.Contains(Port))
+    {
+        UE_LOG(LogHktLoopback, Error, TEXT("Loopback port %d is already in use."), Port);
+        return nullptr;
+    }
+
+    TUniquePtr<FHktLoopbackEndpoint> Endpoint(new FHktLoopbackEndpoint(Port, Address));
+    Endpoint->LinkBandwidth = Registry.LinkBandwidths.FindRef(Port);
+    Endpoint->bLinkDown = Registry.DownLinks.Contains(Port);
+    Registry.Endpoints.Add(Port, Endpoint.Get());
+    return Endpoint;
+}
+
+FHktLoopbackEndpoint::FHktLoopbackEndpoint(uint16 InPort, TSharedRef<FInternetAddr> InAddress)
+    : Port(InPort)
+    , Address(MoveTemp(InAddress))
+{
+}
+
+FHktLoopbackEndpoint::~FHktLoopbackEndpoint()
+{
+    {
+        // 등록을 해제한 뒤에는 어떤 송신자도 이 엔드포인트의 큐에 접근하지 않음
+        HktLoopback::FRegistry& Registry = HktLoopback::GetRegistry();
+        FWriteScopeLock Lock(Registry.Lock);
+        Registry.Endpoints.Remove(Port);
+    }
+
+    FHktLoopbackDatagram Datagram;
+    while (Inbox.Dequeue(Datagram))
+    {
+        HktPacketPool::Release(MoveTemp(Datagram.Data));
+    }
+}
+
+bool FHktLoopbackEndpoint::SendTo(const uint8* Data, int32 Size, const FInternetAddr& Destination)
+{
+    FHktLoopbackDatagram Datagram;
+    Datagram.Data = HktPacketPool::Acquire(Size);
+    Datagram.Data.Append(Data, Size);
+    Datagram.Source = Address;
+
+    HktLoopback::FRegistry& Registry = HktLoopback::GetRegistry();
+    FReadScopeLock Lock(Registry.Lock);
+    FHktLoopbackEndpoint* const* Target = Registry.Endpoints.Find((uint16)Destination.GetPort());
+    if (!Target)
+    {
+        HktPacketPool::Release(MoveTemp(Datagram.Data));
+        return false;
+    }
+
+    FHktLoopbackEndpoint& Receiver = **Target;
+    if (Receiver.bLinkDown.load(std::memory_order_relaxed))
+    {
+        // 보내는 쪽은 손실을 알 수 없으므로 보낸 것으로 셈
+        HktPacketPool::Release(MoveTemp(Datagram.Data));
+        NumSent.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    const int32 Bandwidth = Receiver.LinkBandwidth.load(std::memory_order_relaxed);
+    if (Bandwidth > 0)
+    {
+        // 앞서 보낸 데이터그램이 링크를 다 지나간 뒤에 이어서 전송. 큐에 넣는 순서도 잠금 안에서 정해 도착 시각 순서를 지킴
+        FScopeLock LinkLock(&Receiver.LinkMutex);
+        Receiver.LinkFreeTime = FMath::Max(Receiver.LinkFreeTime, HktNetClock::Seconds()) + (double)Size / Bandwidth;
+        Datagram.DeliverTime = Receiver.LinkFreeTime;
+        Receiver.Inbox.Enqueue(MoveTemp(Datagram));
+    }
+    else
+    {
+        Receiver.Inbox.Enqueue(MoveTemp(Datagram));
+    }
+    NumSent.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FHktLoopbackEndpoint::Receive(FHktLoopbackDatagram& OutDatagram)
+{
+    // 링크를 아직 다 지나지 않은 데이터그램은 다음 호출까지 큐에 남겨 둠
+    const FHktLoopbackDatagram* Next = Inbox.Peek();
+    if (!Next || (Next->DeliverTime > 0.0 && Next->DeliverTime > HktNetClock::Seconds()))
+    {
+        return false;
+    }
+    Inbox.Dequeue(OutDatagram);
+    ++NumReceived;
+    return true;
+}
+
+void FHktLoopbackEndpoint::SetLinkBandwidth(uint16 Port, int32 BytesPerSecond)
+{
+    HktLoopback::FRegistry& Registry = HktLoopback::GetRegistry();
+    FWriteScopeLock Lock(Registry.Lock);
+    BytesPerSecond = FMath::Max(BytesPerSecond, 0);
+    if (BytesPerSecond > 0)
+    {
+        Registry.LinkBandwidths.Add(Port, BytesPerSecond);
+    }
+    else
+    {
+        Registry.LinkBandwidths.Remove(Port);
+    }
+    if (FHktLoopbackEndpoint* const* Endpoint = Registry.Endpoints.Find(Port))
+    {
+        (*Endpoint)->LinkBandwidth = BytesPerSecond;
+    }
+}
+
+void FHktLoopbackEndpoint::SetLinkDown(uint16 Port, bool bDown)
+{
+    HktLoopback::FRegistry& Registry = HktLoopback::GetRegistry();
+    FWriteScopeLock Lock(Registry.Lock);
+    if (bDown)
+    {
+        Registry.DownLinks.Add(Port);
+    }
+    else
+    {
+        Registry.DownLinks.Remove(Port);
+    }
+    if (FHktLoopbackEndpoint* const* Endpoint = Registry.Endpoints.Find(Port))
+    {
+        (*Endpoint)->bLinkDown = bDown;
+    }
+}
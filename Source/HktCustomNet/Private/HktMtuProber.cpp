@@ -0,0 +1,72 @@
+#include "HktMtuProber.h"
+
+void FHktMtuProber::Start(double Now)
+{
+    bSearching = true;
+    FailedMtu = MaxMtu + 1;
+    ProbeSize = 0;
+    ProbeAttempts = 0;
+    SearchDoneTime = Now;
+}
+
+int32 FHktMtuProber::Tick(double Now)
+{
+    if (!bSearching)
+    {
+        // 경로가 바뀌어 더 큰 MTU가 가능해졌을 수 있으므로 주기적으로 다시 탐색
+        if (SearchDoneTime > 0.0 && ConfirmedMtu < MaxMtu && Now - SearchDoneTime > RaiseInterval)
+        {
+            Start(Now);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    if (ProbeSize != 0)
+    {
+        if (Now - ProbeSentTime < ProbeTimeout)
+        {
+            return 0;
+        }
+
+        if (ProbeAttempts < MaxProbeAttempts)
+        {
+            // 일반 손실일 수 있으므로 같은 크기로 다시 탐침
+            ++ProbeAttempts;
+            ProbeSentTime = Now;
+            return ProbeSize;
+        }
+
+        // 여러 번 사라졌다면 이 크기는 경로를 통과하지 못함
+        FailedMtu = ProbeSize;
+        ProbeSize = 0;
+    }
+
+    if (FailedMtu - ConfirmedMtu <= SearchGranularity)
+    {
+        bSearching = false;
+        SearchDoneTime = Now;
+        return 0;
+    }
+
+    // 대부분의 경로는 이더넷 MTU를 그대로 통과하므로 최대 크기부터 확인하고,
+    // 실패했다면 확인된 크기와 실패한 크기 사이의 중간값을 탐침
+    ProbeSize = FailedMtu > MaxMtu ? MaxMtu : ConfirmedMtu + (FailedMtu - ConfirmedMtu) / 2;
+    ProbeAttempts = 1;
+    ProbeSentTime = Now;
+    return ProbeSize;
+}
+
+void FHktMtuProber::OnProbeAcked(int32 Size)
+{
+    if (Size > ConfirmedMtu && Size <= MaxMtu)
+    {
+        ConfirmedMtu = Size;
+    }
+    if (Size == ProbeSize)
+    {
+        ProbeSize = 0;
+    }
+}
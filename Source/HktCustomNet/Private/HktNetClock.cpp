@@ -0,0 +1,42 @@
+#include "HktNetClock.h"
+#include "HAL/PlatformTime.h"
+#include <atomic>
+
+namespace HktNetClock
+{
+    static std::atomic<bool> bVirtualTime{ false };
+    static std::atomic<double> VirtualSeconds{ 0.0 };
+
+    double Seconds()
+    {
+        return bVirtualTime.load(std::memory_order_acquire) ? VirtualSeconds.load(std::memory_order_relaxed) : FPlatformTime::Seconds();
+    }
+
+    void EnableVirtualTime()
+    {
+        VirtualSeconds.store(FPlatformTime::Seconds(), std::memory_order_relaxed);
+        bVirtualTime.store(true, std::memory_order_release);
+    }
+
+    void DisableVirtualTime()
+    {
+        bVirtualTime.store(false, std::memory_order_release);
+    }
+
+    bool IsVirtualTime()
+    {
+        return bVirtualTime.load(std::memory_order_acquire);
+    }
+
+    void Advance(double DeltaSeconds)
+    {
+        if (bVirtualTime.load(std::memory_order_acquire))
+        {
+            // 여러 스레드에서 진행시켜도 누락이 없도록 CAS로 더함
+            double Current = VirtualSeconds.load(std::memory_order_relaxed);
+            while (!VirtualSeconds.compare_exchange_weak(Current, Current + DeltaSeconds, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+}
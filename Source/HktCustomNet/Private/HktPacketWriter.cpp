@@ -0,0 +1,108 @@
+#include "HktPacketWriter.h"
+#include "Misc/ScopeLock.h"
+
+namespace HktPacketPool
+{
+    // 풀에 보관할 최대 버퍼 수와 버퍼 하나의 최대 용량
+    constexpr int32 MaxPooledBuffers = 1024;
+    constexpr int32 MaxPooledCapacity = 64 * 1024;
+
+    struct FPool
+    {
+        FCriticalSection Mutex;
+        TArray<TArray<uint8>> FreeBuffers;
+    };
+
+    static FPool& GetPool()
+    {
+        static FPool Pool;
+        return Pool;
+    }
+
+    TArray<uint8> Acquire(int32 MinCapacity)
+    {
+        TArray<uint8> Buffer;
+        {
+            FPool& Pool = GetPool();
+            FScopeLock Lock(&Pool.Mutex);
+            if (Pool.FreeBuffers.Num() > 0)
+            {
+                Buffer = Pool.FreeBuffers.Pop();
+            }
+        }
+        Buffer.Reserve(MinCapacity);
+        return Buffer;
+    }
+
+    void Release(TArray<uint8>&& Buffer)
+    {
+        if (Buffer.Max() == 0 || Buffer.Max() > MaxPooledCapacity)
+        {
+            return;
+        }
+
+        Buffer.Reset();
+        FPool& Pool = GetPool();
+        FScopeLock Lock(&Pool.Mutex);
+        if (Pool.FreeBuffers.Num() < MaxPooledBuffers)
+        {
+            Pool.FreeBuffers.Add(MoveTemp(Buffer));
+        }
+    }
+}
+
+FHktPacketWriter::FHktPacketWriter(int32 ExpectedPayloadSize)
+{
+    SetIsSaving(true);
+    SetIsPersistent(true);
+    EnsureBuffer(ExpectedPayloadSize);
+}
+
+FHktPacketWriter::~FHktPacketWriter()
+{
+    // 보내지 않고 버려진 버퍼도 풀로 돌려줌
+    HktPacketPool::Release(MoveTemp(Buffer));
+}
+
+void FHktPacketWriter::Serialize(void* Data, int64 Num)
+{
+    if (Num <= 0)
+    {
+        return;
+    }
+
+    EnsureBuffer((int32)Num);
+
+    const int64 End = HeaderSize + Offset + Num;
+    if (End > Buffer.Num())
+    {
+        Buffer.AddUninitialized((int32)(End - Buffer.Num()));
+    }
+    FMemory::Memcpy(Buffer.GetData() + HeaderSize + Offset, Data, Num);
+    Offset += Num;
+}
+
+void FHktPacketWriter::Seek(int64 InPos)
+{
+    // 태그 직렬화는 크기 자리를 나중에 채우기 위해 되돌아가므로 페이로드 범위 안의 이동을 지원
+    Offset = FMath::Clamp<int64>(InPos, 0, GetPayloadSize());
+}
+
+TArray<uint8> FHktPacketWriter::TakeBuffer()
+{
+    EnsureBuffer(0);
+    Offset = 0;
+    return MoveTemp(Buffer);
+}
+
+void FHktPacketWriter::EnsureBuffer(int32 ExpectedPayloadSize)
+{
+    if (Buffer.Num() >= HeaderSize)
+    {
+        return;
+    }
+
+    // 헤더 자리는 전송 직전에 채우므로 초기화하지 않음
+    Buffer = HktPacketPool::Acquire(HeaderSize + ExpectedPayloadSize);
+    Buffer.AddUninitialized(HeaderSize);
+}
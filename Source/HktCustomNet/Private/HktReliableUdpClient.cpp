@@ -1,4 +1,6 @@
 #include "HktReliableUdpClient.h"
+#include "HktUdpPlatform.h"
+#include "HktNetClock.h"
 #include "Common/UdpSocketBuilder.h"
 #include "SocketSubsystem.h"
 #include "HAL/RunnableThread.h"
@@ -33,24 +35,22 @@ bool FHktReliableUdpClient::Connect(const FString& ServerIp, uint16 ServerPort,
         return false;
     }
 
-    // 2. UDP  
-    ClientSocket = FUdpSocketBuilder(TEXT("UdpClientSocket"))
-        .AsNonBlocking()
-        .BoundToPort(ClientPort);
-
-    if (ClientSocket)
+    // 2. (Ǵ  Ʈ)   
+    if (!OpenTransport(ClientPort))
     {
-        // 3.   
-        ReceiverThread = FRunnableThread::Create(this, TEXT("UdpClientReceiverThread"));
-
-        // 4.   û Ŷ  (Handshake )
-        SendPacket(TArray<uint8>(), EPacketType::Connect);
-        UE_LOG(LogHktCustomNetClient, Log, TEXT("Socket created. Sent [Connect] request to %s:%d"), *ServerIp, ServerPort);
-        return true;
+        return false;
     }
 
-    UE_LOG(LogHktCustomNetClient, Error, TEXT("Failed to create client socket."));
-    return false;
+    // 3.   û Ŷ  (Handshake )
+    HandshakeCookie.Reset();
+    HeaderVersion = HktPacketHeader::Version1;
+    bHasSessionToken = false;
+    bResuming = false;
+    ResumeCookie.Reset();
+    BulkReceiver.Reset();
+    SendHandshake();
+    UE_LOG(LogHktCustomNetClient, Log, TEXT("%s ready. Sent [Connect] request to %s:%d"), LoopbackEndpoint ? TEXT("Loopback endpoint") : TEXT("Socket"), *ServerIp, ServerPort);
+    return true;
 }
 
 void FHktReliableUdpClient::Disconnect()
@@ -63,6 +63,82 @@ void FHktReliableUdpClient::Disconnect()
     }
 
     //   
+    CloseTransport();
+
+    if (bIsConnected)
+    {
+        UE_LOG(LogHktCustomNetClient, Log, TEXT("Client disconnected."));
+    }
+    bIsConnected = false;
+    bHasSessionToken = false;
+}
+
+bool FHktReliableUdpClient::Rebind(uint16 NewClientPort)
+{
+    if (!bIsConnected || !bHasSessionToken)
+    {
+        UE_LOG(LogHktCustomNetClient, Warning, TEXT("Cannot rebind. No resumable session."));
+        return false;
+    }
+
+    //  ´ ״ ΰ ϸ ٲ ,  ּҿ ٷ  簳 û
+    CloseTransport();
+    if (!OpenTransport(NewClientPort))
+    {
+        bIsConnected = false;
+        return false;
+    }
+
+    //  ּҷ ߱޹ Ű  ּҿ   
+    ResumeCookie.Reset();
+    bResuming = true;
+    SendResume();
+    UE_LOG(LogHktCustomNetClient, Log, TEXT("Rebound to local port %d. Sent [Resume]."), NewClientPort);
+    return true;
+}
+
+bool FHktReliableUdpClient::OpenTransport(uint16 ClientPort)
+{
+    if (Transport == EHktNetTransport::Loopback)
+    {
+        //  μ   ޸ ť . ε MTU Ž ǹ̰   嵵 
+        LoopbackEndpoint = FHktLoopbackEndpoint::Bind(ClientPort);
+        if (!LoopbackEndpoint)
+        {
+            UE_LOG(LogHktCustomNetClient, Error, TEXT("Failed to bind loopback port %d."), ClientPort);
+            return false;
+        }
+        bSendOffloadActive = false;
+        bReceiveOffloadActive = false;
+        bMtuDiscoveryActive = false;
+        return true;
+    }
+
+    // UDP  
+    ClientSocket = FUdpSocketBuilder(TEXT("UdpClientSocket"))
+        .AsNonBlocking()
+        .BoundToPort(ClientPort);
+
+    if (!ClientSocket)
+    {
+        UE_LOG(LogHktCustomNetClient, Error, TEXT("Failed to create client socket."));
+        return false;
+    }
+
+    // Ŀ ϸ GSO/GRO , ƴϸ Ϲ η ü
+    bSendOffloadActive = bUdpOffloadEnabled && HktUdpPlatform::EnableSendOffload(ClientSocket);
+    bReceiveOffloadActive = bUdpOffloadEnabled && HktUdpPlatform::EnableReceiveOffload(ClientSocket);
+    // DF    ū Žħ  ϹǷ Ž ʰ  MTU 
+    bMtuDiscoveryActive = bMtuDiscoveryEnabled && HktUdpPlatform::EnableDontFragment(ClientSocket);
+
+    //   
+    bIsStopping = false;
+    ReceiverThread = FRunnableThread::Create(this, TEXT("UdpClientReceiverThread"));
+    return true;
+}
+
+void FHktReliableUdpClient::CloseTransport()
+{
     bIsStopping = true;
     if (ReceiverThread)
     {
@@ -77,22 +153,75 @@ void FHktReliableUdpClient::Disconnect()
         ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientSocket);
         ClientSocket = nullptr;
     }
+    LoopbackEndpoint.Reset();
+}
 
-    if (bIsConnected)
+void FHktReliableUdpClient::Send(const TArray<uint8>& Data, uint64 CollapseKey)
+{
+    if (!bIsConnected)
     {
-        UE_LOG(LogHktCustomNetClient, Log, TEXT("Client disconnected."));
+        UE_LOG(LogHktCustomNetClient, Warning, TEXT("Cannot send data. Not connected to server."));
+        return;
     }
-    bIsConnected = false;
+    SendPacket(Data, EPacketType::Data, 0, CollapseKey);
 }
 
-void FHktReliableUdpClient::Send(const TArray<uint8>& Data)
+void FHktReliableUdpClient::Send(FHktPacketWriter& Writer, uint64 CollapseKey)
 {
     if (!bIsConnected)
     {
         UE_LOG(LogHktCustomNetClient, Warning, TEXT("Cannot send data. Not connected to server."));
         return;
     }
-    SendPacket(Data, EPacketType::Data);
+    SendPreparedPacket(Writer.TakeBuffer(), EPacketType::Data, 0, CollapseKey);
+}
+
+void FHktReliableUdpClient::SendBurst(const TArray<TArray<uint8>>& DataArray)
+{
+    if (!bIsConnected)
+    {
+        UE_LOG(LogHktCustomNetClient, Warning, TEXT("Cannot send data. Not connected to server."));
+        return;
+    }
+    if (!CanSend() || DataArray.Num() == 0) return;
+
+    TArray<TArray<uint8>> Packets;
+    TArray<uint32> Sequences;
+    Packets.Reserve(DataArray.Num());
+    Sequences.Reserve(DataArray.Num());
+    for (const TArray<uint8>& Data : DataArray)
+    {
+        if (!FitsPathMtu(HktPacketHeader::MaxSize + Data.Num()))
+        {
+            continue;
+        }
+        FPacketHeader Header;
+        Packets.Add(BuildPacket(Data, EPacketType::Data, Header));
+        Sequences.Add(Header.Sequence);
+    }
+
+    //  ũ Ŷ GSO    ý ݷ .  ý  Ƿ ϳ ť 
+    int32 NumSendCalls = 0;
+    if (LoopbackEndpoint)
+    {
+        for (const TArray<uint8>& Packet : Packets)
+        {
+            LoopbackEndpoint->SendTo(Packet.GetData(), Packet.Num(), *ServerAddr);
+        }
+    }
+    else
+    {
+        NumSendCalls = HktUdpPlatform::SendBatch(ClientSocket, Packets, *ServerAddr, bSendOffloadActive);
+    }
+    UE_LOG(LogHktCustomNetClient, Verbose, TEXT("=> Sent burst of %d [Data] packets with %d send calls."), Packets.Num(), NumSendCalls);
+
+    FScopeLock Lock(&StateMutex);
+    //    Ŷ  
+    const double CurrentTime = HktNetClock::Seconds();
+    for (int32 i = 0; i < Packets.Num(); ++i)
+    {
+        PendingAckPackets.Add(Sequences[i], FPendingPacket(MoveTemp(Packets[i]), CurrentTime));
+    }
 }
 
 void FHktReliableUdpClient::JoinGroup(int32 GroupId)
@@ -127,54 +256,291 @@ void FHktReliableUdpClient::LeaveGroup()
 }
 
 
-void FHktReliableUdpClient::SendPacket(const TArray<uint8>& Data, EPacketType Type)
+void FHktReliableUdpClient::SendPacket(const TArray<uint8>& Data, EPacketType Type, int32 PadToSize, uint64 CollapseKey)
 {
-    if (!ClientSocket || !ServerAddr.IsValid()) return;
+    //  ڸ   Ǯ ۿ ̷ε带   
+    TArray<uint8> PacketData = HktPacketPool::Acquire(HktPacketHeader::MaxSize + FMath::Max(Data.Num(), PadToSize));
+    PacketData.AddUninitialized(HktPacketHeader::MaxSize);
+    PacketData.Append(Data);
+    SendPreparedPacket(MoveTemp(PacketData), Type, PadToSize, CollapseKey);
+}
+
+void FHktReliableUdpClient::SendPreparedPacket(TArray<uint8>&& PacketData, EPacketType Type, int32 PadToSize, uint64 CollapseKey)
+{
+    if (!CanSend()) return;
+
+    check(PacketData.Num() >= HktPacketHeader::MaxSize);
+    //  ִ ũ .    źϿ     ʰ 
+    if (Type == EPacketType::Data && !FitsPathMtu(PacketData.Num()))
+    {
+        HktPacketPool::Release(MoveTemp(PacketData));
+        return;
+    }
 
     FPacketHeader Header;
-    Header.Type = Type;
+    const int32 HeaderOffset = WritePacketHeader(PacketData.GetData(), Type, Header);
+    if (PadToSize > PacketData.Num() - HeaderOffset)
+    {
+        PacketData.AddZeroed(PadToSize - (PacketData.Num() - HeaderOffset));
+    }
+
+    SendDatagram(PacketData.GetData() + HeaderOffset, PacketData.Num() - HeaderOffset);
 
+    // α :    Ŷ   
+    if (Type == EPacketType::Data)
     {
+        UE_LOG(LogHktCustomNetClient, Verbose, TEXT("=> Sent [Data]. Seq: %u, Ack: %u, AckBits: %u"), Header.Sequence, Header.LastAckedSequence, Header.AckBitfield);
         FScopeLock Lock(&StateMutex);
-        // 'Data' Ÿ Ŷ 쿡 ο  ȣ ο
-        if (Type == EPacketType::Data)
+        //    Ŷ  .  ü Ű  Ŷ  ̻  
+        FPendingPacket PendingPacket(MoveTemp(PacketData), HktNetClock::Seconds(), HeaderOffset);
+        PendingPacket.CollapseKey = CollapseKey;
+        if (HktPendingPackets::Add(PendingAckPackets, PendingCollapseKeys, Header.Sequence, MoveTemp(PendingPacket)))
         {
-            SentSequence++;
-            Header.Sequence = SentSequence;
+            NumSupersededPackets.fetch_add(1, std::memory_order_relaxed);
         }
-        //  κ   Ŷ     (Piggybacking Ack)
-        Header.LastAckedSequence = ReceivedSequence;
-        Header.AckBitfield = ReceivedAckBitfield;
     }
+    else
+    {
+        HktPacketPool::Release(MoveTemp(PacketData));
+    }
+}
+
 
-    TArray<uint8> PacketData;
-    PacketData.Append((uint8*)&Header, sizeof(FPacketHeader));
+TArray<uint8> FHktReliableUdpClient::BuildPacket(const TArray<uint8>& Data, EPacketType Type, FPacketHeader& OutHeader)
+{
+    // GSO    ֵ   տ ΰ ̷ε带 ̾ 
+    uint8 HeaderSpace[HktPacketHeader::MaxSize];
+    const int32 HeaderOffset = WritePacketHeader(HeaderSpace, Type, OutHeader);
+
+    TArray<uint8> PacketData = HktPacketPool::Acquire(HktPacketHeader::MaxSize + Data.Num());
+    PacketData.Append(HeaderSpace + HeaderOffset, HktPacketHeader::MaxSize - HeaderOffset);
     PacketData.Append(Data);
+    return PacketData;
+}
 
-    int32 BytesSent = 0;
-    ClientSocket->SendTo(PacketData.GetData(), PacketData.Num(), BytesSent, *ServerAddr);
+int32 FHktReliableUdpClient::WritePacketHeader(uint8* HeaderSpace, EPacketType Type, FPacketHeader& OutHeader)
+{
+    OutHeader.Type = Type;
 
-    // α :    Ŷ   
+    FScopeLock Lock(&StateMutex);
+    // 'Data' Ÿ Ŷ 쿡 ο  ȣ ο
     if (Type == EPacketType::Data)
     {
-        UE_LOG(LogHktCustomNetClient, Verbose, TEXT("=> Sent [Data]. Seq: %u, Ack: %u, AckBits: %u"), Header.Sequence, Header.LastAckedSequence, Header.AckBitfield);
-        FScopeLock Lock(&StateMutex);
-        //    Ŷ  
-        PendingAckPackets.Add(Header.Sequence, FPendingPacket(MoveTemp(PacketData), FPlatformTime::Seconds()));
+        SentSequence++;
+        OutHeader.Sequence = SentSequence;
     }
+    //  κ   Ŷ     (Piggybacking Ack)
+    OutHeader.LastAckedSequence = ReceivedSequence;
+    OutHeader.AckBitfield = ReceivedAckBitfield;
+
+    // Resume     ã  ¿ ؼϹǷ   ʿ  v1  
+    const uint8 Version = Type == EPacketType::Resume ? HktPacketHeader::Version1 : HeaderVersion;
+    return HktPacketHeader::EncodeInPlace(OutHeader, Version, HeaderSpace);
 }
 
+bool FHktReliableUdpClient::SendDatagram(const uint8* Data, int32 Size)
+{
+    if (LoopbackEndpoint)
+    {
+        return LoopbackEndpoint->SendTo(Data, Size, *ServerAddr);
+    }
+
+    int32 BytesSent = 0;
+    return ClientSocket && ClientSocket->SendTo(Data, Size, BytesSent, *ServerAddr);
+}
+
+void FHktReliableUdpClient::SendHandshake()
+{
+    // Ű Ǿٸ  Connect ٽ 
+    if (HandshakeCookie.Num() > 0 && HktNetClock::Seconds() - HandshakeCookieTime > HktReliableUdp::CookieLifetime)
+    {
+        HandshakeCookie.Reset();
+    }
+
+    if (HandshakeCookie.Num() > 0)
+    {
+        //  ߱ Ű ״   Ȯ. Ű ڿ ϴ ִ   
+        TArray<uint8> Response = HandshakeCookie;
+        Response.Add(MaxHeaderVersion);
+        SendPacket(Response, EPacketType::ConnectResponse);
+    }
+    else
+    {
+        //  Challenge  û Ŀ ʵ Ű ũ⸸ŭ е. ù Ʈ ϴ ִ   
+        TArray<uint8> Padding;
+        Padding.SetNumZeroed(sizeof(FHktConnectCookie));
+        Padding[0] = MaxHeaderVersion;
+        SendPacket(Padding, EPacketType::Connect);
+    }
+    LastHandshakeTime = HktNetClock::Seconds();
+}
 
 void FHktReliableUdpClient::Tick()
 {
-    //  忡   ŵ Ŷ ó
-    ProcessReceivedPackets();
+    Tick(FHktNetTickBudget());
+}
 
-    //  ¶, Ack   Ŷ ִ ˻Ͽ 
+void FHktReliableUdpClient::Tick(const FHktNetTickBudget& Budget)
+{
+    FHktNetTickBudgetTracker Tracker(Budget);
+
+    //  ̸    ⼭  ͱ׷ ó ť ű
+    if (LoopbackEndpoint)
+    {
+        FHktLoopbackDatagram Datagram;
+        while (LoopbackEndpoint->Receive(Datagram))
+        {
+            EnqueuePacket(MoveTemp(Datagram.Data));
+        }
+    }
+
+    //  忡   ŵ Ŷ  ȿ ó
+    ProcessReceivedPackets(Tracker);
+
+    //  ¶,    Ȯϰ Ack   Ŷ ִ ˻Ͽ 
     if (IsConnected())
     {
-        CheckForResends();
+        UpdateSessionResume();
+        // 簳 ٸ ȿ  . 簳Ǹ Ѳ ٽ 
+        if (IsConnected() && !bResuming)
+        {
+            CheckForResends();
+        }
+        UpdateMtuProbe();
+    }
+    // ڵũ    ٸ ڵũ Ŷ 
+    else if (CanSend() && HktNetClock::Seconds() - LastHandshakeTime > ResendTimeout)
+    {
+        SendHandshake();
+    }
+
+    //  . ť    ť   ٸ Ŷ
+    LastTickStats.ProcessedPackets = Tracker.GetNumPackets();
+    LastTickStats.BacklogPackets = NumQueuedPackets.load(std::memory_order_relaxed);
+    LastTickStats.TickSeconds = Tracker.GetElapsed();
+    LastTickStats.bBudgetExhausted = Tracker.IsExhausted();
+    LastTickStats.BacklogAge = 0.0;
+    const double Now = HktNetClock::Seconds();
+    for (TQueue<FReceivedPacket, EQueueMode::Mpsc>* Queue : { &IncomingControlPackets, &IncomingPackets })
+    {
+        if (const FReceivedPacket* Oldest = Queue->Peek())
+        {
+            LastTickStats.BacklogAge = FMath::Max(LastTickStats.BacklogAge, Now - Oldest->ReceiveTime);
+        }
+    }
+}
+
+void FHktReliableUdpClient::EnqueuePacket(TArray<uint8>&& Data)
+{
+    //     Ŷ  ť  ó  
+    EPacketType Type;
+    const bool bControl = HktPacketHeader::PeekType(Data.GetData(), Data.Num(), Type) && HktPacketHeader::IsControlType(Type);
+
+    FReceivedPacket Packet(nullptr, MoveTemp(Data));
+    Packet.ReceiveTime = HktNetClock::Seconds();
+    NumQueuedPackets.fetch_add(1, std::memory_order_relaxed);
+    (bControl ? IncomingControlPackets : IncomingPackets).Enqueue(MoveTemp(Packet));
+}
+
+bool FHktReliableUdpClient::DequeuePacket(FReceivedPacket& OutPacket)
+{
+    if (IncomingControlPackets.Dequeue(OutPacket) || IncomingPackets.Dequeue(OutPacket))
+    {
+        NumQueuedPackets.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void FHktReliableUdpClient::UpdateSessionResume()
+{
+    if (!bHasSessionToken)
+    {
+        return;
+    }
+
+    const double Now = HktNetClock::Seconds();
+    const double Silence = Now - LastReceiveTime;
+    if (Silence > SessionResumeTimeout)
+    {
+        UE_LOG(LogHktCustomNetClient, Error, TEXT("Server not responding for %.1f s. Giving up session resume."), Silence);
+        Disconnect();
+        return;
+    }
+
+    // κ ѵ ƹ͵  ߴٸ ּҰ ٲų   ߴ  Ƿ 簳 û.
+    // ϱ⸸  ῡ ResumeAck ƿǷ   Ȯ ҵ 
+    if (Silence > ResumeAfterSilence && Now - LastResumeTime > ResendTimeout)
+    {
+        bResuming = true;
+        SendResume();
+    }
+}
+
+void FHktReliableUdpClient::SendResume()
+{
+    TArray<uint8> Payload;
+    Payload.Append(SessionToken.Bytes, sizeof(FHktSessionToken));
+    if (ResumeCookie.Num() == sizeof(FHktConnectCookie))
+    {
+        Payload.Append(ResumeCookie);
+    }
+    else
+    {
+        Payload.AddZeroed(sizeof(FHktConnectCookie));
     }
+    SendPacket(Payload, EPacketType::Resume);
+    LastResumeTime = HktNetClock::Seconds();
+}
+
+void FHktReliableUdpClient::UpdateMtuProbe()
+{
+    if (!bMtuDiscoveryActive)
+    {
+        return;
+    }
+
+    int32 ProbeSize;
+    {
+        FScopeLock Lock(&StateMutex);
+        ProbeSize = MtuProber.Tick(HktNetClock::Seconds());
+    }
+    if (ProbeSize <= 0)
+    {
+        return;
+    }
+
+    // ͱ׷ ü Žħ ũⰡ ǵ 0 ä
+    const uint16 ProbeSize16 = (uint16)ProbeSize;
+    TArray<uint8> Payload;
+    Payload.Append((const uint8*)&ProbeSize16, sizeof(uint16));
+    SendPacket(Payload, EPacketType::MtuProbe, ProbeSize);
+}
+
+int32 FHktReliableUdpClient::GetPathMtu() const
+{
+    FScopeLock Lock(&StateMutex);
+    return MtuProber.GetPathMtu();
+}
+
+bool FHktReliableUdpClient::FitsPathMtu(int32 DatagramSize) const
+{
+    // DF  ū ͱ׷ Ŀ  
+    if (!bMtuDiscoveryActive)
+    {
+        return true;
+    }
+
+    const int32 PathMtu = GetPathMtu();
+    if (DatagramSize <= PathMtu)
+    {
+        return true;
+    }
+
+    // DF    MTU ū ͱ׷ EMSGSIZE źϰų ο Ƿ,
+    //  Ͽ   Ŷ Ǯϴ  
+    UE_LOG(LogHktCustomNetClient, Error, TEXT("Dropped %d byte packet. It exceeds the path MTU %d and MTU discovery disables fragmentation."), DatagramSize, PathMtu);
+    return false;
 }
 
 bool FHktReliableUdpClient::Poll(TArray<uint8>& OutData)
@@ -183,6 +549,11 @@ bool FHktReliableUdpClient::Poll(TArray<uint8>& OutData)
     return ReceivedDataPackets.Dequeue(OutData);
 }
 
+bool FHktReliableUdpClient::PollSnapshot(FHktSnapshotFrame& OutFrame)
+{
+    return ReceivedSnapshots.Dequeue(OutFrame);
+}
+
 bool FHktReliableUdpClient::Init()
 {
     bIsStopping = false;
@@ -201,14 +572,27 @@ uint32 FHktReliableUdpClient::Run()
         if (ClientSocket && ClientSocket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100)))
         {
             int32 BytesRead = 0;
-            if (ClientSocket->Recv(ReceiveBuffer.GetData(), ReceiveBuffer.Num(), BytesRead))
+            int32 SegmentSize = 0;
+            if (bReceiveOffloadActive && HktUdpPlatform::RecvCoalesced(ClientSocket, ReceiveBuffer.GetData(), ReceiveBuffer.Num(), BytesRead, SegmentSize, nullptr))
+            {
+                // GRO: Ŀ   ͱ׷  ũ   ó ť 
+                SegmentSize = SegmentSize > 0 ? SegmentSize : BytesRead;
+                for (int32 Offset = 0; Offset < BytesRead; Offset += SegmentSize)
+                {
+                    TArray<uint8> Data;
+                    Data.Append(ReceiveBuffer.GetData() + Offset, FMath::Min(SegmentSize, BytesRead - Offset));
+                    EnqueuePacket(MoveTemp(Data));
+                }
+                UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Socket received %d coalesced bytes (segment %d) from server."), BytesRead, SegmentSize);
+            }
+            else if (!bReceiveOffloadActive && ClientSocket->Recv(ReceiveBuffer.GetData(), ReceiveBuffer.Num(), BytesRead))
             {
                 if (BytesRead > 0)
                 {
                     // ŵ ͸ Ͽ ó ť(IncomingPackets) 
                     TArray<uint8> Data;
                     Data.Append(ReceiveBuffer.GetData(), BytesRead);
-                    IncomingPackets.Enqueue(MoveTemp(Data));
+                    EnqueuePacket(MoveTemp(Data));
                     UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Socket received %d bytes from server."), BytesRead);
                 }
             }
@@ -222,57 +606,198 @@ void FHktReliableUdpClient::Exit()
     UE_LOG(LogHktCustomNetClient, Log, TEXT("Receiver thread finished."));
 }
 
-void FHktReliableUdpClient::ProcessReceivedPackets()
+void FHktReliableUdpClient::ProcessReceivedPackets(FHktNetTickBudgetTracker& Tracker)
 {
     //  Լ   Tick ȣ˴ϴ.
-    TArray<uint8> PacketData;
-    while (IncomingPackets.Dequeue(PacketData))
+    // Ŷ  ť  Ȯϰ, ó  Ŷ ۴  Ŷ   Ǯ 
+    FReceivedPacket Packet;
+    TArray<uint8>& PacketData = Packet.Data;
+    // ̹ Tick  ũ ûũ  Ack ( ID -> ). ۸     
+    TMap<uint32, uint32> BulkAcks;
+    for (; Tracker.CanProcessPacket() && DequeuePacket(Packet); Tracker.OnPacketProcessed(), HktPacketPool::Release(MoveTemp(PacketData)))
     {
-        if (PacketData.Num() < sizeof(FPacketHeader))
+        // v2  16Ʈ /Ack  ۼ ¸  
+        uint32 SequenceReference;
+        uint32 AckReference;
         {
-            UE_LOG(LogHktCustomNetClient, Warning, TEXT("Received a packet smaller than header size. Dropping."));
-            continue;
+            FScopeLock Lock(&StateMutex);
+            SequenceReference = ReceivedSequence;
+            AckReference = SentSequence;
         }
 
         FPacketHeader Header;
-        FMemory::Memcpy(&Header, PacketData.GetData(), sizeof(FPacketHeader));
+        const int32 HeaderSize = HktPacketHeader::Decode(PacketData.GetData(), PacketData.Num(), SequenceReference, AckReference, Header);
+        if (HeaderSize == 0)
+        {
+            UE_LOG(LogHktCustomNetClient, Warning, TEXT("Received a packet with a malformed header. Dropping."));
+            continue;
+        }
+
+        const uint8* Payload = PacketData.GetData() + HeaderSize;
+        const int32 PayloadSize = PacketData.Num() - HeaderSize;
+        LastReceiveTime = HktNetClock::Seconds();
 
         UE_LOG(LogHktCustomNetClient, Verbose, TEXT("<= Rcvd Packet Type: %d, Seq: %u, Ack: %u, AckBits: %u"), (int)Header.Type, Header.Sequence, Header.LastAckedSequence, Header.AckBitfield);
 
+        //  ߱ Ű ϰ  
+        if (Header.Type == EPacketType::ConnectChallenge)
+        {
+            if (!bIsConnected && PayloadSize == sizeof(FHktConnectCookie))
+            {
+                HandshakeCookie.Reset();
+                HandshakeCookie.Append(Payload, sizeof(FHktConnectCookie));
+                HandshakeCookieTime = HktNetClock::Seconds();
+                SendHandshake();
+                UE_LOG(LogHktCustomNetClient, Log, TEXT("Received [ConnectChallenge]. Sent [ConnectResponse] with cookie."));
+            }
+            // ּҰ ٲ ä 簳 ûϸ   ּҸ ȮϷ Ű . Ű Ǿ ٷ ٽ û
+            else if (bIsConnected && bResuming && PayloadSize == sizeof(FHktConnectCookie))
+            {
+                ResumeCookie.Reset();
+                ResumeCookie.Append(Payload, sizeof(FHktConnectCookie));
+                SendResume();
+                UE_LOG(LogHktCustomNetClient, Log, TEXT("Received [ConnectChallenge] while resuming. Sent [Resume] with cookie."));
+            }
+            continue;
+        }
+
         //   :   Connect  ù Ack    
         if (!bIsConnected && Header.Type == EPacketType::Ack && Header.LastAckedSequence == 0)
         {
             bIsConnected = true;
-            UE_LOG(LogHktCustomNetClient, Log, TEXT("Handshake complete. Connection to server established."));
+            {
+                FScopeLock Lock(&StateMutex);
+                //     ˷  v1 ƴ 
+                HeaderVersion = PayloadSize >= HktReliableUdp::HandshakeVersionSize
+                    ? FMath::Clamp<uint8>(FMath::Min(Payload[0], MaxHeaderVersion), HktPacketHeader::Version1, HktPacketHeader::LatestVersion)
+                    : HktPacketHeader::Version1;
+                //  簳 ϴ   ڿ  ū ٿ 
+                bHasSessionToken = PayloadSize == HktReliableUdp::HandshakeSessionSize;
+                if (bHasSessionToken)
+                {
+                    FMemory::Memcpy(SessionToken.Bytes, Payload + HktReliableUdp::HandshakeVersionSize, sizeof(FHktSessionToken));
+                }
+                if (bMtuDiscoveryActive)
+                {
+                    MtuProber.Start(HktNetClock::Seconds());
+                }
+            }
+            UE_LOG(LogHktCustomNetClient, Log, TEXT("Handshake complete. Connection to server established (header v%d)."), HeaderVersion);
         }
 
         //    Ŷ  ޾Ҵٰ ˷ִ Ack  ó
         ProcessAck(Header);
 
+        //  簳 Ϸ.  и Ŷ  ϹǷ ʵ Ack  Ŷ ٷ ٽ 
+        if (Header.Type == EPacketType::ResumeAck && bResuming)
+        {
+            bResuming = false;
+            ResumeCookie.Reset();
+            FScopeLock Lock(&StateMutex);
+            for (auto& Elem : PendingAckPackets)
+            {
+                Elem.Value.SentTime = 0.0;
+                Elem.Value.Retries = 0;
+            }
+            UE_LOG(LogHktCustomNetClient, Log, TEXT("Session resumed."));
+        }
+
+        //    (簳  ð ų  ۵)
+        if (Header.Type == EPacketType::Disconnect && bIsConnected)
+        {
+            UE_LOG(LogHktCustomNetClient, Warning, TEXT("Server closed the session."));
+            bIsConnected = false;
+            bHasSessionToken = false;
+            bResuming = false;
+            continue;
+        }
+
+        //   ׷  ó
+        if (Header.Type == EPacketType::Snapshot)
+        {
+            ProcessSnapshot(Payload, PayloadSize);
+        }
+
+        //   MTU Žħ   ũ 
+        if (Header.Type == EPacketType::MtuProbe)
+        {
+            const uint16 ReceivedSize = (uint16)FMath::Min(PacketData.Num(), (int32)MAX_uint16);
+            TArray<uint8> AckPayload;
+            AckPayload.Append((const uint8*)&ReceivedSize, sizeof(uint16));
+            SendPacket(AckPayload, EPacketType::MtuProbeAck);
+        }
+        else if (Header.Type == EPacketType::MtuProbeAck && PayloadSize == sizeof(uint16))
+        {
+            uint16 AckedSize;
+            FMemory::Memcpy(&AckedSize, Payload, sizeof(uint16));
+            FScopeLock Lock(&StateMutex);
+            MtuProber.OnProbeAcked(AckedSize);
+        }
+
+        //   ũ ûũ ó
+        if (Header.Type == EPacketType::BulkData && PayloadSize >= (int32)sizeof(FHktBulkChunkHeader))
+        {
+            FHktBulkChunkHeader ChunkHeader;
+            FMemory::Memcpy(&ChunkHeader, Payload, sizeof(FHktBulkChunkHeader));
+
+            FHktBulkAck BulkAck;
+            bool bCompleted = false;
+            TArray<uint8> CompletedData;
+            if (BulkReceiver.OnChunk(ChunkHeader, Payload + sizeof(FHktBulkChunkHeader), PayloadSize - (int32)sizeof(FHktBulkChunkHeader), BulkAck, bCompleted, CompletedData))
+            {
+                BulkAcks.Add(BulkAck.TransferId, BulkAck.AckedOffset);
+                if (bCompleted)
+                {
+                    UE_LOG(LogHktCustomNetClient, Log, TEXT("Bulk transfer %u received. %d bytes from offset %u."), ChunkHeader.TransferId, CompletedData.Num(), ChunkHeader.StartOffset);
+                    if (BulkReceivedCallback)
+                    {
+                        BulkReceivedCallback(ChunkHeader.TransferId, ChunkHeader.StartOffset, MoveTemp(CompletedData));
+                    }
+                }
+            }
+        }
+
         //   '' Ŷ ó
         if (Header.Type == EPacketType::Data)
         {
             //   Ŷ ޾Ҵ   
-            UpdateReceivedState(Header.Sequence);
+            const bool bIsNew = UpdateReceivedState(Header.Sequence);
+            //   ѵ ɸ ʵ  Ack . ռ Ack  ۵ ߺ ٽ Ackؾ  
+            SendPacket(TArray<uint8>(), EPacketType::Ack);
+            if (!bIsNew)
+            {
+                UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Dropped duplicate data packet (Seq: %u)."), Header.Sequence);
+                continue;
+            }
 
             //    (Payload)   ť 
-            TArray<uint8> Payload;
-            Payload.Append(PacketData.GetData() + sizeof(FPacketHeader), PacketData.Num() - sizeof(FPacketHeader));
-            ReceivedDataPackets.Enqueue(MoveTemp(Payload));
+            TArray<uint8> Data;
+            Data.Append(Payload, PayloadSize);
+            ReceivedDataPackets.Enqueue(MoveTemp(Data));
 
             UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Data packet (Seq: %u) processed and enqueued for game logic."), Header.Sequence);
         }
     }
+
+    //  ũ ûũ   Ack 
+    for (const TPair<uint32, uint32>& Elem : BulkAcks)
+    {
+        FHktBulkAck BulkAck;
+        BulkAck.TransferId = Elem.Key;
+        BulkAck.AckedOffset = Elem.Value;
+        TArray<uint8> AckPayload;
+        AckPayload.Append(reinterpret_cast<const uint8*>(&BulkAck), sizeof(FHktBulkAck));
+        SendPacket(AckPayload, EPacketType::BulkAck);
+    }
 }
 
 void FHktReliableUdpClient::ProcessAck(const FPacketHeader& Header)
 {
     FScopeLock Lock(&StateMutex);
 
-    // 1. LastAckedSequence  ֱ Ŷ  Ȯϰ Pending ť 
-    if (PendingAckPackets.Contains(Header.LastAckedSequence))
+    // 1. LastAckedSequence  ֱ Ŷ  Ȯϰ Pending ť . ۴ Ǯ 
+    if (HktPendingPackets::Remove(PendingAckPackets, PendingCollapseKeys, Header.LastAckedSequence))
     {
-        PendingAckPackets.Remove(Header.LastAckedSequence);
         UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Ack confirmed for sequence %u."), Header.LastAckedSequence);
     }
 
@@ -282,26 +807,27 @@ void FHktReliableUdpClient::ProcessAck(const FPacketHeader& Header)
         if ((Header.AckBitfield >> i) & 1)
         {
             uint32 AckedSequence = Header.LastAckedSequence - (i + 1);
-            if (PendingAckPackets.Contains(AckedSequence))
+            if (HktPendingPackets::Remove(PendingAckPackets, PendingCollapseKeys, AckedSequence))
             {
-                PendingAckPackets.Remove(AckedSequence);
                 UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Ack confirmed for sequence %u via bitfield."), AckedSequence);
             }
         }
     }
 }
 
-void FHktReliableUdpClient::UpdateReceivedState(uint32 IncomingSequence)
+bool FHktReliableUdpClient::UpdateReceivedState(uint32 IncomingSequence)
 {
     FScopeLock Lock(&StateMutex);
 
-    // ʹ , ̹ ó  ȣ 
-    if (IncomingSequence <= ReceivedSequence - 32) return;
+    //  ȣ ȯص ùٸ 񱳵ǵ ȣ ִ Ÿ Ǵ
+    const int32 Diff = HktSequence::Distance(IncomingSequence, ReceivedSequence);
 
-    //   ȣ    ȣ ū  ( )
-    if (IncomingSequence > ReceivedSequence)
+    // ʹ Ǿų ̹ ó  ȣ 
+    if (Diff <= -32 || Diff == 0) return false;
+
+    //   ȣ    ȣ   ( )
+    if (Diff > 0)
     {
-        uint32 Diff = IncomingSequence - ReceivedSequence;
         // Ʈʵ带  о  Ŷ  
         ReceivedAckBitfield = (Diff >= 32) ? 1 : (ReceivedAckBitfield << Diff) | 1;
         //   ȣ 
@@ -309,16 +835,75 @@ void FHktReliableUdpClient::UpdateReceivedState(uint32 IncomingSequence)
     }
     else //  ڹٲ  Ŷ (Out-of-order)
     {
-        uint32 Diff = ReceivedSequence - IncomingSequence;
+        // ̹ ǥõ Ʈ ۵ ߺ
+        const uint32 Bit = 1u << (-Diff - 1);
+        if (ReceivedAckBitfield & Bit)
+        {
+            return false;
+        }
         // Ʈʵ ش ġ 1 Ͽ  ǥ
-        ReceivedAckBitfield |= (1 << (Diff - 1));
+        ReceivedAckBitfield |= Bit;
     }
     UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Receive state updated. Last Rcvd Seq: %u, Rcvd Bits: %u"), ReceivedSequence, ReceivedAckBitfield);
+    return true;
+}
+
+void FHktReliableUdpClient::ProcessSnapshot(const uint8* Data, int32 Size)
+{
+    int32 GroupId = 0;
+    uint32 SnapshotId = 0;
+    uint32 BaselineId = 0;
+    if (!HktSnapshot::ReadDeltaHeader(Data, Size, GroupId, SnapshotId, BaselineId))
+    {
+        UE_LOG(LogHktCustomNetClient, Warning, TEXT("Received a malformed snapshot. Dropping."));
+        return;
+    }
+
+    FHktSnapshotHistory& History = SnapshotHistories.FindOrAdd(GroupId);
+
+    // ŷ  : ̹  ͺ   
+    if (SnapshotId <= History.GetLatestId())
+    {
+        return;
+    }
+
+    // Ÿ   Ҿȴٸ   ʱȭ(ü ) û
+    const FHktSnapshotFrame* Baseline = BaselineId != 0 ? History.Find(BaselineId) : nullptr;
+    if (BaselineId != 0 && Baseline == nullptr)
+    {
+        UE_LOG(LogHktCustomNetClient, Warning, TEXT("Snapshot %u of group %d references missing baseline %u. Requesting full snapshot."), SnapshotId, GroupId, BaselineId);
+        SendSnapshotAck(GroupId, 0);
+        return;
+    }
+
+    TSharedPtr<FHktSnapshotFrame, ESPMode::ThreadSafe> Frame = MakeShared<FHktSnapshotFrame, ESPMode::ThreadSafe>();
+    if (!HktSnapshot::DecodeDelta(Data, Size, Baseline, *Frame))
+    {
+        UE_LOG(LogHktCustomNetClient, Warning, TEXT("Failed to decode snapshot %u of group %d. Dropping."), SnapshotId, GroupId);
+        return;
+    }
+
+    //    Ƿ ׺    ̻ ʿ 
+    History.SetBaseline(BaselineId);
+    History.Add(Frame);
+    ReceivedSnapshots.Enqueue(*Frame);
+
+    SendSnapshotAck(GroupId, SnapshotId);
+    UE_LOG(LogHktCustomNetClient, Verbose, TEXT("Snapshot %u of group %d applied (baseline %u, %d bytes, %d entities)."), SnapshotId, GroupId, BaselineId, Size, Frame->Entities.Num());
+}
+
+void FHktReliableUdpClient::SendSnapshotAck(int32 GroupId, uint32 SnapshotId)
+{
+    TArray<uint8> Payload;
+    Payload.SetNumUninitialized(sizeof(int32) + sizeof(uint32));
+    FMemory::Memcpy(Payload.GetData(), &GroupId, sizeof(int32));
+    FMemory::Memcpy(Payload.GetData() + sizeof(int32), &SnapshotId, sizeof(uint32));
+    SendPacket(Payload, EPacketType::SnapshotAck);
 }
 
 void FHktReliableUdpClient::CheckForResends()
 {
-    double CurrentTime = FPlatformTime::Seconds();
+    double CurrentTime = HktNetClock::Seconds();
 
     FScopeLock Lock(&StateMutex);
 
@@ -332,6 +917,13 @@ void FHktReliableUdpClient::CheckForResends()
             // ִ õ Ƚ ʰߴٸ   
             if (PendingPacket.Retries >= MaxRetries)
             {
+                //  ū   ʰ  簳 õ
+                if (bHasSessionToken)
+                {
+                    UE_LOG(LogHktCustomNetClient, Warning, TEXT("Server not responding after %d retries. Trying to resume the session."), MaxRetries);
+                    bResuming = true;
+                    return;
+                }
                 UE_LOG(LogHktCustomNetClient, Error, TEXT("Server not responding after %d retries. Disconnecting."), MaxRetries);
                 //  忡 Disconnect  ȣϸ   Ƿ,
                 //  Ʈ ÷׸ ϰ Tick  ӿ óϴ   մϴ.
@@ -341,8 +933,7 @@ void FHktReliableUdpClient::CheckForResends()
             }
 
             // Ŷ 
-            int32 BytesSent = 0;
-            ClientSocket->SendTo(PendingPacket.PacketData.GetData(), PendingPacket.PacketData.Num(), BytesSent, *ServerAddr);
+            SendDatagram(PendingPacket.PacketData.GetData() + PendingPacket.HeaderOffset, PendingPacket.PacketData.Num() - PendingPacket.HeaderOffset);
 
             PendingPacket.SentTime = CurrentTime;
             PendingPacket.Retries++;
@@ -1,3 +1,178 @@
 #include "HktReliableUdpHeader.h"
 
-DEFINE_LOG_CATEGORY(LogHktCustomNet);
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogHktCustomNet);
+
+namespace HktPacketHeader
+{
+    // v2 버전/플래그 바이트 구성
+    constexpr uint8 VersionShift = 6;
+    constexpr uint8 HasSequenceFlag = 1 << 5;
+    constexpr uint8 HasAckFlag = 1 << 4;
+    constexpr uint8 MissingLengthShift = 2;
+    constexpr uint8 MissingLengthMask = 0x3 << MissingLengthShift;
+    // 누락 비트 길이 코드 -> 바이트 수
+    constexpr int32 MissingLengths[4] = { 0, 1, 2, 4 };
+
+    // v2 버전/플래그 바이트가 나타내는 헤더 크기
+    static int32 GetVersion2HeaderSize(uint8 Flags)
+    {
+        const int32 MissingLength = MissingLengths[(Flags & MissingLengthMask) >> MissingLengthShift];
+        return MinSize
+            + ((Flags & HasSequenceFlag) ? sizeof(uint16) : 0)
+            + ((Flags & HasAckFlag) ? sizeof(uint16) + MissingLength : 0);
+    }
+
+    template<typename T>
+    static void WriteValue(uint8*& Out, T Value)
+    {
+        FMemory::Memcpy(Out, &Value, sizeof(T));
+        Out += sizeof(T);
+    }
+
+    int32 Encode(const FPacketHeader& Header, uint8 Version, uint8* Out)
+    {
+        if (Version < Version2)
+        {
+            FMemory::Memcpy(Out, &Header, sizeof(FPacketHeader));
+            return sizeof(FPacketHeader);
+        }
+
+        const bool bHasSequence = Header.Type == EPacketType::Data || Header.Sequence != 0;
+        const bool bHasAck = Header.LastAckedSequence != 0 || Header.AckBitfield != 0;
+
+        // 받지 못한 패킷만 1인 비트필드. 시퀀스 1보다 앞을 가리키는 비트는 의미가 없으므로 받은 것으로 취급
+        uint32 Missing = ~Header.AckBitfield;
+        if (Header.LastAckedSequence <= 32)
+        {
+            Missing &= Header.LastAckedSequence >= 2 ? (uint32)((1ull << (Header.LastAckedSequence - 1)) - 1) : 0u;
+        }
+        const uint8 MissingCode = !bHasAck || Missing == 0 ? 0 : Missing <= 0xFF ? 1 : Missing <= 0xFFFF ? 2 : 3;
+
+        uint8* Cursor = Out;
+        WriteValue<uint8>(Cursor, (uint8)((Version2 << VersionShift)
+            | (bHasSequence ? HasSequenceFlag : 0)
+            | (bHasAck ? HasAckFlag : 0)
+            | (MissingCode << MissingLengthShift)));
+        WriteValue<uint8>(Cursor, (uint8)Header.Type);
+        if (bHasSequence)
+        {
+            WriteValue<uint16>(Cursor, (uint16)Header.Sequence);
+        }
+        if (bHasAck)
+        {
+            WriteValue<uint16>(Cursor, (uint16)Header.LastAckedSequence);
+            // 리틀 엔디언 하위 바이트부터 필요한 만큼만 기록
+            FMemory::Memcpy(Cursor, &Missing, MissingLengths[MissingCode]);
+            Cursor += MissingLengths[MissingCode];
+        }
+        return (int32)(Cursor - Out);
+    }
+
+    int32 EncodeInPlace(const FPacketHeader& Header, uint8 Version, uint8* Buffer)
+    {
+        uint8 Encoded[MaxSize];
+        const int32 EncodedSize = Encode(Header, Version, Encoded);
+        const int32 Offset = MaxSize - EncodedSize;
+        FMemory::Memcpy(Buffer + Offset, Encoded, EncodedSize);
+        return Offset;
+    }
+
+    int32 Decode(const uint8* Data, int32 Size, uint32 SequenceReference, uint32 AckReference, FPacketHeader& OutHeader, uint8* OutVersion)
+    {
+        if (Size < MinSize)
+        {
+            return 0;
+        }
+
+        const uint8 Version = Data[0] >> VersionShift;
+        if (Version == 0)
+        {
+            // v1: 첫 바이트가 패킷 종류
+            if (Size < (int32)sizeof(FPacketHeader))
+            {
+                return 0;
+            }
+            FMemory::Memcpy(&OutHeader, Data, sizeof(FPacketHeader));
+            if (OutVersion)
+            {
+                *OutVersion = Version1;
+            }
+            return sizeof(FPacketHeader);
+        }
+
+        if (Version != Version2)
+        {
+            return 0;
+        }
+
+        const uint8 Flags = Data[0];
+        const int32 MissingLength = MissingLengths[(Flags & MissingLengthMask) >> MissingLengthShift];
+        const int32 HeaderSize = GetVersion2HeaderSize(Flags);
+        if (Size < HeaderSize)
+        {
+            return 0;
+        }
+
+        const uint8* Cursor = Data + 1;
+        OutHeader = FPacketHeader();
+        OutHeader.Type = static_cast<EPacketType>(*Cursor++);
+        if (Flags & HasSequenceFlag)
+        {
+            uint16 Sequence16;
+            FMemory::Memcpy(&Sequence16, Cursor, sizeof(uint16));
+            Cursor += sizeof(uint16);
+            OutHeader.Sequence = HktSequence::Expand16(Sequence16, SequenceReference);
+        }
+        if (Flags & HasAckFlag)
+        {
+            uint16 Ack16;
+            FMemory::Memcpy(&Ack16, Cursor, sizeof(uint16));
+            Cursor += sizeof(uint16);
+            OutHeader.LastAckedSequence = HktSequence::Expand16(Ack16, AckReference);
+
+            uint32 Missing = 0;
+            FMemory::Memcpy(&Missing, Cursor, MissingLength);
+            OutHeader.AckBitfield = ~Missing;
+        }
+
+        if (OutVersion)
+        {
+            *OutVersion = Version2;
+        }
+        return HeaderSize;
+    }
+
+    bool PeekType(const uint8* Data, int32 Size, EPacketType& OutType)
+    {
+        if (Size < MinSize)
+        {
+            return false;
+        }
+
+        // v1은 첫 바이트, v2는 버전/플래그 다음 바이트가 패킷 종류
+        const uint8 Version = Data[0] >> VersionShift;
+        if (Version == 0)
+        {
+            OutType = static_cast<EPacketType>(Data[0]);
+            return true;
+        }
+        if (Version == Version2)
+        {
+            OutType = static_cast<EPacketType>(Data[1]);
+            return true;
+        }
+        return false;
+    }
+
+    bool Validate(const uint8* Data, int32 Size, EPacketType& OutType)
+    {
+        if (!PeekType(Data, Size, OutType) || !IsValidType(OutType))
+        {
+            return false;
+        }
+
+        // v1은 고정 크기, v2는 플래그가 나타내는 필드까지 모두 있어야 함
+        const bool bVersion1 = (Data[0] >> VersionShift) == 0;
+        return Size >= (bVersion1 ? (int32)sizeof(FPacketHeader) : GetVersion2HeaderSize(Data[0]));
+    }
+}
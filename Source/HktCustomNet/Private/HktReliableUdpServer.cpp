@@ -1,14 +1,68 @@
 #include "HktReliableUdpServer.h"
+#include "HktUdpPlatform.h"
+#include "HktNetClock.h"
 #include "Common/UdpSocketBuilder.h"
 #include "SocketSubsystem.h"
 #include "HAL/PlatformTime.h"
+#include "Misc/SecureHash.h"
+#include "Misc/Guid.h"
+#include "Misc/ScopeRWLock.h"
+#include "Async/ParallelFor.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogHktCustomNetServer, Log, All);
 
+namespace HktPendingPackets
+{
+    bool Add(TMap<uint32, FPendingPacket>& Pending, TMap<uint64, uint32>& CollapseKeys, uint32 Sequence, FPendingPacket&& Packet)
+    {
+        bool bSuperseded = false;
+        if (Packet.CollapseKey != HktCollapseKey::None)
+        {
+            // 이전 패킷이 이미 Ack되었다면 색인에서도 빠져 있으므로 찾지 못함
+            uint32& IndexedSequence = CollapseKeys.FindOrAdd(Packet.CollapseKey, Sequence);
+            FPendingPacket Superseded;
+            if (IndexedSequence != Sequence && Pending.RemoveAndCopyValue(IndexedSequence, Superseded))
+            {
+                HktPacketPool::Release(MoveTemp(Superseded.PacketData));
+                bSuperseded = true;
+            }
+            IndexedSequence = Sequence;
+        }
+        Pending.Add(Sequence, MoveTemp(Packet));
+        return bSuperseded;
+    }
+
+    bool Remove(TMap<uint32, FPendingPacket>& Pending, TMap<uint64, uint32>& CollapseKeys, uint32 Sequence)
+    {
+        FPendingPacket Removed;
+        if (!Pending.RemoveAndCopyValue(Sequence, Removed))
+        {
+            return false;
+        }
+        // 색인이 이 패킷을 가리킬 때만 지움. 이미 더 새 패킷으로 바뀌었으면 그대로 둠
+        if (Removed.CollapseKey != HktCollapseKey::None)
+        {
+            const uint32* IndexedSequence = CollapseKeys.Find(Removed.CollapseKey);
+            if (IndexedSequence && *IndexedSequence == Sequence)
+            {
+                CollapseKeys.Remove(Removed.CollapseKey);
+            }
+        }
+        HktPacketPool::Release(MoveTemp(Removed.PacketData));
+        return true;
+    }
+}
+
 FHktReliableUdpServer::FHktReliableUdpServer(uint16 InPort)
     : Port(InPort)
     , bIsStopping(false)
 {
+    // 쿠키 서명용 비밀키를 무작위로 생성 (서버 인스턴스마다 다름)
+    for (int32 Offset = 0; Offset < UE_ARRAY_COUNT(CookieSecret); Offset += sizeof(FGuid))
+    {
+        const FGuid RandomGuid = FGuid::NewGuid();
+        FMemory::Memcpy(CookieSecret + Offset, &RandomGuid, sizeof(FGuid));
+    }
 }
 
 FHktReliableUdpServer::~FHktReliableUdpServer()
@@ -18,6 +72,19 @@ FHktReliableUdpServer::~FHktReliableUdpServer()
 
 void FHktReliableUdpServer::Start()
 {
+    RateLimiter.Configure(ReceiveRateLimit, ReceiveRateBurst);
+
+    if (Transport == EHktNetTransport::Loopback)
+    {
+        // 같은 프로세스 안의 클라이언트와 메모리 큐로 통신. 수신 스레드 없이 Tick에서 받음
+        LoopbackEndpoint = FHktLoopbackEndpoint::Bind(Port);
+        if (LoopbackEndpoint)
+        {
+            UE_LOG(LogHktCustomNetServer, Log, TEXT("UDP Server listening on loopback port %d"), Port);
+        }
+        return;
+    }
+
     // 서버의 패킷 수신을 전담할 스레드 생성 및 시작
     ReceiverThread = FRunnableThread::Create(this, TEXT("UdpServerReceiverThread"), 0, TPri_Normal);
 }
@@ -30,6 +97,7 @@ void FHktReliableUdpServer::Stop()
     }
 
     bIsStopping = true;
+    StopCapture();
 
     if (ReceiverThread)
     {
@@ -44,18 +112,61 @@ void FHktReliableUdpServer::Stop()
         ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
         ListenSocket = nullptr;
     }
+    LoopbackEndpoint.Reset();
     UE_LOG(LogHktCustomNetServer, Log, TEXT("Server stopped."));
 }
 
 void FHktReliableUdpServer::Tick()
 {
+    Tick(FHktNetTickBudget());
+}
+
+void FHktReliableUdpServer::Tick(const FHktNetTickBudget& Budget)
+{
+    FHktNetTickBudgetTracker Tracker(Budget);
+
     // 메인 스레드에서 매 프레임 다음 작업 수행:
-    // 1. 수신 큐에 쌓인 패킷들을 처리
-    ProcessReceivedPackets();
+    // 1. 수신 큐에 쌓인 패킷들을 예산 안에서 처리 (루프백 전송이면 도착한 데이터그램부터 큐로 옮김).
+    //    제어 패킷을 먼저 처리하고, 남은 패킷은 다음 Tick으로 이월
+    if (LoopbackEndpoint)
+    {
+        ReceiveLoopbackDatagrams();
+    }
+    ProcessReceivedPackets(Tracker);
     // 2. Ack를 받지 못한 패킷이 있다면 재전송
-    CheckForResends();
+    CheckForResends(Tracker);
     // 3. 일정 시간 응답 없는 클라이언트 타임아웃 처리
     CheckForTimeouts();
+    // 4. 주기가 된 그룹의 스냅샷 전송
+    UpdateSnapshots();
+    // 5. 경로 MTU 탐침 전송
+    UpdateMtuProbes();
+    // 6. 게임플레이 송신이 끝난 뒤 남은 대역폭으로 벌크 전송. 우선순위가 가장 낮으므로 시간 예산이 남았을 때만
+    if (!Tracker.IsTimeUp())
+    {
+        UpdateBulkTransfers();
+    }
+
+    UpdateTickStats(Tracker);
+}
+
+void FHktReliableUdpServer::UpdateTickStats(FHktNetTickBudgetTracker& Tracker)
+{
+    LastTickStats.ProcessedPackets = Tracker.GetNumPackets();
+    LastTickStats.BacklogPackets = NumQueuedPackets.load(std::memory_order_relaxed);
+    LastTickStats.TickSeconds = Tracker.GetElapsed();
+    LastTickStats.bBudgetExhausted = Tracker.IsExhausted();
+
+    // 큐의 맨 앞이 그 큐에서 가장 오래 기다린 패킷
+    const double Now = HktNetClock::Seconds();
+    LastTickStats.BacklogAge = 0.0;
+    for (TQueue<FReceivedPacket, EQueueMode::Mpsc>* Queue : { &ReceivedControlPackets, &ReceivedPackets })
+    {
+        if (const FReceivedPacket* Oldest = Queue->Peek())
+        {
+            LastTickStats.BacklogAge = FMath::Max(LastTickStats.BacklogAge, Now - Oldest->ReceiveTime);
+        }
+    }
 }
 
 bool FHktReliableUdpServer::Init()
@@ -70,7 +181,16 @@ bool FHktReliableUdpServer::Init()
         int32 BufferSize = 2 * 1024 * 1024;
         ListenSocket->SetReceiveBufferSize(BufferSize, BufferSize);
         ListenSocket->SetSendBufferSize(BufferSize, BufferSize);
-        UE_LOG(LogHktCustomNetServer, Log, TEXT("UDP Server socket created and listening on port %d"), Port);
+
+        // 커널이 지원하면 GSO/GRO 사용, 아니면 일반 경로로 대체
+        if (bUdpOffloadEnabled)
+        {
+            bSendOffloadActive = HktUdpPlatform::EnableSendOffload(ListenSocket);
+            bReceiveOffloadActive = HktUdpPlatform::EnableReceiveOffload(ListenSocket);
+        }
+        // DF를 설정할 수 없으면 큰 탐침이 조각나서 도착하므로 탐색하지 않고 안전한 MTU만 사용
+        bMtuDiscoveryActive = bMtuDiscoveryEnabled && HktUdpPlatform::EnableDontFragment(ListenSocket);
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("UDP Server socket created and listening on port %d (GSO: %d, GRO: %d, PMTUD: %d)"), Port, (int32)bSendOffloadActive, (int32)bReceiveOffloadActive, (int32)bMtuDiscoveryActive);
         return true;
     }
 
@@ -86,26 +206,37 @@ uint32 FHktReliableUdpServer::Run()
 
     while (!bIsStopping)
     {
-        uint32 PendingDataSize = 0;
-        // 읽을 데이터가 있는지 확인
-        if (ListenSocket->HasPendingData(PendingDataSize))
-        {
-            TSharedRef<FInternetAddr> PeerAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
-            int32 BytesRead = 0;
+        TSharedRef<FInternetAddr> PeerAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+        int32 BytesRead = 0;
 
-            if (ListenSocket->RecvFrom(ReceiveBuffer.GetData(), ReceiveBuffer.Num(), BytesRead, *PeerAddr))
+        if (bReceiveOffloadActive)
+        {
+            // GRO: 커널이 병합한 여러 데이터그램을 한 번에 읽어 원래 크기 단위로 나눔
+            int32 SegmentSize = 0;
+            if (HktUdpPlatform::RecvCoalesced(ListenSocket, ReceiveBuffer.GetData(), ReceiveBuffer.Num(), BytesRead, SegmentSize, &PeerAddr.Get()))
             {
-                if (BytesRead > 0)
+                SegmentSize = SegmentSize > 0 ? SegmentSize : BytesRead;
+                for (int32 Offset = 0; Offset < BytesRead; Offset += SegmentSize)
                 {
-                    // 수신된 데이터를 복사하여 메인 스레드가 처리할 큐에 넣음
-                    TArray<uint8> ReceivedData;
-                    ReceivedData.Append(ReceiveBuffer.GetData(), BytesRead);
-                    ReceivedPackets.Enqueue(FReceivedPacket(PeerAddr, MoveTemp(ReceivedData)));
-                    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Socket received %d bytes from %s."), BytesRead, *PeerAddr->ToString(true));
+                    HandleReceivedDatagram(ReceiveBuffer.GetData() + Offset, FMath::Min(SegmentSize, BytesRead - Offset), PeerAddr);
                 }
+                // 소켓에 남은 데이터가 있을 수 있으므로 대기 없이 계속 읽음
+                continue;
+            }
+        }
+        else
+        {
+            uint32 PendingDataSize = 0;
+            // 읽을 데이터가 있는지 확인
+            if (ListenSocket->HasPendingData(PendingDataSize)
+                && ListenSocket->RecvFrom(ReceiveBuffer.GetData(), ReceiveBuffer.Num(), BytesRead, *PeerAddr)
+                && BytesRead > 0)
+            {
+                HandleReceivedDatagram(ReceiveBuffer.GetData(), BytesRead, PeerAddr);
+                continue;
             }
         }
-        // CPU 사용량을 줄이기 위해 잠시 대기
+        // 읽을 데이터가 없을 때만 CPU 사용량을 줄이기 위해 잠시 대기
         FPlatformProcess::Sleep(0.001f);
     }
     UE_LOG(LogHktCustomNetServer, Log, TEXT("Server receiver thread finished."));
@@ -117,34 +248,200 @@ void FHktReliableUdpServer::Exit()
     Stop();
 }
 
-void FHktReliableUdpServer::ProcessReceivedPackets()
+void FHktReliableUdpServer::HandleReceivedDatagram(const uint8* Data, int32 Size, const TSharedRef<FInternetAddr>& PeerAddr)
 {
-    // 이 함수는 메인 스레드의 Tick에서 호출됩니다.
-    FReceivedPacket Packet;
-    while (ReceivedPackets.Dequeue(Packet))
+    if (!AcceptDatagram(Data, Size, PeerAddr))
+    {
+        return;
+    }
+
+    // 수신된 데이터를 복사하여 메인 스레드가 처리할 큐에 넣음
+    TArray<uint8> ReceivedData;
+    ReceivedData.Append(Data, Size);
+    EnqueuePacket(PeerAddr, MoveTemp(ReceivedData));
+    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Socket received %d bytes from %s."), Size, *PeerAddr->ToString(true));
+}
+
+bool FHktReliableUdpServer::AcceptDatagram(const uint8* Data, int32 Size, const TSharedRef<FInternetAddr>& PeerAddr)
+{
+    // 헤더를 해석할 수 없는 쓰레기 패킷은 복사하기 전에 버림
+    EPacketType Type;
+    if (!HktPacketHeader::Validate(Data, Size, Type))
     {
-        if (Packet.Data.Num() < sizeof(FPacketHeader)) continue;
+        NumDroppedMalformed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
 
-        FPacketHeader Header;
-        FMemory::Memcpy(&Header, Packet.Data.GetData(), sizeof(FPacketHeader));
+    // 주소별 수신 한도. 쿠키 검증(HMAC)보다 먼저 하여 폭주하는 주소의 패킷은 거의 비용 없이 버림.
+    // 이미 연결된 주소는 핸드셰이크로 확인된 상대이므로 연결과 해제 때 면제를 걸어 두고, 모르는 주소끼리만 크기가 정해진 주소 표를 나눠 씀.
+    // 그래야 모르는 주소가 표를 가득 채워도 연결된 클라이언트의 패킷은 버려지지 않음. 면제는 리미터가 수신 스레드에서 해시 키로 찾으므로
+    // 여기서 주소 문자열을 만들거나 ConnectionsLock을 잡지 않음
+    if (RateLimiter.IsEnabled())
+    {
+        switch (RateLimiter.Consume(*PeerAddr, HktNetClock::Seconds()))
+        {
+        case FHktSourceRateLimiter::EResult::RateLimited:
+            NumDroppedRateLimited.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        case FHktSourceRateLimiter::EResult::TooManySources:
+            NumDroppedTooManySources.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        default:
+            break;
+        }
+    }
+
+    // 핸드셰이크 패킷은 수신 스레드에서 바로 처리하여 메인 스레드의 큐에 쌓이지 않도록 함
+    if (FilterHandshakePacket(Data, Size, PeerAddr))
+    {
+        return false;
+    }
+
+    if (bCapturing)
+    {
+        FScopeLock Lock(&CaptureMutex);
+        if (CaptureWriter)
+        {
+            CaptureWriter->WriteDatagram(PeerAddr, Data, Size);
+        }
+    }
+    return true;
+}
+
+void FHktReliableUdpServer::ReceiveLoopbackDatagrams()
+{
+    // 보낸 쪽이 채운 풀 버퍼를 그대로 처리 큐에 넣고, 처리가 끝나면 ProcessReceivedPackets에서 풀에 돌려줌
+    FHktLoopbackDatagram Datagram;
+    while (LoopbackEndpoint->Receive(Datagram))
+    {
+        TSharedRef<FInternetAddr> PeerAddr = Datagram.Source.ToSharedRef();
+        if (AcceptDatagram(Datagram.Data.GetData(), Datagram.Data.Num(), PeerAddr))
+        {
+            EnqueuePacket(PeerAddr, MoveTemp(Datagram.Data));
+        }
+        else
+        {
+            HktPacketPool::Release(MoveTemp(Datagram.Data));
+        }
+    }
+}
+
+bool FHktReliableUdpServer::SendDatagram(const uint8* Data, int32 Size, const FInternetAddr& Destination)
+{
+    if (LoopbackEndpoint)
+    {
+        return LoopbackEndpoint->SendTo(Data, Size, Destination);
+    }
+
+    int32 BytesSent = 0;
+    return ListenSocket && ListenSocket->SendTo(Data, Size, BytesSent, Destination);
+}
+
+void FHktReliableUdpServer::EnqueueReceivedPacket(const TSharedPtr<FInternetAddr>& PeerAddr, TArray<uint8>&& Data)
+{
+    if (PeerAddr.IsValid())
+    {
+        EnqueuePacket(PeerAddr, MoveTemp(Data));
+    }
+}
+
+void FHktReliableUdpServer::EnqueuePacket(const TSharedPtr<FInternetAddr>& PeerAddr, TArray<uint8>&& Data)
+{
+    // 종류를 읽을 수 없는 패킷은 데이터 큐로 보내고 처리할 때 버림
+    EPacketType Type;
+    const bool bControl = HktPacketHeader::PeekType(Data.GetData(), Data.Num(), Type) && HktPacketHeader::IsControlType(Type);
+
+    FReceivedPacket Packet(PeerAddr, MoveTemp(Data));
+    Packet.ReceiveTime = HktNetClock::Seconds();
+    NumQueuedPackets.fetch_add(1, std::memory_order_relaxed);
+    (bControl ? ReceivedControlPackets : ReceivedPackets).Enqueue(MoveTemp(Packet));
+}
+
+bool FHktReliableUdpServer::DequeuePacket(FReceivedPacket& OutPacket)
+{
+    if (ReceivedControlPackets.Dequeue(OutPacket) || ReceivedPackets.Dequeue(OutPacket))
+    {
+        NumQueuedPackets.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+FHktReceiveDropStats FHktReliableUdpServer::GetReceiveDropStats() const
+{
+    FHktReceiveDropStats Stats;
+    Stats.Malformed = NumDroppedMalformed.load(std::memory_order_relaxed);
+    Stats.RateLimited = NumDroppedRateLimited.load(std::memory_order_relaxed);
+    Stats.TooManySources = NumDroppedTooManySources.load(std::memory_order_relaxed);
+    return Stats;
+}
+
+bool FHktReliableUdpServer::StartCapture(const FString& Path, int64 MaxBytes)
+{
+    TUniquePtr<FHktTrafficCaptureWriter> Writer = MakeUnique<FHktTrafficCaptureWriter>();
+    if (!Writer->Open(Path, MaxBytes))
+    {
+        return false;
+    }
+
+    FScopeLock Lock(&CaptureMutex);
+    CaptureWriter = MoveTemp(Writer);
+    bCapturing = true;
+    return true;
+}
+
+void FHktReliableUdpServer::StopCapture()
+{
+    FScopeLock Lock(&CaptureMutex);
+    bCapturing = false;
+    CaptureWriter.Reset();
+}
 
+void FHktReliableUdpServer::ProcessReceivedPackets(FHktNetTickBudgetTracker& Tracker)
+{
+    // 이 함수는 메인 스레드의 Tick에서 호출됩니다.
+    // 패킷마다 제어 큐를 먼저 확인하므로 데이터 처리 중에 도착한 Ack도 다음 데이터보다 먼저 처리됨.
+    // 처리가 끝난 패킷 버퍼는 다음 패킷을 꺼내기 전에 풀에 돌려줌
+    FReceivedPacket Packet;
+    for (; Tracker.CanProcessPacket() && DequeuePacket(Packet); Tracker.OnPacketProcessed(), HktPacketPool::Release(MoveTemp(Packet.Data)))
+    {
         FString ClientAddrStr = Packet.PeerAddress->ToString(true);
-        TSharedPtr<FClientConnection> Connection;
+        TSharedPtr<FClientConnection> Connection = FindConnection(ClientAddrStr);
 
+        // v2 헤더의 16비트 시퀀스/Ack는 이 연결의 송수신 상태를 기준으로 복원
+        uint32 SequenceReference = 0;
+        uint32 AckReference = 0;
+        if (Connection)
         {
-            FScopeLock Lock(&ConnectionMutex);
-            Connection = Connections.FindRef(ClientAddrStr);
+            FScopeLock Lock(&Connection->Mutex);
+            SequenceReference = Connection->ReceivedSequence;
+            AckReference = Connection->SentSequence;
         }
 
+        FPacketHeader Header;
+        const int32 HeaderSize = HktPacketHeader::Decode(Packet.Data.GetData(), Packet.Data.Num(), SequenceReference, AckReference, Header);
+        if (HeaderSize == 0) continue;
+
+        const uint8* Payload = Packet.Data.GetData() + HeaderSize;
+        const int32 PayloadSize = Packet.Data.Num() - HeaderSize;
+
         UE_LOG(LogHktCustomNetServer, Verbose, TEXT("<= Rcvd Packet from %s. Type: %d, Seq: %u, Ack: %u, AckBits: %u"), *ClientAddrStr, (int)Header.Type, Header.Sequence, Header.LastAckedSequence, Header.AckBitfield);
 
         // 등록되지 않은 클라이언트 처리
         if (!Connection)
         {
-            // 'Connect' 타입의 패킷일 경우에만 새로운 연결로 처리
-            if (Header.Type == EPacketType::Connect)
+            // 수신 스레드에서 쿠키 검증을 통과한 'ConnectResponse' 패킷일 경우에만 새로운 연결로 처리
+            if (Header.Type == EPacketType::ConnectResponse)
+            {
+                // 쿠키 뒤에 버전 바이트가 없으면 v1만 아는 클라이언트
+                const uint8 ClientMaxVersion = PayloadSize >= (int32)sizeof(FHktConnectCookie) + HktReliableUdp::HandshakeVersionSize
+                    ? Payload[sizeof(FHktConnectCookie)] : HktPacketHeader::Version1;
+                HandleNewConnection(Packet.PeerAddress, ClientMaxVersion);
+            }
+            // 주소가 바뀐 클라이언트가 세션 토큰으로 다시 붙음
+            else if (Header.Type == EPacketType::Resume)
             {
-                HandleNewConnection(Packet.PeerAddress);
+                HandleResume(Packet.PeerAddress, Header, Payload, PayloadSize);
             }
             else
             {
@@ -154,7 +451,7 @@ void FHktReliableUdpServer::ProcessReceivedPackets()
         }
 
         // 마지막 통신 시간 갱신 (타임아웃 방지)
-        Connection->LastReceiveTime = FPlatformTime::Seconds();
+        Connection->LastReceiveTime = HktNetClock::Seconds();
 
         // 클라이언트가 보낸 Ack 정보를 먼저 처리하여 내가 보낸 패킷이 잘 도착했는지 확인
         ProcessAck(Header, Connection);
@@ -164,27 +461,102 @@ void FHktReliableUdpServer::ProcessReceivedPackets()
         case EPacketType::Data:
         {
             // 내가 어떤 패킷까지 받았는지 수신 상태 갱신
-            UpdateReceivedState(Header.Sequence, Connection);
-            // "당신이 보낸 데이터 잘 받았다"는 의미로 즉시 Ack 전송
+            const bool bIsNew = UpdateReceivedState(Header.Sequence, Connection);
+            // "당신이 보낸 데이터 잘 받았다"는 의미로 즉시 Ack 전송. 앞선 Ack가 사라져 재전송된 중복에도 다시 Ack해야 재전송이 멈춤
             SendAck(Connection);
+            if (!bIsNew)
+            {
+                UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Dropped duplicate [Data] packet (Seq: %u) from %s."), Header.Sequence, *ClientAddrStr);
+                break;
+            }
             UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Processed [Data] packet (Seq: %u) from %s."), Header.Sequence, *ClientAddrStr);
-            // TODO: 페이로드(Header 이후의 데이터)를 파싱하여 게임 로직 큐로 전달
+            // 헤더를 제외한 순수 데이터(Payload)를 게임 로직으로 전달
+            if (DataReceivedCallback)
+            {
+                DataReceivedCallback(Connection->Address, TConstArrayView<uint8>(Payload, PayloadSize));
+            }
             break;
         }
         case EPacketType::Ack:
             // Ack 패킷은 ProcessAck에서 이미 모든 처리가 끝났으므로 별도 작업 없음
             break;
+        case EPacketType::ConnectResponse:
+            // 핸드셰이크 Ack가 유실되어 클라이언트가 쿠키를 다시 보낸 경우, Ack만 다시 전송
+            SendHandshakeAck(Connection);
+            break;
+        case EPacketType::Resume:
+            // 주소는 그대로인데 클라이언트가 서버 응답을 오래 받지 못한 경우. 같은 경로로 재개
+            HandleResume(Packet.PeerAddress, Header, Payload, PayloadSize);
+            break;
+        case EPacketType::SnapshotAck:
+        {
+            if (PayloadSize == sizeof(int32) + sizeof(uint32))
+            {
+                int32 AckGroupId;
+                uint32 AckSnapshotId;
+                FMemory::Memcpy(&AckGroupId, Payload, sizeof(int32));
+                FMemory::Memcpy(&AckSnapshotId, Payload + sizeof(int32), sizeof(uint32));
+
+                // 클라이언트가 적용한 스냅샷을 다음 델타의 기준으로 사용 (0이면 기준 초기화)
+                if (FHktSnapshotHistory* History = Connection->SnapshotHistories.Find(AckGroupId))
+                {
+                    History->SetBaseline(AckSnapshotId);
+                }
+            }
+            break;
+        }
+        case EPacketType::MtuProbe:
+        {
+            // 실제로 도착한 크기를 돌려주어 상대가 그 크기까지 경로를 통과함을 확인하도록 함
+            const uint16 ReceivedSize = (uint16)FMath::Min(Packet.Data.Num(), (int32)MAX_uint16);
+            TArray<uint8> AckPayload;
+            AckPayload.Append((const uint8*)&ReceivedSize, sizeof(uint16));
+            SendUnreliable(*Connection, EPacketType::MtuProbeAck, AckPayload);
+            break;
+        }
+        case EPacketType::MtuProbeAck:
+        {
+            if (PayloadSize == sizeof(uint16))
+            {
+                uint16 AckedSize;
+                FMemory::Memcpy(&AckedSize, Payload, sizeof(uint16));
+
+                FScopeLock Lock(&Connection->Mutex);
+                Connection->MtuProber.OnProbeAcked(AckedSize);
+            }
+            break;
+        }
+        case EPacketType::BulkAck:
+        {
+            if (PayloadSize == sizeof(FHktBulkAck))
+            {
+                FHktBulkAck Ack;
+                FMemory::Memcpy(&Ack, Payload, sizeof(FHktBulkAck));
+
+                TArray<uint32> Completed;
+                Connection->BulkSender.OnAck(Ack, HktNetClock::Seconds(), Completed);
+                for (uint32 TransferId : Completed)
+                {
+                    UE_LOG(LogHktCustomNetServer, Log, TEXT("Bulk transfer %u to %s completed."), TransferId, *ClientAddrStr);
+                    if (BulkCompleteCallback)
+                    {
+                        BulkCompleteCallback(Connection->Address, TransferId, true);
+                    }
+                }
+            }
+            break;
+        }
         case EPacketType::Disconnect:
             DisconnectClient(ClientAddrStr, TEXT("Client requested disconnect."));
             break;
         case EPacketType::JoinGroup:
         {
             // 페이로드 크기가 유효한지 확인
-            if (Packet.Data.Num() - sizeof(FPacketHeader) == sizeof(int32))
+            if (PayloadSize == sizeof(int32))
             {
                 int32 RequestedGroupId;
                 // 페이로드에서 GroupId를 역직렬화
-                FMemory::Memcpy(&RequestedGroupId, Packet.Data.GetData() + sizeof(FPacketHeader), sizeof(int32));
+                FMemory::Memcpy(&RequestedGroupId, Payload, sizeof(int32));
 
                 UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s requested to join group %d."), *ClientAddrStr, RequestedGroupId);
 
@@ -199,10 +571,10 @@ void FHktReliableUdpServer::ProcessReceivedPackets()
         }
         case EPacketType::LeaveGroup:
         {
-            if (Packet.Data.Num() - sizeof(FPacketHeader) == sizeof(int32))
+            if (PayloadSize == sizeof(int32))
             {
                 int32 GroupIdToLeave;
-                FMemory::Memcpy(&GroupIdToLeave, Packet.Data.GetData() + sizeof(FPacketHeader), sizeof(int32));
+                FMemory::Memcpy(&GroupIdToLeave, Payload, sizeof(int32));
                 LeaveGroup(Packet.PeerAddress, GroupIdToLeave);
             }
             else
@@ -217,240 +589,1297 @@ void FHktReliableUdpServer::ProcessReceivedPackets()
     }
 }
 
-void FHktReliableUdpServer::SendTo(const TSharedPtr<FInternetAddr>& DstAddr, const TArray<uint8>& Data)
+void FHktReliableUdpServer::SendTo(const TSharedPtr<FInternetAddr>& DstAddr, const TArray<uint8>& Data, uint64 CollapseKey)
 {
-    if (!ListenSocket || !DstAddr.IsValid()) return;
-
-    FString AddrStr = DstAddr->ToString(true);
-    TSharedPtr<FClientConnection> Connection;
-    {
-        FScopeLock Lock(&ConnectionMutex);
-        Connection = Connections.FindRef(AddrStr);
-    }
+    if (!CanSend() || !DstAddr.IsValid()) return;
 
+    TSharedPtr<FClientConnection> Connection = FindConnection(DstAddr->ToString(true));
     if (!Connection)
     {
-        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Attempted to send data to an unknown client %s."), *AddrStr);
+        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Attempted to send data to an unknown client %s."), *DstAddr->ToString(true));
         return;
     }
 
-    FPacketHeader Header;
-    Header.Type = EPacketType::Data;
+    SendToConnection(*Connection, Data, CollapseKey);
+}
+
+void FHktReliableUdpServer::SendTo(const TSharedPtr<FInternetAddr>& DstAddr, FHktPacketWriter& Writer, uint64 CollapseKey)
+{
+    if (!CanSend() || !DstAddr.IsValid()) return;
 
+    TSharedPtr<FClientConnection> Connection = FindConnection(DstAddr->ToString(true));
+    if (!Connection)
     {
-        FScopeLock Lock(&ConnectionMutex);
-        // 이 클라이언트에게 보낼 다음 시퀀스 번호
-        Connection->SentSequence++;
-        Header.Sequence = Connection->SentSequence;
-        // 내가 이 클라이언트로부터 마지막으로 받은 패킷 정보를 헤더에 담음 (Piggybacking Ack)
-        Header.LastAckedSequence = Connection->ReceivedSequence;
-        Header.AckBitfield = Connection->ReceivedAckBitfield;
+        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Attempted to send data to an unknown client %s."), *DstAddr->ToString(true));
+        return;
     }
 
-    TArray<uint8> PacketData;
-    PacketData.Append((uint8*)&Header, sizeof(FPacketHeader));
+    SendPreparedToConnection(*Connection, Writer.TakeBuffer(), CollapseKey);
+}
+
+void FHktReliableUdpServer::SendToConnection(FClientConnection& Connection, const TArray<uint8>& Data, uint64 CollapseKey)
+{
+    // 헤더 자리를 비워 둔 풀 버퍼에 페이로드를 한 번만 복사
+    TArray<uint8> PacketData = HktPacketPool::Acquire(HktPacketHeader::MaxSize + Data.Num());
+    PacketData.AddUninitialized(HktPacketHeader::MaxSize);
     PacketData.Append(Data);
+    SendPreparedToConnection(Connection, MoveTemp(PacketData), CollapseKey);
+}
 
-    int32 BytesSent = 0;
-    ListenSocket->SendTo(PacketData.GetData(), PacketData.Num(), BytesSent, *DstAddr);
-    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("=> Sent [Data] to %s. Seq: %u, Ack: %u, AckBits: %u"), *AddrStr, Header.Sequence, Header.LastAckedSequence, Header.AckBitfield);
+void FHktReliableUdpServer::SendPreparedToConnection(FClientConnection& Connection, TArray<uint8>&& PacketData, uint64 CollapseKey)
+{
+    if (!CanSend()) return;
+
+    // 시퀀스 부여부터 재전송 대기 등록까지 연결 잠금 안에서 처리하여, 같은 연결로의 패킷은 시퀀스 순서대로 나가고
+    // Ack가 등록보다 먼저 처리되는 일이 없도록 함. 다른 연결로의 송신과는 경쟁하지 않음
+    FScopeLock Lock(&Connection.Mutex);
 
+    // 헤더는 최대 크기로 계산. 시퀀스를 쓰기 전에 거부하여 수신 쪽에 빈 시퀀스가 생기지 않게 함
+    if (!FitsPathMtu(Connection, PacketData.Num(), EPacketType::Data))
     {
-        FScopeLock Lock(&ConnectionMutex);
-        // 재전송을 위해 보낸 패킷 정보 저장
-        Connection->PendingAckPackets.Add(Header.Sequence, FPendingPacket(MoveTemp(PacketData), FPlatformTime::Seconds()));
+        HktPacketPool::Release(MoveTemp(PacketData));
+        return;
     }
-}
 
-void FHktReliableUdpServer::BroadcastToGroup(int32 GroupId, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr)
-{
-    FScopeLock Lock(&ConnectionMutex);
-    if (const TMap<FString, TSharedPtr<FInternetAddr>>* GroupMembers = Groups.Find(GroupId))
+    // 중단된 세션에 한도 이상 쌓이면 더 받지 않고 세션을 버림. 다음 Tick에 ExpireSuspendedSessions가 정리
+    if (Connection.bSuspended && Connection.PendingAckPackets.Num() >= MaxSuspendedPendingPackets)
     {
-        UE_LOG(LogHktCustomNetServer, Log, TEXT("Broadcasting to group %d (%d members)."), GroupId, GroupMembers->Num());
-        for (const auto& Elem : *GroupMembers)
+        if (!Connection.bPendingOverflow.exchange(true, std::memory_order_relaxed))
         {
-            const TSharedPtr<FInternetAddr>& MemberAddr = Elem.Value;
-            if (MemberAddr.IsValid() && (!ExcludeAddr.IsValid() || !MemberAddr->CompareEndpoints(*ExcludeAddr)))
-            {
-                SendTo(MemberAddr, Data);
-            }
+            UE_LOG(LogHktCustomNetServer, Warning, TEXT("Suspended session of %s has %d pending packets. Dropping the session."), *Connection.Address->ToString(true), Connection.PendingAckPackets.Num());
         }
+        HktPacketPool::Release(MoveTemp(PacketData));
+        return;
+    }
+
+    FPacketHeader Header;
+    check(PacketData.Num() >= HktPacketHeader::MaxSize);
+    const int32 HeaderOffset = WriteDataHeader(Connection, PacketData.GetData(), Header);
+
+    // 일시 중단된 세션은 보내지 않고 재전송 대기 목록에만 넣어 두었다가 Resume 뒤에 재전송
+    if (!Connection.bSuspended)
+    {
+        SendDatagram(PacketData.GetData() + HeaderOffset, PacketData.Num() - HeaderOffset, *Connection.Address);
+        Connection.GameplayBytesSent.fetch_add(PacketData.Num() - HeaderOffset, std::memory_order_relaxed);
+    }
+    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("=> Sent [Data] to %s. Seq: %u, Ack: %u, AckBits: %u"), *Connection.Address->ToString(true), Header.Sequence, Header.LastAckedSequence, Header.AckBitfield);
+
+    // 재전송을 위해 보낸 패킷 정보 저장. 같은 대체 키의 이전 패킷은 더 이상 재전송하지 않음
+    FPendingPacket PendingPacket(MoveTemp(PacketData), HktNetClock::Seconds(), HeaderOffset);
+    PendingPacket.CollapseKey = CollapseKey;
+    if (HktPendingPackets::Add(Connection.PendingAckPackets, Connection.PendingCollapseKeys, Header.Sequence, MoveTemp(PendingPacket)))
+    {
+        NumSupersededPackets.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-void FHktReliableUdpServer::ProcessAck(const FPacketHeader& Header, TSharedPtr<FClientConnection> Connection)
+void FHktReliableUdpServer::SendBurstTo(const TSharedPtr<FInternetAddr>& DstAddr, const TArray<TArray<uint8>>& DataArray)
 {
-    FScopeLock Lock(&ConnectionMutex);
+    if (!CanSend() || !DstAddr.IsValid() || DataArray.Num() == 0) return;
 
-    // 1. LastAckedSequence로 가장 최근 패킷이 도착했음을 확인하고 Pending 큐에서 제거
-    if (Connection->PendingAckPackets.Contains(Header.LastAckedSequence))
+    FString AddrStr = DstAddr->ToString(true);
+    TSharedPtr<FClientConnection> Connection = FindConnection(AddrStr);
+    if (!Connection)
     {
-        Connection->PendingAckPackets.Remove(Header.LastAckedSequence);
-        UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Ack confirmed for sequence %u from %s."), Header.LastAckedSequence, *Connection->Address->ToString(true));
+        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Attempted to send a burst to an unknown client %s."), *AddrStr);
+        return;
     }
 
-    // 2. AckBitfield를 순회하며 그 이전 패킷들의 도착 여부도 확인하고 제거
-    for (int32 i = 0; i < 32; ++i)
+    FScopeLock Lock(&Connection->Mutex);
+
+    TArray<TArray<uint8>> Packets;
+    TArray<uint32> Sequences;
+    Packets.Reserve(DataArray.Num());
+    Sequences.Reserve(DataArray.Num());
+    for (const TArray<uint8>& Data : DataArray)
     {
-        if ((Header.AckBitfield >> i) & 1)
+        if (!FitsPathMtu(*Connection, HktPacketHeader::MaxSize + Data.Num(), EPacketType::Data))
         {
-            uint32 AckedSequence = Header.LastAckedSequence - (i + 1);
-            if (Connection->PendingAckPackets.Contains(AckedSequence))
-            {
-                Connection->PendingAckPackets.Remove(AckedSequence);
-                UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Ack confirmed for sequence %u from %s via bitfield."), AckedSequence, *Connection->Address->ToString(true));
-            }
+            continue;
+        }
+        FPacketHeader Header;
+        Packets.Add(BuildDataPacket(*Connection, Data, Header));
+        Sequences.Add(Header.Sequence);
+    }
+
+    // 같은 크기의 패킷들은 GSO로 묶어 한 번의 시스템 콜로 전송. 루프백은 시스템 콜이 없으므로 하나씩 큐에 넣음
+    int32 NumSendCalls = 0;
+    if (LoopbackEndpoint)
+    {
+        for (const TArray<uint8>& Packet : Packets)
+        {
+            LoopbackEndpoint->SendTo(Packet.GetData(), Packet.Num(), *DstAddr);
         }
     }
+    else
+    {
+        NumSendCalls = HktUdpPlatform::SendBatch(ListenSocket, Packets, *DstAddr, bSendOffloadActive);
+    }
+    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("=> Sent burst of %d [Data] packets to %s with %d send calls."), Packets.Num(), *AddrStr, NumSendCalls);
+
+    // 재전송을 위해 보낸 패킷 정보 저장
+    const double CurrentTime = HktNetClock::Seconds();
+    for (int32 i = 0; i < Packets.Num(); ++i)
+    {
+        Connection->GameplayBytesSent.fetch_add(Packets[i].Num(), std::memory_order_relaxed);
+        Connection->PendingAckPackets.Add(Sequences[i], FPendingPacket(MoveTemp(Packets[i]), CurrentTime));
+    }
+}
+
+TArray<uint8> FHktReliableUdpServer::BuildDataPacket(FClientConnection& Connection, const TArray<uint8>& Data, FPacketHeader& OutHeader)
+{
+    // GSO로 묶어 보낼 수 있도록 헤더를 맨 앞에 두고 페이로드를 이어 붙임
+    uint8 HeaderSpace[HktPacketHeader::MaxSize];
+    const int32 HeaderOffset = WriteDataHeader(Connection, HeaderSpace, OutHeader);
+
+    TArray<uint8> PacketData = HktPacketPool::Acquire(HktPacketHeader::MaxSize + Data.Num());
+    PacketData.Append(HeaderSpace + HeaderOffset, HktPacketHeader::MaxSize - HeaderOffset);
+    PacketData.Append(Data);
+    return PacketData;
 }
 
-void FHktReliableUdpServer::UpdateReceivedState(uint32 IncomingSequence, TSharedPtr<FClientConnection> Connection)
+int32 FHktReliableUdpServer::WriteDataHeader(FClientConnection& Connection, uint8* HeaderSpace, FPacketHeader& OutHeader)
 {
-    FScopeLock Lock(&ConnectionMutex);
+    OutHeader.Type = EPacketType::Data;
+    // 이 클라이언트에게 보낼 다음 시퀀스 번호
+    Connection.SentSequence++;
+    OutHeader.Sequence = Connection.SentSequence;
+    // 내가 이 클라이언트로부터 마지막으로 받은 패킷 정보를 헤더에 담음 (Piggybacking Ack)
+    OutHeader.LastAckedSequence = Connection.ReceivedSequence;
+    OutHeader.AckBitfield = Connection.ReceivedAckBitfield;
+
+    return HktPacketHeader::EncodeInPlace(OutHeader, Connection.HeaderVersion, HeaderSpace);
+}
 
-    if (IncomingSequence <= Connection->ReceivedSequence - 32)
+void FHktReliableUdpServer::BroadcastToGroup(int32 GroupId, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr)
+{
+    // 하위 그룹이 있으면 구성원이 겹칠 수 있으므로 합집합을 구해서 보냄
+    bool bHasSubgroups;
     {
-        return; // 너무 오래된 패킷은 무시
+        FReadScopeLock Lock(ConnectionsLock);
+        bHasSubgroups = Subgroups.Contains(GroupId);
     }
-
-    if (IncomingSequence > Connection->ReceivedSequence)
+    if (bHasSubgroups)
     {
-        // 정상 순서로 패킷 도착
-        uint32 Diff = IncomingSequence - Connection->ReceivedSequence;
-        Connection->ReceivedAckBitfield = (Diff >= 32) ? 1 : (Connection->ReceivedAckBitfield << Diff) | 1;
-        Connection->ReceivedSequence = IncomingSequence;
+        BroadcastToGroups({ GroupId }, Data, ExcludeAddr);
+        return;
     }
-    else
+
+    // 구성원 목록은 변경되지 않는 스냅샷이므로 잠금 없이 순회하며 전송
+    if (FGroupMembersPtr GroupMembers = GetGroupMembers(GroupId))
     {
-        // 순서가 뒤바뀌어 패킷 도착 (Out-of-order)
-        uint32 Diff = Connection->ReceivedSequence - IncomingSequence;
-        Connection->ReceivedAckBitfield |= (1 << (Diff - 1));
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("Broadcasting to group %d (%d members)."), GroupId, GroupMembers->Num());
+        SendToConnections(*GroupMembers, Data, ExcludeAddr);
     }
-    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Receive state updated for %s. Last Rcvd Seq: %u, Rcvd Bits: %u"), *Connection->Address->ToString(true), Connection->ReceivedSequence, Connection->ReceivedAckBitfield);
 }
 
-
-void FHktReliableUdpServer::CheckForResends()
+void FHktReliableUdpServer::BroadcastToGroups(const TArray<int32>& GroupIds, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr)
 {
-    double CurrentTime = FPlatformTime::Seconds();
-    TArray<FString> ClientsToDisconnect;
+    TArray<TSharedPtr<FClientConnection>> Recipients;
+    CollectGroupRecipients(GroupIds, Recipients);
+    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Broadcasting to %d groups (%d unique members)."), GroupIds.Num(), Recipients.Num());
+    SendToConnections(Recipients, Data, ExcludeAddr);
+}
 
-    FScopeLock Lock(&ConnectionMutex);
-    // 모든 연결된 클라이언트를 순회
-    for (auto& Elem : Connections)
+void FHktReliableUdpServer::CollectGroupRecipients(const TArray<int32>& GroupIds, TArray<TSharedPtr<FClientConnection>>& OutRecipients) const
+{
+    FReadScopeLock Lock(ConnectionsLock);
+    // 하위 그룹까지 펼침. DAG에서 여러 경로로 닿는 그룹은 한 번만 순회
+    TArray<int32, TInlineAllocator<16>> PendingGroups(GroupIds);
+    TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<16>> VisitedGroups;
+    // 여러 그룹에 속한 연결은 한 번만 수신자로 고름. 연결 번호로 비트를 찾으므로 구성원 수만큼의 비용으로 합치며,
+    // 호출마다 지역 비트 배열을 쓰므로 동시에 브로드캐스트해도 서로 간섭하지 않음
+    TBitArray<> VisitedConnections(false, NumConnectionSlots);
+    while (PendingGroups.Num() > 0)
     {
-        TSharedPtr<FClientConnection> Connection = Elem.Value;
-        // 해당 클라이언트의 Ack 대기 중인 패킷들을 순회
-        for (auto& PacketElem : Connection->PendingAckPackets)
+        const int32 GroupId = PendingGroups.Pop();
+        bool bAlreadyVisited = false;
+        VisitedGroups.Add(GroupId, &bAlreadyVisited);
+        if (bAlreadyVisited)
+        {
+            continue;
+        }
+
+        if (const FGroupMembersPtr* GroupMembers = Groups.Find(GroupId))
         {
-            FPendingPacket& PendingPacket = PacketElem.Value;
-            if (CurrentTime - PendingPacket.SentTime > ResendTimeout)
+            for (const TSharedPtr<FClientConnection>& Member : **GroupMembers)
             {
-                // 최대 재전송 횟수 초과 시 연결 종료 목록에 추가
-                if (PendingPacket.Retries >= MaxRetries)
+                FBitReference Visited = VisitedConnections[Member->Slot];
+                if (!Visited)
                 {
-                    ClientsToDisconnect.Add(Elem.Key);
-                    break;
+                    Visited = true;
+                    OutRecipients.Add(Member);
                 }
-
-                // 패킷 재전송
-                int32 BytesSent = 0;
-                ListenSocket->SendTo(PendingPacket.PacketData.GetData(), PendingPacket.PacketData.Num(), BytesSent, *Connection->Address);
-
-                PendingPacket.SentTime = CurrentTime;
-                PendingPacket.Retries++;
-                UE_LOG(LogHktCustomNetServer, Warning, TEXT("Packet timeout. Resending (Seq:%u) to %s, Retry: %d/%d"), PacketElem.Key, *Elem.Key, PendingPacket.Retries, MaxRetries);
             }
         }
-    }
-
-    // 재전송 초과로 연결을 끊어야 할 클라이언트가 있다면 처리
-    if (ClientsToDisconnect.Num() > 0)
-    {
-        for (const FString& AddrStr : ClientsToDisconnect)
+        if (const TArray<int32>* Children = Subgroups.Find(GroupId))
         {
-            DisconnectClient(AddrStr, TEXT("Packet resend limit exceeded. Not responding."));
+            PendingGroups.Append(*Children);
         }
     }
 }
 
-void FHktReliableUdpServer::CheckForTimeouts()
+bool FHktReliableUdpServer::AddSubgroup(int32 ParentGroupId, int32 ChildGroupId)
 {
-    const double CurrentTime = FPlatformTime::Seconds();
+    FWriteScopeLock Lock(ConnectionsLock);
+    // 하위 그룹에서 상위 그룹으로 닿을 수 있다면 순환이 생김
+    if (ParentGroupId == ChildGroupId || IsSubgroupReachable(ChildGroupId, ParentGroupId))
+    {
+        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Adding group %d under group %d would create a cycle."), ChildGroupId, ParentGroupId);
+        return false;
+    }
+    Subgroups.FindOrAdd(ParentGroupId).AddUnique(ChildGroupId);
+    return true;
+}
+
+void FHktReliableUdpServer::RemoveSubgroup(int32 ParentGroupId, int32 ChildGroupId)
+{
+    FWriteScopeLock Lock(ConnectionsLock);
+    if (TArray<int32>* Children = Subgroups.Find(ParentGroupId))
+    {
+        Children->Remove(ChildGroupId);
+        if (Children->Num() == 0)
+        {
+            Subgroups.Remove(ParentGroupId);
+        }
+    }
+}
+
+bool FHktReliableUdpServer::IsSubgroupReachable(int32 From, int32 To) const
+{
+    TArray<int32, TInlineAllocator<16>> PendingGroups;
+    PendingGroups.Add(From);
+    TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<16>> VisitedGroups;
+    while (PendingGroups.Num() > 0)
+    {
+        const int32 GroupId = PendingGroups.Pop();
+        if (GroupId == To)
+        {
+            return true;
+        }
+        bool bAlreadyVisited = false;
+        VisitedGroups.Add(GroupId, &bAlreadyVisited);
+        if (!bAlreadyVisited)
+        {
+            if (const TArray<int32>* Children = Subgroups.Find(GroupId))
+            {
+                PendingGroups.Append(*Children);
+            }
+        }
+    }
+    return false;
+}
+
+void FHktReliableUdpServer::SendToConnections(const TArray<TSharedPtr<FClientConnection>>& Recipients, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr)
+{
+    auto SendRange = [this, &Recipients, &Data, &ExcludeAddr](int32 Begin, int32 End)
+    {
+        for (int32 Index = Begin; Index < End; ++Index)
+        {
+            const TSharedPtr<FClientConnection>& Recipient = Recipients[Index];
+            if (!ExcludeAddr.IsValid() || !Recipient->Address->CompareEndpoints(*ExcludeAddr))
+            {
+                SendToConnection(*Recipient, Data);
+            }
+        }
+    };
+
+    int32 NumTasks = 1;
+    if (ParallelBroadcastMinRecipients > 0 && Recipients.Num() >= ParallelBroadcastMinRecipients)
+    {
+        const int32 MaxTasks = ParallelBroadcastMaxTasks > 0 ? ParallelBroadcastMaxTasks : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        NumTasks = FMath::Clamp(FMath::DivideAndRoundUp(Recipients.Num(), MinRecipientsPerTask), 1, MaxTasks);
+    }
+    if (NumTasks == 1)
+    {
+        SendRange(0, Recipients.Num());
+        return;
+    }
+
+    // 작업마다 목록의 연속된 구간을 순서대로 맡음. 어느 구간을 어느 작업이 맡는지는 수신자 수와 작업 수로만 정해짐.
+    // 연결별 상태는 SendToConnection이 연결 잠금 안에서 갱신하고, 한 연결은 한 작업만 보내므로 작업 사이에 경쟁하지 않음
+    const int32 RecipientsPerTask = FMath::DivideAndRoundUp(Recipients.Num(), NumTasks);
+    ParallelFor(NumTasks, [&SendRange, &Recipients, RecipientsPerTask](int32 TaskIndex)
+        {
+            const int32 Begin = TaskIndex * RecipientsPerTask;
+            SendRange(Begin, FMath::Min(Begin + RecipientsPerTask, Recipients.Num()));
+        });
+}
+
+int32 FHktReliableUdpServer::BroadcastToGroupInRadius(int32 GroupId, const FVector& Origin, float Radius, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr)
+{
+    // 그룹 전체를 순회하지 않고 격자에서 반경 안의 클라이언트만 찾은 뒤 그룹 소속을 확인
+    TArray<uint64> NearbyIds;
+    {
+        FReadScopeLock Lock(InterestLock);
+        InterestGrid.QueryRadius(Origin, Radius, NearbyIds);
+    }
+
+    TArray<TSharedPtr<FClientConnection>> Recipients;
+    {
+        FReadScopeLock Lock(ConnectionsLock);
+        for (uint64 Id : NearbyIds)
+        {
+            const TSharedPtr<FClientConnection> Connection = ConnectionsById.FindRef(Id);
+            if (Connection && Connection->GroupIds.Contains(GroupId)
+                && (!ExcludeAddr.IsValid() || !Connection->Address->CompareEndpoints(*ExcludeAddr)))
+            {
+                Recipients.Add(Connection);
+            }
+        }
+    }
+
+    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Broadcasting to group %d within %.1f (%d relevant members)."), GroupId, Radius, Recipients.Num());
+    SendToConnections(Recipients, Data, nullptr);
+    return Recipients.Num();
+}
+
+void FHktReliableUdpServer::SetClientInterestLocation(const TSharedPtr<FInternetAddr>& ClientAddr, const FVector& Location)
+{
+    if (!ClientAddr.IsValid()) return;
+
+    if (TSharedPtr<FClientConnection> Connection = FindConnection(ClientAddr->ToString(true)))
+    {
+        FWriteScopeLock Lock(InterestLock);
+        InterestGrid.Update(Connection->ConnectionId, Location);
+    }
+}
+
+void FHktReliableUdpServer::ClearClientInterestLocation(const TSharedPtr<FInternetAddr>& ClientAddr)
+{
+    if (!ClientAddr.IsValid()) return;
+
+    if (TSharedPtr<FClientConnection> Connection = FindConnection(ClientAddr->ToString(true)))
+    {
+        FWriteScopeLock Lock(InterestLock);
+        InterestGrid.Remove(Connection->ConnectionId);
+    }
+}
+
+void FHktReliableUdpServer::ProcessAck(const FPacketHeader& Header, TSharedPtr<FClientConnection> Connection)
+{
+    FScopeLock Lock(&Connection->Mutex);
+
+    // 1. LastAckedSequence로 가장 최근 패킷이 도착했음을 확인하고 Pending 큐에서 제거. 버퍼는 풀로 돌려줌
+    if (HktPendingPackets::Remove(Connection->PendingAckPackets, Connection->PendingCollapseKeys, Header.LastAckedSequence))
+    {
+        UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Ack confirmed for sequence %u from %s."), Header.LastAckedSequence, *Connection->Address->ToString(true));
+    }
+
+    // 2. AckBitfield를 순회하며 그 이전 패킷들의 도착 여부도 확인하고 제거
+    for (int32 i = 0; i < 32; ++i)
+    {
+        if ((Header.AckBitfield >> i) & 1)
+        {
+            uint32 AckedSequence = Header.LastAckedSequence - (i + 1);
+            if (HktPendingPackets::Remove(Connection->PendingAckPackets, Connection->PendingCollapseKeys, AckedSequence))
+            {
+                UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Ack confirmed for sequence %u from %s via bitfield."), AckedSequence, *Connection->Address->ToString(true));
+            }
+        }
+    }
+}
+
+bool FHktReliableUdpServer::UpdateReceivedState(uint32 IncomingSequence, TSharedPtr<FClientConnection> Connection)
+{
+    FScopeLock Lock(&Connection->Mutex);
+
+    // 시퀀스 번호가 순환해도 올바르게 비교되도록 부호 있는 거리로 판단
+    const int32 Diff = HktSequence::Distance(IncomingSequence, Connection->ReceivedSequence);
+    if (Diff <= -32 || Diff == 0)
+    {
+        return false; // 너무 오래되었거나 중복된 패킷은 무시
+    }
+
+    if (Diff > 0)
+    {
+        // 정상 순서로 패킷 도착
+        Connection->ReceivedAckBitfield = (Diff >= 32) ? 1 : (Connection->ReceivedAckBitfield << Diff) | 1;
+        Connection->ReceivedSequence = IncomingSequence;
+    }
+    else
+    {
+        // 순서가 뒤바뀌어 패킷 도착 (Out-of-order). 이미 표시된 비트면 재전송된 중복
+        const uint32 Bit = 1u << (-Diff - 1);
+        if (Connection->ReceivedAckBitfield & Bit)
+        {
+            return false;
+        }
+        Connection->ReceivedAckBitfield |= Bit;
+    }
+    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Receive state updated for %s. Last Rcvd Seq: %u, Rcvd Bits: %u"), *Connection->Address->ToString(true), Connection->ReceivedSequence, Connection->ReceivedAckBitfield);
+    return true;
+}
+
+
+void FHktReliableUdpServer::CheckForResends(FHktNetTickBudgetTracker& Tracker)
+{
+    double CurrentTime = HktNetClock::Seconds();
+    TArray<FString> ClientsToDisconnect;
+    TArray<uint32> DueSequences;
+
+    // 모든 연결된 클라이언트를 순회. 연결 목록은 복사해 두고 연결마다 자신의 잠금만 잡음.
+    // 시간 예산을 다 쓰면 멈추고 다음 Tick에 이어서 검사하도록, 매번 지난번에 멈춘 연결부터 시작
+    const TArray<TSharedPtr<FClientConnection>> AllConnections = GetAllConnections();
+    const int32 NumConnections = AllConnections.Num();
+    const int32 FirstIndex = NumConnections > 0 ? ResendCursor % NumConnections : 0;
+    for (int32 Checked = 0; Checked < NumConnections; ++Checked)
+    {
+        if (Checked > 0 && Tracker.IsTimeUp())
+        {
+            ResendCursor = FirstIndex + Checked;
+            break;
+        }
+        const TSharedPtr<FClientConnection>& Connection = AllConnections[(FirstIndex + Checked) % NumConnections];
+        FScopeLock Lock(&Connection->Mutex);
+
+        // 재전송 허용량을 송신 대역폭만큼 충전. 최대 ResendBurstTime 동안의 양까지만 쌓아 두어, 재개 직후처럼
+        // 밀린 패킷이 많아도 한 번에 쏟아내지 않고 여러 Tick에 나누어 보냄
+        const int64 MaxAllowance = FMath::Max<int64>((int64)(SendBandwidth * ResendBurstTime), HktPacketHeader::MaxSize);
+        Connection->ResendAllowance = FMath::Min<int64>(MaxAllowance,
+            Connection->ResendAllowance + (int64)((CurrentTime - Connection->ResendRefillTime) * SendBandwidth));
+        Connection->ResendRefillTime = CurrentTime;
+
+        // 재전송할 때가 된 패킷을 모아 오래된 시퀀스부터 보냄. 맵 순서대로 보내다 허용량이 바닥나면
+        // 해시 순서상 뒤에 있는 오래된 패킷이 계속 밀려 수신 측의 순서 대기가 길어짐
+        DueSequences.Reset();
+        for (const auto& PacketElem : Connection->PendingAckPackets)
+        {
+            if (CurrentTime - PacketElem.Value.SentTime > ResendTimeout)
+            {
+                DueSequences.Add(PacketElem.Key);
+            }
+        }
+        DueSequences.Sort([](uint32 A, uint32 B) { return HktSequence::IsNewer(B, A); });
+
+        for (uint32 Sequence : DueSequences)
+        {
+            // 허용량을 다 쓰면 남은 패킷은 다음 Tick에 재전송
+            if (Connection->ResendAllowance <= 0)
+            {
+                break;
+            }
+
+            // 최대 재전송 횟수 초과 시 연결 종료 목록에 추가
+            FPendingPacket& PendingPacket = Connection->PendingAckPackets[Sequence];
+            if (PendingPacket.Retries >= MaxRetries)
+            {
+                ClientsToDisconnect.Add(Connection->Address->ToString(true));
+                break;
+            }
+
+            // 패킷 재전송
+            const int32 ResendSize = PendingPacket.PacketData.Num() - PendingPacket.HeaderOffset;
+            SendDatagram(PendingPacket.PacketData.GetData() + PendingPacket.HeaderOffset, ResendSize, *Connection->Address);
+            Connection->GameplayBytesSent.fetch_add(ResendSize, std::memory_order_relaxed);
+            Connection->ResendAllowance -= ResendSize;
+
+            PendingPacket.SentTime = CurrentTime;
+            PendingPacket.Retries++;
+            UE_LOG(LogHktCustomNetServer, Warning, TEXT("Packet timeout. Resending (Seq:%u) to %s, Retry: %d/%d"), Sequence, *Connection->Address->ToString(true), PendingPacket.Retries, MaxRetries);
+        }
+    }
+
+    // 재전송 초과로 연결을 끊어야 할 클라이언트가 있다면 처리
+    if (ClientsToDisconnect.Num() > 0)
+    {
+        for (const FString& AddrStr : ClientsToDisconnect)
+        {
+            SuspendClient(AddrStr, TEXT("Packet resend limit exceeded. Not responding."));
+        }
+    }
+}
+
+void FHktReliableUdpServer::CheckForTimeouts()
+{
+    const double CurrentTime = HktNetClock::Seconds();
     TArray<FString> TimedOutClients;
 
     {
-        FScopeLock Lock(&ConnectionMutex);
-        // 모든 연결된 클라이언트를 순회하며 타임아웃 검사
-        for (const auto& Elem : Connections)
+        FReadScopeLock Lock(ConnectionsLock);
+        // 모든 연결된 클라이언트를 순회하며 타임아웃 검사
+        for (const auto& Elem : Connections)
+        {
+            const FString& ClientAddrStr = Elem.Key;
+            const TSharedPtr<FClientConnection>& Connection = Elem.Value;
+
+            if (CurrentTime - Connection->LastReceiveTime > ClientTimeoutDuration)
+            {
+                TimedOutClients.Add(ClientAddrStr);
+                UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s timed out."), *ClientAddrStr);
+            }
+        }
+    }
+
+    // 타임아웃된 클라이언트들의 세션을 일시 중단 (세션 재개를 쓰지 않으면 연결 종료)
+    for (const FString& ClientAddrStr : TimedOutClients)
+    {
+        SuspendClient(ClientAddrStr, TEXT("Connection timed out."));
+    }
+
+    ExpireSuspendedSessions();
+}
+
+
+bool FHktReliableUdpServer::FilterHandshakePacket(const uint8* Data, int32 Size, const TSharedRef<FInternetAddr>& PeerAddr)
+{
+    // 이 함수는 'UdpServerReceiverThread' 스레드에서 실행됩니다.
+    // 헤더를 해석할 수 없는 패킷은 메인 스레드로 넘길 필요도 없이 버림.
+    // 핸드셰이크는 항상 v1이므로 종류와 크기만 보면 되고, v2 시퀀스 복원 기준은 필요 없음
+    FPacketHeader Header;
+    const int32 HeaderSize = HktPacketHeader::Decode(Data, Size, 0, 0, Header);
+    if (HeaderSize == 0)
+    {
+        return true;
+    }
+
+    const EPacketType Type = Header.Type;
+    const int32 PayloadSize = Size - HeaderSize;
+
+    if (Type == EPacketType::Connect)
+    {
+        // 증폭 공격 방지: 쿠키 크기만큼 패딩되지 않은 Connect 요청에는 응답하지 않음
+        if (PayloadSize >= (int32)sizeof(FHktConnectCookie))
+        {
+            SendConnectChallenge(*PeerAddr);
+        }
+        // Connect 패킷은 어떤 경우에도 메인 스레드로 전달하지 않음
+        return true;
+    }
+
+    if (Type == EPacketType::ConnectResponse)
+    {
+        // 쿠키만 있거나(v1 클라이언트) 쿠키 뒤에 최대 헤더 버전이 붙음
+        if (PayloadSize != (int32)sizeof(FHktConnectCookie) && PayloadSize != (int32)sizeof(FHktConnectCookie) + HktReliableUdp::HandshakeVersionSize)
+        {
+            return true;
+        }
+
+        FHktConnectCookie Cookie;
+        FMemory::Memcpy(&Cookie, Data + HeaderSize, sizeof(FHktConnectCookie));
+        // 검증에 실패한 쿠키는 메인 스레드까지 오지 않도록 여기서 버림
+        return !VerifyConnectCookie(*PeerAddr, Cookie);
+    }
+
+    return false;
+}
+
+void FHktReliableUdpServer::SendConnectChallenge(const FInternetAddr& Addr)
+{
+    FPacketHeader ChallengeHeader;
+    ChallengeHeader.Type = EPacketType::ConnectChallenge;
+
+    FHktConnectCookie Cookie;
+    MakeConnectCookie(Addr, (uint32)HktNetClock::Seconds(), Cookie);
+
+    // 서버는 어떤 상태도 만들지 않고 쿠키만 돌려보냄
+    uint8 ChallengePacket[sizeof(FPacketHeader) + sizeof(FHktConnectCookie)];
+    FMemory::Memcpy(ChallengePacket, &ChallengeHeader, sizeof(FPacketHeader));
+    FMemory::Memcpy(ChallengePacket + sizeof(FPacketHeader), &Cookie, sizeof(FHktConnectCookie));
+
+    SendDatagram(ChallengePacket, sizeof(ChallengePacket), Addr);
+    UE_LOG(LogHktCustomNetServer, Verbose, TEXT("=> Sent [ConnectChallenge] to %s."), *Addr.ToString(true));
+}
+
+void FHktReliableUdpServer::MakeConnectCookie(const FInternetAddr& Addr, uint32 IssuedAt, FHktConnectCookie& OutCookie) const
+{
+    // 서명 대상: 발급 시각 + 포트 + IP
+    const int32 AddrPort = Addr.GetPort();
+    TArray<uint8, TInlineAllocator<32>> Message;
+    Message.Append(reinterpret_cast<const uint8*>(&IssuedAt), sizeof(uint32));
+    Message.Append(reinterpret_cast<const uint8*>(&AddrPort), sizeof(int32));
+    Message.Append(Addr.GetRawIp());
+
+    OutCookie.IssuedAt = IssuedAt;
+    FSHA1::HMACBuffer(CookieSecret, sizeof(CookieSecret), Message.GetData(), Message.Num(), OutCookie.Mac);
+}
+
+bool FHktReliableUdpServer::VerifyConnectCookie(const FInternetAddr& Addr, const FHktConnectCookie& Cookie) const
+{
+    // 만료되었거나 미래 시각으로 발급된 쿠키는 거부
+    const uint32 Now = (uint32)HktNetClock::Seconds();
+    if (Cookie.IssuedAt > Now || Now - Cookie.IssuedAt > HktReliableUdp::CookieLifetime)
+    {
+        return false;
+    }
+
+    FHktConnectCookie Expected;
+    MakeConnectCookie(Addr, Cookie.IssuedAt, Expected);
+
+    // 타이밍 공격을 피하기 위해 상수 시간으로 비교
+    uint8 Diff = 0;
+    for (int32 i = 0; i < UE_ARRAY_COUNT(Expected.Mac); ++i)
+    {
+        Diff |= Expected.Mac[i] ^ Cookie.Mac[i];
+    }
+    return Diff == 0;
+}
+
+void FHktReliableUdpServer::EnableGroupSnapshots(int32 GroupId, float Interval)
+{
+    FSnapshotGroupConfig& Config = SnapshotGroups.FindOrAdd(GroupId);
+    Config.Interval = Interval;
+    UE_LOG(LogHktCustomNetServer, Log, TEXT("Snapshot replication enabled for group %d (interval %.3f s)."), GroupId, Interval);
+}
+
+void FHktReliableUdpServer::DisableGroupSnapshots(int32 GroupId)
+{
+    SnapshotGroups.Remove(GroupId);
+}
+
+void FHktReliableUdpServer::SetSnapshotByteBudget(int32 GroupId, int32 BytesPerClient)
+{
+    if (FSnapshotGroupConfig* Config = SnapshotGroups.Find(GroupId))
+    {
+        Config->ByteBudget = FMath::Max(BytesPerClient, 0);
+    }
+}
+
+void FHktReliableUdpServer::UpdateSnapshots()
+{
+    if (!SnapshotProvider || SnapshotGroups.Num() == 0)
+    {
+        return;
+    }
+
+    const double CurrentTime = HktNetClock::Seconds();
+    for (auto& Elem : SnapshotGroups)
+    {
+        const int32 GroupId = Elem.Key;
+        FSnapshotGroupConfig& Config = Elem.Value;
+        if (CurrentTime - Config.LastSnapshotTime < Config.Interval)
+        {
+            continue;
+        }
+        // 첫 스냅샷이나 오래 멈췄다가 재개된 경우 우선순위가 한 번에 치솟지 않도록 경과 시간을 제한
+        const float DeltaTime = (float)FMath::Min(CurrentTime - Config.LastSnapshotTime, 1.0);
+        Config.LastSnapshotTime = CurrentTime;
+
+        // 1. 그룹 구성원 수집
+        const FGroupMembersPtr GroupMembers = GetGroupMembers(GroupId);
+        if (!GroupMembers || GroupMembers->Num() == 0)
+        {
+            continue;
+        }
+        const FGroupMembers& Members = *GroupMembers;
+
+        // 2. 그룹 상태 수집
+        TSharedPtr<FHktSnapshotFrame, ESPMode::ThreadSafe> Frame = MakeShared<FHktSnapshotFrame, ESPMode::ThreadSafe>();
+        Frame->GroupId = GroupId;
+        Frame->SnapshotId = Config.NextSnapshotId++;
+        SnapshotProvider(GroupId, Frame->Entities);
+
+        // 3. 클라이언트별로 마지막 Ack 스냅샷 대비 델타 전송.
+        // 같은 기준을 가진 클라이언트들은 같은 델타를 받으므로 기준 ID별로 한 번만 인코딩
+        TMap<uint32, TArray<uint8>> EncodedByBaseline;
+        if (Config.ByteBudget > 0)
+        {
+            // 예산이 있으면 클라이언트마다 보내는 개체가 다르므로 클라이언트별로 스냅샷을 만들고 인코딩
+            TMap<uint64, FHktReplicationSubject> Subjects;
+            if (ReplicationSubjectProvider)
+            {
+                ReplicationSubjectProvider(GroupId, Subjects);
+            }
+
+            for (const TSharedPtr<FClientConnection>& Member : Members)
+            {
+                FHktSnapshotHistory& History = Member->SnapshotHistories.FindOrAdd(GroupId);
+                FHktSnapshotFramePtr ClientFrame = BuildPrioritizedFrame(*Member, *Frame, Subjects, DeltaTime, Config.ByteBudget);
+                SendUnreliable(*Member, EPacketType::Snapshot, HktSnapshot::EncodeDelta(*ClientFrame, History.GetBaseline()));
+                History.Add(ClientFrame);
+            }
+        }
+        else
+        {
+            for (const TSharedPtr<FClientConnection>& Member : Members)
+            {
+                FHktSnapshotHistory& History = Member->SnapshotHistories.FindOrAdd(GroupId);
+                const FHktSnapshotFrame* Baseline = History.GetBaseline();
+                const uint32 BaselineId = Baseline ? Baseline->SnapshotId : 0;
+
+                TArray<uint8>* Encoded = EncodedByBaseline.Find(BaselineId);
+                if (Encoded == nullptr)
+                {
+                    Encoded = &EncodedByBaseline.Add(BaselineId, HktSnapshot::EncodeDelta(*Frame, Baseline));
+                }
+
+                SendUnreliable(*Member, EPacketType::Snapshot, *Encoded);
+                History.Add(Frame);
+            }
+        }
+
+        UE_LOG(LogHktCustomNetServer, Verbose, TEXT("Snapshot %u of group %d sent to %d clients (%d distinct deltas)."), Frame->SnapshotId, GroupId, Members.Num(), EncodedByBaseline.Num());
+    }
+}
+
+FHktSnapshotFramePtr FHktReliableUdpServer::BuildPrioritizedFrame(FClientConnection& Connection, const FHktSnapshotFrame& Frame, const TMap<uint64, FHktReplicationSubject>& Subjects, float DeltaTime, int32 ByteBudget)
+{
+    // 개체 하나를 델타에 담을 때 상태 바이트 외에 드는 대략적인 비용 (ID + 크기)
+    constexpr int32 EntryOverhead = 6;
+
+    FHktSnapshotHistory& History = Connection.SnapshotHistories.FindOrAdd(Frame.GroupId);
+    const FHktSnapshotFrame* Baseline = History.GetBaseline();
+    const FHktSnapshotFrame* Latest = History.Find(History.GetLatestId());
+
+    TSharedPtr<FHktSnapshotFrame, ESPMode::ThreadSafe> ClientFrame = MakeShared<FHktSnapshotFrame, ESPMode::ThreadSafe>();
+    ClientFrame->GroupId = Frame.GroupId;
+    ClientFrame->SnapshotId = Frame.SnapshotId;
+    ClientFrame->Entities.Reserve(Frame.Entities.Num());
+
+    TArray<FHktReplicationCandidate> Candidates;
+    // 후보가 선택되지 않았을 때 대신 담을 상태 (클라이언트가 이미 가졌거나 받고 있는 상태)
+    TArray<FHktSnapshotState> Fallbacks;
+    TArray<const FHktSnapshotState*> Currents;
+    int32 RemainingBudget = ByteBudget;
+
+    for (const auto& Elem : Frame.Entities)
+    {
+        const FHktSnapshotState* BaseState = Baseline ? Baseline->Entities.Find(Elem.Key) : nullptr;
+        if (BaseState && HktSnapshot::IsSameState(*BaseState, Elem.Value))
+        {
+            // 변경 없음: 델타에 포함되지 않음
+            ClientFrame->Entities.Add(Elem.Key, Elem.Value);
+            continue;
+        }
+
+        const int32 Cost = (Elem.Value.IsValid() ? Elem.Value->Num() : 0) + EntryOverhead;
+        const FHktSnapshotState* LatestState = Latest ? Latest->Entities.Find(Elem.Key) : nullptr;
+        if (LatestState && HktSnapshot::IsSameState(*LatestState, Elem.Value))
+        {
+            // 이미 보냈지만 아직 Ack되지 않은 최신 상태는 되돌리지 않도록 계속 포함하고 예산에서 먼저 차감
+            ClientFrame->Entities.Add(Elem.Key, Elem.Value);
+            RemainingBudget -= Cost;
+            continue;
+        }
+
+        FHktReplicationCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+        Candidate.SubjectId = Elem.Key;
+        if (const FHktReplicationSubject* Subject = Subjects.Find(Elem.Key))
+        {
+            Candidate.Subject = *Subject;
+        }
+        Candidate.Size = Cost;
+        Fallbacks.Add(LatestState ? *LatestState : (BaseState ? *BaseState : FHktSnapshotState()));
+        Currents.Add(&Elem.Value);
+    }
+
+    // 클라이언트의 관심 위치가 있으면 거리를 반영
+    FVector ViewLocation;
+    bool bHasViewLocation = false;
+    {
+        FReadScopeLock Lock(InterestLock);
+        if (const FVector* Location = InterestGrid.FindLocation(Connection.ConnectionId))
+        {
+            ViewLocation = *Location;
+            bHasViewLocation = true;
+        }
+    }
+
+    TArray<int32> Selected;
+    FHktReplicationPrioritizer& Prioritizer = Connection.SnapshotPrioritizers.FindOrAdd(Frame.GroupId);
+    Prioritizer.Select(bHasViewLocation ? &ViewLocation : nullptr, Candidates, DeltaTime, FMath::Max(RemainingBudget, 0), Selected);
+
+    TBitArray<> bSelected(false, Candidates.Num());
+    for (int32 Index : Selected)
+    {
+        bSelected[Index] = true;
+    }
+    for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+    {
+        // 선택되지 않은 개체는 클라이언트가 알고 있는 상태를 유지. 처음 보는 개체면 아직 포함하지 않음
+        const FHktSnapshotState& State = bSelected[Index] ? *Currents[Index] : Fallbacks[Index];
+        if (State.IsValid())
+        {
+            ClientFrame->Entities.Add(Candidates[Index].SubjectId, State);
+        }
+    }
+
+    return ClientFrame;
+}
+
+void FHktReliableUdpServer::UpdateMtuProbes()
+{
+    if (!bMtuDiscoveryActive)
+    {
+        return;
+    }
+
+    const double Now = HktNetClock::Seconds();
+    for (const TSharedPtr<FClientConnection>& Connection : GetAllConnections())
+    {
+        int32 ProbeSize;
         {
-            const FString& ClientAddrStr = Elem.Key;
-            const TSharedPtr<FClientConnection>& Connection = Elem.Value;
+            FScopeLock Lock(&Connection->Mutex);
+            ProbeSize = Connection->MtuProber.Tick(Now);
+        }
+        if (ProbeSize <= 0)
+        {
+            continue;
+        }
 
-            if (CurrentTime - Connection->LastReceiveTime > ClientTimeoutDuration)
+        // 데이터그램 전체가 탐침 크기가 되도록 0으로 채움
+        const uint16 ProbeSize16 = (uint16)ProbeSize;
+        TArray<uint8> Payload;
+        Payload.Append((const uint8*)&ProbeSize16, sizeof(uint16));
+        SendUnreliable(*Connection, EPacketType::MtuProbe, Payload, ProbeSize);
+    }
+}
+
+uint32 FHktReliableUdpServer::SendBulk(const TSharedPtr<FInternetAddr>& DstAddr, TArray<uint8>&& Data, uint32 StartOffset)
+{
+    if (!DstAddr.IsValid() || Data.Num() == 0 || StartOffset >= (uint32)Data.Num() || (uint32)Data.Num() > FHktBulkReceiver::MaxTransferSize)
+    {
+        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Invalid bulk transfer. Size: %d, StartOffset: %u"), Data.Num(), StartOffset);
+        return 0;
+    }
+
+    TSharedPtr<FClientConnection> Connection = FindConnection(DstAddr->ToString(true));
+    if (!Connection)
+    {
+        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Attempted to send bulk data to an unknown client %s."), *DstAddr->ToString(true));
+        return 0;
+    }
+
+    const uint32 TransferId = NextBulkTransferId++;
+    UE_LOG(LogHktCustomNetServer, Log, TEXT("Bulk transfer %u to %s queued. %d bytes from offset %u."), TransferId, *DstAddr->ToString(true), Data.Num(), StartOffset);
+    Connection->BulkSender.Add(TransferId, MoveTemp(Data), StartOffset);
+    return TransferId;
+}
+
+bool FHktReliableUdpServer::GetBulkProgress(const TSharedPtr<FInternetAddr>& ClientAddr, uint32 TransferId, uint32& OutAckedBytes, uint32& OutTotalBytes) const
+{
+    TSharedPtr<FClientConnection> Connection = ClientAddr ? FindConnection(ClientAddr->ToString(true)) : nullptr;
+    return Connection && Connection->BulkSender.GetProgress(TransferId, OutAckedBytes, OutTotalBytes);
+}
+
+void FHktReliableUdpServer::UpdateBulkTransfers()
+{
+    // 연결이 끊겨 중단된 전송 통지
+    if (AbortedBulkTransfers.Num() > 0)
+    {
+        TArray<TPair<TSharedPtr<FInternetAddr>, uint32>> Aborted = MoveTemp(AbortedBulkTransfers);
+        for (const TPair<TSharedPtr<FInternetAddr>, uint32>& Elem : Aborted)
+        {
+            UE_LOG(LogHktCustomNetServer, Warning, TEXT("Bulk transfer %u to %s aborted."), Elem.Value, *Elem.Key->ToString(true));
+            if (BulkCompleteCallback)
             {
-                TimedOutClients.Add(ClientAddrStr);
-                UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s timed out."), *ClientAddrStr);
+                BulkCompleteCallback(Elem.Key, Elem.Value, false);
             }
         }
     }
 
-    // 타임아웃된 클라이언트들의 연결을 종료
-    for (const FString& ClientAddrStr : TimedOutClients)
+    // 일시 중단된 세션은 목록에 없으므로 보내지 않음. 재개되면 마지막 Ack 지점부터 이어서 보냄
+    const double Now = HktNetClock::Seconds();
+    for (const TSharedPtr<FClientConnection>& Connection : GetAllConnections())
+    {
+        FHktBulkSender& Sender = Connection->BulkSender;
+        Sender.Refill(Now, SendBandwidth, Connection->GameplayBytesSent.load(std::memory_order_relaxed));
+        if (!Sender.HasTransfers())
+        {
+            continue;
+        }
+
+        int32 MaxChunkSize;
+        {
+            FScopeLock Lock(&Connection->Mutex);
+            MaxChunkSize = Connection->MtuProber.GetPathMtu() - HktPacketHeader::MaxSize - (int32)sizeof(FHktBulkChunkHeader);
+        }
+
+        // 청크 데이터를 헤더 자리 뒤에 바로 복사하여 보냄
+        FHktBulkChunkHeader ChunkHeader;
+        const uint8* ChunkData;
+        int32 ChunkSize;
+        while (Sender.NextChunk(Now, MaxChunkSize, ChunkHeader, ChunkData, ChunkSize))
+        {
+            TArray<uint8> PacketData = HktPacketPool::Acquire(HktPacketHeader::MaxSize + sizeof(FHktBulkChunkHeader) + ChunkSize);
+            PacketData.AddUninitialized(HktPacketHeader::MaxSize);
+            PacketData.Append(reinterpret_cast<const uint8*>(&ChunkHeader), sizeof(FHktBulkChunkHeader));
+            PacketData.Append(ChunkData, ChunkSize);
+            SendPreparedUnreliable(*Connection, EPacketType::BulkData, MoveTemp(PacketData));
+        }
+    }
+}
+
+uint8 FHktReliableUdpServer::GetHeaderVersion(const TSharedPtr<FInternetAddr>& ClientAddr) const
+{
+    TSharedPtr<FClientConnection> Connection = ClientAddr ? FindConnection(ClientAddr->ToString(true)) : nullptr;
+    return Connection ? Connection->HeaderVersion : 0;
+}
+
+bool FHktReliableUdpServer::FitsPathMtu(FClientConnection& Connection, int32 DatagramSize, EPacketType Type)
+{
+    // DF가 없으면 큰 데이터그램은 커널이 조각내어 보냄
+    if (!bMtuDiscoveryActive)
+    {
+        return true;
+    }
+
+    int32 PathMtu;
+    {
+        FScopeLock Lock(&Connection.Mutex);
+        PathMtu = Connection.MtuProber.GetPathMtu();
+    }
+    if (DatagramSize <= PathMtu)
+    {
+        return true;
+    }
+
+    // DF가 설정된 소켓은 경로 MTU보다 큰 데이터그램을 EMSGSIZE로 거부하거나 경로에서 버려지므로,
+    // 재전송 목록에 넣으면 같은 패킷만 되풀이하다 연결이 끊김
+    UE_LOG(LogHktCustomNetServer, Error, TEXT("Dropped %d byte packet of type %d to %s. It exceeds the path MTU %d and MTU discovery disables fragmentation."),
+        DatagramSize, (int32)Type, *Connection.Address->ToString(true), PathMtu);
+    return false;
+}
+
+int32 FHktReliableUdpServer::GetPathMtu(const TSharedPtr<FInternetAddr>& ClientAddr) const
+{
+    TSharedPtr<FClientConnection> Connection = ClientAddr ? FindConnection(ClientAddr->ToString(true)) : nullptr;
+    if (!Connection)
     {
-        DisconnectClient(ClientAddrStr, TEXT("Connection timed out."));
+        return FHktMtuProber::SafeMtu;
     }
+
+    FScopeLock Lock(&Connection->Mutex);
+    return Connection->MtuProber.GetPathMtu();
+}
+
+void FHktReliableUdpServer::SendUnreliable(FClientConnection& Connection, EPacketType Type, const TArray<uint8>& Payload, int32 PadToSize)
+{
+    if (!CanSend()) return;
+
+    TArray<uint8> PacketData = HktPacketPool::Acquire(HktPacketHeader::MaxSize + FMath::Max(Payload.Num(), PadToSize));
+    PacketData.AddUninitialized(HktPacketHeader::MaxSize);
+    PacketData.Append(Payload);
+    SendPreparedUnreliable(Connection, Type, MoveTemp(PacketData), PadToSize);
 }
 
+void FHktReliableUdpServer::SendPreparedUnreliable(FClientConnection& Connection, EPacketType Type, TArray<uint8>&& PacketData, int32 PadToSize)
+{
+    if (!CanSend())
+    {
+        HktPacketPool::Release(MoveTemp(PacketData));
+        return;
+    }
+
+    FPacketHeader Header;
+    Header.Type = Type;
+    {
+        FScopeLock Lock(&Connection.Mutex);
+        // 일시 중단된 세션의 주소는 유효하지 않을 수 있고 비신뢰 패킷은 재개 후 다시 보낼 필요도 없음
+        if (Connection.bSuspended)
+        {
+            HktPacketPool::Release(MoveTemp(PacketData));
+            return;
+        }
+        // 비신뢰 패킷은 시퀀스 번호를 쓰지 않지만 Ack 정보는 함께 실어 보냄 (Piggybacking Ack)
+        Header.LastAckedSequence = Connection.ReceivedSequence;
+        Header.AckBitfield = Connection.ReceivedAckBitfield;
+    }
+
+    // 탐침은 경로 MTU보다 큰 것이 목적이므로 검사하지 않음
+    if (Type != EPacketType::MtuProbe && !FitsPathMtu(Connection, PacketData.Num(), Type))
+    {
+        HktPacketPool::Release(MoveTemp(PacketData));
+        return;
+    }
+
+    check(PacketData.Num() >= HktPacketHeader::MaxSize);
+    const int32 HeaderOffset = HktPacketHeader::EncodeInPlace(Header, Connection.HeaderVersion, PacketData.GetData());
+    if (PadToSize > PacketData.Num() - HeaderOffset)
+    {
+        PacketData.AddZeroed(PadToSize - (PacketData.Num() - HeaderOffset));
+    }
+
+    SendDatagram(PacketData.GetData() + HeaderOffset, PacketData.Num() - HeaderOffset, *Connection.Address);
+    if (Type != EPacketType::BulkData)
+    {
+        Connection.GameplayBytesSent.fetch_add(PacketData.Num() - HeaderOffset, std::memory_order_relaxed);
+    }
+    HktPacketPool::Release(MoveTemp(PacketData));
+}
 
-void FHktReliableUdpServer::HandleNewConnection(const TSharedPtr<FInternetAddr>& NewAddr)
+void FHktReliableUdpServer::HandleNewConnection(const TSharedPtr<FInternetAddr>& NewAddr, uint8 ClientMaxVersion)
 {
-    FScopeLock Lock(&ConnectionMutex);
     FString AddrStr = NewAddr->ToString(true);
-    if (!Connections.Contains(AddrStr))
+    TSharedPtr<FClientConnection> NewConnection;
     {
+        FWriteScopeLock Lock(ConnectionsLock);
+        if (Connections.Contains(AddrStr))
+        {
+            return;
+        }
+
         // 새로운 클라이언트를 위한 Connection 정보 생성
-        TSharedPtr<FClientConnection> NewConnection = MakeShared<FClientConnection>();
+        NewConnection = MakeShared<FClientConnection>();
+        NewConnection->ConnectionId = NextConnectionId++;
         NewConnection->Address = NewAddr;
-        NewConnection->LastReceiveTime = FPlatformTime::Seconds();
+        NewConnection->HeaderVersion = FMath::Clamp<uint8>(FMath::Min(ClientMaxVersion, MaxHeaderVersion), HktPacketHeader::Version1, HktPacketHeader::LatestVersion);
+        NewConnection->LastReceiveTime = HktNetClock::Seconds();
+        if (SessionGracePeriod > 0.0f)
+        {
+            MakeSessionToken(NewConnection->ConnectionId, NewConnection->SessionToken);
+            Sessions.Add(NewConnection->SessionToken, NewConnection);
+        }
+        if (bMtuDiscoveryActive)
+        {
+            NewConnection->MtuProber.Start(NewConnection->LastReceiveTime);
+        }
         // Connections 맵에 등록
         Connections.Add(AddrStr, NewConnection);
-        UE_LOG(LogHktCustomNetServer, Log, TEXT("New client connected: %s. Total clients: %d"), *AddrStr, Connections.Num());
-
-        // 연결 수락 의미로 Ack 전송 (Handshake 완료)
-        SendAck(NewConnection);
+        RateLimiter.QueueExemption(*NewAddr, true);
+        NewConnection->Slot = FreeConnectionSlots.Num() > 0 ? FreeConnectionSlots.Pop() : NumConnectionSlots++;
+        ConnectionsById.Add(NewConnection->ConnectionId, NewConnection);
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("New client connected: %s (header v%d). Total clients: %d"), *AddrStr, NewConnection->HeaderVersion, Connections.Num());
     }
+
+    // 연결 수락 의미로 Ack 전송 (Handshake 완료)
+    SendHandshakeAck(NewConnection);
 }
 
 void FHktReliableUdpServer::DisconnectClient(const FString& ClientAddrStr, const FString& Reason)
 {
-    FScopeLock Lock(&ConnectionMutex);
     TSharedPtr<FClientConnection> Connection;
-    if (Connections.RemoveAndCopyValue(ClientAddrStr, Connection))
     {
+        FWriteScopeLock Lock(ConnectionsLock);
+        Connection = Connections.FindRef(ClientAddrStr);
+        if (!Connection)
+        {
+            return;
+        }
+
+        RemoveConnection(Connection);
         UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s disconnected. Reason: %s. Total clients: %d"), *ClientAddrStr, *Reason, Connections.Num());
-        
-        // 클라이언트가 속해있던 모든 그룹에서 제거
-        for (int32 GroupId : Connection->GroupIds)
+    }
+
+    FWriteScopeLock Lock(InterestLock);
+    InterestGrid.Remove(Connection->ConnectionId);
+}
+
+void FHktReliableUdpServer::RemoveConnection(const TSharedPtr<FClientConnection>& Connection)
+{
+    const FString AddrStr = Connection->Address->ToString(true);
+    if (Connections.FindRef(AddrStr) == Connection)
+    {
+        Connections.Remove(AddrStr);
+        RateLimiter.QueueExemption(*Connection->Address, false);
+    }
+    ConnectionsById.Remove(Connection->ConnectionId);
+    Sessions.Remove(Connection->SessionToken);
+
+    // 클라이언트가 속해있던 모든 그룹에서 제거
+    for (int32 GroupId : Connection->GroupIds)
+    {
+        RemoveGroupMember(GroupId, Connection);
+    }
+    // 그룹에서 빠진 뒤에 연결 번호를 반환하여 다른 연결이 다시 씀
+    if (Connection->Slot != INDEX_NONE)
+    {
+        FreeConnectionSlots.Add(Connection->Slot);
+        Connection->Slot = INDEX_NONE;
+    }
+
+    // 진행 중이던 벌크 전송은 중단. 잠금 밖에서 통지하도록 다음 Tick으로 미룸
+    TArray<uint32> Aborted;
+    Connection->BulkSender.Abort(Aborted);
+    for (uint32 TransferId : Aborted)
+    {
+        AbortedBulkTransfers.Emplace(Connection->Address, TransferId);
+    }
+}
+
+void FHktReliableUdpServer::SuspendClient(const FString& ClientAddrStr, const FString& Reason)
+{
+    const TSharedPtr<FClientConnection> Found = FindConnection(ClientAddrStr);
+    if (!Found)
+    {
+        return;
+    }
+    // 세션 토큰 없이 연결된 클라이언트는 다시 붙을 방법이 없으므로 바로 해제
+    if (SessionGracePeriod <= 0.0f || !Found->SessionToken.IsValid())
+    {
+        DisconnectClient(ClientAddrStr, Reason);
+        return;
+    }
+
+    FWriteScopeLock Lock(ConnectionsLock);
+    TSharedPtr<FClientConnection> Connection;
+    if (!Connections.RemoveAndCopyValue(ClientAddrStr, Connection))
+    {
+        return;
+    }
+    RateLimiter.QueueExemption(*Connection->Address, false);
+
+    // 주소 목록에서만 빼고 연결 ID, 세션, 그룹 소속은 그대로 둠. 그 주소는 새 연결이 쓸 수 있음
+    {
+        FScopeLock ConnectionLock(&Connection->Mutex);
+        Connection->bSuspended = true;
+        Connection->SuspendTime = HktNetClock::Seconds();
+    }
+    UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s suspended. Reason: %s. Session kept for %.1f s."), *ClientAddrStr, *Reason, SessionGracePeriod);
+}
+
+void FHktReliableUdpServer::ExpireSuspendedSessions()
+{
+    // bSuspended와 SuspendTime은 메인 스레드에서만 바뀌므로 읽기 잠금으로 먼저 찾음
+    const double CurrentTime = HktNetClock::Seconds();
+    TArray<TSharedPtr<FClientConnection>> Expired;
+    {
+        FReadScopeLock Lock(ConnectionsLock);
+        for (const auto& Elem : Sessions)
         {
-            if (TMap<FString, TSharedPtr<FInternetAddr>>* GroupMembers = Groups.Find(GroupId))
+            const TSharedPtr<FClientConnection>& Connection = Elem.Value;
+            if (Connection->bSuspended && (CurrentTime - Connection->SuspendTime > SessionGracePeriod || Connection->bPendingOverflow.load(std::memory_order_relaxed)))
             {
-                GroupMembers->Remove(ClientAddrStr);
-
-                if (GroupMembers->Num() == 0)
-                {
-                    Groups.Remove(GroupId);
-                }
+                Expired.Add(Connection);
             }
         }
     }
+    if (Expired.Num() == 0)
+    {
+        return;
+    }
+
+    {
+        FWriteScopeLock Lock(ConnectionsLock);
+        for (const TSharedPtr<FClientConnection>& Connection : Expired)
+        {
+            RemoveConnection(Connection);
+            UE_LOG(LogHktCustomNetServer, Log, TEXT("Suspended session of %s expired."), *Connection->Address->ToString(true));
+        }
+    }
+
+    FWriteScopeLock Lock(InterestLock);
+    for (const TSharedPtr<FClientConnection>& Connection : Expired)
+    {
+        InterestGrid.Remove(Connection->ConnectionId);
+    }
+}
+
+void FHktReliableUdpServer::HandleResume(const TSharedPtr<FInternetAddr>& PeerAddr, const FPacketHeader& Header, const uint8* Payload, int32 PayloadSize)
+{
+    if (PayloadSize != HktReliableUdp::ResumePayloadSize)
+    {
+        return;
+    }
+
+    FHktSessionToken Token;
+    FMemory::Memcpy(Token.Bytes, Payload, sizeof(FHktSessionToken));
+    FHktConnectCookie Cookie;
+    FMemory::Memcpy(&Cookie, Payload + sizeof(FHktSessionToken), sizeof(FHktConnectCookie));
+    const FString NewAddrStr = PeerAddr->ToString(true);
+
+    TSharedPtr<FClientConnection> Connection;
+    EResumeResult Result = TryResume(Token, PeerAddr, NewAddrStr, false, Connection);
+    if (Result == EResumeResult::NeedsVerification)
+    {
+        // 쿠키 검증(HMAC)과 챌린지 전송은 ConnectionsLock을 놓은 뒤에 함.
+        // 검증하는 동안 세션이 만료되거나 다른 주소로 옮겨졌을 수 있으므로 통과하면 잠금 안에서 다시 확인하고 옮김
+        if (!VerifyConnectCookie(*PeerAddr, Cookie))
+        {
+            SendConnectChallenge(*PeerAddr);
+            return;
+        }
+        Result = TryResume(Token, PeerAddr, NewAddrStr, true, Connection);
+    }
+
+    if (Result == EResumeResult::AddressInUse)
+    {
+        UE_LOG(LogHktCustomNetServer, Warning, TEXT("Resume from %s rejected. Address is in use by another connection."), *NewAddrStr);
+        return;
+    }
+    if (Result == EResumeResult::UnknownSession)
+    {
+        // 유예 시간이 지났거나 모르는 토큰. 클라이언트가 처음부터 다시 연결하도록 알림 (요청보다 작으므로 증폭 없음)
+        FPacketHeader DisconnectHeader;
+        DisconnectHeader.Type = EPacketType::Disconnect;
+        SendDatagram(reinterpret_cast<const uint8*>(&DisconnectHeader), sizeof(FPacketHeader), *PeerAddr);
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("Resume from %s rejected. Unknown or expired session."), *NewAddrStr);
+        return;
+    }
+
+    // Resume은 v1 헤더라 Ack가 32비트 그대로이므로, 받은 것은 정리하고 나머지는 이번 Tick의 재전송 검사부터 대역폭에 맞춰 재전송
+    ProcessAck(Header, Connection);
+    SendUnreliable(*Connection, EPacketType::ResumeAck, TArray<uint8>());
+    MarkAllPendingForResend(*Connection);
+}
+
+FHktReliableUdpServer::EResumeResult FHktReliableUdpServer::TryResume(const FHktSessionToken& Token, const TSharedPtr<FInternetAddr>& PeerAddr, const FString& NewAddrStr, bool bAddressVerified, TSharedPtr<FClientConnection>& OutConnection)
+{
+    FWriteScopeLock Lock(ConnectionsLock);
+    const TSharedPtr<FClientConnection> Connection = Sessions.FindRef(Token);
+    // 중단된 동안 재전송 대기 목록이 넘친 세션은 재전송 순서를 지킬 수 없으므로 만료된 것으로 취급
+    if (!Connection || Connection->bPendingOverflow.load(std::memory_order_relaxed))
+    {
+        return EResumeResult::UnknownSession;
+    }
+
+    // 새 주소를 이미 다른 연결이 쓰고 있다면 그 연결이 우선
+    const TSharedPtr<FClientConnection> Existing = Connections.FindRef(NewAddrStr);
+    if (Existing && Existing != Connection)
+    {
+        return EResumeResult::AddressInUse;
+    }
+
+    // 주소가 바뀌었으면 토큰만으로는 옮기지 않음. 새 주소가 실제로 응답을 받을 수 있는지 쿠키로 확인해야
+    // 토큰을 엿본 제3자가 세션을 가로채거나 재전송을 다른 주소로 돌리지 못함
+    const FString OldAddrStr = Connection->Address->ToString(true);
+    if (OldAddrStr != NewAddrStr && !bAddressVerified)
+    {
+        return EResumeResult::NeedsVerification;
+    }
+
+    // 이전 주소 대신 새 주소로 등록하고 재개
+    if (Connections.FindRef(OldAddrStr) == Connection)
+    {
+        Connections.Remove(OldAddrStr);
+        RateLimiter.QueueExemption(*Connection->Address, false);
+    }
+    {
+        FScopeLock ConnectionLock(&Connection->Mutex);
+        Connection->Address = PeerAddr;
+        Connection->bSuspended = false;
+    }
+    Connection->LastReceiveTime = HktNetClock::Seconds();
+    Connections.Add(NewAddrStr, Connection);
+    RateLimiter.QueueExemption(*PeerAddr, true);
+    if (OldAddrStr != NewAddrStr)
+    {
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s resumed its session from %s."), *OldAddrStr, *NewAddrStr);
+    }
+    OutConnection = Connection;
+    return EResumeResult::Resumed;
+}
+
+void FHktReliableUdpServer::MarkAllPendingForResend(FClientConnection& Connection)
+{
+    // 보낸 시간을 재전송 시간보다 넉넉히 앞당겨 다음 검사에서 바로 재전송 대상이 되도록 함
+    FScopeLock Lock(&Connection.Mutex);
+    const double DueTime = HktNetClock::Seconds() - 2.0 * ResendTimeout;
+    for (auto& PacketElem : Connection.PendingAckPackets)
+    {
+        FPendingPacket& PendingPacket = PacketElem.Value;
+        PendingPacket.SentTime = DueTime;
+        PendingPacket.Retries = 0;
+    }
+}
+
+void FHktReliableUdpServer::MakeSessionToken(uint64 ConnectionId, FHktSessionToken& OutToken) const
+{
+    // 서명 대상: 연결 ID + 무작위 GUID. 비밀키를 모르면 다른 연결의 토큰을 추측할 수 없음
+    const FGuid Nonce = FGuid::NewGuid();
+    uint8 Message[sizeof(uint64) + sizeof(FGuid)];
+    FMemory::Memcpy(Message, &ConnectionId, sizeof(uint64));
+    FMemory::Memcpy(Message + sizeof(uint64), &Nonce, sizeof(FGuid));
+
+    uint8 Mac[20];
+    FSHA1::HMACBuffer(CookieSecret, sizeof(CookieSecret), Message, sizeof(Message), Mac);
+    FMemory::Memcpy(OutToken.Bytes, Mac, sizeof(OutToken.Bytes));
 }
 
 
 void FHktReliableUdpServer::JoinGroup(const TSharedPtr<FInternetAddr>& ClientAddr, int32 GroupId)
 {
-    FScopeLock Lock(&ConnectionMutex);
+    FWriteScopeLock Lock(ConnectionsLock);
     FString AddrStr = ClientAddr->ToString(true);
     if (TSharedPtr<FClientConnection> Connection = Connections.FindRef(AddrStr))
     {
@@ -464,11 +1893,15 @@ void FHktReliableUdpServer::JoinGroup(const TSharedPtr<FInternetAddr>& ClientAdd
         // 클라이언트의 그룹 목록에 추가
         Connection->GroupIds.Add(GroupId);
 
-        // 전체 그룹 목록에 클라이언트 추가
-        TMap<FString, TSharedPtr<FInternetAddr>>& GroupMembers = Groups.FindOrAdd(GroupId);
-        GroupMembers.Add(AddrStr, ClientAddr);
+        // 기존 구성원 목록을 복사한 새 목록으로 교체. 이미 목록을 들고 순회 중인 쪽에는 영향 없음
+        FGroupMembersPtr& GroupMembers = Groups.FindOrAdd(GroupId);
+        TSharedRef<FGroupMembers, ESPMode::ThreadSafe> NewMembers = GroupMembers
+            ? MakeShared<FGroupMembers, ESPMode::ThreadSafe>(*GroupMembers)
+            : MakeShared<FGroupMembers, ESPMode::ThreadSafe>();
+        NewMembers->Add(Connection);
+        GroupMembers = NewMembers;
 
-        UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s joined group %d. Group now has %d members."), *AddrStr, GroupId, GroupMembers.Num());
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s joined group %d. Group now has %d members."), *AddrStr, GroupId, NewMembers->Num());
     }
     else
     {
@@ -478,7 +1911,7 @@ void FHktReliableUdpServer::JoinGroup(const TSharedPtr<FInternetAddr>& ClientAdd
 
 void FHktReliableUdpServer::LeaveGroup(const TSharedPtr<FInternetAddr>& ClientAddr, int32 GroupId)
 {
-    FScopeLock Lock(&ConnectionMutex);
+    FWriteScopeLock Lock(ConnectionsLock);
     FString AddrStr = ClientAddr->ToString(true);
     if (TSharedPtr<FClientConnection> Connection = Connections.FindRef(AddrStr))
     {
@@ -491,21 +1924,12 @@ void FHktReliableUdpServer::LeaveGroup(const TSharedPtr<FInternetAddr>& ClientAd
 
         // 클라이언트의 그룹 목록에서 제거
         Connection->GroupIds.Remove(GroupId);
+        Connection->SnapshotHistories.Remove(GroupId);
+        Connection->SnapshotPrioritizers.Remove(GroupId);
 
         // 전체 그룹 목록에서 클라이언트 제거
-        if (TMap<FString, TSharedPtr<FInternetAddr>>* GroupMembers = Groups.Find(GroupId))
-        {
-            GroupMembers->Remove(AddrStr);
-
-            UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s left group %d. Group now has %d members."), *AddrStr, GroupId, GroupMembers->Num());
-
-            // 그룹이 비었다면 맵에서 제거
-            if (GroupMembers->Num() == 0)
-            {
-                Groups.Remove(GroupId);
-                UE_LOG(LogHktCustomNetServer, Log, TEXT("Group %d is now empty and has been removed."), GroupId);
-            }
-        }
+        RemoveGroupMember(GroupId, Connection);
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("Client %s left group %d."), *AddrStr, GroupId);
     }
      else
     {
@@ -513,19 +1937,108 @@ void FHktReliableUdpServer::LeaveGroup(const TSharedPtr<FInternetAddr>& ClientAd
     }
 }
 
+void FHktReliableUdpServer::RemoveGroupMember(int32 GroupId, const TSharedPtr<FClientConnection>& Connection)
+{
+    FGroupMembersPtr* GroupMembers = Groups.Find(GroupId);
+    if (GroupMembers == nullptr || !GroupMembers->IsValid())
+    {
+        return;
+    }
+
+    TSharedRef<FGroupMembers, ESPMode::ThreadSafe> NewMembers = MakeShared<FGroupMembers, ESPMode::ThreadSafe>(**GroupMembers);
+    NewMembers->RemoveSingleSwap(Connection);
+
+    // 그룹이 비었다면 맵에서 제거
+    if (NewMembers->Num() == 0)
+    {
+        Groups.Remove(GroupId);
+        UE_LOG(LogHktCustomNetServer, Log, TEXT("Group %d is now empty and has been removed."), GroupId);
+    }
+    else
+    {
+        *GroupMembers = NewMembers;
+    }
+}
+
+int32 FHktReliableUdpServer::GetNumConnections() const
+{
+    FReadScopeLock Lock(ConnectionsLock);
+    return Connections.Num();
+}
+
+int32 FHktReliableUdpServer::GetNumSuspendedSessions() const
+{
+    FReadScopeLock Lock(ConnectionsLock);
+    int32 NumSuspended = 0;
+    for (const auto& Elem : Sessions)
+    {
+        NumSuspended += Elem.Value->bSuspended ? 1 : 0;
+    }
+    return NumSuspended;
+}
+
+TSharedPtr<FClientConnection> FHktReliableUdpServer::FindConnection(const FString& AddrStr) const
+{
+    FReadScopeLock Lock(ConnectionsLock);
+    return Connections.FindRef(AddrStr);
+}
+
+FHktReliableUdpServer::FGroupMembersPtr FHktReliableUdpServer::GetGroupMembers(int32 GroupId) const
+{
+    FReadScopeLock Lock(ConnectionsLock);
+    return Groups.FindRef(GroupId);
+}
+
+TArray<TSharedPtr<FClientConnection>> FHktReliableUdpServer::GetAllConnections() const
+{
+    FReadScopeLock Lock(ConnectionsLock);
+    TArray<TSharedPtr<FClientConnection>> Result;
+    Connections.GenerateValueArray(Result);
+    return Result;
+}
+
 void FHktReliableUdpServer::SendAck(TSharedPtr<FClientConnection> Connection)
 {
-    FScopeLock Lock(&ConnectionMutex);
+    if (!CanSend()) return;
+
     FPacketHeader AckHeader;
     AckHeader.Type = EPacketType::Ack;
     AckHeader.Sequence = 0; // Ack 패킷 자체는 시퀀스 번호가 필요 없음
-    AckHeader.LastAckedSequence = Connection->ReceivedSequence;
-    AckHeader.AckBitfield = Connection->ReceivedAckBitfield;
+    {
+        FScopeLock Lock(&Connection->Mutex);
+        AckHeader.LastAckedSequence = Connection->ReceivedSequence;
+        AckHeader.AckBitfield = Connection->ReceivedAckBitfield;
+    }
 
-    int32 BytesSent = 0;
-    ListenSocket->SendTo((uint8*)&AckHeader, sizeof(FPacketHeader), BytesSent, *Connection->Address);
+    uint8 AckPacket[HktPacketHeader::MaxSize];
+    const int32 AckSize = HktPacketHeader::Encode(AckHeader, Connection->HeaderVersion, AckPacket);
+
+    SendDatagram(AckPacket, AckSize, *Connection->Address);
+    Connection->GameplayBytesSent.fetch_add(AckSize, std::memory_order_relaxed);
     UE_LOG(LogHktCustomNetServer, Verbose, TEXT("=> Sent [Ack] to %s. Ack: %u, AckBits: %u"), *Connection->Address->ToString(true), AckHeader.LastAckedSequence, AckHeader.AckBitfield);
 }
 
+void FHktReliableUdpServer::SendHandshakeAck(TSharedPtr<FClientConnection> Connection)
+{
+    if (!CanSend()) return;
+
+    // 클라이언트는 이 패킷을 받기 전까지 협상 결과를 모르므로 항상 v1 헤더로 보냄.
+    // v1 클라이언트는 페이로드를 무시하므로 버전 바이트와 세션 토큰을 붙여도 호환됨
+    FPacketHeader AckHeader;
+    AckHeader.Type = EPacketType::Ack;
+
+    uint8 AckPacket[sizeof(FPacketHeader) + HktReliableUdp::HandshakeSessionSize];
+    FMemory::Memcpy(AckPacket, &AckHeader, sizeof(FPacketHeader));
+    AckPacket[sizeof(FPacketHeader)] = Connection->HeaderVersion;
+    int32 AckSize = sizeof(FPacketHeader) + HktReliableUdp::HandshakeVersionSize;
+    if (Connection->SessionToken.IsValid())
+    {
+        FMemory::Memcpy(AckPacket + AckSize, Connection->SessionToken.Bytes, sizeof(FHktSessionToken));
+        AckSize += sizeof(FHktSessionToken);
+    }
+
+    SendDatagram(AckPacket, AckSize, *Connection->Address);
+}
+
 
 
@@ -0,0 +1,68 @@
+#include "HktReplicationPrioritizer.h"
+
+FHktReplicationPrioritizer::FHktReplicationPrioritizer(float InDistanceScale)
+    : DistanceScale(FMath::Max(InDistanceScale, 1.0f))
+{
+}
+
+void FHktReplicationPrioritizer::Select(const FVector* ViewLocation, TArrayView<const FHktReplicationCandidate> Candidates, float DeltaTime, int32 ByteBudget, TArray<int32>& OutSelected)
+{
+    // 1. 우선순위 누적. 이번 호출 번호를 찍어 두고, 번호가 지난 항목(후보에서 빠진 개체)은 누적값을 버린 것으로 봄
+    ++Generation;
+    Heap.Reset(Candidates.Num());
+    for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+    {
+        const FHktReplicationCandidate& Candidate = Candidates[Index];
+        if (Candidate.Subject.Relevance <= 0.0f)
+        {
+            continue;
+        }
+
+        const float Distance = ViewLocation ? FVector::Dist(*ViewLocation, Candidate.Subject.Location) : 0.0f;
+        const float Rate = Candidate.Subject.Relevance / (1.0f + Distance / DistanceScale);
+        FAccumulator& Accumulator = Accumulated.FindOrAdd(Candidate.SubjectId);
+        if (Accumulator.Generation != Generation - 1)
+        {
+            // 직전 호출에 후보가 아니었으면 새로 쌓기 시작
+            Accumulator.Priority = 0.0f;
+        }
+        Accumulator.Priority += DeltaTime * Rate;
+        Accumulator.Generation = Generation;
+        Heap.Add({ Accumulator.Priority, Index });
+    }
+
+    // 후보에서 빠진 개체가 쌓였을 때만 정리. 후보 집합이 그대로면 맵을 다시 만들지 않음
+    if (Accumulated.Num() > Heap.Num() * 2)
+    {
+        for (auto It = Accumulated.CreateIterator(); It; ++It)
+        {
+            if (It.Value().Generation != Generation)
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+
+    // 2. 우선순위가 높은 순으로 예산이 찰 때까지 꺼냄
+    auto HigherPriority = [](const FRankedCandidate& A, const FRankedCandidate& B)
+    {
+        return A.Priority > B.Priority;
+    };
+    Heap.Heapify(HigherPriority);
+
+    int32 RemainingBudget = ByteBudget;
+    while (Heap.Num() > 0)
+    {
+        const FRankedCandidate& Top = Heap.HeapTop();
+        const FHktReplicationCandidate& Candidate = Candidates[Top.Index];
+        if (Candidate.Size > RemainingBudget && OutSelected.Num() > 0)
+        {
+            break;
+        }
+
+        OutSelected.Add(Top.Index);
+        RemainingBudget -= Candidate.Size;
+        Accumulated.FindChecked(Candidate.SubjectId).Priority = 0.0f;
+        Heap.HeapPopDiscard(HigherPriority);
+    }
+}
@@ -0,0 +1,181 @@
+#include "HktSnapshot.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+const FHktSnapshotFrame* FHktSnapshotHistory::Find(uint32 SnapshotId) const
+{
+    for (const FHktSnapshotFramePtr& Frame : Frames)
+    {
+        if (Frame->SnapshotId == SnapshotId)
+        {
+            return Frame.Get();
+        }
+    }
+    return nullptr;
+}
+
+void FHktSnapshotHistory::Add(const FHktSnapshotFramePtr& Frame)
+{
+    Frames.Add(Frame);
+
+    while (Frames.Num() > HktSnapshot::MaxFrames)
+    {
+        // 기준 스냅샷은 Ack가 갱신될 때까지 유지해야 하므로 건너뜀
+        const int32 RemoveIndex = Frames[0]->SnapshotId == BaselineId ? 1 : 0;
+        Frames.RemoveAt(RemoveIndex);
+    }
+}
+
+void FHktSnapshotHistory::SetBaseline(uint32 SnapshotId)
+{
+    // 0은 기준 초기화 요청 (클라이언트가 기준을 잃어버린 경우)
+    if (SnapshotId == 0)
+    {
+        BaselineId = 0;
+        return;
+    }
+
+    // 순서가 뒤바뀌어 도착한 오래된 Ack는 무시
+    if (SnapshotId <= BaselineId || Find(SnapshotId) == nullptr)
+    {
+        return;
+    }
+
+    BaselineId = SnapshotId;
+    Frames.RemoveAll([SnapshotId](const FHktSnapshotFramePtr& Frame) { return Frame->SnapshotId < SnapshotId; });
+}
+
+FHktSnapshotState HktSnapshot::MakeState(TArray<uint8>&& Bytes)
+{
+    return MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Bytes));
+}
+
+bool HktSnapshot::IsSameState(const FHktSnapshotState& A, const FHktSnapshotState& B)
+{
+    // 같은 버퍼를 공유하고 있다면 내용을 비교할 필요가 없음
+    if (A == B)
+    {
+        return true;
+    }
+    if (!A.IsValid() || !B.IsValid())
+    {
+        return false;
+    }
+    return *A == *B;
+}
+
+TArray<uint8> HktSnapshot::EncodeDelta(const FHktSnapshotFrame& Current, const FHktSnapshotFrame* Baseline)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+
+    int32 GroupId = Current.GroupId;
+    uint32 SnapshotId = Current.SnapshotId;
+    uint32 BaselineId = Baseline ? Baseline->SnapshotId : 0;
+    Writer << GroupId << SnapshotId << BaselineId;
+
+    // 1. 기준 대비 추가되었거나 바뀐 개체
+    TArray<TPair<uint64, const TArray<uint8>*>, TInlineAllocator<64>> Changed;
+    static const TArray<uint8> EmptyState;
+    for (const auto& Elem : Current.Entities)
+    {
+        const FHktSnapshotState* BaseState = Baseline ? Baseline->Entities.Find(Elem.Key) : nullptr;
+        if (BaseState == nullptr || !IsSameState(*BaseState, Elem.Value))
+        {
+            Changed.Emplace(Elem.Key, Elem.Value.IsValid() ? Elem.Value.Get() : &EmptyState);
+        }
+    }
+
+    uint32 NumChanged = Changed.Num();
+    Writer.SerializeIntPacked(NumChanged);
+    for (const auto& Pair : Changed)
+    {
+        uint64 EntityId = Pair.Key;
+        uint32 StateSize = Pair.Value->Num();
+        Writer.SerializeIntPacked64(EntityId);
+        Writer.SerializeIntPacked(StateSize);
+        Writer.Serialize(const_cast<uint8*>(Pair.Value->GetData()), StateSize);
+    }
+
+    // 2. 기준에는 있었지만 사라진 개체
+    TArray<uint64, TInlineAllocator<64>> Removed;
+    if (Baseline)
+    {
+        for (const auto& Elem : Baseline->Entities)
+        {
+            if (!Current.Entities.Contains(Elem.Key))
+            {
+                Removed.Add(Elem.Key);
+            }
+        }
+    }
+
+    uint32 NumRemoved = Removed.Num();
+    Writer.SerializeIntPacked(NumRemoved);
+    for (uint64 EntityId : Removed)
+    {
+        Writer.SerializeIntPacked64(EntityId);
+    }
+
+    return Bytes;
+}
+
+bool HktSnapshot::ReadDeltaHeader(const uint8* Data, int32 Size, int32& OutGroupId, uint32& OutSnapshotId, uint32& OutBaselineId)
+{
+    FMemoryReaderView Reader(MakeArrayView(Data, Size));
+    Reader << OutGroupId << OutSnapshotId << OutBaselineId;
+    return !Reader.IsError();
+}
+
+bool HktSnapshot::DecodeDelta(const uint8* Data, int32 Size, const FHktSnapshotFrame* Baseline, FHktSnapshotFrame& OutFrame)
+{
+    FMemoryReaderView Reader(MakeArrayView(Data, Size));
+
+    int32 GroupId = 0;
+    uint32 SnapshotId = 0;
+    uint32 BaselineId = 0;
+    Reader << GroupId << SnapshotId << BaselineId;
+
+    // 델타가 요구하는 기준 스냅샷이 없으면 복원할 수 없음
+    if (Reader.IsError() || (BaselineId != 0 && (Baseline == nullptr || Baseline->SnapshotId != BaselineId)))
+    {
+        return false;
+    }
+
+    OutFrame.GroupId = GroupId;
+    OutFrame.SnapshotId = SnapshotId;
+    // 기준 스냅샷의 상태 버퍼들을 공유한 채로 시작
+    OutFrame.Entities = BaselineId != 0 ? Baseline->Entities : TMap<uint64, FHktSnapshotState>();
+
+    uint32 NumChanged = 0;
+    Reader.SerializeIntPacked(NumChanged);
+    for (uint32 i = 0; i < NumChanged && !Reader.IsError(); ++i)
+    {
+        uint64 EntityId = 0;
+        uint32 StateSize = 0;
+        Reader.SerializeIntPacked64(EntityId);
+        Reader.SerializeIntPacked(StateSize);
+
+        // 잘못된 크기로 인한 과도한 할당 방지
+        if (Reader.IsError() || (int64)StateSize > Reader.TotalSize() - Reader.Tell())
+        {
+            return false;
+        }
+
+        TArray<uint8> State;
+        State.SetNumUninitialized(StateSize);
+        Reader.Serialize(State.GetData(), StateSize);
+        OutFrame.Entities.Add(EntityId, MakeState(MoveTemp(State)));
+    }
+
+    uint32 NumRemoved = 0;
+    Reader.SerializeIntPacked(NumRemoved);
+    for (uint32 i = 0; i < NumRemoved && !Reader.IsError(); ++i)
+    {
+        uint64 EntityId = 0;
+        Reader.SerializeIntPacked64(EntityId);
+        OutFrame.Entities.Remove(EntityId);
+    }
+
+    return !Reader.IsError();
+}
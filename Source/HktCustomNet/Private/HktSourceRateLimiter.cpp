@@ -0,0 +1,111 @@
+#include "HktSourceRateLimiter.h"
+#include "IPAddress.h"
+
+void FHktSourceRateLimiter::Configure(double InRate, double InBurst, int32 InMaxSources)
+{
+    Rate = InRate;
+    Burst = FMath::Max(InBurst, 1.0);
+    MaxSources = FMath::Max(InMaxSources, 1);
+    Reset();
+}
+
+FHktSourceRateLimiter::EResult FHktSourceRateLimiter::Consume(const FInternetAddr& Addr, double Now)
+{
+    if (!IsEnabled())
+    {
+        return EResult::Allowed;
+    }
+
+    ApplyExemptions();
+    const uint64 Key = MakeKey(Addr);
+    if (Exemptions.Contains(Key))
+    {
+        return EResult::Allowed;
+    }
+
+    FBucket* Bucket = Buckets.Find(Key);
+    if (!Bucket)
+    {
+        if (Buckets.Num() >= MaxSources)
+        {
+            if (Now - LastPruneTime < PruneInterval)
+            {
+                return EResult::TooManySources;
+            }
+            Prune(Now);
+            if (Buckets.Num() >= MaxSources)
+            {
+                return EResult::TooManySources;
+            }
+        }
+        // 새 주소는 버킷이 가득 찬 상태에서 시작
+        Bucket = &Buckets.Add(Key);
+        Bucket->Tokens = Burst;
+        Bucket->LastTime = Now;
+    }
+    else
+    {
+        Bucket->Tokens = FMath::Min(Burst, Bucket->Tokens + (Now - Bucket->LastTime) * Rate);
+        Bucket->LastTime = Now;
+    }
+
+    if (Bucket->Tokens < 1.0)
+    {
+        return EResult::RateLimited;
+    }
+    Bucket->Tokens -= 1.0;
+    return EResult::Allowed;
+}
+
+void FHktSourceRateLimiter::QueueExemption(const FInternetAddr& Addr, bool bExempt)
+{
+    // 제한이 꺼져 있으면 Consume이 큐를 비우지 않으므로 쌓지 않음
+    if (!IsEnabled())
+    {
+        return;
+    }
+    PendingExemptions.Enqueue({ MakeKey(Addr), bExempt });
+}
+
+void FHktSourceRateLimiter::ApplyExemptions()
+{
+    FExemptionUpdate Update;
+    while (PendingExemptions.Dequeue(Update))
+    {
+        int32& Count = Exemptions.FindOrAdd(Update.Key);
+        Count += Update.bExempt ? 1 : -1;
+        if (Count <= 0)
+        {
+            Exemptions.Remove(Update.Key);
+        }
+        else if (Update.bExempt)
+        {
+            // 면제된 주소는 표에서 빼서 모르는 주소들의 자리를 차지하지 않게 함
+            Buckets.Remove(Update.Key);
+        }
+    }
+}
+
+void FHktSourceRateLimiter::Reset()
+{
+    Buckets.Reset();
+    LastPruneTime = -PruneInterval;
+}
+
+uint64 FHktSourceRateLimiter::MakeKey(const FInternetAddr& Addr)
+{
+    return ((uint64)Addr.GetTypeHash() << 16) ^ (uint64)(uint16)Addr.GetPort();
+}
+
+void FHktSourceRateLimiter::Prune(double Now)
+{
+    LastPruneTime = Now;
+    for (auto It = Buckets.CreateIterator(); It; ++It)
+    {
+        const FBucket& Bucket = It.Value();
+        if (Bucket.Tokens + (Now - Bucket.LastTime) * Rate >= Burst)
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
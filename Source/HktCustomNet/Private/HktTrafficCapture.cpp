@@ -0,0 +1,343 @@
+#include "HktTrafficCapture.h"
+#include "HktReliableUdpServer.h"
+#include "SocketSubsystem.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#define HKT_CAPTURE_WITH_MMAP (PLATFORM_UNIX || PLATFORM_MAC)
+
+#if HKT_CAPTURE_WITH_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogHktTrafficCapture, Log, All);
+
+using namespace HktTrafficCapture;
+
+FHktTrafficCaptureWriter::~FHktTrafficCaptureWriter()
+{
+    Close();
+}
+
+bool FHktTrafficCaptureWriter::Open(const FString& Path, int64 MaxBytes)
+{
+    Close();
+
+    MaxSize = FMath::Max<int64>(MaxBytes, sizeof(FFileHeader));
+    WriteOffset = 0;
+    StartTime = FPlatformTime::Seconds();
+    LastRecordMicros = 0;
+    PeerHandles.Reset();
+    NumDatagrams = 0;
+    NumDropped = 0;
+
+    const FString FullPath = FPaths::ConvertRelativePathToFull(Path);
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(FullPath), true);
+
+#if HKT_CAPTURE_WITH_MMAP
+    // 파일을 최대 크기로 늘린 뒤 매핑. 커널이 페이지를 필요할 때 할당하므로 실제로 쓴 만큼만 디스크를 사용
+    NativeFile = open(TCHAR_TO_UTF8(*FullPath), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (NativeFile >= 0)
+    {
+        if (ftruncate(NativeFile, MaxSize) == 0)
+        {
+            void* Mapped = mmap(nullptr, MaxSize, PROT_READ | PROT_WRITE, MAP_SHARED, NativeFile, 0);
+            if (Mapped != MAP_FAILED)
+            {
+                MappedData = static_cast<uint8*>(Mapped);
+                MappedSize = MaxSize;
+            }
+        }
+        if (!MappedData)
+        {
+            close(NativeFile);
+            NativeFile = -1;
+        }
+    }
+#endif
+
+    if (!MappedData)
+    {
+        FileWriter.Reset(IFileManager::Get().CreateFileWriter(*FullPath));
+        if (!FileWriter)
+        {
+            UE_LOG(LogHktTrafficCapture, Error, TEXT("Failed to open capture file %s"), *FullPath);
+            return false;
+        }
+    }
+
+    FFileHeader FileHeader;
+    FileHeader.Magic = Magic;
+    FileHeader.Version = Version;
+    FileHeader.Reserved = 0;
+    FileHeader.StartUnixTime = FDateTime::UtcNow().ToUnixTimestamp();
+    Append(&FileHeader, sizeof(FileHeader));
+
+    UE_LOG(LogHktTrafficCapture, Log, TEXT("Capturing received traffic to %s (max %lld bytes, mmap: %d)"), *FullPath, MaxSize, (int32)(MappedData != nullptr));
+    return true;
+}
+
+void FHktTrafficCaptureWriter::Close()
+{
+#if HKT_CAPTURE_WITH_MMAP
+    if (MappedData)
+    {
+        munmap(MappedData, MappedSize);
+        MappedData = nullptr;
+        MappedSize = 0;
+        // 미리 늘려 둔 파일을 실제로 기록한 크기로 줄임
+        ftruncate(NativeFile, WriteOffset);
+        close(NativeFile);
+        NativeFile = -1;
+    }
+#endif
+
+    if (FileWriter)
+    {
+        FileWriter->Close();
+        FileWriter.Reset();
+    }
+
+    if (NumDatagrams > 0 || NumDropped > 0)
+    {
+        UE_LOG(LogHktTrafficCapture, Log, TEXT("Capture closed. Datagrams: %d, Bytes: %lld, Dropped: %d"), NumDatagrams, WriteOffset, NumDropped);
+    }
+}
+
+void FHktTrafficCaptureWriter::WriteDatagram(const TSharedRef<FInternetAddr>& PeerAddr, const uint8* Data, int32 Size)
+{
+    if (!IsOpen() || Size <= 0 || Size > MAX_uint16)
+    {
+        return;
+    }
+
+    // 시작 시각 기준 누적 시간으로 차이를 구해 레코드마다 버림 오차가 쌓이지 않도록 함
+    const uint64 NowMicros = (uint64)((FPlatformTime::Seconds() - StartTime) * 1000000.0);
+    uint32 DeltaMicros = (uint32)FMath::Min<uint64>(NowMicros - FMath::Min(NowMicros, LastRecordMicros), MAX_uint32);
+
+    uint32 PeerHandle;
+    if (!FindOrAddPeer(PeerAddr, PeerHandle, DeltaMicros))
+    {
+        ++NumDropped;
+        return;
+    }
+
+    FRecordHeader Header;
+    Header.Kind = ERecordKind::Datagram;
+    Header.DeltaMicros = DeltaMicros;
+    Header.PeerHandle = PeerHandle;
+    Header.Size = (uint16)Size;
+    if (!AppendRecord(Header, Data))
+    {
+        ++NumDropped;
+        return;
+    }
+
+    LastRecordMicros = NowMicros;
+    ++NumDatagrams;
+}
+
+bool FHktTrafficCaptureWriter::FindOrAddPeer(const TSharedRef<FInternetAddr>& PeerAddr, uint32& OutHandle, uint32& InOutDeltaMicros)
+{
+    if (const uint32* Handle = PeerHandles.Find(PeerAddr))
+    {
+        OutHandle = *Handle;
+        return true;
+    }
+
+    const TArray<uint8> RawIp = PeerAddr->GetRawIp();
+    const uint16 PeerPort = (uint16)PeerAddr->GetPort();
+
+    TArray<uint8, TInlineAllocator<32>> Payload;
+    Payload.Add((uint8)RawIp.Num());
+    Payload.Append(RawIp);
+    Payload.Append(reinterpret_cast<const uint8*>(&PeerPort), sizeof(uint16));
+
+    FRecordHeader Header;
+    Header.Kind = ERecordKind::Peer;
+    Header.DeltaMicros = InOutDeltaMicros;
+    Header.PeerHandle = (uint32)PeerHandles.Num();
+    Header.Size = (uint16)Payload.Num();
+    if (!AppendRecord(Header, Payload.GetData()))
+    {
+        return false;
+    }
+
+    // 경과 시간은 Peer 레코드에 실었으므로 이어지는 데이터그램 레코드는 0
+    InOutDeltaMicros = 0;
+    OutHandle = Header.PeerHandle;
+    PeerHandles.Add(PeerAddr->Clone(), OutHandle);
+    return true;
+}
+
+bool FHktTrafficCaptureWriter::AppendRecord(const FRecordHeader& Header, const void* Payload)
+{
+    if (WriteOffset + (int64)sizeof(FRecordHeader) + Header.Size > MaxSize)
+    {
+        return false;
+    }
+    return Append(&Header, sizeof(FRecordHeader)) && Append(Payload, Header.Size);
+}
+
+bool FHktTrafficCaptureWriter::Append(const void* Data, int64 Size)
+{
+    if (WriteOffset + Size > MaxSize)
+    {
+        return false;
+    }
+
+    if (MappedData)
+    {
+        FMemory::Memcpy(MappedData + WriteOffset, Data, Size);
+    }
+    else if (FileWriter)
+    {
+        FileWriter->Serialize(const_cast<void*>(Data), Size);
+    }
+    else
+    {
+        return false;
+    }
+
+    WriteOffset += Size;
+    return true;
+}
+
+bool FHktTrafficReplay::Load(const FString& Path)
+{
+    FileData.Reset();
+    Records.Reset();
+    Peers.Reset();
+
+    if (!FFileHelper::LoadFileToArray(FileData, *Path))
+    {
+        UE_LOG(LogHktTrafficCapture, Error, TEXT("Failed to read capture file %s"), *Path);
+        return false;
+    }
+
+    FFileHeader FileHeader;
+    if (FileData.Num() < (int32)sizeof(FFileHeader))
+    {
+        return false;
+    }
+    FMemory::Memcpy(&FileHeader, FileData.GetData(), sizeof(FFileHeader));
+    if (FileHeader.Magic != Magic || FileHeader.Version != Version)
+    {
+        UE_LOG(LogHktTrafficCapture, Error, TEXT("Unsupported capture file %s (version %u)"), *Path, FileHeader.Version);
+        return false;
+    }
+
+    ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+    double Time = 0.0;
+    int32 Offset = sizeof(FFileHeader);
+    while (Offset + (int32)sizeof(FRecordHeader) <= FileData.Num())
+    {
+        FRecordHeader Header;
+        FMemory::Memcpy(&Header, FileData.GetData() + Offset, sizeof(FRecordHeader));
+        Offset += sizeof(FRecordHeader);
+        // 기록 도중 프로세스가 종료되면 미리 늘려 둔 0 영역이나 잘린 레코드가 남음. 빈 레코드는 기록하지 않으므로 거기서 끝냄
+        if (Header.Size == 0 || Offset + Header.Size > FileData.Num())
+        {
+            break;
+        }
+
+        Time += Header.DeltaMicros / 1000000.0;
+        const uint8* Payload = FileData.GetData() + Offset;
+
+        if (Header.Kind == ERecordKind::Peer)
+        {
+            const int32 IpLength = Header.Size > 0 ? Payload[0] : 0;
+            if (Header.PeerHandle != (uint32)Peers.Num() || Header.Size != 1 + IpLength + sizeof(uint16))
+            {
+                UE_LOG(LogHktTrafficCapture, Error, TEXT("Corrupted peer record in %s"), *Path);
+                return false;
+            }
+
+            TArray<uint8> RawIp;
+            RawIp.Append(Payload + 1, IpLength);
+            uint16 PeerPort;
+            FMemory::Memcpy(&PeerPort, Payload + 1 + IpLength, sizeof(uint16));
+
+            TSharedRef<FInternetAddr> PeerAddr = SocketSubsystem->CreateInternetAddr();
+            PeerAddr->SetRawIp(RawIp);
+            PeerAddr->SetPort(PeerPort);
+            Peers.Add(PeerAddr);
+        }
+        else if (Header.Kind == ERecordKind::Datagram && Peers.IsValidIndex((int32)Header.PeerHandle))
+        {
+            Records.Add({ Time, (int32)Header.PeerHandle, Offset, Header.Size });
+        }
+
+        Offset += Header.Size;
+    }
+
+    UE_LOG(LogHktTrafficCapture, Log, TEXT("Loaded capture %s. Datagrams: %d, Peers: %d, Duration: %.2fs"), *Path, Records.Num(), Peers.Num(), GetDuration());
+    return true;
+}
+
+FHktTrafficReplayStats FHktTrafficReplay::Replay(FHktReliableUdpServer& Server, float Speed, float TickInterval) const
+{
+    FHktTrafficReplayStats Stats;
+    if (Records.Num() == 0)
+    {
+        return Stats;
+    }
+
+    TickInterval = FMath::Max(TickInterval, 0.001f);
+    const double FirstTime = Records[0].Time;
+    const double WallStart = FPlatformTime::Seconds();
+    double NextTickTime = TickInterval;
+    int32 NumSinceTick = 0;
+
+    auto TickServer = [&]()
+    {
+        if (Speed > 0.0f)
+        {
+            // 기록된 시각에 맞춰 기다림
+            const double TargetWall = WallStart + NextTickTime / Speed;
+            const double Remaining = TargetWall - FPlatformTime::Seconds();
+            if (Remaining > 0.0)
+            {
+                FPlatformProcess::Sleep((float)Remaining);
+            }
+        }
+        Server.Tick();
+        ++Stats.NumTicks;
+        NumSinceTick = 0;
+    };
+
+    for (const FRecord& Record : Records)
+    {
+        const double RecordTime = Record.Time - FirstTime;
+        while (RecordTime >= NextTickTime)
+        {
+            // 최대 속도로 재생할 때는 패킷이 없는 구간의 빈 Tick을 건너뜀
+            if (Speed <= 0.0f && NumSinceTick == 0)
+            {
+                NextTickTime = (FMath::FloorToDouble(RecordTime / TickInterval) + 1.0) * TickInterval;
+                break;
+            }
+            TickServer();
+            NextTickTime += TickInterval;
+        }
+
+        TArray<uint8> Data;
+        Data.Append(FileData.GetData() + Record.Offset, Record.Size);
+        Server.EnqueueReceivedPacket(Peers[Record.PeerIndex], MoveTemp(Data));
+
+        ++NumSinceTick;
+        ++Stats.NumDatagrams;
+        Stats.NumBytes += Record.Size;
+    }
+    TickServer();
+
+    Stats.RecordedSeconds = GetDuration();
+    Stats.WallSeconds = FPlatformTime::Seconds() - WallStart;
+    return Stats;
+}
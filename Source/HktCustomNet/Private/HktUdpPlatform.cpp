@@ -0,0 +1,286 @@
+#include "HktUdpPlatform.h"
+#include "HktReliableUdpHeader.h"
+#include "Sockets.h"
+#include "IPAddress.h"
+
+#if HKT_WITH_UDP_OFFLOAD
+#include "BSDSockets/SocketsBSD.h"
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#ifndef IP_MTU_DISCOVER
+#define IP_MTU_DISCOVER 10
+#endif
+#ifndef IP_PMTUDISC_PROBE
+#define IP_PMTUDISC_PROBE 3
+#endif
+#ifndef IPV6_MTU_DISCOVER
+#define IPV6_MTU_DISCOVER 23
+#endif
+#ifndef IPV6_PMTUDISC_PROBE
+#define IPV6_PMTUDISC_PROBE 3
+#endif
+
+namespace
+{
+    int GetNativeHandle(FSocket* Socket)
+    {
+        return static_cast<int>(static_cast<FSocketBSD*>(Socket)->GetNativeSocket());
+    }
+
+    socklen_t ToSockAddr(const FInternetAddr& Addr, sockaddr_storage& OutStorage)
+    {
+        // GetRawIp는 네트워크 바이트 순서(상위 바이트 먼저)로 주소를 반환
+        const TArray<uint8> RawIp = Addr.GetRawIp();
+        FMemory::Memzero(OutStorage);
+
+        if (RawIp.Num() == 16)
+        {
+            sockaddr_in6* Addr6 = reinterpret_cast<sockaddr_in6*>(&OutStorage);
+            Addr6->sin6_family = AF_INET6;
+            Addr6->sin6_port = htons((uint16)Addr.GetPort());
+            FMemory::Memcpy(&Addr6->sin6_addr, RawIp.GetData(), 16);
+            return sizeof(sockaddr_in6);
+        }
+
+        sockaddr_in* Addr4 = reinterpret_cast<sockaddr_in*>(&OutStorage);
+        Addr4->sin_family = AF_INET;
+        Addr4->sin_port = htons((uint16)Addr.GetPort());
+        FMemory::Memcpy(&Addr4->sin_addr, RawIp.GetData(), FMath::Min(RawIp.Num(), 4));
+        return sizeof(sockaddr_in);
+    }
+
+    void FromSockAddr(const sockaddr_storage& Storage, FInternetAddr& OutAddr)
+    {
+        TArray<uint8> RawIp;
+        if (Storage.ss_family == AF_INET6)
+        {
+            const sockaddr_in6* Addr6 = reinterpret_cast<const sockaddr_in6*>(&Storage);
+            RawIp.Append(reinterpret_cast<const uint8*>(&Addr6->sin6_addr), 16);
+            OutAddr.SetRawIp(RawIp);
+            OutAddr.SetPort(ntohs(Addr6->sin6_port));
+        }
+        else
+        {
+            const sockaddr_in* Addr4 = reinterpret_cast<const sockaddr_in*>(&Storage);
+            RawIp.Append(reinterpret_cast<const uint8*>(&Addr4->sin_addr), 4);
+            OutAddr.SetRawIp(RawIp);
+            OutAddr.SetPort(ntohs(Addr4->sin_port));
+        }
+    }
+}
+
+bool HktUdpPlatform::EnableSendOffload(FSocket* Socket)
+{
+    if (!Socket)
+    {
+        return false;
+    }
+    // 세그먼트 크기 0으로 옵션을 설정해 보아 커널이 UDP_SEGMENT를 아는지 확인 (Linux 4.18+)
+    int SegmentSize = 0;
+    return setsockopt(GetNativeHandle(Socket), SOL_UDP, UDP_SEGMENT, &SegmentSize, sizeof(SegmentSize)) == 0;
+}
+
+bool HktUdpPlatform::EnableReceiveOffload(FSocket* Socket)
+{
+    if (!Socket)
+    {
+        return false;
+    }
+    // Linux 5.0+
+    int bEnable = 1;
+    return setsockopt(GetNativeHandle(Socket), SOL_UDP, UDP_GRO, &bEnable, sizeof(bEnable)) == 0;
+}
+
+bool HktUdpPlatform::SendSegmented(FSocket* Socket, const uint8* Data, int32 NumBytes, int32 SegmentSize, const FInternetAddr& Destination)
+{
+    sockaddr_storage Storage;
+    const socklen_t StorageSize = ToSockAddr(Destination, Storage);
+
+    iovec Iov;
+    Iov.iov_base = const_cast<uint8*>(Data);
+    Iov.iov_len = NumBytes;
+
+    alignas(cmsghdr) char Control[CMSG_SPACE(sizeof(uint16_t))];
+    FMemory::Memzero(Control);
+
+    msghdr Message;
+    FMemory::Memzero(Message);
+    Message.msg_name = &Storage;
+    Message.msg_namelen = StorageSize;
+    Message.msg_iov = &Iov;
+    Message.msg_iovlen = 1;
+    Message.msg_control = Control;
+    Message.msg_controllen = sizeof(Control);
+
+    cmsghdr* ControlMessage = CMSG_FIRSTHDR(&Message);
+    ControlMessage->cmsg_level = SOL_UDP;
+    ControlMessage->cmsg_type = UDP_SEGMENT;
+    ControlMessage->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    *reinterpret_cast<uint16_t*>(CMSG_DATA(ControlMessage)) = (uint16_t)SegmentSize;
+
+    return sendmsg(GetNativeHandle(Socket), &Message, 0) == NumBytes;
+}
+
+bool HktUdpPlatform::RecvCoalesced(FSocket* Socket, uint8* Data, int32 BufferSize, int32& OutBytesRead, int32& OutSegmentSize, FInternetAddr* OutSource)
+{
+    sockaddr_storage Storage;
+    FMemory::Memzero(Storage);
+
+    iovec Iov;
+    Iov.iov_base = Data;
+    Iov.iov_len = BufferSize;
+
+    alignas(cmsghdr) char Control[CMSG_SPACE(sizeof(int))];
+    FMemory::Memzero(Control);
+
+    msghdr Message;
+    FMemory::Memzero(Message);
+    Message.msg_name = &Storage;
+    Message.msg_namelen = sizeof(Storage);
+    Message.msg_iov = &Iov;
+    Message.msg_iovlen = 1;
+    Message.msg_control = Control;
+    Message.msg_controllen = sizeof(Control);
+
+    const ssize_t BytesRead = recvmsg(GetNativeHandle(Socket), &Message, MSG_DONTWAIT);
+    if (BytesRead <= 0)
+    {
+        return false;
+    }
+
+    OutBytesRead = (int32)BytesRead;
+    OutSegmentSize = OutBytesRead;
+
+    // 커널이 여러 데이터그램을 병합했다면 원래 데이터그램 크기가 UDP_GRO 제어 메시지로 전달됨
+    for (cmsghdr* ControlMessage = CMSG_FIRSTHDR(&Message); ControlMessage; ControlMessage = CMSG_NXTHDR(&Message, ControlMessage))
+    {
+        if (ControlMessage->cmsg_level == SOL_UDP && ControlMessage->cmsg_type == UDP_GRO)
+        {
+            OutSegmentSize = *reinterpret_cast<const int*>(CMSG_DATA(ControlMessage));
+            break;
+        }
+    }
+
+    if (OutSource)
+    {
+        FromSockAddr(Storage, *OutSource);
+    }
+    return true;
+}
+
+bool HktUdpPlatform::EnableDontFragment(FSocket* Socket)
+{
+    if (!Socket)
+    {
+        return false;
+    }
+    // 기본값(IP_PMTUDISC_WANT)은 커널이 경로 MTU를 줄여 알게 되면 그보다 큰 데이터그램을 DF 없이 조각내 보내므로
+    // 탐침이 조각나서 도착해도 성공으로 보일 수 있음. PROBE는 항상 DF를 설정하고 커널이 기억한 경로 MTU를 무시하여
+    // 탐침 크기 그대로 경로를 시험함. 듀얼 스택 소켓이면 IPv6 쪽도 설정
+    int Mode = IP_PMTUDISC_PROBE;
+    if (setsockopt(GetNativeHandle(Socket), IPPROTO_IP, IP_MTU_DISCOVER, &Mode, sizeof(Mode)) == 0)
+    {
+        Mode = IPV6_PMTUDISC_PROBE;
+        setsockopt(GetNativeHandle(Socket), IPPROTO_IPV6, IPV6_MTU_DISCOVER, &Mode, sizeof(Mode));
+        return true;
+    }
+    Mode = IPV6_PMTUDISC_PROBE;
+    return setsockopt(GetNativeHandle(Socket), IPPROTO_IPV6, IPV6_MTU_DISCOVER, &Mode, sizeof(Mode)) == 0;
+}
+
+#else
+
+bool HktUdpPlatform::EnableSendOffload(FSocket* Socket)
+{
+    return false;
+}
+
+bool HktUdpPlatform::EnableDontFragment(FSocket* Socket)
+{
+    return false;
+}
+
+bool HktUdpPlatform::EnableReceiveOffload(FSocket* Socket)
+{
+    return false;
+}
+
+bool HktUdpPlatform::SendSegmented(FSocket* Socket, const uint8* Data, int32 NumBytes, int32 SegmentSize, const FInternetAddr& Destination)
+{
+    return false;
+}
+
+bool HktUdpPlatform::RecvCoalesced(FSocket* Socket, uint8* Data, int32 BufferSize, int32& OutBytesRead, int32& OutSegmentSize, FInternetAddr* OutSource)
+{
+    return false;
+}
+
+#endif // HKT_WITH_UDP_OFFLOAD
+
+int32 HktUdpPlatform::SendBatch(FSocket* Socket, const TArray<TArray<uint8>>& Datagrams, const FInternetAddr& Destination, bool& bInOutUseOffload)
+{
+    int32 NumSyscalls = 0;
+    int32 Index = 0;
+    TArray<uint8> Coalesced;
+
+    while (Index < Datagrams.Num())
+    {
+        // GSO 규칙: 같은 크기의 세그먼트가 이어지고, 마지막 세그먼트만 더 작을 수 있음
+        const int32 SegmentSize = Datagrams[Index].Num();
+        int32 RunEnd = Index + 1;
+        int32 RunBytes = SegmentSize;
+        if (bInOutUseOffload)
+        {
+            while (RunEnd < Datagrams.Num()
+                && RunEnd - Index < MaxSegmentsPerSend
+                && RunBytes + Datagrams[RunEnd].Num() <= MaxBytesPerSend
+                && Datagrams[RunEnd].Num() <= SegmentSize)
+            {
+                RunBytes += Datagrams[RunEnd].Num();
+                // 더 작은 세그먼트는 묶음의 마지막이어야 함
+                if (Datagrams[RunEnd++].Num() < SegmentSize)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (RunEnd - Index > 1)
+        {
+            Coalesced.Reset(RunBytes);
+            for (int32 i = Index; i < RunEnd; ++i)
+            {
+                Coalesced.Append(Datagrams[i]);
+            }
+
+            ++NumSyscalls;
+            if (SendSegmented(Socket, Coalesced.GetData(), Coalesced.Num(), SegmentSize, Destination))
+            {
+                Index = RunEnd;
+                continue;
+            }
+
+            // 커널이나 NIC가 GSO를 거부하면 이후로는 일반 경로만 사용
+            UE_LOG(LogHktCustomNet, Warning, TEXT("UDP GSO send failed. Falling back to per-datagram sends."));
+            bInOutUseOffload = false;
+        }
+
+        int32 BytesSent = 0;
+        Socket->SendTo(Datagrams[Index].GetData(), Datagrams[Index].Num(), BytesSent, Destination);
+        ++NumSyscalls;
+        ++Index;
+    }
+
+    return NumSyscalls;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSocket;
+class FInternetAddr;
+
+/**
+ * 플랫폼별 UDP 오프로드(GSO/GRO) 기능을 감싸는 헬퍼.
+ * 지원하지 않는 플랫폼이나 커널에서는 모든 함수가 false를 반환하므로, 호출자는 일반 SendTo/RecvFrom 경로로 대체하면 됩니다.
+ */
+namespace HktUdpPlatform
+{
+    // 한 번의 GSO 전송에 담을 수 있는 최대 세그먼트 수와 바이트 수
+    constexpr int32 MaxSegmentsPerSend = 64;
+    constexpr int32 MaxBytesPerSend = 65000;
+
+    // UDP_SEGMENT(GSO) 지원 여부를 런타임에 검사
+    bool EnableSendOffload(FSocket* Socket);
+    // UDP_GRO를 활성화. 성공하면 이후 수신은 RecvCoalesced로 해야 함
+    bool EnableReceiveOffload(FSocket* Socket);
+
+    // 같은 크기의 세그먼트들을 이어 붙인 버퍼를 한 번의 시스템 콜로 전송. 마지막 세그먼트만 더 작을 수 있음
+    bool SendSegmented(FSocket* Socket, const uint8* Data, int32 NumBytes, int32 SegmentSize, const FInternetAddr& Destination);
+    // GRO가 켜진 소켓에서 수신. OutSegmentSize는 병합된 데이터그램 하나의 크기 (병합되지 않았으면 OutBytesRead와 같음)
+    bool RecvCoalesced(FSocket* Socket, uint8* Data, int32 BufferSize, int32& OutBytesRead, int32& OutSegmentSize, FInternetAddr* OutSource);
+
+    // 소켓이 보내는 모든 데이터그램에 DF(Don't Fragment)를 설정. 실패하면 경로 MTU 탐침 결과를 믿을 수 없음
+    bool EnableDontFragment(FSocket* Socket);
+
+    /**
+     * 여러 데이터그램을 같은 목적지로 전송합니다.
+     * bInOutUseOffload가 true이면 연속된 같은 크기의 데이터그램들을 GSO로 묶어 보내고,
+     * GSO 전송이 실패하면 bInOutUseOffload를 false로 바꾸고 나머지를 하나씩 전송합니다.
+     * @return 실제 호출한 전송 시스템 콜 수
+     */
+    int32 SendBatch(FSocket* Socket, const TArray<TArray<uint8>>& Datagrams, const FInternetAddr& Destination, bool& bInOutUseOffload);
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 벌크 전송 패킷의 페이로드 앞부분. 나머지는 Offset부터 이어지는 데이터
+#pragma pack(push, 1)
+struct FHktBulkChunkHeader
+{
+    // 연결 안에서 전송을 구분하는 ID
+    uint32 TransferId = 0;
+    // 전체 데이터 크기
+    uint32 TotalSize = 0;
+    // 이 전송이 시작된 오프셋. 받는 쪽이 이미 가진 앞부분은 보내지 않음
+    uint32 StartOffset = 0;
+    // 이 청크의 오프셋
+    uint32 Offset = 0;
+};
+
+// 받는 쪽이 StartOffset부터 빈틈없이 받은 끝 오프셋 (누적 Ack)
+struct FHktBulkAck
+{
+    uint32 TransferId = 0;
+    uint32 AckedOffset = 0;
+};
+#pragma pack(pop)
+
+/**
+ * 큰 데이터(초기 월드 상태, 리플레이, 에셋 목록 등)를 게임플레이 트래픽과 같은 연결로 보내는 벌크 전송의 송신 측.
+ * 게임플레이 신뢰성 스트림의 시퀀스와 재전송 목록을 쓰지 않고 자체 창(window)과 누적 Ack로 흐름을 제어합니다.
+ * - 대역폭: 연결의 송신 대역폭에서 게임플레이가 이미 쓴 바이트를 뺀 나머지 크레딧만큼만 보냅니다.
+ * - 창: 느린 시작 후 선형 증가, Ack가 재전송 시간 안에 오지 않으면 창을 반으로 줄이고 마지막 Ack 지점부터 다시 보냅니다 (Go-Back-N).
+ * - 재개: 진행 상태가 오프셋이므로 세션이 잠시 끊겨도 마지막 Ack 지점부터 이어서 보냅니다.
+ * 전송은 추가된 순서대로 하나씩 진행합니다. 메인 스레드에서만 사용합니다.
+ */
+class HKTCUSTOMNET_API FHktBulkSender
+{
+public:
+    static constexpr int32 InitialWindow = 16 * 1024;
+    static constexpr int32 MinWindow = 4 * 1024;
+    static constexpr int32 MaxWindow = 4 * 1024 * 1024;
+    // 이 시간 동안 Ack가 진전되지 않으면 손실로 보고 마지막 Ack 지점부터 다시 보냄 (초)
+    static constexpr double RetransmitTimeout = 0.3;
+    // 쓰지 않은 대역폭을 모아 둘 수 있는 최대 시간 (초). 한 번에 몰아 보내는 양을 제한함
+    static constexpr double MaxBurstTime = 0.05;
+
+    // 전송 추가. Data 전체 중 StartOffset 이후만 보냄
+    void Add(uint32 TransferId, TArray<uint8>&& Data, uint32 StartOffset);
+    bool HasTransfers() const { return Transfers.Num() > 0; }
+    int32 GetNumTransfers() const { return Transfers.Num(); }
+    int32 GetWindow() const { return Window; }
+
+    // 경과 시간만큼 크레딧을 채우고 그동안 게임플레이가 보낸 바이트를 뺌. GameplayBytesSent는 연결의 누적 값
+    void Refill(double Now, int32 BytesPerSecond, int64 GameplayBytesSent);
+    // 보낼 청크를 하나 정함. 창이나 크레딧이 부족하거나 보낼 것이 없으면 false. OutData는 다음 호출 전까지 유효
+    bool NextChunk(double Now, int32 MaxChunkSize, FHktBulkChunkHeader& OutHeader, const uint8*& OutData, int32& OutSize);
+    // 받는 쪽의 누적 Ack 처리. 완료된 전송 ID를 OutCompleted에 추가
+    void OnAck(const FHktBulkAck& Ack, double Now, TArray<uint32>& OutCompleted);
+    // 모든 전송을 중단하고 ID를 OutAborted에 추가
+    void Abort(TArray<uint32>& OutAborted);
+
+    // 전송 진행 상황. 없는 전송이면 false
+    bool GetProgress(uint32 TransferId, uint32& OutAckedBytes, uint32& OutTotalBytes) const;
+
+private:
+    struct FTransfer
+    {
+        uint32 TransferId = 0;
+        TArray<uint8> Data;
+        uint32 StartOffset = 0;
+        // 받는 쪽이 확인한 오프셋
+        uint32 AckedOffset = 0;
+        // 다음에 보낼 오프셋
+        uint32 NextOffset = 0;
+    };
+    // 맨 앞의 전송만 진행
+    TArray<FTransfer> Transfers;
+
+    // 응답을 기다리지 않고 보낼 수 있는 바이트 수
+    int32 Window = InitialWindow;
+    int32 SlowStartThreshold = MaxWindow;
+    // 최근에 보낸 청크 크기. 선형 증가 구간에서 왕복마다 늘릴 창 크기
+    int32 ChunkSize = 1200;
+    // 마지막으로 Ack가 진전된 (또는 창이 비어 있다가 보내기 시작한) 시간
+    double LastProgressTime = 0.0;
+
+    // 보낼 수 있는 바이트 수. 게임플레이가 많이 보냈다면 음수
+    double Credit = 0.0;
+    double LastRefillTime = 0.0;
+    int64 LastGameplayBytesSent = 0;
+};
+
+/**
+ * 벌크 전송의 수신 측. 순서대로 도착한 청크만 이어 붙이고 누적 오프셋으로 Ack합니다.
+ * 순서가 어긋난 청크는 버리며, 송신 측이 마지막 Ack 지점부터 다시 보냅니다.
+ */
+class HKTCUSTOMNET_API FHktBulkReceiver
+{
+public:
+    // 받을 수 있는 최대 전송 크기
+    static constexpr uint32 MaxTransferSize = 512 * 1024 * 1024;
+    // 동시에 받는 중일 수 있는 최대 전송 수
+    static constexpr int32 MaxIncomingTransfers = 8;
+    // 완료 후에도 중복 청크에 다시 Ack하기 위해 기억해 두는 전송 수
+    static constexpr int32 MaxCompletedHistory = 32;
+
+    // 청크 처리. 보낼 Ack를 OutAck에 채우며, 받을 수 없는 청크면 false.
+    // 이 청크로 전송이 끝났으면 bOutCompleted가 true이고 StartOffset 이후 데이터가 OutData로 옮겨짐
+    bool OnChunk(const FHktBulkChunkHeader& Header, const uint8* Data, int32 Size, FHktBulkAck& OutAck, bool& bOutCompleted, TArray<uint8>& OutData);
+
+    // 받는 중인 전송의 수신 바이트 수 (StartOffset 포함). 없으면 0
+    uint32 GetReceivedOffset(uint32 TransferId) const;
+    int32 GetNumIncoming() const { return Incoming.Num(); }
+
+    void Reset();
+
+private:
+    struct FIncoming
+    {
+        uint32 TotalSize = 0;
+        uint32 StartOffset = 0;
+        uint32 ReceivedOffset = 0;
+        TArray<uint8> Data;
+    };
+    TMap<uint32, FIncoming> Incoming;
+    // 최근 완료된 전송 ID와 전체 크기
+    TArray<TPair<uint32, uint32>> Completed;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 위치 기반 관심 영역(Interest Management)을 위한 균일 격자.
+ * 개체를 XY 평면의 셀에 배치하고, 반경 안의 개체만 빠르게 찾습니다.
+ * 셀 경계 근처에서 개체가 셀을 오가며 깜빡이지 않도록, 현재 셀 경계에서 Hysteresis 이상 벗어나야 셀을 옮깁니다.
+ */
+class HKTCUSTOMNET_API FHktInterestGrid
+{
+public:
+    explicit FHktInterestGrid(float InCellSize = 2000.0f, float InHysteresis = 200.0f);
+
+    // 개체 위치 갱신. 처음 보는 개체면 추가
+    void Update(uint64 Id, const FVector& Location);
+    // 개체 제거
+    void Remove(uint64 Id);
+    // 모든 개체 제거
+    void Reset();
+
+    // Center로부터 Radius 안에 있는 개체 ID를 OutIds에 추가 (실제 위치로 거리 검사)
+    void QueryRadius(const FVector& Center, float Radius, TArray<uint64>& OutIds) const;
+
+    const FVector* FindLocation(uint64 Id) const;
+    bool Contains(uint64 Id) const { return Entries.Contains(Id); }
+    int32 Num() const { return Entries.Num(); }
+    int32 GetNumCells() const { return Cells.Num(); }
+    // 지금까지 셀을 옮긴 횟수 (Hysteresis 효과 측정용)
+    int64 GetNumCellChanges() const { return NumCellChanges; }
+
+private:
+    struct FEntry
+    {
+        FVector Location;
+        FIntPoint Cell;
+        // Cells[Cell] 배열 안의 위치 (O(1) 제거용)
+        int32 IndexInCell = INDEX_NONE;
+    };
+
+    FIntPoint ToCell(const FVector& Location) const;
+    void AddToCell(uint64 Id, FEntry& Entry);
+    void RemoveFromCell(const FEntry& Entry);
+
+    float CellSize;
+    float Hysteresis;
+
+    TMap<uint64, FEntry> Entries;
+    TMap<FIntPoint, TArray<uint64>> Cells;
+    int64 NumCellChanges = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "IPAddress.h"
+#include <atomic>
+
+// 서버/클라이언트가 데이터그램을 주고받는 방식. Start/Connect 전에 설정
+enum class EHktNetTransport : uint8
+{
+    // 실제 UDP 소켓과 수신 스레드
+    Socket,
+    // 같은 프로세스 안의 메모리 큐. 시스템 콜과 수신 스레드 없이 Tick에서 바로 받음
+    Loopback
+};
+
+// 루프백으로 전달된 데이터그램. Data는 패킷 풀에서 꺼낸 버퍼이므로 다 쓰면 풀에 돌려주는 것이 좋음
+struct FHktLoopbackDatagram
+{
+    TArray<uint8> Data;
+    // 보낸 엔드포인트의 주소 (127.0.0.1:포트). 같은 엔드포인트가 보낸 데이터그램은 같은 주소 객체를 공유
+    TSharedPtr<FInternetAddr> Source;
+    // 받는 쪽 링크 대역폭을 모의할 때 이 데이터그램이 도착하는 HktNetClock 시각. 모의하지 않으면 0
+    double DeliverTime = 0.0;
+};
+
+/**
+ * 같은 프로세스 안의 루프백 전송 엔드포인트.
+ * 리슨 서버나 에디터 PIE처럼 서버와 클라이언트가 한 프로세스에 있을 때 소켓 대신 사용합니다.
+ * 엔드포인트는 포트로 전역 등록되며, SendTo는 목적지 포트의 엔드포인트 수신 큐(lock-free MPSC)에 풀 버퍼를 넣기만 합니다.
+ * 목적지 IP는 보지 않으므로 한 프로세스 안에서 포트가 겹치지 않아야 합니다.
+ * 목적지 포트에 엔드포인트가 없으면 UDP처럼 조용히 버립니다.
+ * SendTo는 여러 스레드에서 호출해도 되지만 Receive는 한 스레드에서만 호출해야 합니다.
+ * SetLinkBandwidth로 포트의 수신 링크 대역폭을 정하면 그 포트로 가는 데이터그램은 HktNetClock 기준으로
+ * 크기 / 대역폭만큼씩 차례로 도착하므로, 링크가 포화되었을 때의 대기 시간을 재현할 수 있습니다.
+ * SetLinkDown으로 포트의 수신 링크를 끊으면 그 포트로 가는 데이터그램을 조용히 버려 손실을 재현합니다.
+ */
+class HKTCUSTOMNET_API FHktLoopbackEndpoint
+{
+public:
+    // Port에 바인딩된 엔드포인트를 만듦. 이미 사용 중인 포트면 nullptr
+    static TUniquePtr<FHktLoopbackEndpoint> Bind(uint16 Port);
+    ~FHktLoopbackEndpoint();
+
+    FHktLoopbackEndpoint(const FHktLoopbackEndpoint&) = delete;
+    FHktLoopbackEndpoint& operator=(const FHktLoopbackEndpoint&) = delete;
+
+    uint16 GetPort() const { return Port; }
+    const TSharedRef<FInternetAddr>& GetAddress() const { return Address; }
+
+    // 데이터그램을 풀 버퍼에 복사하여 목적지 엔드포인트에 전달. 목적지가 없으면 false
+    bool SendTo(const uint8* Data, int32 Size, const FInternetAddr& Destination);
+    // 받은 데이터그램을 하나 꺼냄. 없거나 링크 모의상 아직 도착하지 않았으면 false
+    bool Receive(FHktLoopbackDatagram& OutDatagram);
+
+    // Port로 들어오는 링크의 대역폭 (바이트/초). 0이면 보내는 즉시 도착. 바인딩 전후 언제든 설정 가능하며 포트가 풀려도 유지됨
+    static void SetLinkBandwidth(uint16 Port, int32 BytesPerSecond);
+    // Port로 들어오는 링크를 끊거나 다시 이음. 끊긴 동안 그 포트로 보낸 데이터그램은 버려짐. 포트가 풀려도 유지됨
+    static void SetLinkDown(uint16 Port, bool bDown);
+
+    int64 GetNumSent() const { return NumSent; }
+    int64 GetNumReceived() const { return NumReceived; }
+
+private:
+    FHktLoopbackEndpoint(uint16 InPort, TSharedRef<FInternetAddr> InAddress);
+
+    const uint16 Port;
+    const TSharedRef<FInternetAddr> Address;
+    TQueue<FHktLoopbackDatagram, EQueueMode::Mpsc> Inbox;
+
+    // 수신 링크 모의 상태. 송신자들이 LinkMutex를 잡고 다음 데이터그램이 링크에 올라갈 수 있는 시각을 앞으로 밂
+    std::atomic<int32> LinkBandwidth{ 0 };
+    FCriticalSection LinkMutex;
+    double LinkFreeTime = 0.0;
+    std::atomic<bool> bLinkDown{ false };
+
+    std::atomic<int64> NumSent{ 0 };
+    int64 NumReceived = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 경로 MTU 탐색 (PLPMTUD, RFC 8899 방식).
+ * 패딩한 탐침 패킷을 보내 상대가 받았다고 응답한 가장 큰 데이터그램 크기를 찾습니다.
+ * 먼저 최대 크기를 탐침하고, 실패하면 이진 탐색으로 범위를 좁힙니다.
+ * 탐침이 응답 없이 여러 번 사라지면 그 크기는 경로를 통과하지 못한다고 보고 범위를 줄입니다.
+ * 탐색 전이나 탐침을 쓸 수 없는 환경에서는 안전한 최소값(1200)을 사용합니다.
+ * 크기는 모두 UDP 페이로드(헤더 포함 데이터그램) 기준입니다.
+ */
+class HKTCUSTOMNET_API FHktMtuProber
+{
+public:
+    // 어떤 경로든 통과한다고 가정하는 크기 (IPv6 최소 MTU 1280 - IPv6/UDP 헤더 여유)
+    static constexpr int32 SafeMtu = 1200;
+    // 이더넷 MTU 1500 - IPv4(20) - UDP(8)
+    static constexpr int32 MaxMtu = 1472;
+    // 탐색 종료 간격. 이보다 좁아지면 탐색을 끝냄
+    static constexpr int32 SearchGranularity = 8;
+    // 한 크기에 대한 최대 탐침 횟수
+    static constexpr int32 MaxProbeAttempts = 3;
+    // 탐침 응답 대기 시간 (초)
+    static constexpr double ProbeTimeout = 0.5;
+    // 탐색이 끝난 뒤 더 큰 MTU를 다시 찾아보는 주기 (초)
+    static constexpr double RaiseInterval = 600.0;
+
+    // 탐색 시작 (이미 확인된 MTU는 유지)
+    void Start(double Now);
+    // 탐색 중단. 확인된 MTU는 유지
+    void Stop() { bSearching = false; ProbeSize = 0; }
+
+    // 지금 보내야 할 탐침 크기를 반환. 보낼 것이 없으면 0
+    int32 Tick(double Now);
+    // 상대가 Size 크기의 탐침을 받았다고 응답함
+    void OnProbeAcked(int32 Size);
+
+    // 현재 확인된 경로 MTU
+    int32 GetPathMtu() const { return ConfirmedMtu; }
+    bool IsSearching() const { return bSearching; }
+
+private:
+    int32 ConfirmedMtu = SafeMtu;
+    // 통과하지 못한 것으로 판단된 가장 작은 크기 (탐색 상한, 미포함)
+    int32 FailedMtu = MaxMtu + 1;
+
+    bool bSearching = false;
+    // 현재 탐침 중인 크기 (0이면 없음)
+    int32 ProbeSize = 0;
+    int32 ProbeAttempts = 0;
+    double ProbeSentTime = 0.0;
+    double SearchDoneTime = 0.0;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 신뢰성 UDP 계층이 재전송, 타임아웃, 쿠키 만료 등에 쓰는 시계.
+ * 기본은 FPlatformTime::Seconds()이고, 가상 시간을 켜면 Advance로만 흐릅니다.
+ * 루프백 전송과 함께 쓰면 테스트가 실제로 기다리지 않고 타임아웃까지 재현할 수 있습니다.
+ * 프로세스 전역 시계이므로 가상 시간을 켜면 같은 프로세스의 모든 서버/클라이언트에 적용됩니다.
+ */
+namespace HktNetClock
+{
+    // 현재 시각 (초)
+    HKTCUSTOMNET_API double Seconds();
+
+    // 가상 시간을 켬. 진행 중인 연결의 시각이 뒤로 가지 않도록 현재 실제 시각에서 시작
+    HKTCUSTOMNET_API void EnableVirtualTime();
+    // 실제 시간으로 되돌림
+    HKTCUSTOMNET_API void DisableVirtualTime();
+    HKTCUSTOMNET_API bool IsVirtualTime();
+    // 가상 시간을 DeltaSeconds만큼 진행. 실제 시간을 쓰는 중이면 무시
+    HKTCUSTOMNET_API void Advance(double DeltaSeconds);
+}
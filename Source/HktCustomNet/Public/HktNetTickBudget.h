@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+// Tick 한 번에 쓸 수 있는 처리 예산. 0이면 제한 없음
+struct FHktNetTickBudget
+{
+    // 처리 시간 (초, 실제 시간)
+    double MaxSeconds = 0.0;
+    // 처리할 수신 패킷 수
+    int32 MaxPackets = 0;
+
+    FHktNetTickBudget() = default;
+    explicit FHktNetTickBudget(double InMaxSeconds, int32 InMaxPackets = 0)
+        : MaxSeconds(InMaxSeconds)
+        , MaxPackets(InMaxPackets)
+    {
+    }
+};
+
+// 마지막 Tick의 처리 결과와 다음 Tick으로 넘어간 수신 대기열 상태
+struct FHktNetTickStats
+{
+    // 처리한 수신 패킷 수
+    int32 ProcessedPackets = 0;
+    // 처리하지 못하고 남은 수신 패킷 수
+    int32 BacklogPackets = 0;
+    // 남은 패킷 중 가장 오래 기다린 패킷의 대기 시간 (초, HktNetClock)
+    double BacklogAge = 0.0;
+    // Tick에 걸린 실제 시간 (초)
+    double TickSeconds = 0.0;
+    // 예산을 다 썼는지 여부. 남은 수신 패킷, 재전송 검사, 벌크 전송은 다음 Tick으로 미룸
+    bool bBudgetExhausted = false;
+};
+
+// Tick 안에서 예산 소모를 추적
+class FHktNetTickBudgetTracker
+{
+public:
+    explicit FHktNetTickBudgetTracker(const FHktNetTickBudget& InBudget)
+        : Budget(InBudget)
+        , StartTime(FPlatformTime::Seconds())
+    {
+    }
+
+    // 수신 패킷을 하나 더 처리할 수 있는지 여부
+    bool CanProcessPacket()
+    {
+        if (IsTimeUp() || (Budget.MaxPackets > 0 && NumPackets >= Budget.MaxPackets))
+        {
+            bExhausted = true;
+            return false;
+        }
+        return true;
+    }
+    void OnPacketProcessed() { ++NumPackets; }
+
+    // 시간 예산을 다 썼는지 여부
+    bool IsTimeUp()
+    {
+        if (Budget.MaxSeconds > 0.0 && GetElapsed() >= Budget.MaxSeconds)
+        {
+            bExhausted = true;
+            return true;
+        }
+        return false;
+    }
+
+    double GetElapsed() const { return FPlatformTime::Seconds() - StartTime; }
+    int32 GetNumPackets() const { return NumPackets; }
+    bool IsExhausted() const { return bExhausted; }
+
+private:
+    FHktNetTickBudget Budget;
+    double StartTime;
+    int32 NumPackets = 0;
+    bool bExhausted = false;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "HktReliableUdpHeader.h"
+
+// 송신 패킷 버퍼 풀. 송신 후 Ack되었거나 보내고 버려진 버퍼를 재사용하여 메시지마다 할당하지 않도록 함
+namespace HktPacketPool
+{
+    // 최소 MinCapacity 용량의 빈 버퍼를 꺼냄
+    HKTCUSTOMNET_API TArray<uint8> Acquire(int32 MinCapacity);
+    // 다 쓴 버퍼를 풀에 돌려줌. 너무 크거나 풀이 가득 찼으면 그냥 해제
+    HKTCUSTOMNET_API void Release(TArray<uint8>&& Buffer);
+}
+
+/**
+ * 전송 버퍼에 바로 직렬화하는 패킷 작성기.
+ * 풀에서 꺼낸 버퍼 앞쪽에 헤더 자리를 비워 두고 페이로드를 그 뒤에 씁니다.
+ * Send(Writer)/SendTo(Addr, Writer)는 헤더 자리만 채워 그대로 보내므로 페이로드 배열을 따로 만들고 다시 복사하는 과정이 없습니다.
+ *
+ *   FHktPacketWriter Writer;
+ *   FHktStructSerializer::SerializeStructToArchive(Writer, Flagment);
+ *   Client->Send(Writer);
+ */
+class HKTCUSTOMNET_API FHktPacketWriter : public FArchive
+{
+public:
+    // 페이로드 앞에 비워 두는 헤더 자리 크기. 실제 헤더가 더 작으면 자리 끝에 맞춰 쓰고 그 위치부터 전송함
+    static constexpr int32 HeaderSize = HktPacketHeader::MaxSize;
+
+    explicit FHktPacketWriter(int32 ExpectedPayloadSize = 256);
+    virtual ~FHktPacketWriter();
+
+    FHktPacketWriter(const FHktPacketWriter&) = delete;
+    FHktPacketWriter& operator=(const FHktPacketWriter&) = delete;
+
+    // FArchive 인터페이스. 위치는 페이로드 시작 기준
+    virtual void Serialize(void* Data, int64 Num) override;
+    virtual int64 Tell() override { return Offset; }
+    virtual int64 TotalSize() override { return GetPayloadSize(); }
+    virtual void Seek(int64 InPos) override;
+    virtual FString GetArchiveName() const override { return TEXT("FHktPacketWriter"); }
+
+    int32 GetPayloadSize() const { return FMath::Max(Buffer.Num() - HeaderSize, 0); }
+    TArrayView<const uint8> GetPayload() const { return TArrayView<const uint8>(Buffer.GetData() + HeaderSize, GetPayloadSize()); }
+
+    // 전송 계층용: 헤더 자리가 포함된 버퍼의 소유권을 넘김. 이후 Writer는 비워지고 다시 쓰면 새 패킷이 시작됨
+    TArray<uint8> TakeBuffer();
+
+private:
+    void EnsureBuffer(int32 ExpectedPayloadSize);
+
+    TArray<uint8> Buffer;
+    int64 Offset = 0;
+};
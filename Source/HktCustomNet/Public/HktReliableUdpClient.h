@@ -1,6 +1,12 @@
 #pragma once
 
 #include "HktReliableUdpHeader.h"
+#include "HktSnapshot.h"
+#include "HktPacketWriter.h"
+#include "HktMtuProber.h"
+#include "HktLoopbackTransport.h"
+#include "HktBulkTransfer.h"
+#include "HktNetTickBudget.h"
 #include "HAL/Runnable.h"
 #include "HktReliableUdpServer.h" // For FPendingPacket
 
@@ -8,6 +14,9 @@ class FSocket;
 class FRunnableThread;
 class FInternetAddr;
 
+// 서버가 보낸 벌크 전송을 모두 받았을 때 호출 (전송 ID, 시작 오프셋, 시작 오프셋 이후 데이터)
+using FHktBulkReceivedCallback = TFunction<void(uint32 /*TransferId*/, uint32 /*StartOffset*/, TArray<uint8>&& /*Data*/)>;
+
 class HKTCUSTOMNET_API FHktReliableUdpClient : public FRunnable
 {
 public:
@@ -18,23 +27,74 @@ public:
     bool Connect(const FString& ServerIp, uint16 ServerPort, uint16 ClientPort = HktReliableUdp::ClientPort);
     // 연결 해제
     void Disconnect();
+    // 연결을 유지한 채 로컬 포트를 바꿈 (네트워크 전환 등). 새 주소에서 세션 토큰으로 바로 재개를 요청하며 1 RTT 안에 끝남
+    bool Rebind(uint16 NewClientPort);
     
-    // 서버로 데이터 전송
-    void Send(const TArray<uint8>& Data);
+    // 서버로 데이터 전송. CollapseKey가 있으면 같은 키로 보낸 이전 메시지가 Ack되지 않았어도 더 이상 재전송하지 않음.
+    // 대체된 메시지가 이미 전송 중이었다면 새 메시지보다 늦게 도착할 수 있으므로 받는 쪽에서 순서를 판단해야 함
+    void Send(const TArray<uint8>& Data, uint64 CollapseKey = HktCollapseKey::None);
+    // Writer에 직렬화한 페이로드를 복사 없이 전송. 전송 후 Writer는 비워짐
+    void Send(FHktPacketWriter& Writer, uint64 CollapseKey = HktCollapseKey::None);
+    // 서버로 여러 데이터를 연속으로 전송. 가능하면 UDP GSO로 묶어 한 번의 시스템 콜로 보냄
+    void SendBurst(const TArray<TArray<uint8>>& DataArray);
     
     // 매 프레임 호출될 함수
     void Tick();
+    // 예산 안에서만 수신 패킷을 처리하는 Tick. 제어 패킷을 먼저 처리하고 남은 패킷은 다음 Tick으로 이월
+    void Tick(const FHktNetTickBudget& Budget);
+    // 마지막 Tick의 처리량과 이월된 대기열 상태
+    const FHktNetTickStats& GetLastTickStats() const { return LastTickStats; }
+    // 처리를 기다리는 수신 패킷 수. 어느 스레드에서든 호출 가능
+    int32 GetBacklogSize() const { return NumQueuedPackets.load(std::memory_order_relaxed); }
 
     // 서버로부터 받은 패킷이 있는지 확인하고 가져옴
     bool Poll(TArray<uint8>& OutData);
 
+    // 서버로부터 받은 그룹 스냅샷을 복원된 전체 상태로 가져옴 (받은 순서대로)
+    bool PollSnapshot(FHktSnapshotFrame& OutFrame);
+
+    // 벌크 전송 수신 완료 통지 함수 설정. Tick 안에서 호출됨
+    void SetBulkReceivedCallback(FHktBulkReceivedCallback InCallback) { BulkReceivedCallback = MoveTemp(InCallback); }
+    // 받는 중인 벌크 전송의 수신 오프셋. 연결이 끊긴 뒤 SendBulk의 StartOffset으로 이어 받을 때 사용. 없으면 0
+    uint32 GetBulkReceivedOffset(uint32 TransferId) const { return BulkReceiver.GetReceivedOffset(TransferId); }
+
     // 서버에 특정 그룹 참여를 요청
     void JoinGroup(int32 GroupId);
 
     // 서버에 현재 그룹 탈퇴를 요청
     void LeaveGroup();
 
+    // 대체 키로 대체되어 재전송 대기에서 빠진 메시지 수 (누적)
+    int64 GetNumSupersededPackets() const { return NumSupersededPackets.load(std::memory_order_relaxed); }
+
     bool IsConnected() const { return bIsConnected; }
+    // 서버 응답이 끊겨 세션 재개를 기다리는 중인지 여부
+    bool IsResuming() const { return bResuming; }
+    // 서버 응답이 끊긴 뒤 세션 재개를 포기하고 연결을 끊기까지의 시간 (초). 서버의 세션 유지 시간과 맞추는 것이 좋음
+    void SetSessionResumeTimeout(float Seconds) { SessionResumeTimeout = Seconds; }
+
+    // UDP GSO/GRO 오프로드 사용 여부 (Linux 전용). Connect 전에 설정해야 함
+    void SetUdpOffloadEnabled(bool bEnabled) { bUdpOffloadEnabled = bEnabled; }
+    // 런타임 검사 결과 실제로 오프로드가 사용되고 있는지 여부
+    bool IsSendOffloadActive() const { return bSendOffloadActive; }
+    bool IsReceiveOffloadActive() const { return bReceiveOffloadActive; }
+
+    // 데이터그램 전송 방식. Connect 전에 설정해야 함. 루프백이면 같은 프로세스의 루프백 서버에만 연결되며 수신 스레드 없이 Tick에서 바로 받음
+    void SetTransport(EHktNetTransport InTransport) { Transport = InTransport; }
+    EHktNetTransport GetTransport() const { return Transport; }
+
+    // 서버와 협상할 최대 헤더 버전. Connect 전에 설정해야 함
+    void SetMaxHeaderVersion(uint8 Version) { MaxHeaderVersion = FMath::Clamp<uint8>(Version, HktPacketHeader::Version1, HktPacketHeader::LatestVersion); }
+    // 서버와 협상된 헤더 버전 (연결 전에는 v1)
+    uint8 GetHeaderVersion() const { return HeaderVersion; }
+
+    // 서버까지의 경로 MTU 탐색 사용 여부 (기본 꺼짐). Connect 전에 설정해야 함.
+    // 켜면 소켓이 데이터그램을 조각내지 않으므로, 경로 MTU보다 큰 데이터 패킷은 오류 로그를 남기고 보내지 않음
+    void SetMtuDiscoveryEnabled(bool bEnabled) { bMtuDiscoveryEnabled = bEnabled; }
+    // 소켓이 DF를 설정하여 실제로 탐색이 진행되는지 여부
+    bool IsMtuDiscoveryActive() const { return bMtuDiscoveryActive; }
+    // 서버까지의 경로 MTU (헤더 포함 UDP 페이로드 최대 크기). 탐색 전이면 FHktMtuProber::SafeMtu
+    int32 GetPathMtu() const;
 
 protected:
     // FRunnable 인터페이스 구현
@@ -43,14 +103,47 @@ protected:
     virtual void Exit() override;
 
 private:
-    void ProcessReceivedPackets();
+    void ProcessReceivedPackets(FHktNetTickBudgetTracker& Tracker);
+    // 패킷 종류에 따라 제어/데이터 처리 큐에 넣음. 수신 스레드에서도 호출
+    void EnqueuePacket(TArray<uint8>&& Data);
+    // 제어 큐를 먼저 비우는 순서로 처리할 패킷을 하나 꺼냄
+    bool DequeuePacket(FReceivedPacket& OutPacket);
     void CheckForResends();
     void ProcessAck(const FPacketHeader& Header);
-    void UpdateReceivedState(uint32 IncomingSequence);
-    void SendPacket(const TArray<uint8>& Data, EPacketType Type);
+    // 처음 받은 시퀀스면 true, 중복이거나 너무 오래되었으면 false
+    bool UpdateReceivedState(uint32 IncomingSequence);
+    // 스냅샷 델타를 기준 스냅샷에 적용하여 복원하고 서버에 Ack
+    void ProcessSnapshot(const uint8* Data, int32 Size);
+    void SendSnapshotAck(int32 GroupId, uint32 SnapshotId);
+    // PadToSize가 있으면 데이터그램 전체가 그 크기가 되도록 0으로 채움
+    void SendPacket(const TArray<uint8>& Data, EPacketType Type, int32 PadToSize = 0, uint64 CollapseKey = HktCollapseKey::None);
+    // 헤더 자리가 비어 있는 패킷을 완성하여 전송. Data 타입이면 재전송 대기 목록에 넣고, 아니면 버퍼를 풀로 돌려줌
+    void SendPreparedPacket(TArray<uint8>&& PacketData, EPacketType Type, int32 PadToSize = 0, uint64 CollapseKey = HktCollapseKey::None);
+    // 조각내지 않는 소켓에서 DatagramSize가 경로 MTU 안에 드는지 검사. 넘으면 오류 로그를 남기고 false
+    bool FitsPathMtu(int32 DatagramSize) const;
+    // HeaderSpace(HktPacketHeader::MaxSize 바이트)의 끝에 맞춰 헤더를 채우고 헤더가 시작하는 오프셋을 반환. Data 타입이면 다음 시퀀스 번호를 부여
+    int32 WritePacketHeader(uint8* HeaderSpace, EPacketType Type, FPacketHeader& OutHeader);
+    // 헤더를 채우고 헤더 + 페이로드 패킷을 만듦. 헤더는 맨 앞에서 시작. Data 타입이면 다음 시퀀스 번호를 부여
+    TArray<uint8> BuildPacket(const TArray<uint8>& Data, EPacketType Type, FPacketHeader& OutHeader);
+    // 소켓(또는 루프백 엔드포인트)을 열고 수신을 시작 / 정리
+    bool OpenTransport(uint16 ClientPort);
+    void CloseTransport();
+    // 서버가 한동안 조용하면 세션 재개 요청. 재개 유예 시간이 지나면 연결을 끊음
+    void UpdateSessionResume();
+    void SendResume();
+    // 현재 전송 방식으로 서버에 데이터그램 하나를 보냄
+    bool SendDatagram(const uint8* Data, int32 Size);
+    bool CanSend() const { return (ClientSocket != nullptr || LoopbackEndpoint.IsValid()) && ServerAddr.IsValid(); }
+    // 핸드셰이크 패킷 (재)전송. 쿠키가 있으면 ConnectResponse, 없으면 Connect
+    void SendHandshake();
+    // 탐침 주기가 되었으면 경로 MTU 탐침 전송
+    void UpdateMtuProbe();
 
     FSocket* ClientSocket = nullptr;
     TSharedPtr<FInternetAddr> ServerAddr;
+    // 데이터그램 전송 방식과 루프백 전송일 때의 엔드포인트
+    EHktNetTransport Transport = EHktNetTransport::Socket;
+    TUniquePtr<FHktLoopbackEndpoint> LoopbackEndpoint;
 
     FRunnableThread* ReceiverThread = nullptr;
     FThreadSafeBool bIsStopping;
@@ -58,18 +151,72 @@ private:
     
     // 수신된 '데이터' 패킷만 담는 큐
     TQueue<TArray<uint8>, EQueueMode::Mpsc> ReceivedDataPackets;
-    // 수신된 모든 패킷을 담는 큐 (처리를 위해)
-    TQueue<TArray<uint8>, EQueueMode::Mpsc> IncomingPackets;
+    // 수신된 모든 패킷을 담는 큐 (처리를 위해). 제어 패킷은 별도 큐에 넣어 데이터가 밀려 있어도 먼저 처리
+    TQueue<FReceivedPacket, EQueueMode::Mpsc> IncomingControlPackets;
+    TQueue<FReceivedPacket, EQueueMode::Mpsc> IncomingPackets;
+    // 두 큐에 들어 있는 패킷 수
+    std::atomic<int32> NumQueuedPackets{ 0 };
+    // 마지막 Tick 통계. 메인 스레드에서만 접근
+    FHktNetTickStats LastTickStats;
+    // 복원된 그룹 스냅샷 큐
+    TQueue<FHktSnapshotFrame> ReceivedSnapshots;
+    // 그룹별로 받은 스냅샷과 서버가 사용 중인 델타 기준 (그룹 ID -> 기록)
+    TMap<int32, FHktSnapshotHistory> SnapshotHistories;
+    // 서버가 보내는 벌크 전송 수신 상태. 메인 스레드에서만 접근
+    FHktBulkReceiver BulkReceiver;
+    FHktBulkReceivedCallback BulkReceivedCallback;
 
     // 신뢰성 보장을 위한 상태 변수
     uint32 SentSequence = 0;
     uint32 ReceivedSequence = 0;
     uint32 ReceivedAckBitfield = 0;
     TMap<uint32, FPendingPacket> PendingAckPackets;
-    FCriticalSection StateMutex;
+    // Ack를 기다리는 패킷 중 대체 키가 있는 것 (대체 키 -> 시퀀스 번호)
+    TMap<uint64, uint32> PendingCollapseKeys;
+    std::atomic<int64> NumSupersededPackets{ 0 };
+    // 협상된 송신 헤더 버전. 핸드셰이크가 끝나기 전에는 v1
+    uint8 HeaderVersion = HktPacketHeader::Version1;
+    // 서버까지의 경로 MTU 탐색 상태
+    FHktMtuProber MtuProber;
+    mutable FCriticalSection StateMutex;
+
+    // 서버로부터 발급받은 연결 쿠키. 비어 있으면 아직 Challenge를 받지 못한 상태
+    TArray<uint8> HandshakeCookie;
+    // 쿠키를 발급받은 시간
+    double HandshakeCookieTime = 0.0;
+    // 마지막으로 핸드셰이크 패킷을 보낸 시간
+    double LastHandshakeTime = 0.0;
+
+    // 서버가 발급한 세션 토큰. 세션 재개를 지원하지 않는 서버면 없음
+    FHktSessionToken SessionToken;
+    bool bHasSessionToken = false;
+    // 세션 재개 요청 후 ResumeAck를 기다리는 중
+    FThreadSafeBool bResuming;
+    // 주소가 바뀐 뒤 재개할 때 서버가 새 주소로 발급한 쿠키. 비어 있으면 0으로 채워 보냄. 메인 스레드에서만 접근
+    TArray<uint8> ResumeCookie;
+    // 서버로부터 마지막으로 패킷을 받은 시간과 마지막 Resume 전송 시간. 메인 스레드에서만 접근
+    double LastReceiveTime = 0.0;
+    double LastResumeTime = 0.0;
+
+    // UDP 오프로드 설정 및 런타임 검사 결과
+    bool bUdpOffloadEnabled = true;
+    bool bSendOffloadActive = false;
+    bool bReceiveOffloadActive = false;
+
+    // 서버와 협상할 최대 헤더 버전
+    uint8 MaxHeaderVersion = HktPacketHeader::LatestVersion;
+
+    // 경로 MTU 탐색 설정 및 런타임 검사 결과
+    bool bMtuDiscoveryEnabled = false;
+    bool bMtuDiscoveryActive = false;
+
+    // 세션 재개를 포기하기까지의 시간 (초)
+    float SessionResumeTimeout = 30.0f;
 
     // 재전송 관련 상수
     const float ResendTimeout = 0.2f; // 200ms
     const int32 MaxRetries = 10;
+    // 서버로부터 이 시간 동안 아무것도 받지 못하면 세션 재개 요청 (초)
+    const float ResumeAfterSilence = 1.0f;
 };
 
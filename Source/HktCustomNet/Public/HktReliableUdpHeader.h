@@ -24,11 +24,33 @@ enum class EPacketType : uint8
     // 클라이언트가 그룹 참가를 요청
     JoinGroup,
     // 클라이언트가 그룹 탈퇴를 요청
-    LeaveGroup 
+    LeaveGroup,
+    // Connect 요청에 대해 서버가 상태 없이 쿠키를 발급
+    ConnectChallenge,
+    // 클라이언트가 발급받은 쿠키를 그대로 돌려보내 연결을 확정
+    ConnectResponse,
+    // 그룹 상태 스냅샷 (비신뢰, 순서 보장: 오래된 스냅샷은 버림)
+    Snapshot,
+    // 클라이언트가 적용한 스냅샷 ID를 알림. 서버는 이를 다음 델타의 기준으로 사용
+    SnapshotAck,
+    // 경로 MTU 탐침. 페이로드는 탐침 크기(uint16)와 0 패딩이며, 데이터그램 전체 크기가 탐침 크기와 같음 (비신뢰)
+    MtuProbe,
+    // 탐침을 받은 쪽이 받은 데이터그램 크기(uint16)를 돌려줌 (비신뢰)
+    MtuProbeAck,
+    // 클라이언트가 세션 토큰으로 기존 연결에 다시 붙음. 페이로드는 세션 토큰과 쿠키 자리(FHktConnectCookie).
+    // 주소가 바뀌었으면 서버가 새 주소로 ConnectChallenge를 보내고, 그 쿠키를 실은 Resume이 와야 재개함. 항상 v1 헤더 (비신뢰)
+    Resume,
+    // Resume에 대한 서버 응답. 이후 서버는 Ack되지 않은 패킷을 일반 재전송 경로로 나누어 재전송함 (비신뢰)
+    ResumeAck,
+    // 벌크 전송 청크. 페이로드는 FHktBulkChunkHeader와 데이터 (비신뢰, 벌크 자체 창과 누적 Ack로 재전송)
+    BulkData,
+    // 벌크 전송 누적 Ack. 페이로드는 FHktBulkAck (비신뢰)
+    BulkAck
 };
 
 // pragma pack을 사용하여 구조체 패딩을 방지합니다.
 // 네트워크로 전송될 데이터는 크기가 정확히 일치해야 합니다.
+// v1 헤더는 이 구조체를 그대로 전송하며, v2 헤더는 HktPacketHeader로 압축하여 전송합니다.
 #pragma pack(push, 1)
 struct FPacketHeader
 {
@@ -49,6 +71,59 @@ struct FPacketHeader
     {
     }
 };
+
+// 서버가 Connect 요청에 대해 발급하는 쿠키.
+// 서버는 쿠키를 검증할 수 있는 비밀키만 보관하며, 클라이언트가 쿠키를 돌려보내기 전까지 어떤 상태도 만들지 않습니다.
+struct FHktConnectCookie
+{
+    // 쿠키 발급 시각 (초)
+    uint32 IssuedAt;
+    // HMAC-SHA1(서버 비밀키, IssuedAt + 클라이언트 주소)
+    uint8 Mac[20];
+
+    FHktConnectCookie()
+        : IssuedAt(0)
+    {
+        FMemory::Memzero(Mac);
+    }
+};
+
+// 핸드셰이크 완료 시 서버가 발급하는 세션 토큰. 주소가 바뀌거나 잠시 끊겨도 이 토큰으로 기존 연결에 다시 붙음
+struct FHktSessionToken
+{
+    uint8 Bytes[16];
+
+    FHktSessionToken()
+    {
+        FMemory::Memzero(Bytes);
+    }
+
+    // 발급된 토큰인지 여부 (세션 재개를 쓰지 않으면 0)
+    bool IsValid() const
+    {
+        for (uint8 Byte : Bytes)
+        {
+            if (Byte != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool operator==(const FHktSessionToken& Other) const
+    {
+        return FMemory::Memcmp(Bytes, Other.Bytes, sizeof(Bytes)) == 0;
+    }
+
+    friend uint32 GetTypeHash(const FHktSessionToken& Token)
+    {
+        // 토큰은 HMAC 출력이므로 앞 4바이트만으로도 고르게 분포함
+        uint32 Hash;
+        FMemory::Memcpy(&Hash, Token.Bytes, sizeof(uint32));
+        return Hash;
+    }
+};
 #pragma pack(pop)
 
 // 네트워크를 통해 받은 패킷 데이터를 담을 구조체
@@ -56,6 +131,8 @@ struct FReceivedPacket
 {
     TSharedPtr<FInternetAddr> PeerAddress;
     TArray<uint8> Data;
+    // 처리 큐에 들어간 시각 (HktNetClock). 처리 대기 시간 측정용
+    double ReceiveTime = 0.0;
 
     FReceivedPacket() = default;
     FReceivedPacket(TSharedPtr<FInternetAddr> InAddr, TArray<uint8>&& InData)
@@ -69,4 +146,119 @@ namespace HktReliableUdp
 {
     constexpr uint16 ServerPort = 7777;
     constexpr uint16 ClientPort = 7778;
-}
\ No newline at end of file
+    // 발급된 쿠키의 유효 시간 (초)
+    constexpr uint32 CookieLifetime = 10;
+    // Connect 패딩의 첫 바이트와 ConnectResponse의 쿠키 뒤 1바이트에 클라이언트가 지원하는 최대 헤더 버전을 실음.
+    // 서버는 핸드셰이크 Ack 페이로드 1바이트로 협상된 버전을 알려주며, 이 바이트가 없으면 양쪽 모두 v1
+    constexpr int32 HandshakeVersionSize = 1;
+    // 세션 재개를 지원하는 서버는 핸드셰이크 Ack의 버전 바이트 뒤에 세션 토큰을 붙임
+    constexpr int32 HandshakeSessionSize = HandshakeVersionSize + sizeof(FHktSessionToken);
+    // Resume 페이로드 크기. 쿠키가 없을 때도 0으로 채워 보내므로 서버의 Challenge 응답이 요청보다 커지지 않음
+    constexpr int32 ResumePayloadSize = sizeof(FHktSessionToken) + sizeof(FHktConnectCookie);
+}
+
+// 대체 키. 같은 키를 단 새 데이터 메시지가 아직 Ack되지 않은 이전 메시지를 대체하여 이전 메시지는 더 이상 재전송하지 않음.
+// 위치처럼 최신 값만 의미 있는 상태를 자주 보낼 때 사용
+namespace HktCollapseKey
+{
+    // 대체하지 않음
+    constexpr uint64 None = 0;
+
+    // 대상 ID(하위 48비트)와 행동 종류 ID(하위 16비트)로 키를 만듦. 예: FHktBehaviorRequestHeader의 SubjectId, FlagmentTypeId
+    inline uint64 Make(int64 SubjectId, int32 TypeId)
+    {
+        return ((uint64)(uint16)TypeId << 48) | ((uint64)SubjectId & 0xFFFFFFFFFFFFull);
+    }
+}
+
+// 시퀀스 번호의 순환(wrap-around)을 고려한 비교 (RFC 1982 serial number arithmetic)
+namespace HktSequence
+{
+    // A가 B보다 뒤의 시퀀스인지 여부
+    inline bool IsNewer(uint32 A, uint32 B)
+    {
+        return (int32)(A - B) > 0;
+    }
+
+    // A - B를 부호 있는 거리로 반환
+    inline int32 Distance(uint32 A, uint32 B)
+    {
+        return (int32)(A - B);
+    }
+
+    // 하위 16비트만 전송된 시퀀스를 Reference에 가장 가까운 32비트 값으로 복원
+    inline uint32 Expand16(uint16 Value, uint32 Reference)
+    {
+        return Reference + (uint32)(int32)(int16)(uint16)(Value - (uint16)Reference);
+    }
+}
+
+/**
+ * 패킷 헤더 인코딩.
+ * v1: FPacketHeader 13바이트를 그대로 전송합니다. 첫 바이트가 패킷 종류이므로 상위 2비트가 항상 0입니다.
+ * v2: [버전/플래그 1바이트][종류 1바이트][시퀀스 16비트?][Ack 16비트?][누락 비트 0/1/2/4바이트]
+ *     - 버전/플래그: 상위 2비트 버전(2), HasSequence, HasAck, 누락 비트 길이 코드(2비트)
+ *     - 시퀀스와 Ack는 하위 16비트만 보내고, 받는 쪽이 자신의 상태를 기준으로 32비트로 복원합니다.
+ *     - Ack 비트필드는 반전하여(받지 못한 패킷만 1) 앞쪽 0바이트를 생략하므로 손실이 없으면 0바이트입니다.
+ *     - 손실 없는 데이터 패킷은 6바이트, 순수 Ack는 4바이트입니다.
+ * 버전은 첫 바이트로 구분되므로 받는 쪽은 연결의 협상 결과와 관계없이 두 버전 모두 해석할 수 있습니다.
+ */
+namespace HktPacketHeader
+{
+    constexpr uint8 Version1 = 1;
+    constexpr uint8 Version2 = 2;
+    constexpr uint8 LatestVersion = Version2;
+
+    // 송신 버퍼 앞에 비워 두는 헤더 자리 크기 (모든 버전 중 가장 큰 헤더)
+    constexpr int32 MaxSize = sizeof(FPacketHeader);
+    // 가장 작은 헤더 크기 (v2의 버전/플래그 + 종류)
+    constexpr int32 MinSize = 2;
+
+    // 헤더를 Out에 인코딩하고 쓴 바이트 수를 반환. Out은 MaxSize 이상이어야 함
+    HKTCUSTOMNET_API int32 Encode(const FPacketHeader& Header, uint8 Version, uint8* Out);
+    // 버퍼 앞 MaxSize 바이트의 헤더 자리 끝에 맞춰 헤더를 인코딩하고 헤더가 시작하는 오프셋을 반환.
+    // 데이터그램은 Buffer + 반환값부터 보내면 되므로 페이로드를 옮기지 않아도 됨
+    HKTCUSTOMNET_API int32 EncodeInPlace(const FPacketHeader& Header, uint8 Version, uint8* Buffer);
+    /**
+     * 헤더를 해석하고 헤더 크기를 반환합니다. 형식이 맞지 않으면 0.
+     * @param SequenceReference v2의 16비트 시퀀스 복원 기준 (상대로부터 마지막으로 받은 시퀀스)
+     * @param AckReference v2의 16비트 Ack 복원 기준 (상대에게 마지막으로 보낸 시퀀스)
+     */
+    HKTCUSTOMNET_API int32 Decode(const uint8* Data, int32 Size, uint32 SequenceReference, uint32 AckReference, FPacketHeader& OutHeader, uint8* OutVersion = nullptr);
+    // 헤더 전체를 해석하지 않고 패킷 종류만 읽음. 수신 스레드에서 처리 큐를 고를 때 사용. 형식이 맞지 않으면 false
+    HKTCUSTOMNET_API bool PeekType(const uint8* Data, int32 Size, EPacketType& OutType);
+    // 시퀀스를 복원하지 않고 헤더 크기, 버전, 종류 범위만 검사. 수신 스레드에서 큐에 넣기 전에 쓰레기 패킷을 거를 때 사용
+    HKTCUSTOMNET_API bool Validate(const uint8* Data, int32 Size, EPacketType& OutType);
+
+    // 이 버전의 프로토콜이 아는 패킷 종류인지 여부. EPacketType에 종류를 추가하면 함께 갱신
+    inline bool IsValidType(EPacketType Type)
+    {
+        return (uint8)Type <= (uint8)EPacketType::BulkAck;
+    }
+
+    // 프로토콜 유지에 필요한 제어 패킷인지 여부 (Ack, 핸드셰이크, Ping, MTU 탐침, 재개).
+    // 데이터, 스냅샷, 벌크 청크가 밀려 있어도 제어 패킷은 먼저 처리함.
+    // Disconnect와 그룹 요청은 앞서 보낸 데이터보다 먼저 처리되면 안 되므로 데이터와 같은 큐에서 순서대로 처리
+    inline bool IsControlType(EPacketType Type)
+    {
+        switch (Type)
+        {
+        case EPacketType::Ack:
+        case EPacketType::Connect:
+        case EPacketType::ConnectChallenge:
+        case EPacketType::ConnectResponse:
+        case EPacketType::Ping:
+        case EPacketType::Pong:
+        case EPacketType::SnapshotAck:
+        case EPacketType::MtuProbe:
+        case EPacketType::MtuProbeAck:
+        case EPacketType::Resume:
+        case EPacketType::ResumeAck:
+        case EPacketType::BulkAck:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
@@ -1,11 +1,22 @@
 #pragma once
 
 #include "HktReliableUdpHeader.h"
+#include "HktSnapshot.h"
+#include "HktInterestGrid.h"
+#include "HktReplicationPrioritizer.h"
+#include "HktPacketWriter.h"
+#include "HktMtuProber.h"
+#include "HktTrafficCapture.h"
+#include "HktLoopbackTransport.h"
+#include "HktBulkTransfer.h"
+#include "HktNetTickBudget.h"
+#include "HktSourceRateLimiter.h"
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
 #include "Sockets.h"
 #include "Common/UdpSocketReceiver.h"
 #include "Containers/Set.h"
+#include <atomic>
 
 class FSocket;
 class FRunnableThread;
@@ -19,33 +30,104 @@ struct FPendingPacket
     double SentTime;
     // 재전송 횟수
     int32 Retries;
+    // PacketData에서 헤더가 시작하는 위치. 압축 헤더는 헤더 자리 끝에 맞춰 쓰므로 앞쪽이 비어 있음
+    int32 HeaderOffset;
+    // 이 패킷을 대체할 수 있는 키 (HktCollapseKey)
+    uint64 CollapseKey = HktCollapseKey::None;
 
-    FPendingPacket() : SentTime(0.0), Retries(0) {}
-    FPendingPacket(TArray<uint8>&& InData, double InTime)
+    FPendingPacket() : SentTime(0.0), Retries(0), HeaderOffset(0) {}
+    FPendingPacket(TArray<uint8>&& InData, double InTime, int32 InHeaderOffset = 0)
         : PacketData(MoveTemp(InData))
         , SentTime(InTime)
         , Retries(0)
+        , HeaderOffset(InHeaderOffset)
     {}
 };
 
+// Ack를 기다리는 패킷 목록(시퀀스 -> 패킷)과 대체 키 색인(대체 키 -> 시퀀스)을 함께 갱신. 호출자가 목록의 잠금을 잡고 있어야 함
+namespace HktPendingPackets
+{
+    // 패킷을 추가. 같은 대체 키로 Ack를 기다리던 이전 패킷은 목록에서 빼서 더 이상 재전송하지 않음. 대체했으면 true
+    HKTCUSTOMNET_API bool Add(TMap<uint32, FPendingPacket>& Pending, TMap<uint64, uint32>& CollapseKeys, uint32 Sequence, FPendingPacket&& Packet);
+    // Ack된 패킷을 빼고 버퍼를 풀에 돌려줌. 목록에 있었으면 true
+    HKTCUSTOMNET_API bool Remove(TMap<uint32, FPendingPacket>& Pending, TMap<uint64, uint32>& CollapseKeys, uint32 Sequence);
+}
+
 // 클라이언트 연결 정보를 관리하는 구조체
 struct FClientConnection
 {
+    // 서버가 부여한 연결 ID (관심 영역 격자의 키)
+    uint64 ConnectionId = 0;
+    // 서버에 등록된 동안 연결마다 다른 조밀한 번호. 여러 그룹 브로드캐스트에서 수신자 중복을 비트로 거를 때 씀.
+    // 서버의 ConnectionsLock 아래에서 할당되고 반환됨
+    int32 Slot = INDEX_NONE;
     // 클라이언트의 주소 정보
     TSharedPtr<FInternetAddr> Address;
+    // 핸드셰이크에서 협상한 송신 헤더 버전
+    uint8 HeaderVersion = HktPacketHeader::Version1;
+    // 세션 재개용 토큰
+    FHktSessionToken SessionToken;
+
+    // 아래의 시퀀스, Ack, 재전송 대기 상태를 보호하는 연결별 잠금.
+    // 서버 전역 잠금 없이 서로 다른 연결로의 송신은 병렬로 진행됨
+    FCriticalSection Mutex;
     // 이 클라이언트에게 보낸 마지막 시퀀스 번호
     uint32 SentSequence = 0;
     // 이 클라이언트로부터 받은 마지막 시퀀스 번호
     uint32 ReceivedSequence = 0;
     // 이 클라이언트로부터 받은 패킷들의 Ack 비트필드
     uint32 ReceivedAckBitfield = 0;
-    // 마지막으로 통신한 시간
+    // 응답이 없어 일시 중단된 세션인지 여부. 중단된 동안 보내는 데이터는 재전송 대기 목록에만 쌓이고 Resume 때 재전송됨.
+    // 메인 스레드에서 Mutex를 잡고 변경
+    bool bSuspended = false;
+    // 일시 중단된 시간
+    double SuspendTime = 0.0;
+    // 중단된 동안 재전송 대기 목록이 한도를 넘어 세션을 버려야 하는지 여부. 브로드캐스트 스레드에서도 설정됨
+    std::atomic<bool> bPendingOverflow{ false };
+    // 마지막으로 통신한 시간. 메인 스레드에서만 접근
     double LastReceiveTime = 0.0;
-    // 소속된 그룹 ID 목록
+    // 소속된 그룹 ID 목록. 서버의 ConnectionsLock 아래에서 접근
     TSet<int32> GroupIds;
 
     // Ack를 기다리는 전송된 패킷들 (시퀀스 번호 -> 패킷 정보)
     TMap<uint32, FPendingPacket> PendingAckPackets;
+    // Ack를 기다리는 패킷 중 대체 키가 있는 것 (대체 키 -> 시퀀스 번호)
+    TMap<uint64, uint32> PendingCollapseKeys;
+    // 이 클라이언트까지의 경로 MTU 탐색 상태
+    FHktMtuProber MtuProber;
+    // 이 클라이언트에게 보낸 게임플레이(벌크 외) 바이트 누적. 벌크 전송은 남은 대역폭만 사용
+    std::atomic<int64> GameplayBytesSent{ 0 };
+    // 이 클라이언트로의 벌크 전송. 메인 스레드에서만 접근
+    FHktBulkSender BulkSender;
+    // 재전송에 쓸 수 있는 남은 바이트와 마지막 충전 시간. 재개 직후 밀린 패킷이 한꺼번에 나가지 않도록 대역폭에 맞춰 나눔.
+    // 메인 스레드에서만 접근
+    int64 ResendAllowance = 0;
+    double ResendRefillTime = 0.0;
+
+    // 그룹별로 이 클라이언트에게 보낸 스냅샷과 델타 기준 (그룹 ID -> 기록). 메인 스레드에서만 접근
+    TMap<int32, FHktSnapshotHistory> SnapshotHistories;
+    // 그룹별 복제 우선순위 누적기 (그룹 ID -> 누적기). 메인 스레드에서만 접근
+    TMap<int32, FHktReplicationPrioritizer> SnapshotPrioritizers;
+};
+
+// 그룹의 개체 상태를 수집하는 함수 (그룹 ID, 개체 ID -> 상태)
+using FHktSnapshotProvider = TFunction<void(int32 /*GroupId*/, TMap<uint64, FHktSnapshotState>& /*OutEntities*/)>;
+// 그룹 개체들의 위치와 관련도를 수집하는 함수 (그룹 ID, 개체 ID -> 정보). 복제 우선순위 계산에 사용
+using FHktReplicationSubjectProvider = TFunction<void(int32 /*GroupId*/, TMap<uint64, FHktReplicationSubject>& /*OutSubjects*/)>;
+// 클라이언트가 보낸 데이터 패킷의 페이로드를 받았을 때 호출 (클라이언트 주소, 페이로드). 메인 스레드의 Tick에서 수신 순서대로 호출
+using FHktDataReceivedCallback = TFunction<void(const TSharedPtr<FInternetAddr>& /*ClientAddr*/, TConstArrayView<uint8> /*Payload*/)>;
+// 벌크 전송이 끝났을 때 호출 (클라이언트 주소, 전송 ID, 성공 여부). 연결이 끊겨 중단되면 bSucceeded가 false
+using FHktBulkCompleteCallback = TFunction<void(const TSharedPtr<FInternetAddr>& /*ClientAddr*/, uint32 /*TransferId*/, bool /*bSucceeded*/)>;
+
+// 수신 스레드가 처리 큐에 넣기 전에 버린 데이터그램 수 (누적)
+struct FHktReceiveDropStats
+{
+    // 헤더 크기, 버전, 종류 범위가 맞지 않음
+    int64 Malformed = 0;
+    // 보낸 주소의 수신 한도 초과
+    int64 RateLimited = 0;
+    // 수신 제한이 추적할 수 있는 주소 수 초과
+    int64 TooManySources = 0;
 };
 
 class HKTCUSTOMNET_API FHktReliableUdpServer : public FRunnable
@@ -61,17 +143,136 @@ public:
 
     // 매 프레임 호출될 함수. 수신된 패킷 처리 및 재전송 검사
     void Tick();
+    // 예산 안에서만 처리하는 Tick. 제어 패킷(Ack, 핸드셰이크 등)을 먼저 처리하고 남은 예산으로 데이터 패킷을 처리하며,
+    // 처리하지 못한 패킷과 재전송 검사는 다음 Tick으로 이월. 벌크 전송은 예산이 남았을 때만 보냄
+    void Tick(const FHktNetTickBudget& Budget);
+    // 마지막 Tick의 처리량과 이월된 대기열 상태
+    const FHktNetTickStats& GetLastTickStats() const { return LastTickStats; }
+    // 처리를 기다리는 수신 패킷 수. 어느 스레드에서든 호출 가능
+    int32 GetBacklogSize() const { return NumQueuedPackets.load(std::memory_order_relaxed); }
 
-    // 특정 클라이언트에게 데이터 전송
-    void SendTo(const TSharedPtr<FInternetAddr>& DstAddr, const TArray<uint8>& Data);
-    // 특정 그룹의 모든 클라이언트에게 데이터 전송 (Broadcast)
+    // 특정 클라이언트에게 데이터 전송. CollapseKey가 있으면 같은 키로 보낸 이전 메시지가 Ack되지 않았어도 더 이상 재전송하지 않음
+    void SendTo(const TSharedPtr<FInternetAddr>& DstAddr, const TArray<uint8>& Data, uint64 CollapseKey = HktCollapseKey::None);
+    // Writer에 직렬화한 페이로드를 복사 없이 전송. 전송 후 Writer는 비워짐
+    void SendTo(const TSharedPtr<FInternetAddr>& DstAddr, FHktPacketWriter& Writer, uint64 CollapseKey = HktCollapseKey::None);
+    // 같은 클라이언트에게 여러 데이터를 연속으로 전송. 가능하면 UDP GSO로 묶어 한 번의 시스템 콜로 보냄
+    void SendBurstTo(const TSharedPtr<FInternetAddr>& DstAddr, const TArray<TArray<uint8>>& DataArray);
+    // 특정 그룹의 모든 클라이언트에게 데이터 전송 (Broadcast). 병렬 브로드캐스트가 켜져 있고 구성원이 충분히 많으면
+    // 구성원 목록을 연속된 구간으로 나눠 작업 스레드들이 동시에 인코딩/전송하며, 모든 전송이 끝난 뒤 반환
     void BroadcastToGroup(int32 GroupId, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr = nullptr);
+    // 여러 그룹의 구성원 합집합에 전송. 여러 그룹에 속한 클라이언트도 한 번만 받음. 하위 그룹의 구성원도 포함.
+    // 중복 제거 상태는 호출마다 따로 두므로 여러 스레드에서 동시에 호출해도 됨
+    void BroadcastToGroups(const TArray<int32>& GroupIds, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr = nullptr);
+
+    // 그룹 계층 설정. Child 그룹(과 그 하위 그룹)의 구성원은 Parent로의 브로드캐스트도 받음 (월드 > 지역 > 파티).
+    // 구성원 목록을 복사하지 않고 관계만 기록하며, 한 그룹이 여러 상위 그룹을 가질 수 있음. 순환이 생기면 false.
+    // 스냅샷 복제는 계층과 관계없이 그룹에 직접 참여한 구성원에게만 보냄
+    bool AddSubgroup(int32 ParentGroupId, int32 ChildGroupId);
+    void RemoveSubgroup(int32 ParentGroupId, int32 ChildGroupId);
+    // 특정 그룹에서 Origin으로부터 Radius 안에 관심 위치가 있는 클라이언트에게만 데이터 전송.
+    // 관심 위치가 설정되지 않은 클라이언트는 받지 않음. 전송한 클라이언트 수를 반환
+    int32 BroadcastToGroupInRadius(int32 GroupId, const FVector& Origin, float Radius, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr = nullptr);
+
+    // 병렬 브로드캐스트 설정. 수신자가 MinRecipients 이상이면 최대 MaxTasks개(0이면 작업 스레드 수 + 1)의 작업으로 나눠 보냄.
+    // MinRecipients가 0이면 항상 호출한 스레드에서 순서대로 보냄. 연결마다 한 작업만 보내므로 연결별 시퀀스 순서는 유지됨
+    void SetParallelBroadcast(int32 MinRecipients, int32 MaxTasks = 0)
+    {
+        ParallelBroadcastMinRecipients = FMath::Max(MinRecipients, 0);
+        ParallelBroadcastMaxTasks = FMath::Max(MaxTasks, 0);
+    }
+
+    // 클라이언트의 관심 위치(보통 플레이어가 조종하는 개체의 위치) 갱신
+    void SetClientInterestLocation(const TSharedPtr<FInternetAddr>& ClientAddr, const FVector& Location);
+    // 클라이언트의 관심 위치 제거
+    void ClearClientInterestLocation(const TSharedPtr<FInternetAddr>& ClientAddr);
     
     // 클라이언트를 그룹에 추가
     void JoinGroup(const TSharedPtr<FInternetAddr>& ClientAddr, int32 GroupId);
     // 클라이언트를 그룹에서 제거
     void LeaveGroup(const TSharedPtr<FInternetAddr>& ClientAddr, int32 GroupId);
 
+    // 그룹 스냅샷 복제를 켬. Interval(초)마다 그룹 상태를 수집하여 각 클라이언트에게 마지막으로 Ack한 스냅샷 대비 델타를 전송
+    void EnableGroupSnapshots(int32 GroupId, float Interval);
+    // 그룹 스냅샷 복제를 끔
+    void DisableGroupSnapshots(int32 GroupId);
+    // 스냅샷에 담을 그룹 상태를 수집하는 함수 설정
+    void SetSnapshotProvider(FHktSnapshotProvider InProvider) { SnapshotProvider = MoveTemp(InProvider); }
+    // 클라이언트별 스냅샷 바이트 예산 설정 (0이면 무제한, EnableGroupSnapshots 이후 호출).
+    // 예산이 있으면 변경된 개체 중 우선순위가 높은 것부터 예산만큼만 보냄. 아직 Ack되지 않은 최근 전송분은 되돌리지 않으므로 예산을 조금 넘을 수 있음
+    void SetSnapshotByteBudget(int32 GroupId, int32 BytesPerClient);
+    // 우선순위 계산에 쓸 개체 위치/관련도를 수집하는 함수 설정. 없으면 모든 개체의 관련도가 같음
+    void SetReplicationSubjectProvider(FHktReplicationSubjectProvider InProvider) { ReplicationSubjectProvider = MoveTemp(InProvider); }
+
+    // 클라이언트 데이터 수신 통지 함수 설정
+    void SetDataReceivedCallback(FHktDataReceivedCallback InCallback) { DataReceivedCallback = MoveTemp(InCallback); }
+
+    // 큰 데이터를 벌크 전송 레인으로 보냄. 게임플레이 트래픽이 쓰고 남은 대역폭만 사용하며 전송 ID를 반환 (실패하면 0).
+    // StartOffset이 있으면 받는 쪽이 이미 가진 앞부분을 건너뜀 (이전 연결에서 받다 만 전송을 이어 보낼 때). 메인 스레드에서 호출
+    uint32 SendBulk(const TSharedPtr<FInternetAddr>& DstAddr, TArray<uint8>&& Data, uint32 StartOffset = 0);
+    // 벌크 전송 완료/중단 통지 함수 설정
+    void SetBulkCompleteCallback(FHktBulkCompleteCallback InCallback) { BulkCompleteCallback = MoveTemp(InCallback); }
+    // 벌크 전송 진행 상황 (받는 쪽이 확인한 바이트, 전체 바이트). 끝났거나 없는 전송이면 false
+    bool GetBulkProgress(const TSharedPtr<FInternetAddr>& ClientAddr, uint32 TransferId, uint32& OutAckedBytes, uint32& OutTotalBytes) const;
+    // 클라이언트별 송신 대역폭 (바이트/초). 게임플레이 트래픽은 제한하지 않으며, 벌크 전송은 여기서 게임플레이가 쓴 만큼을 뺀 나머지만 사용
+    void SetSendBandwidth(int32 BytesPerSecond) { SendBandwidth = FMath::Max(BytesPerSecond, 1024); }
+
+    // 대체 키로 대체되어 재전송 대기에서 빠진 메시지 수 (누적)
+    int64 GetNumSupersededPackets() const { return NumSupersededPackets.load(std::memory_order_relaxed); }
+
+    // 현재 연결된 클라이언트 수 (일시 중단된 세션 제외)
+    int32 GetNumConnections() const;
+    // 재개를 기다리는 일시 중단된 세션 수
+    int32 GetNumSuspendedSessions() const;
+
+    // 보낸 주소별 수신 한도 (초당 데이터그램 수, 한 번에 몰려와도 되는 수). 넘는 데이터그램은 수신 스레드에서 바로 버림.
+    // PacketsPerSecond가 0이면 제한하지 않음. Start 전에 설정해야 함
+    void SetReceiveRateLimit(int32 PacketsPerSecond, int32 Burst)
+    {
+        ReceiveRateLimit = FMath::Max(PacketsPerSecond, 0);
+        ReceiveRateBurst = FMath::Max(Burst, 1);
+    }
+    // 수신 스레드에서 버린 데이터그램 수. 어느 스레드에서든 호출 가능
+    FHktReceiveDropStats GetReceiveDropStats() const;
+
+    // 응답 없는 클라이언트의 세션을 유지할 시간 (초). 이 시간 안에는 어느 주소에서든 세션 토큰으로 다시 붙을 수 있고
+    // 재전송 대기 데이터, 시퀀스, 그룹 소속이 모두 유지됨. 0이면 세션 재개를 쓰지 않고 바로 연결을 끊음. 새 연결부터 적용
+    void SetSessionGracePeriod(float Seconds) { SessionGracePeriod = FMath::Max(Seconds, 0.0f); }
+    // 중단된 세션에 쌓아 둘 수 있는 재전송 대기 패킷 수. 넘으면 세션을 버리고 클라이언트는 처음부터 다시 연결해야 함
+    void SetMaxSuspendedPendingPackets(int32 MaxPackets) { MaxSuspendedPendingPackets = FMath::Max(MaxPackets, 1); }
+
+    // UDP GSO/GRO 오프로드 사용 여부 (Linux 전용). Start 전에 설정해야 함
+    void SetUdpOffloadEnabled(bool bEnabled) { bUdpOffloadEnabled = bEnabled; }
+    // 런타임 검사 결과 실제로 오프로드가 사용되고 있는지 여부
+    bool IsSendOffloadActive() const { return bSendOffloadActive; }
+    bool IsReceiveOffloadActive() const { return bReceiveOffloadActive; }
+
+    // 연결별 경로 MTU 탐색 사용 여부 (기본 꺼짐). Start 전에 설정해야 함.
+    // 켜면 소켓이 데이터그램을 조각내지 않으므로, 경로 MTU보다 큰 데이터 패킷과 스냅샷은 오류 로그를 남기고 보내지 않음
+    void SetMtuDiscoveryEnabled(bool bEnabled) { bMtuDiscoveryEnabled = bEnabled; }
+    // 소켓이 DF를 설정하여 실제로 탐색이 진행되는지 여부. 아니면 모든 연결이 안전한 최소 MTU를 사용
+    bool IsMtuDiscoveryActive() const { return bMtuDiscoveryActive; }
+    // 클라이언트까지의 경로 MTU (헤더 포함 UDP 페이로드 최대 크기). 묶어 보내거나 나눠 보낼 크기의 기준.
+    // 탐색 전이거나 연결이 없으면 FHktMtuProber::SafeMtu
+    int32 GetPathMtu(const TSharedPtr<FInternetAddr>& ClientAddr) const;
+
+    // 데이터그램 전송 방식. Start 전에 설정해야 함. 루프백이면 수신 스레드 없이 Tick에서 바로 받음
+    void SetTransport(EHktNetTransport InTransport) { Transport = InTransport; }
+    EHktNetTransport GetTransport() const { return Transport; }
+
+    // 새 연결과 협상할 최대 헤더 버전. v1만 아는 클라이언트와는 항상 v1을 사용
+    void SetMaxHeaderVersion(uint8 Version) { MaxHeaderVersion = FMath::Clamp<uint8>(Version, HktPacketHeader::Version1, HktPacketHeader::LatestVersion); }
+    // 클라이언트와 협상된 헤더 버전. 연결이 없으면 0
+    uint8 GetHeaderVersion(const TSharedPtr<FInternetAddr>& ClientAddr) const;
+
+    // 수신 트래픽 캡처 시작. 핸드셰이크 검사를 통과해 처리 큐에 들어가는 데이터그램을 시각, 주소와 함께 기록
+    bool StartCapture(const FString& Path, int64 MaxBytes = 256 * 1024 * 1024);
+    // 캡처 종료 및 파일 닫기
+    void StopCapture();
+    bool IsCapturing() const { return bCapturing; }
+
+    // 소켓에서 받은 것처럼 처리 큐에 패킷을 넣음 (핸드셰이크 검사 없음). 캡처 재생과 테스트용
+    void EnqueueReceivedPacket(const TSharedPtr<FInternetAddr>& PeerAddr, TArray<uint8>&& Data);
+
 protected:
     // FRunnable 인터페이스 구현
     virtual bool Init() override;
@@ -79,26 +280,101 @@ protected:
     virtual void Exit() override;
 
 private:
-    // 수신된 패킷 처리
-    void ProcessReceivedPackets();
+    // 수신 스레드에서 데이터그램 하나를 검사하여 메인 스레드 큐에 넣음
+    void HandleReceivedDatagram(const uint8* Data, int32 Size, const TSharedRef<FInternetAddr>& PeerAddr);
+    // 헤더 검사, 주소별 수신 제한, 핸드셰이크 처리와 캡처를 거쳐 처리 큐에 넣을 데이터그램이면 true
+    bool AcceptDatagram(const uint8* Data, int32 Size, const TSharedRef<FInternetAddr>& PeerAddr);
+    // 루프백 엔드포인트에 도착한 데이터그램을 복사 없이 처리 큐로 옮김
+    void ReceiveLoopbackDatagrams();
+    // 패킷 종류에 따라 제어/데이터 처리 큐에 넣음
+    void EnqueuePacket(const TSharedPtr<FInternetAddr>& PeerAddr, TArray<uint8>&& Data);
+    // 제어 큐를 먼저 비우는 순서로 처리할 패킷을 하나 꺼냄
+    bool DequeuePacket(FReceivedPacket& OutPacket);
+    // 남은 대기열 상태를 포함한 Tick 통계 갱신
+    void UpdateTickStats(FHktNetTickBudgetTracker& Tracker);
+    // 현재 전송 방식으로 데이터그램 하나를 보냄
+    bool SendDatagram(const uint8* Data, int32 Size, const FInternetAddr& Destination);
+    bool CanSend() const { return ListenSocket != nullptr || LoopbackEndpoint.IsValid(); }
+    // 예산 안에서 수신된 패킷 처리
+    void ProcessReceivedPackets(FHktNetTickBudgetTracker& Tracker);
+    // 다음 시퀀스 번호로 데이터 패킷(헤더 + 페이로드)을 만듦. 헤더는 맨 앞에서 시작. 호출자가 Connection.Mutex를 잡고 있어야 함
+    TArray<uint8> BuildDataPacket(FClientConnection& Connection, const TArray<uint8>& Data, FPacketHeader& OutHeader);
+    // HeaderSpace(HktPacketHeader::MaxSize 바이트)에 다음 시퀀스 번호의 데이터 헤더를 끝에 맞춰 채우고 헤더가 시작하는 오프셋을 반환.
+    // 호출자가 Connection.Mutex를 잡고 있어야 함
+    int32 WriteDataHeader(FClientConnection& Connection, uint8* HeaderSpace, FPacketHeader& OutHeader);
     // Ack 및 AckBitfield 처리
     void ProcessAck(const FPacketHeader& Header, TSharedPtr<FClientConnection> Connection);
-    // 수신 상태 업데이트 (ReceivedSequence, ReceivedAckBitfield)
-    void UpdateReceivedState(uint32 IncomingSequence, TSharedPtr<FClientConnection> Connection);
-    // 재전송이 필요한 패킷 검사 및 처리
-    void CheckForResends();
+    // 수신 상태 업데이트 (ReceivedSequence, ReceivedAckBitfield). 처음 받은 시퀀스면 true, 중복이거나 너무 오래되었으면 false
+    bool UpdateReceivedState(uint32 IncomingSequence, TSharedPtr<FClientConnection> Connection);
+    // 재전송이 필요한 패킷 검사 및 처리. 시간 예산을 다 쓰면 멈추고 다음 Tick에 그다음 연결부터 검사
+    void CheckForResends(FHktNetTickBudgetTracker& Tracker);
     // 일정 시간 응답 없는 클라이언트 타임아웃 처리
     void CheckForTimeouts();
+    // 주기가 된 그룹의 스냅샷을 만들어 각 클라이언트에게 델타 전송
+    void UpdateSnapshots();
+    // 바이트 예산 안에서 우선순위가 높은 변경만 반영한 클라이언트 전용 스냅샷을 만듦
+    FHktSnapshotFramePtr BuildPrioritizedFrame(FClientConnection& Connection, const FHktSnapshotFrame& Frame, const TMap<uint64, FHktReplicationSubject>& Subjects, float DeltaTime, int32 ByteBudget);
+    // 탐침 주기가 된 연결에 경로 MTU 탐침 전송
+    void UpdateMtuProbes();
+    // 남은 대역폭과 창 안에서 벌크 청크 전송. 게임플레이 송신이 모두 끝난 뒤 호출
+    void UpdateBulkTransfers();
+    // 재전송하지 않는 패킷 전송 (Ack 정보는 함께 실어 보냄). PadToSize가 있으면 데이터그램 전체가 그 크기가 되도록 0으로 채움
+    void SendUnreliable(FClientConnection& Connection, EPacketType Type, const TArray<uint8>& Payload, int32 PadToSize = 0);
+    // 헤더 자리가 비어 있는 패킷을 완성하여 재전송 없이 보냄
+    void SendPreparedUnreliable(FClientConnection& Connection, EPacketType Type, TArray<uint8>&& PacketData, int32 PadToSize = 0);
+    // 조각내지 않는 소켓에서 DatagramSize가 연결의 경로 MTU 안에 드는지 검사. 넘으면 오류 로그를 남기고 false
+    bool FitsPathMtu(FClientConnection& Connection, int32 DatagramSize, EPacketType Type);
 
-    // 새로운 클라이언트 연결 처리
-    void HandleNewConnection(const TSharedPtr<FInternetAddr>& NewAddr);
+    // 수신 스레드에서 핸드셰이크 패킷을 처리. true를 반환하면 패킷을 큐에 넣지 않고 버림
+    bool FilterHandshakePacket(const uint8* Data, int32 Size, const TSharedRef<FInternetAddr>& PeerAddr);
+    // 주어진 주소로 쿠키를 담은 ConnectChallenge 전송. 서버 상태는 만들지 않음
+    void SendConnectChallenge(const FInternetAddr& Addr);
+    // 주어진 주소와 발급 시각에 대한 쿠키 생성
+    void MakeConnectCookie(const FInternetAddr& Addr, uint32 IssuedAt, FHktConnectCookie& OutCookie) const;
+    // 클라이언트가 돌려보낸 쿠키 검증
+    bool VerifyConnectCookie(const FInternetAddr& Addr, const FHktConnectCookie& Cookie) const;
+
+    // 새로운 클라이언트 연결 처리. ClientMaxVersion은 클라이언트가 ConnectResponse에 실어 보낸 최대 헤더 버전
+    void HandleNewConnection(const TSharedPtr<FInternetAddr>& NewAddr, uint8 ClientMaxVersion);
     // 클라이언트 연결 해제 처리
     void DisconnectClient(const FString& ClientAddrStr, const FString& Reason);
+    // 세션 재개를 쓰면 연결을 일시 중단하고, 아니면 연결을 해제
+    void SuspendClient(const FString& ClientAddrStr, const FString& Reason);
+    // 연결을 모든 목록에서 제거. 호출자가 ConnectionsLock 쓰기 잠금을 잡고 있어야 함
+    void RemoveConnection(const TSharedPtr<FClientConnection>& Connection);
+    // 유예 시간이 지난 일시 중단 세션 제거
+    void ExpireSuspendedSessions();
+    // 세션 토큰으로 연결을 찾아 재개. 주소가 바뀌었으면 새 주소의 쿠키를 확인한 뒤에만 옮김
+    void HandleResume(const TSharedPtr<FInternetAddr>& PeerAddr, const FPacketHeader& Header, const uint8* Payload, int32 PayloadSize);
+
+    enum class EResumeResult : uint8
+    {
+        Resumed,
+        // 유예 시간이 지났거나 모르는 토큰
+        UnknownSession,
+        // 새 주소를 다른 연결이 쓰고 있음
+        AddressInUse,
+        // 주소가 바뀌어 새 주소의 쿠키를 확인해야 함
+        NeedsVerification
+    };
+    // ConnectionsLock 쓰기 잠금 안에서 재개 여부를 정하고 가능하면 새 주소로 옮김. bAddressVerified이면 주소가 바뀌어도 옮김
+    EResumeResult TryResume(const FHktSessionToken& Token, const TSharedPtr<FInternetAddr>& PeerAddr, const FString& NewAddrStr, bool bAddressVerified, TSharedPtr<FClientConnection>& OutConnection);
+    // Ack되지 않은 모든 패킷을 바로 재전송 대상으로 표시하고 재시도 횟수를 초기화. 실제 전송은 CheckForResends가 대역폭에 맞춰 나눔
+    void MarkAllPendingForResend(FClientConnection& Connection);
+    // 연결 ID와 무작위 값으로 추측할 수 없는 세션 토큰 생성
+    void MakeSessionToken(uint64 ConnectionId, FHktSessionToken& OutToken) const;
+    // 그룹 구성원 목록에서 연결 제거. 호출자가 ConnectionsLock 쓰기 잠금을 잡고 있어야 함
+    void RemoveGroupMember(int32 GroupId, const TSharedPtr<FClientConnection>& Connection);
     // ACK 패킷 전송
     void SendAck(TSharedPtr<FClientConnection> Connection);
+    // 핸드셰이크 완료 Ack 전송. 클라이언트가 아직 버전을 모르므로 v1 헤더에 협상된 버전과 세션 토큰을 실어 보냄
+    void SendHandshakeAck(TSharedPtr<FClientConnection> Connection);
 
     // 서버 리슨 소켓
     FSocket* ListenSocket = nullptr;
+    // 데이터그램 전송 방식과 루프백 전송일 때의 엔드포인트
+    EHktNetTransport Transport = EHktNetTransport::Socket;
+    TUniquePtr<FHktLoopbackEndpoint> LoopbackEndpoint;
     // 서버 포트
     uint16 Port;
     
@@ -107,20 +383,130 @@ private:
     // 스레드 중지 플래그
     FThreadSafeBool bIsStopping;
 
-    // 수신된 패킷들을 담는 스레드 안전 큐
+    // 수신된 패킷들을 담는 스레드 안전 큐. 제어 패킷은 별도 큐에 넣어 데이터가 밀려 있어도 먼저 처리
+    TQueue<FReceivedPacket, EQueueMode::Mpsc> ReceivedControlPackets;
     TQueue<FReceivedPacket, EQueueMode::Mpsc> ReceivedPackets;
+    // 두 큐에 들어 있는 패킷 수
+    std::atomic<int32> NumQueuedPackets{ 0 };
+    // 마지막 Tick 통계와 다음 재전송 검사를 시작할 연결 위치. 메인 스레드에서만 접근
+    FHktNetTickStats LastTickStats;
+    int32 ResendCursor = 0;
+
+    // 그룹 구성원 목록. 변경할 때마다 새 배열로 교체하므로(Copy-on-write) 읽는 쪽은 포인터만 얻으면 잠금 없이 순회 가능
+    using FGroupMembers = TArray<TSharedPtr<FClientConnection>>;
+    using FGroupMembersPtr = TSharedPtr<const FGroupMembers, ESPMode::ThreadSafe>;
+
+    // 주소 문자열로 연결 조회 (읽기 잠금)
+    TSharedPtr<FClientConnection> FindConnection(const FString& AddrStr) const;
+    // 그룹 구성원 목록 조회 (읽기 잠금). 반환된 목록은 이후 변경되지 않음
+    FGroupMembersPtr GetGroupMembers(int32 GroupId) const;
+    // 여러 그룹과 그 하위 그룹 구성원의 합집합을 중복 없이 수집 (읽기 잠금)
+    void CollectGroupRecipients(const TArray<int32>& GroupIds, TArray<TSharedPtr<FClientConnection>>& OutRecipients) const;
+    // From 그룹에서 하위 그룹을 따라 To 그룹에 닿는지 여부. 호출자가 ConnectionsLock을 잡고 있어야 함
+    bool IsSubgroupReachable(int32 From, int32 To) const;
+    // 현재 모든 연결 목록 복사 (읽기 잠금)
+    TArray<TSharedPtr<FClientConnection>> GetAllConnections() const;
+    // 조회가 끝난 연결로 데이터 패킷 전송
+    void SendToConnection(FClientConnection& Connection, const TArray<uint8>& Data, uint64 CollapseKey = HktCollapseKey::None);
+    // 헤더 자리가 비어 있는 패킷을 완성하여 전송하고 재전송 대기 목록에 넣음
+    void SendPreparedToConnection(FClientConnection& Connection, TArray<uint8>&& PacketData, uint64 CollapseKey = HktCollapseKey::None);
+    // 여러 연결로 같은 데이터 전송. 수신자가 많으면 병렬 브로드캐스트 설정에 따라 구간별로 나눠 동시에 보냄
+    void SendToConnections(const TArray<TSharedPtr<FClientConnection>>& Recipients, const TArray<uint8>& Data, const TSharedPtr<FInternetAddr>& ExcludeAddr);
 
     // 연결된 클라이언트 정보 (주소 -> 정보)
     TMap<FString, TSharedPtr<FClientConnection>> Connections;
+    // 연결 ID로 찾기 위한 맵 (연결 ID -> 정보). 일시 중단된 세션도 포함
+    TMap<uint64, TSharedPtr<FClientConnection>> ConnectionsById;
+    // 세션 토큰으로 찾기 위한 맵 (토큰 -> 정보). 일시 중단된 세션도 포함
+    TMap<FHktSessionToken, TSharedPtr<FClientConnection>> Sessions;
+    uint64 NextConnectionId = 1;
+    // 연결 번호(FClientConnection::Slot) 할당 상태. 해제된 번호를 먼저 다시 씀
+    TArray<int32> FreeConnectionSlots;
+    int32 NumConnectionSlots = 0;
     
-    // 그룹 정보 (그룹 ID -> 클라이언트 주소 맵)
-    TMap<int32, TMap<FString, TSharedPtr<FInternetAddr>>> Groups;
-    
-    // Connections, Groups 접근을 위한 크리티컬 섹션
-    FCriticalSection ConnectionMutex;
+    // 그룹 정보 (그룹 ID -> 구성원 목록)
+    TMap<int32, FGroupMembersPtr> Groups;
+    // 그룹 계층 (상위 그룹 ID -> 하위 그룹 ID 목록)
+    TMap<int32, TArray<int32>> Subgroups;
+
+    // Connections, ConnectionsById, Sessions, Groups, Subgroups, 각 연결의 GroupIds 보호용.
+    // 조회가 대부분이고 연결/해제/그룹 변경만 쓰기 잠금을 잡음
+    mutable FRWLock ConnectionsLock;
+
+    // 클라이언트 관심 위치 격자 (연결 ID -> 위치)
+    FHktInterestGrid InterestGrid;
+    mutable FRWLock InterestLock;
+
+    // 수신 트래픽 캡처. 수신 스레드가 기록하고 시작/종료는 다른 스레드에서 하므로 잠금으로 보호
+    FThreadSafeBool bCapturing;
+    FCriticalSection CaptureMutex;
+    TUniquePtr<FHktTrafficCaptureWriter> CaptureWriter;
+
+    // 주소별 수신 제한. 수신 스레드(루프백이면 메인 스레드)에서만 접근
+    int32 ReceiveRateLimit = 2000;
+    int32 ReceiveRateBurst = 2000;
+    FHktSourceRateLimiter RateLimiter;
+    // 수신 스레드에서 버린 데이터그램 수
+    std::atomic<int64> NumDroppedMalformed{ 0 };
+    std::atomic<int64> NumDroppedRateLimited{ 0 };
+    std::atomic<int64> NumDroppedTooManySources{ 0 };
+    // 대체 키로 대체된 메시지 수
+    std::atomic<int64> NumSupersededPackets{ 0 };
+
+    // 쿠키 서명용 비밀키. 서버 시작 시 무작위로 생성
+    uint8 CookieSecret[32];
+
+    // 그룹별 스냅샷 복제 설정
+    struct FSnapshotGroupConfig
+    {
+        // 스냅샷 주기 (초)
+        float Interval = 0.1f;
+        // 마지막 스냅샷 시간
+        double LastSnapshotTime = 0.0;
+        // 다음 스냅샷 ID
+        uint32 NextSnapshotId = 1;
+        // 클라이언트별 스냅샷 바이트 예산 (0이면 무제한)
+        int32 ByteBudget = 0;
+    };
+    TMap<int32, FSnapshotGroupConfig> SnapshotGroups;
+    FHktSnapshotProvider SnapshotProvider;
+    FHktReplicationSubjectProvider ReplicationSubjectProvider;
+
+    // UDP 오프로드 설정 및 런타임 검사 결과
+    bool bUdpOffloadEnabled = true;
+    bool bSendOffloadActive = false;
+    bool bReceiveOffloadActive = false;
+
+    // 새 연결과 협상할 최대 헤더 버전
+    uint8 MaxHeaderVersion = HktPacketHeader::LatestVersion;
+
+    // 경로 MTU 탐색 설정 및 런타임 검사 결과
+    bool bMtuDiscoveryEnabled = false;
+    bool bMtuDiscoveryActive = false;
+
+    // 벌크 전송 설정과 상태. 메인 스레드에서만 접근
+    int32 SendBandwidth = 2 * 1024 * 1024;
+    uint32 NextBulkTransferId = 1;
+    FHktDataReceivedCallback DataReceivedCallback;
+    FHktBulkCompleteCallback BulkCompleteCallback;
+    // 연결이 끊겨 중단된 전송. 다음 Tick에 통지 (클라이언트 주소, 전송 ID)
+    TArray<TPair<TSharedPtr<FInternetAddr>, uint32>> AbortedBulkTransfers;
+
+    // 병렬 브로드캐스트 설정. 병렬로 나눌 최소 수신자 수(0이면 끔)와 최대 작업 수(0이면 작업 스레드 수 + 1)
+    int32 ParallelBroadcastMinRecipients = 0;
+    int32 ParallelBroadcastMaxTasks = 0;
+    // 작업 하나가 맡는 최소 수신자 수. 너무 잘게 나누면 작업 분배 비용이 전송보다 커짐
+    static constexpr int32 MinRecipientsPerTask = 64;
+
+    // 세션 유지 시간 (초). 0이면 세션 재개를 쓰지 않음
+    float SessionGracePeriod = 30.0f;
+    // 중단된 세션 하나에 쌓아 둘 수 있는 재전송 대기 패킷 수
+    int32 MaxSuspendedPendingPackets = 1024;
 
     // 재전송 관련 상수
     const float ResendTimeout = 0.2f; // 200ms
+    // 재전송 허용량을 쌓아 둘 수 있는 최대 시간. 송신 대역폭 x 이 시간만큼까지 한 Tick에 재전송
+    const float ResendBurstTime = 0.05f; // 50ms
     const int32 MaxRetries = 10;
 	const float ClientTimeoutDuration = 5.0f; // 5 seconds
 };
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 복제 우선순위 계산에 쓰는 개체 정보
+struct FHktReplicationSubject
+{
+    FVector Location = FVector::ZeroVector;
+    // 관련도 가중치 (1이 기본, 0이면 보내지 않음)
+    float Relevance = 1.0f;
+};
+
+// 이번에 보낼지 결정할 후보 (변경되었지만 아직 이 클라이언트에게 보내지 않은 개체)
+struct FHktReplicationCandidate
+{
+    uint64 SubjectId = 0;
+    FHktReplicationSubject Subject;
+    // 전송 시 예상 바이트 수
+    int32 Size = 0;
+};
+
+/**
+ * 클라이언트 하나에 대한 복제 우선순위 누적기.
+ * 후보로 남아 있는 동안 우선순위가 (경과 시간 x 관련도 / 거리 감쇠)만큼 쌓이고,
+ * 가장 높은 것부터 바이트 예산이 찰 때까지 선택합니다. 선택된 개체는 누적값이 0으로 돌아갑니다.
+ * 선택은 힙 구성 O(n) + 선택된 k개에 대해 O(k log n)입니다. 후보마다 증가 속도(관련도, 거리)가 달라
+ * 호출마다 순서가 바뀌므로 모든 후보의 누적값을 한 번씩은 갱신해야 하고, 호출하는 쪽도 델타를 만들며
+ * 개체를 모두 훑으므로 이 O(n)이 전체 비용을 바꾸지 않습니다. 누적 맵과 힙 버퍼는 호출 사이에 재사용하여
+ * 매 호출마다 새로 할당하지 않습니다.
+ */
+class HKTCUSTOMNET_API FHktReplicationPrioritizer
+{
+public:
+    // DistanceScale: 이 거리만큼 멀어질 때마다 우선순위 증가 속도가 1/(1 + 거리/DistanceScale)로 줄어듦
+    explicit FHktReplicationPrioritizer(float InDistanceScale = 2000.0f);
+
+    // 후보들의 우선순위를 DeltaTime만큼 누적하고 ByteBudget 안에서 보낼 후보의 인덱스를 우선순위 순으로 OutSelected에 담음.
+    // 가장 높은 후보 하나는 예산을 넘더라도 항상 선택되어 큰 개체가 굶지 않음. 후보에서 빠진 개체의 누적값은 버림
+    void Select(const FVector* ViewLocation, TArrayView<const FHktReplicationCandidate> Candidates, float DeltaTime, int32 ByteBudget, TArray<int32>& OutSelected);
+
+    // 현재 누적된 우선순위 (후보가 아니면 0)
+    float GetPriority(uint64 SubjectId) const
+    {
+        const FAccumulator* Accumulator = Accumulated.Find(SubjectId);
+        return Accumulator && Accumulator->Generation == Generation ? Accumulator->Priority : 0.0f;
+    }
+    void Reset() { Accumulated.Reset(); }
+
+private:
+    struct FAccumulator
+    {
+        float Priority = 0.0f;
+        // 마지막으로 후보였던 Select 호출 번호. 현재 번호와 다르면 후보에서 빠진 것
+        uint32 Generation = 0;
+    };
+
+    struct FRankedCandidate
+    {
+        float Priority;
+        int32 Index;
+    };
+
+    float DistanceScale;
+    // 개체 ID -> 누적 우선순위
+    TMap<uint64, FAccumulator> Accumulated;
+    uint32 Generation = 0;
+    // 힙 버퍼 (호출 사이에 재사용)
+    TArray<FRankedCandidate> Heap;
+};
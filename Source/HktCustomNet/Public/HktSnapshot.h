@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 스냅샷에 담기는 개체 하나의 직렬화된 상태.
+// 변경되지 않은 상태는 여러 스냅샷과 여러 클라이언트의 기준 스냅샷이 같은 버퍼를 공유합니다.
+using FHktSnapshotState = TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe>;
+
+// 한 그룹의 특정 시점 상태
+struct HKTCUSTOMNET_API FHktSnapshotFrame
+{
+    // 그룹 ID
+    int32 GroupId = 0;
+    // 그룹 내에서 단조 증가하는 스냅샷 ID. 0은 '기준 없음'을 의미
+    uint32 SnapshotId = 0;
+    // 개체 ID -> 직렬화된 상태
+    TMap<uint64, FHktSnapshotState> Entities;
+};
+
+using FHktSnapshotFramePtr = TSharedPtr<const FHktSnapshotFrame, ESPMode::ThreadSafe>;
+
+/**
+ * 한 그룹에 대해 최근 스냅샷들과 델타 기준(Baseline)을 보관합니다.
+ * 서버에서는 클라이언트별로 '보낸 스냅샷'과 'Ack 받은 기준'을, 클라이언트에서는 '받은 스냅샷'과 '서버가 사용한 기준'을 보관합니다.
+ */
+struct HKTCUSTOMNET_API FHktSnapshotHistory
+{
+    // 델타의 기준이 되는 스냅샷 ID (0이면 기준 없음 -> 전체 스냅샷)
+    uint32 BaselineId = 0;
+    // 최근 스냅샷들 (ID 오름차순)
+    TArray<FHktSnapshotFramePtr> Frames;
+
+    const FHktSnapshotFrame* Find(uint32 SnapshotId) const;
+    const FHktSnapshotFrame* GetBaseline() const { return BaselineId != 0 ? Find(BaselineId) : nullptr; }
+    uint32 GetLatestId() const { return Frames.Num() > 0 ? Frames.Last()->SnapshotId : 0; }
+
+    // 새 스냅샷 추가. 최대 개수를 넘으면 기준 스냅샷을 제외한 가장 오래된 것부터 버림
+    void Add(const FHktSnapshotFramePtr& Frame);
+    // 기준 스냅샷 갱신. 0이면 기준을 초기화하고, 기준보다 오래된 스냅샷은 버림
+    void SetBaseline(uint32 SnapshotId);
+};
+
+namespace HktSnapshot
+{
+    // 그룹별로 보관할 최대 스냅샷 수
+    constexpr int32 MaxFrames = 32;
+
+    HKTCUSTOMNET_API FHktSnapshotState MakeState(TArray<uint8>&& Bytes);
+    HKTCUSTOMNET_API bool IsSameState(const FHktSnapshotState& A, const FHktSnapshotState& B);
+
+    // Baseline 대비 추가/변경/삭제된 개체만 인코딩. Baseline이 nullptr이면 전체 스냅샷
+    HKTCUSTOMNET_API TArray<uint8> EncodeDelta(const FHktSnapshotFrame& Current, const FHktSnapshotFrame* Baseline);
+    // 인코딩된 델타의 앞부분만 읽어 그룹, 스냅샷, 기준 ID를 확인
+    HKTCUSTOMNET_API bool ReadDeltaHeader(const uint8* Data, int32 Size, int32& OutGroupId, uint32& OutSnapshotId, uint32& OutBaselineId);
+    // Baseline에 델타를 적용하여 스냅샷 복원. 델타의 기준 ID와 Baseline이 일치해야 함
+    HKTCUSTOMNET_API bool DecodeDelta(const uint8* Data, int32 Size, const FHktSnapshotFrame* Baseline, FHktSnapshotFrame& OutFrame);
+}
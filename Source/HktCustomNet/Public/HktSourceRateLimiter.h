@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+
+class FInternetAddr;
+
+/**
+ * 보낸 주소별 토큰 버킷 수신 제한.
+ * 수신 스레드가 데이터그램을 복사해 처리 큐에 넣기 전에 호출하여, 한 주소가 폭주시키는 패킷은 메인 스레드에 닿기 전에 버립니다.
+ * 주소마다 초당 Rate개의 토큰이 Burst개까지 쌓이며 데이터그램 하나에 토큰 하나를 씁니다.
+ * 추적하는 주소 수는 MaxSources로 제한합니다. 가득 차면 토큰이 다 찬(새 주소와 구분되지 않는) 주소부터 정리하고,
+ * 그래도 자리가 없으면 새 주소의 데이터그램을 버립니다.
+ * 면제된 주소(서버에 연결된 클라이언트)는 제한하지 않으며 주소 표의 자리도 차지하지 않습니다.
+ * QueueExemption은 어느 스레드에서나 호출할 수 있고, 나머지는 Consume을 호출하는 한 스레드에서만 사용합니다.
+ */
+class HKTCUSTOMNET_API FHktSourceRateLimiter
+{
+public:
+    static constexpr int32 DefaultMaxSources = 16384;
+    // 주소 테이블이 가득 찼을 때 정리를 시도하는 최소 간격 (초). 위조 주소 폭주 중에 매 패킷 전체를 훑지 않도록 함
+    static constexpr double PruneInterval = 1.0;
+
+    enum class EResult : uint8
+    {
+        Allowed,
+        // 주소의 토큰이 바닥남
+        RateLimited,
+        // 새 주소인데 추적할 자리가 없음
+        TooManySources
+    };
+
+    // Rate가 0 이하이면 제한하지 않음. 기존 주소 상태는 지움
+    void Configure(double InRate, double InBurst, int32 InMaxSources = DefaultMaxSources);
+    bool IsEnabled() const { return Rate > 0.0; }
+
+    // Addr에서 온 데이터그램 하나에 토큰을 씀. Now는 HktNetClock 시각
+    EResult Consume(const FInternetAddr& Addr, double Now);
+
+    // Addr의 면제를 걸거나 풂. 다음 Consume에서 반영됨. 같은 주소에 건 횟수만큼 풀어야 면제가 끝남. 제한이 꺼져 있으면 무시
+    void QueueExemption(const FInternetAddr& Addr, bool bExempt);
+
+    int32 GetNumSources() const { return Buckets.Num(); }
+    void Reset();
+
+private:
+    struct FBucket
+    {
+        double Tokens = 0.0;
+        double LastTime = 0.0;
+    };
+
+    // 주소 해시와 포트로 만든 키. 해시가 겹친 두 주소는 버킷과 면제를 함께 씀
+    static uint64 MakeKey(const FInternetAddr& Addr);
+    // 토큰이 다 찬 버킷 제거
+    void Prune(double Now);
+    // 쌓인 면제 변경을 반영
+    void ApplyExemptions();
+
+    struct FExemptionUpdate
+    {
+        uint64 Key = 0;
+        bool bExempt = false;
+    };
+
+    TMap<uint64, FBucket> Buckets;
+    // 키별 면제 횟수. Consume을 호출하는 스레드만 접근
+    TMap<uint64, int32> Exemptions;
+    TQueue<FExemptionUpdate, EQueueMode::Mpsc> PendingExemptions;
+    double Rate = 0.0;
+    double Burst = 0.0;
+    int32 MaxSources = DefaultMaxSources;
+    double LastPruneTime = -PruneInterval;
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IPAddress.h"
+
+class FHktReliableUdpServer;
+
+/**
+ * 수신 트래픽 캡처 파일 형식.
+ * 파일 헤더 뒤에 레코드가 이어지며, 레코드는 [레코드 헤더][페이로드] 순서입니다.
+ * 주소는 처음 등장할 때 Peer 레코드로 한 번만 기록하고 이후 데이터그램은 핸들로만 참조합니다.
+ */
+namespace HktTrafficCapture
+{
+    constexpr uint32 Magic = 0x43544B48; // 'HKTC'
+    constexpr uint16 Version = 1;
+
+    enum class ERecordKind : uint8
+    {
+        // 수신 데이터그램. 페이로드는 데이터그램 원본
+        Datagram,
+        // 새 주소 등록. 페이로드는 [IP 길이(uint8)][IP (네트워크 바이트 순서)][포트(uint16)]
+        Peer
+    };
+
+#pragma pack(push, 1)
+    struct FFileHeader
+    {
+        uint32 Magic;
+        uint16 Version;
+        uint16 Reserved;
+        // 캡처 시작 시각 (UTC Unix time, 초). 참고용
+        int64 StartUnixTime;
+    };
+
+    struct FRecordHeader
+    {
+        ERecordKind Kind;
+        // 직전 레코드로부터 지난 시간 (마이크로초)
+        uint32 DeltaMicros;
+        // 주소 핸들 (0부터 등록 순서대로)
+        uint32 PeerHandle;
+        // 페이로드 크기
+        uint16 Size;
+    };
+#pragma pack(pop)
+}
+
+/**
+ * 수신 데이터그램을 캡처 파일에 기록합니다.
+ * 수신 스레드에서 호출되므로 파일을 미리 최대 크기로 잡고 메모리 매핑하여 레코드마다 memcpy만 합니다.
+ * 메모리 매핑을 쓸 수 없는 플랫폼에서는 버퍼링된 파일 쓰기로 대체합니다.
+ * 최대 크기를 넘으면 이후 데이터그램은 버리고 개수만 셉니다.
+ * 스레드 안전하지 않으므로 한 스레드에서만 쓰거나 호출자가 잠금을 잡아야 합니다.
+ */
+class HKTCUSTOMNET_API FHktTrafficCaptureWriter
+{
+public:
+    FHktTrafficCaptureWriter() = default;
+    ~FHktTrafficCaptureWriter();
+
+    FHktTrafficCaptureWriter(const FHktTrafficCaptureWriter&) = delete;
+    FHktTrafficCaptureWriter& operator=(const FHktTrafficCaptureWriter&) = delete;
+
+    // 파일을 만들고 기록을 시작. 같은 경로의 파일은 덮어씀
+    bool Open(const FString& Path, int64 MaxBytes);
+    // 기록을 끝내고 파일을 실제 기록한 크기로 줄여 닫음
+    void Close();
+    bool IsOpen() const { return MappedData != nullptr || FileWriter.IsValid(); }
+
+    // 데이터그램 하나를 기록
+    void WriteDatagram(const TSharedRef<FInternetAddr>& PeerAddr, const uint8* Data, int32 Size);
+
+    int64 GetNumBytesWritten() const { return WriteOffset; }
+    int32 GetNumDatagrams() const { return NumDatagrams; }
+    // 최대 크기를 넘어 기록하지 못한 데이터그램 수
+    int32 GetNumDropped() const { return NumDropped; }
+
+private:
+    // 주소 핸들을 찾고, 처음 보는 주소면 경과 시간을 실은 Peer 레코드를 기록한 뒤 새 핸들을 부여. 기록하지 못하면 false
+    bool FindOrAddPeer(const TSharedRef<FInternetAddr>& PeerAddr, uint32& OutHandle, uint32& InOutDeltaMicros);
+    // 레코드 헤더와 페이로드를 이어서 기록. 공간이 부족하면 false
+    bool AppendRecord(const HktTrafficCapture::FRecordHeader& Header, const void* Payload);
+    bool Append(const void* Data, int64 Size);
+
+    // 메모리 매핑 기록 상태
+    uint8* MappedData = nullptr;
+    int64 MappedSize = 0;
+    int32 NativeFile = -1;
+    // 메모리 매핑을 쓸 수 없을 때의 대체 경로
+    TUniquePtr<FArchive> FileWriter;
+
+    int64 MaxSize = 0;
+    int64 WriteOffset = 0;
+    double StartTime = 0.0;
+    uint64 LastRecordMicros = 0;
+
+    TMap<TSharedRef<FInternetAddr>, uint32, FDefaultSetAllocator, FInternetAddrKeyMapFuncs<uint32>> PeerHandles;
+    int32 NumDatagrams = 0;
+    int32 NumDropped = 0;
+};
+
+// 재생 결과
+struct FHktTrafficReplayStats
+{
+    int32 NumDatagrams = 0;
+    int64 NumBytes = 0;
+    // 재생하는 동안 호출한 서버 Tick 수
+    int32 NumTicks = 0;
+    // 캡처된 구간의 길이 (초)
+    double RecordedSeconds = 0.0;
+    // 재생에 걸린 실제 시간 (초)
+    double WallSeconds = 0.0;
+};
+
+/**
+ * 캡처 파일을 읽어 서버의 수신 큐에 다시 넣고 Tick으로 처리시킵니다.
+ * 캡처는 핸드셰이크 검사를 통과한 패킷만 담으므로 재생하는 서버의 쿠키 키와 무관하게 연결이 재현됩니다.
+ * 재생 서버를 Start하지 않으면 소켓이 없어 아무것도 보내지 않으므로 운영 트래픽을 오프라인에서 안전하게 프로파일링할 수 있습니다.
+ * Start한 서버로 재생하면 응답이 캡처된 주소로 실제 전송되므로 주의해야 합니다.
+ */
+class HKTCUSTOMNET_API FHktTrafficReplay
+{
+public:
+    // 캡처 파일을 읽음. 형식이 맞지 않으면 false
+    bool Load(const FString& Path);
+
+    int32 GetNumDatagrams() const { return Records.Num(); }
+    // 첫 데이터그램부터 마지막 데이터그램까지의 시간 (초)
+    double GetDuration() const { return Records.Num() > 0 ? Records.Last().Time - Records[0].Time : 0.0; }
+
+    /**
+     * 캡처를 서버에 재생합니다.
+     * @param Speed 0 이하이면 가능한 한 빠르게, 1이면 기록된 속도, 2이면 두 배 속도
+     * @param TickInterval 기록된 시간 기준으로 이 간격마다 서버 Tick을 호출하여 원래 프레임 단위 처리를 흉내 냄
+     */
+    FHktTrafficReplayStats Replay(FHktReliableUdpServer& Server, float Speed = 0.0f, float TickInterval = 1.0f / 60.0f) const;
+
+private:
+    struct FRecord
+    {
+        // 캡처 시작 기준 시각 (초)
+        double Time;
+        int32 PeerIndex;
+        int32 Offset;
+        int32 Size;
+    };
+
+    TArray<uint8> FileData;
+    TArray<FRecord> Records;
+    TArray<TSharedPtr<FInternetAddr>> Peers;
+};
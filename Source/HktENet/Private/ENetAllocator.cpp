@@ -0,0 +1,169 @@
+#include "ENetManager.h"
+#include "Containers/LockFreeFixedSizeAllocator.h"
+#include <atomic>
+#include <stdlib.h>
+
+namespace HktENetAllocator
+{
+    // 할당 앞에 붙는 헤더. 16바이트로 두어 사용자 영역의 정렬을 유지
+    struct alignas(16) FAllocationHeader
+    {
+        uint32 SizeClass;
+        uint32 Size;
+    };
+    constexpr uint32 HeaderSize = sizeof(FAllocationHeader);
+
+    // 헤더를 포함한 블록 크기. ENet의 명령과 Peer 구조체, MTU 이하 패킷 데이터가 들어감
+    constexpr uint32 BlockSizes[] = { 64, 128, 256, 512, 1024, 2048 };
+    constexpr uint32 NumSizeClasses = UE_ARRAY_COUNT(BlockSizes);
+    constexpr uint32 LargeClass = NumSizeClasses;
+    constexpr uint32 SystemClass = NumSizeClasses + 1;
+
+    std::atomic<EMode> CurrentMode{ EMode::Pooled };
+
+    std::atomic<int64> NumAllocations{ 0 };
+    std::atomic<int64> NumFrees{ 0 };
+    std::atomic<int64> NumLiveBytes{ 0 };
+    std::atomic<int64> NumTotalBytes{ 0 };
+    std::atomic<int64> NumPooledAllocations{ 0 };
+
+    template <uint32 BlockSize>
+    TLockFreeFixedSizeAllocator<BlockSize, PLATFORM_CACHE_LINE_SIZE>& GetPool()
+    {
+        // 프로세스 종료 중에도 ENet이 해제할 수 있으므로 풀은 소멸시키지 않음
+        static TLockFreeFixedSizeAllocator<BlockSize, PLATFORM_CACHE_LINE_SIZE>* Pool = new TLockFreeFixedSizeAllocator<BlockSize, PLATFORM_CACHE_LINE_SIZE>();
+        return *Pool;
+    }
+
+    void* AllocateBlock(uint32 SizeClass)
+    {
+        switch (SizeClass)
+        {
+        case 0: return GetPool<BlockSizes[0]>().Allocate();
+        case 1: return GetPool<BlockSizes[1]>().Allocate();
+        case 2: return GetPool<BlockSizes[2]>().Allocate();
+        case 3: return GetPool<BlockSizes[3]>().Allocate();
+        case 4: return GetPool<BlockSizes[4]>().Allocate();
+        case 5: return GetPool<BlockSizes[5]>().Allocate();
+        default: return nullptr;
+        }
+    }
+
+    void FreeBlock(uint32 SizeClass, void* Block)
+    {
+        switch (SizeClass)
+        {
+        case 0: GetPool<BlockSizes[0]>().Free(Block); break;
+        case 1: GetPool<BlockSizes[1]>().Free(Block); break;
+        case 2: GetPool<BlockSizes[2]>().Free(Block); break;
+        case 3: GetPool<BlockSizes[3]>().Free(Block); break;
+        case 4: GetPool<BlockSizes[4]>().Free(Block); break;
+        case 5: GetPool<BlockSizes[5]>().Free(Block); break;
+        default: break;
+        }
+    }
+
+    uint32 FindSizeClass(size_t BlockSize)
+    {
+        for (uint32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+        {
+            if (BlockSize <= BlockSizes[SizeClass])
+            {
+                return SizeClass;
+            }
+        }
+        return LargeClass;
+    }
+
+    void* ENET_CALLBACK Malloc(size_t Size)
+    {
+        const size_t BlockSize = Size + HeaderSize;
+        uint32 SizeClass = SystemClass;
+        void* Block = nullptr;
+        if (CurrentMode.load(std::memory_order_relaxed) == EMode::System)
+        {
+            Block = ::malloc(BlockSize);
+        }
+        else
+        {
+            SizeClass = FindSizeClass(BlockSize);
+            Block = SizeClass == LargeClass ? FMemory::Malloc(BlockSize, HeaderSize) : AllocateBlock(SizeClass);
+        }
+        if (!Block)
+        {
+            return nullptr;
+        }
+
+        FAllocationHeader* Header = static_cast<FAllocationHeader*>(Block);
+        Header->SizeClass = SizeClass;
+        Header->Size = (uint32)Size;
+
+        NumAllocations.fetch_add(1, std::memory_order_relaxed);
+        NumLiveBytes.fetch_add((int64)Size, std::memory_order_relaxed);
+        NumTotalBytes.fetch_add((int64)Size, std::memory_order_relaxed);
+        if (SizeClass < NumSizeClasses)
+        {
+            NumPooledAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        return static_cast<uint8*>(Block) + HeaderSize;
+    }
+
+    void ENET_CALLBACK Free(void* Memory)
+    {
+        if (!Memory)
+        {
+            return;
+        }
+
+        FAllocationHeader* Header = reinterpret_cast<FAllocationHeader*>(static_cast<uint8*>(Memory) - HeaderSize);
+        NumFrees.fetch_add(1, std::memory_order_relaxed);
+        NumLiveBytes.fetch_sub((int64)Header->Size, std::memory_order_relaxed);
+
+        // 할당한 방식대로 해제. 그 사이 모드가 바뀌었어도 안전함
+        if (Header->SizeClass == SystemClass)
+        {
+            ::free(Header);
+        }
+        else if (Header->SizeClass == LargeClass)
+        {
+            FMemory::Free(Header);
+        }
+        else
+        {
+            FreeBlock(Header->SizeClass, Header);
+        }
+    }
+
+    void ENET_CALLBACK NoMemory()
+    {
+        FPlatformMemory::OnOutOfMemory(0, HeaderSize);
+    }
+
+    void SetMode(EMode Mode)
+    {
+        CurrentMode.store(Mode, std::memory_order_relaxed);
+    }
+
+    EMode GetMode()
+    {
+        return CurrentMode.load(std::memory_order_relaxed);
+    }
+
+    FENetAllocatorStats GetStats()
+    {
+        FENetAllocatorStats Stats;
+        Stats.Allocations = NumAllocations.load(std::memory_order_relaxed);
+        Stats.Frees = NumFrees.load(std::memory_order_relaxed);
+        Stats.LiveAllocations = Stats.Allocations - Stats.Frees;
+        Stats.LiveBytes = NumLiveBytes.load(std::memory_order_relaxed);
+        Stats.TotalBytes = NumTotalBytes.load(std::memory_order_relaxed);
+        Stats.PooledAllocations = NumPooledAllocations.load(std::memory_order_relaxed);
+        return Stats;
+    }
+
+    const ENetCallbacks& GetCallbacks()
+    {
+        static const ENetCallbacks Callbacks = { &Malloc, &Free, &NoMemory };
+        return Callbacks;
+    }
+}
@@ -1,10 +1,150 @@
 #include "ENetManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Compression.h"
+
+namespace HktENetCompression
+{
+    // FCompression 형식을 ENetCompressor로 감싼 압축기. 압축 해제에는 원래 크기가 필요하므로 앞에 2바이트로 기록
+    struct FCompressionContext
+    {
+        FName FormatName;
+        // 여러 버퍼로 나뉜 입력을 이어 붙일 곳과 압축 결과를 받을 곳. 호스트를 서비스하는 스레드만 사용
+        TArray<uint8> Scratch;
+        TArray<uint8> Compressed;
+    };
+    constexpr size_t SizePrefixBytes = 2;
+
+    size_t ENET_CALLBACK CompressWithFormat(void* Context, const ENetBuffer* InBuffers, size_t InBufferCount, size_t InLimit, enet_uint8* OutData, size_t OutLimit)
+    {
+        FCompressionContext& Codec = *static_cast<FCompressionContext*>(Context);
+        if (InLimit > MAX_uint16 || OutLimit <= SizePrefixBytes)
+        {
+            return 0;
+        }
+
+        Codec.Scratch.Reset();
+        for (size_t BufferIndex = 0; BufferIndex < InBufferCount && (size_t)Codec.Scratch.Num() < InLimit; ++BufferIndex)
+        {
+            const size_t Size = FMath::Min<size_t>(InBuffers[BufferIndex].dataLength, InLimit - Codec.Scratch.Num());
+            Codec.Scratch.Append(static_cast<const uint8*>(InBuffers[BufferIndex].data), (int32)Size);
+        }
+
+        // 압축기는 출력 버퍼가 최악의 경우 크기보다 작으면 실패하거나 버퍼 끝을 넘어 쓸 수 있으므로,
+        // 최악의 크기만큼 잡은 별도 버퍼에 압축한 뒤 실제로 줄어든 경우에만 OutData로 복사
+        int32 CompressedSize = FCompression::CompressMemoryBound(Codec.FormatName, Codec.Scratch.Num());
+        if (Codec.Compressed.Num() < CompressedSize)
+        {
+            Codec.Compressed.SetNumUninitialized(CompressedSize);
+        }
+        if (!FCompression::CompressMemory(Codec.FormatName, Codec.Compressed.GetData(), CompressedSize, Codec.Scratch.GetData(), Codec.Scratch.Num(), COMPRESS_BiasSpeed))
+        {
+            return 0;
+        }
+        // OutLimit은 원래 크기이므로 줄어들지 않으면 실패하고 ENet이 압축하지 않은 채로 보냄
+        if ((size_t)CompressedSize >= OutLimit - SizePrefixBytes)
+        {
+            return 0;
+        }
+        OutData[0] = (enet_uint8)(Codec.Scratch.Num() & 0xFF);
+        OutData[1] = (enet_uint8)(Codec.Scratch.Num() >> 8);
+        FMemory::Memcpy(OutData + SizePrefixBytes, Codec.Compressed.GetData(), CompressedSize);
+        return SizePrefixBytes + CompressedSize;
+    }
+
+    size_t ENET_CALLBACK DecompressWithFormat(void* Context, const enet_uint8* InData, size_t InLimit, enet_uint8* OutData, size_t OutLimit)
+    {
+        const FCompressionContext& Codec = *static_cast<const FCompressionContext*>(Context);
+        if (InLimit <= SizePrefixBytes)
+        {
+            return 0;
+        }
+        const size_t UncompressedSize = (size_t)InData[0] | ((size_t)InData[1] << 8);
+        if (UncompressedSize > OutLimit
+            || !FCompression::UncompressMemory(Codec.FormatName, OutData, (int32)UncompressedSize, InData + SizePrefixBytes, (int32)(InLimit - SizePrefixBytes)))
+        {
+            return 0;
+        }
+        return UncompressedSize;
+    }
+
+    void ENET_CALLBACK DestroyFormatContext(void* Context)
+    {
+        delete static_cast<FCompressionContext*>(Context);
+    }
+
+    bool CreateCompressor(EENetCompression Compression, ENetCompressor& OutCompressor)
+    {
+        FName FormatName;
+        switch (Compression)
+        {
+        case EENetCompression::RangeCoder:
+            OutCompressor.context = enet_range_coder_create();
+            if (!OutCompressor.context)
+            {
+                return false;
+            }
+            OutCompressor.compress = enet_range_coder_compress;
+            OutCompressor.decompress = enet_range_coder_decompress;
+            OutCompressor.destroy = enet_range_coder_destroy;
+            return true;
+        case EENetCompression::LZ4:
+            FormatName = NAME_LZ4;
+            break;
+        case EENetCompression::Oodle:
+            FormatName = NAME_Oodle;
+            break;
+        default:
+            return false;
+        }
+
+        if (!FCompression::IsFormatValid(FormatName))
+        {
+            return false;
+        }
+        FCompressionContext* Context = new FCompressionContext();
+        Context->FormatName = FormatName;
+        OutCompressor.context = Context;
+        OutCompressor.compress = CompressWithFormat;
+        OutCompressor.decompress = DecompressWithFormat;
+        OutCompressor.destroy = DestroyFormatContext;
+        return true;
+    }
+}
+
+// 서비스 스레드 모드에서 ENetHost를 서비스하는 네트워크 스레드
+class FENetServiceRunnable : public FRunnable
+{
+public:
+    explicit FENetServiceRunnable(FENetManager& InManager) : Manager(InManager) {}
+
+    virtual uint32 Run() override
+    {
+        Manager.RunServiceThread();
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        Manager.bStopServiceThread = true;
+    }
+
+private:
+    FENetManager& Manager;
+};
 
 // FENetManager의 구현
 FENetManager::FENetManager()
 {
-    // ENet 라이브러리 초기화
-    if (enet_initialize() != 0)
+    // 트래픽 종류마다 채널을 따로 둠. 기존 전송 함수는 채널 0을 그대로 사용
+    TrafficClasses[(int32)EENetTrafficClass::Default] = FENetTrafficClassConfig(0, ENET_PACKET_FLAG_RELIABLE);
+    TrafficClasses[(int32)EENetTrafficClass::Input] = FENetTrafficClassConfig(1, ENET_PACKET_FLAG_RELIABLE);
+    TrafficClasses[(int32)EENetTrafficClass::State] = FENetTrafficClassConfig(2, (ENetPacketFlag)0);
+    TrafficClasses[(int32)EENetTrafficClass::Chat] = FENetTrafficClassConfig(3, ENET_PACKET_FLAG_RELIABLE);
+    TrafficClasses[(int32)EENetTrafficClass::Bulk] = FENetTrafficClassConfig(4, ENET_PACKET_FLAG_RELIABLE);
+
+    // ENet 라이브러리 초기화. 메모리 할당은 풀 할당기를 거침
+    if (enet_initialize_with_callbacks(ENET_VERSION, &HktENetAllocator::GetCallbacks()) != 0)
     {
         UE_LOG(LogTemp, Error, TEXT("An error occurred while initializing ENet."));
         bIsInitialized = false;
@@ -32,62 +172,104 @@ void FENetManager::Tick()
         return;
     }
 
-    ENetEvent Event;
+    if (ServiceThread)
+    {
+        // 네트워크 스레드가 모아 둔 이벤트를 전달
+        FENetQueuedEvent Queued;
+        while (Events.Dequeue(Queued))
+        {
+            HandleEvent(Queued.Event, Queued.ConnectID);
+        }
+        return;
+    }
+
     // non-blocking 방식으로 네트워크 이벤트 처리
+    ENetEvent Event;
     while (enet_host_service(Host, &Event, 0) > 0)
     {
-        switch (Event.type)
+        HandleEvent(Event, Event.peer ? Event.peer->connectID : 0);
+    }
+}
+
+void FENetManager::HandleEvent(const ENetEvent& Event, enet_uint32 ConnectID)
+{
+    switch (Event.type)
+    {
+    case ENET_EVENT_TYPE_CONNECT:
         {
-        case ENET_EVENT_TYPE_CONNECT:
+            UE_LOG(LogTemp, Log, TEXT("A new client connected from %x:%u."), Event.peer->address.host, Event.peer->address.port);
+            // 이 연결로 보내는 명령이 같은 자리의 다른 연결로 새지 않도록 기록
+            if (FENetPeerState* State = GetPeerState(Event.peer))
             {
-                UE_LOG(LogTemp, Log, TEXT("A new client connected from %x:%u."), Event.peer->address.host, Event.peer->address.port);
-                // 연결 이벤트가 발생하면 델리게이트 호출
-                if (OnClientConnected.IsBound())
-                {
-                    OnClientConnected.Broadcast(Event.peer);
-                }
+                State->ConnectID = ConnectID;
             }
-            break;
+            // 연결 이벤트가 발생하면 델리게이트 호출
+            if (OnClientConnected.IsBound())
+            {
+                OnClientConnected.Broadcast(Event.peer);
+            }
+        }
+        break;
 
-        case ENET_EVENT_TYPE_RECEIVE:
+    case ENET_EVENT_TYPE_RECEIVE:
+        {
+            // TArray 델리게이트는 바인딩되어 있을 때만 복사. 뷰 콜백이 패킷을 가져가 해제하기 전에 먼저 전달
+            if (OnPacketReceived.IsBound())
             {
-                // 패킷 수신 시 TArray로 데이터 복사 후 델리게이트 호출
-                TArray<uint8> ReceivedData;
-                ReceivedData.Append(Event.packet->data, Event.packet->dataLength);
-                
-                if (OnPacketReceived.IsBound())
-                {
-                    OnPacketReceived.Broadcast(Event.peer, ReceivedData);
-                }
-                // 패킷 리소스 해제
-                enet_packet_destroy(Event.packet);
+                TArray<uint8> ReceivedData(Event.packet->data, (int32)Event.packet->dataLength);
+                OnPacketReceived.Broadcast(Event.peer, ReceivedData);
             }
-            break;
 
-        case ENET_EVENT_TYPE_DISCONNECT:
+            // 패킷 버퍼를 그대로 뷰로 전달. 콜백에서 TakeReceivedPacket으로 소유권을 가져갈 수 있음
+            ReceivingPacket = Event.packet;
+            if (OnPacketViewReceived.IsBound())
             {
-                UE_LOG(LogTemp, Log, TEXT("%x:%u disconnected."), Event.peer->address.host, Event.peer->address.port);
-                
-                // [수정] 연결이 끊긴 클라이언트를 모든 그룹에서 자동으로 제거
-                RemovePeerFromAllGroups(Event.peer);
+                OnPacketViewReceived.Broadcast(Event.peer, TArrayView<const uint8>(Event.packet->data, (int32)Event.packet->dataLength));
+            }
 
-                // 연결 종료 이벤트가 발생하면 델리게이트 호출
-                if (OnClientDisconnected.IsBound())
-                {
-                    OnClientDisconnected.Broadcast(Event.peer);
-                }
-                if (ServerPeer == Event.peer)
-                {
-                    ServerPeer = nullptr;
-                }
+            // 소유권을 가져가지 않았으면 패킷 리소스 해제
+            if (ReceivingPacket)
+            {
+                enet_packet_destroy(ReceivingPacket);
+                ReceivingPacket = nullptr;
+            }
+        }
+        break;
+
+    case ENET_EVENT_TYPE_DISCONNECT:
+        {
+            UE_LOG(LogTemp, Log, TEXT("%x:%u disconnected."), Event.peer->address.host, Event.peer->address.port);
+            
+            // [수정] 연결이 끊긴 클라이언트를 모든 그룹에서 자동으로 제거
+            RemovePeerFromAllGroups(Event.peer);
+            if (FENetPeerState* State = GetPeerState(Event.peer))
+            {
+                State->ConnectID = 0;
+            }
+
+            // 연결 종료 이벤트가 발생하면 델리게이트 호출
+            if (OnClientDisconnected.IsBound())
+            {
+                OnClientDisconnected.Broadcast(Event.peer);
+            }
+            if (ServerPeer == Event.peer)
+            {
+                ServerPeer = nullptr;
             }
-            break;
-        case ENET_EVENT_TYPE_NONE:
-            break;
         }
+        break;
+    case ENET_EVENT_TYPE_NONE:
+        break;
     }
 }
 
+FENetPacketHandle FENetManager::TakeReceivedPacket()
+{
+    ENetPacket* Packet = ReceivingPacket;
+    ReceivingPacket = nullptr;
+    return FENetPacketHandle(Packet);
+}
+
 bool FENetManager::StartServer(uint16 Port, int32 MaxClients)
 {
     if (!bIsInitialized || Host) return false;
@@ -96,14 +278,18 @@ bool FENetManager::StartServer(uint16 Port, int32 MaxClients)
     Address.host = ENET_HOST_ANY;
     Address.port = Port;
 
-    // 서버 호스트 생성 (2개 채널)
-    Host = enet_host_create(&Address, MaxClients, 2, 0, 0);
+    // 서버 호스트 생성 (트래픽 종류 설정에 따른 채널 수)
+    Host = enet_host_create(&Address, MaxClients, GetChannelCount(), 0, 0);
 
     if (Host == nullptr)
     {
         UE_LOG(LogTemp, Error, TEXT("An error occurred while trying to create an ENet server host."));
         return false;
     }
+    InitPeerStates();
+    InitChannelCounters();
+    ApplyCompression();
+    StartServiceThread();
 
     UE_LOG(LogTemp, Log, TEXT("ENet Server started on port %d"), Port);
     return true;
@@ -114,24 +300,28 @@ bool FENetManager::StartClient(const FString& HostName, uint16 Port)
     if (!bIsInitialized || Host) return false;
 
     // 클라이언트 호스트 생성
-    Host = enet_host_create(NULL, 1, 2, 0, 0);
+    Host = enet_host_create(NULL, 1, GetChannelCount(), 0, 0);
     if (Host == nullptr)
     {
         UE_LOG(LogTemp, Error, TEXT("An error occurred while trying to create an ENet client host."));
         return false;
     }
+    InitPeerStates();
+    InitChannelCounters();
+    ApplyCompression();
 
     ENetAddress Address;
     enet_address_set_host(&Address, TCHAR_TO_ANSI(*HostName));
     Address.port = Port;
 
     // 서버에 연결 시도
-    ServerPeer = enet_host_connect(Host, &Address, 2, 0);
+    ServerPeer = enet_host_connect(Host, &Address, GetChannelCount(), 0);
     if (ServerPeer == nullptr)
     {
         UE_LOG(LogTemp, Error, TEXT("No available peers for initiating an ENet connection."));
         return false;
     }
+    StartServiceThread();
 
     UE_LOG(LogTemp, Log, TEXT("ENet Client connecting to %s:%d"), *HostName, Port);
     return true;
@@ -141,9 +331,15 @@ void FENetManager::Stop()
 {
     if (Host)
     {
+        // 네트워크 스레드가 호스트를 다 쓴 뒤에 정리
+        StopServiceThread();
         // 서버/클라이언트 종료 시 그룹 정보 초기화
         ClientGroups.Empty();
         enet_host_destroy(Host);
+        PeerStates.Empty();
+        // 남은 패킷은 호스트와 함께 해제되었으므로 통계도 정리
+        ChannelCounters.Reset();
+        NumChannelCounters = 0;
         Host = nullptr;
         ServerPeer = nullptr;
         UE_LOG(LogTemp, Log, TEXT("ENet Host stopped."));
@@ -151,19 +347,100 @@ void FENetManager::Stop()
 }
 
 void FENetManager::SendPacketToPeer(ENetPeer* Peer, const TArray<uint8>& Data, ENetPacketFlag Flags)
+{
+    SendPacketToPeer(Peer, Data, FENetTrafficClassConfig(0, Flags));
+}
+
+void FENetManager::SendPacketToPeer(ENetPeer* Peer, const TArray<uint8>& Data, EENetTrafficClass TrafficClass)
+{
+    SendPacketToPeer(Peer, Data, GetTrafficClassConfig(TrafficClass));
+}
+
+void FENetManager::SendPacketToPeer(ENetPeer* Peer, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config)
 {
     if (!Peer) return;
     // TArray의 데이터를 기반으로 ENet 패킷 생성
-    ENetPacket* Packet = enet_packet_create(Data.GetData(), Data.Num(), Flags);
-    // 0번 채널로 패킷 전송
-    enet_peer_send(Peer, 0, Packet);
+    ENetPacket* Packet = CreatePacket(Data, Config.ChannelID, Config.Flags);
+    if (!Packet) return;
+    DispatchPacket(Packet, Config.ChannelID, MakeArrayView(&Peer, 1));
+}
+
+void FENetManager::SendPacketToPeers(TArrayView<ENetPeer* const> Peers, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config)
+{
+    if (Peers.Num() == 0) return;
+
+    // 패킷은 한 번만 만들고 각 Peer의 송신 큐가 참조함. 마지막 참조가 풀릴 때 ENet이 해제
+    ENetPacket* Packet = CreatePacket(Data, Config.ChannelID, Config.Flags);
+    if (!Packet) return;
+    DispatchPacket(Packet, Config.ChannelID, Peers);
+}
+
+void FENetManager::DispatchPacket(ENetPacket* Packet, uint8 ChannelID, TArrayView<ENetPeer* const> Peers)
+{
+    if (ServiceThread)
+    {
+        // 호스트는 네트워크 스레드만 다루므로 명령으로 넘김. 네트워크 스레드는 Peer 자리를 바로 재사용할 수 있으므로
+        // Tick 스레드가 아는 connectID를 함께 넘겨, 명령이 처리될 때 다른 연결이 그 자리에 있으면 보내지 않음
+        FENetCommand Command;
+        Command.Packet = Packet;
+        Command.ChannelID = ChannelID;
+        Command.Peers = Peers;
+        Command.ConnectIDs.Reserve(Peers.Num());
+        for (ENetPeer* Peer : Peers)
+        {
+            const FENetPeerState* State = GetPeerState(Peer);
+            Command.ConnectIDs.Add(State ? State->ConnectID : 0);
+        }
+        Commands.Enqueue(MoveTemp(Command));
+        return;
+    }
+    SendPacketNow(Packet, ChannelID, Peers);
+}
+
+void FENetManager::SendPacketNow(ENetPacket* Packet, uint8 ChannelID, TArrayView<ENetPeer* const> Peers, TArrayView<const enet_uint32> ConnectIDs)
+{
+    // 실패한 Peer(연결되지 않았거나 채널이 없음)는 패킷을 참조하지 않음
+    for (int32 PeerIndex = 0; PeerIndex < Peers.Num(); ++PeerIndex)
+    {
+        ENetPeer* Peer = Peers[PeerIndex];
+        if (ConnectIDs.Num() > 0 && (ConnectIDs[PeerIndex] == 0 || ConnectIDs[PeerIndex] != Peer->connectID))
+        {
+            continue;
+        }
+        enet_peer_send(Peer, ChannelID, Packet);
+    }
+    // 아무 Peer에도 들어가지 않았으면 직접 해제
+    if (Packet->referenceCount == 0)
+    {
+        enet_packet_destroy(Packet);
+    }
 }
 
 void FENetManager::BroadcastPacketToClients(const TArray<uint8>& Data, ENetPacketFlag Flags)
+{
+    BroadcastPacketToClients(Data, FENetTrafficClassConfig(0, Flags));
+}
+
+void FENetManager::BroadcastPacketToClients(const TArray<uint8>& Data, EENetTrafficClass TrafficClass)
+{
+    BroadcastPacketToClients(Data, GetTrafficClassConfig(TrafficClass));
+}
+
+void FENetManager::BroadcastPacketToClients(const TArray<uint8>& Data, const FENetTrafficClassConfig& Config)
 {
     if (!Host) return;
-    ENetPacket* Packet = enet_packet_create(Data.GetData(), Data.Num(), Flags);
-    enet_host_broadcast(Host, 0, Packet);
+    ENetPacket* Packet = CreatePacket(Data, Config.ChannelID, Config.Flags);
+    if (!Packet) return;
+    if (ServiceThread)
+    {
+        FENetCommand Command;
+        Command.Packet = Packet;
+        Command.ChannelID = Config.ChannelID;
+        Command.bBroadcast = true;
+        Commands.Enqueue(MoveTemp(Command));
+        return;
+    }
+    enet_host_broadcast(Host, Config.ChannelID, Packet);
 }
 
 void FENetManager::SendPacketToServer(const TArray<uint8>& Data, ENetPacketFlag Flags)
@@ -172,39 +449,447 @@ void FENetManager::SendPacketToServer(const TArray<uint8>& Data, ENetPacketFlag
     SendPacketToPeer(ServerPeer, Data, Flags);
 }
 
+void FENetManager::SendPacketToServer(const TArray<uint8>& Data, EENetTrafficClass TrafficClass)
+{
+    if (!ServerPeer) return;
+    SendPacketToPeer(ServerPeer, Data, TrafficClass);
+}
+
+void FENetManager::SetTrafficClass(EENetTrafficClass TrafficClass, uint8 ChannelID, ENetPacketFlag Flags)
+{
+    if (Host)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ENet traffic classes must be set before starting."));
+        return;
+    }
+    if (TrafficClass == EENetTrafficClass::Count || ChannelID >= ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT)
+    {
+        return;
+    }
+    TrafficClasses[(int32)TrafficClass] = FENetTrafficClassConfig(ChannelID, Flags);
+}
+
+int32 FENetManager::GetChannelCount() const
+{
+    int32 MaxChannelID = 0;
+    for (const FENetTrafficClassConfig& Config : TrafficClasses)
+    {
+        MaxChannelID = FMath::Max<int32>(MaxChannelID, Config.ChannelID);
+    }
+    return MaxChannelID + 1;
+}
+
+void FENetManager::InitChannelCounters()
+{
+    NumChannelCounters = GetChannelCount();
+    ChannelCounters = MakeUnique<FChannelCounters[]>(NumChannelCounters);
+}
+
+FENetChannelStats FENetManager::GetChannelStats(uint8 ChannelID) const
+{
+    FENetChannelStats Stats;
+    if (ChannelID >= NumChannelCounters)
+    {
+        return Stats;
+    }
+
+    const FChannelCounters& Counters = ChannelCounters[ChannelID];
+    Stats.PacketsSent = Counters.PacketsSent.load(std::memory_order_relaxed);
+    Stats.BytesSent = Counters.BytesSent.load(std::memory_order_relaxed);
+    Stats.QueuedPackets = Counters.QueuedPackets.load(std::memory_order_relaxed);
+    const int64 Released = Counters.ReleasedPackets.load(std::memory_order_relaxed);
+    const double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+    if (Released > 0)
+    {
+        Stats.AverageLatency = Counters.TotalLatencyCycles.load(std::memory_order_relaxed) * SecondsPerCycle / Released;
+    }
+    Stats.MaxLatency = Counters.MaxLatencyCycles.load(std::memory_order_relaxed) * SecondsPerCycle;
+    return Stats;
+}
+
+ENetPacket* FENetManager::CreatePacket(const TArray<uint8>& Data, uint8 ChannelID, ENetPacketFlag Flags)
+{
+    ENetPacket* Packet = enet_packet_create(Data.GetData(), Data.Num(), Flags);
+    if (!Packet || ChannelID >= NumChannelCounters)
+    {
+        return Packet;
+    }
+
+    FChannelCounters& Counters = ChannelCounters[ChannelID];
+    Counters.PacketsSent.fetch_add(1, std::memory_order_relaxed);
+    Counters.BytesSent.fetch_add(Data.Num(), std::memory_order_relaxed);
+    Counters.QueuedPackets.fetch_add(1, std::memory_order_relaxed);
+
+    // ENet이 패킷을 놓을 때(마지막 참조가 풀릴 때) 콜백으로 지연 시간을 기록
+    FPacketStamp* Stamp = new (PacketStampAllocator.Allocate()) FPacketStamp();
+    Stamp->CreatedCycles = FPlatformTime::Cycles64();
+    Stamp->Counters = &Counters;
+    Stamp->Manager = this;
+    Packet->userData = Stamp;
+    Packet->freeCallback = &FENetManager::OnPacketFreed;
+    return Packet;
+}
+
+void ENET_CALLBACK FENetManager::OnPacketFreed(ENetPacket* Packet)
+{
+    // 이 함수는 패킷을 놓는 스레드(Tick 또는 'ENetServiceThread')에서 실행됩니다.
+    FPacketStamp* Stamp = static_cast<FPacketStamp*>(Packet->userData);
+    if (!Stamp)
+    {
+        return;
+    }
+
+    FChannelCounters& Counters = *Stamp->Counters;
+    const int64 LatencyCycles = (int64)(FPlatformTime::Cycles64() - Stamp->CreatedCycles);
+    Counters.QueuedPackets.fetch_sub(1, std::memory_order_relaxed);
+    Counters.ReleasedPackets.fetch_add(1, std::memory_order_relaxed);
+    Counters.TotalLatencyCycles.fetch_add(LatencyCycles, std::memory_order_relaxed);
+    int64 MaxLatency = Counters.MaxLatencyCycles.load(std::memory_order_relaxed);
+    while (LatencyCycles > MaxLatency && !Counters.MaxLatencyCycles.compare_exchange_weak(MaxLatency, LatencyCycles, std::memory_order_relaxed))
+    {
+    }
+
+    Packet->userData = nullptr;
+    Stamp->Manager->PacketStampAllocator.Free(Stamp);
+}
+
+void FENetManager::SetCompression(EENetCompression InCompression)
+{
+    if (Host)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ENet compression must be set before starting."));
+        return;
+    }
+    Compression = InCompression;
+}
+
+void FENetManager::ApplyCompression()
+{
+    if (Compression == EENetCompression::None)
+    {
+        return;
+    }
+
+    ENetCompressor Compressor;
+    if (!HktENetCompression::CreateCompressor(Compression, Compressor))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ENet compression %d is not available. Sending uncompressed."), (int32)Compression);
+        return;
+    }
+    // 호스트가 압축기를 복사해 두고 호스트가 없어질 때 destroy를 호출
+    enet_host_compress(Host, &Compressor);
+}
+
+void FENetManager::SetServiceThread(bool bEnabled, uint32 InServiceTimeoutMs)
+{
+    if (Host)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ENet service thread mode must be set before starting."));
+        return;
+    }
+    bUseServiceThread = bEnabled;
+    ServiceTimeoutMs = InServiceTimeoutMs;
+}
+
+void FENetManager::StartServiceThread()
+{
+    if (!bUseServiceThread) return;
+
+    bStopServiceThread = false;
+    ServiceRunnable = MakeUnique<FENetServiceRunnable>(*this);
+    ServiceThread = FRunnableThread::Create(ServiceRunnable.Get(), TEXT("ENetServiceThread"), 0, TPri_AboveNormal);
+    if (!ServiceThread)
+    {
+        // 스레드를 만들 수 없으면 Tick에서 직접 서비스
+        UE_LOG(LogTemp, Warning, TEXT("Failed to create ENet service thread. Falling back to servicing in Tick."));
+        ServiceRunnable.Reset();
+    }
+}
+
+void FENetManager::StopServiceThread()
+{
+    if (!ServiceThread) return;
+
+    ServiceThread->Kill(true);
+    delete ServiceThread;
+    ServiceThread = nullptr;
+    ServiceRunnable.Reset();
+
+    // 전달되지 못한 이벤트와 명령의 패킷 해제
+    FENetQueuedEvent Queued;
+    while (Events.Dequeue(Queued))
+    {
+        if (Queued.Event.packet) enet_packet_destroy(Queued.Event.packet);
+    }
+    for (const FENetQueuedEvent& Overflow : OverflowEvents)
+    {
+        if (Overflow.Event.packet) enet_packet_destroy(Overflow.Event.packet);
+    }
+    OverflowEvents.Reset();
+    FENetCommand Command;
+    while (Commands.Dequeue(Command))
+    {
+        if (Command.Packet->referenceCount == 0) enet_packet_destroy(Command.Packet);
+    }
+}
+
+void FENetManager::RunServiceThread()
+{
+    // 이 함수는 'ENetServiceThread' 스레드에서 실행됩니다.
+    while (!bStopServiceThread)
+    {
+        ExecuteCommands();
+
+        // 이벤트 큐에 자리가 나면 모아 둔 이벤트부터 순서대로 넘김
+        int32 NumFlushed = 0;
+        while (NumFlushed < OverflowEvents.Num() && Events.Enqueue(OverflowEvents[NumFlushed]))
+        {
+            ++NumFlushed;
+        }
+        OverflowEvents.RemoveAt(0, NumFlushed);
+
+        // 이벤트가 없으면 최대 ServiceTimeoutMs 동안 대기. 그동안 재전송과 타임아웃이 처리됨
+        ENetEvent Event;
+        int32 Result = enet_host_service(Host, &Event, ServiceTimeoutMs);
+        while (Result > 0)
+        {
+            PushEvent(Event);
+            Result = enet_host_check_events(Host, &Event);
+        }
+        if (Result < 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ENet host service failed."));
+        }
+    }
+
+    // 종료 전에 남은 전송을 내보냄
+    ExecuteCommands();
+    enet_host_flush(Host);
+}
+
+void FENetManager::ExecuteCommands()
+{
+    FENetCommand Command;
+    while (Commands.Dequeue(Command))
+    {
+        if (Command.bBroadcast)
+        {
+            enet_host_broadcast(Host, Command.ChannelID, Command.Packet);
+        }
+        else
+        {
+            SendPacketNow(Command.Packet, Command.ChannelID, Command.Peers, Command.ConnectIDs);
+        }
+    }
+}
+
+void FENetManager::PushEvent(const ENetEvent& Event)
+{
+    // 이벤트가 Tick에 닿기 전에 Peer 자리가 재사용될 수 있으므로 지금의 connectID를 함께 넘김
+    FENetQueuedEvent Queued;
+    Queued.Event = Event;
+    Queued.ConnectID = Event.peer ? Event.peer->connectID : 0;
+
+    // 앞서 모아 둔 이벤트가 있으면 순서를 지키기 위해 뒤에 붙임
+    if (OverflowEvents.Num() > 0 || !Events.Enqueue(Queued))
+    {
+        OverflowEvents.Add(Queued);
+    }
+}
+
 // [추가] 특정 그룹에 속한 모든 클라이언트에게 데이터 전송
 void FENetManager::SendPacketToGroup(const FName& GroupName, const TArray<uint8>& Data, ENetPacketFlag Flags)
 {
-    if (const TArray<ENetPeer*>* PeersInGroup = ClientGroups.Find(GroupName))
+    SendPacketToGroup(GroupName, Data, FENetTrafficClassConfig(0, Flags));
+}
+
+void FENetManager::SendPacketToGroup(const FName& GroupName, const TArray<uint8>& Data, EENetTrafficClass TrafficClass)
+{
+    SendPacketToGroup(GroupName, Data, GetTrafficClassConfig(TrafficClass));
+}
+
+void FENetManager::SendPacketToGroup(const FName& GroupName, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config)
+{
+    // 하위 그룹이 있으면 구성원이 겹칠 수 있으므로 합집합을 구해서 보냄
+    if (Subgroups.Contains(GroupName))
     {
-        for (ENetPeer* Peer : *PeersInGroup)
+        SendPacketToGroups({ GroupName }, Data, Config);
+        return;
+    }
+
+    if (const FENetGroup* PeersInGroup = ClientGroups.Find(GroupName))
+    {
+        SendPacketToPeers(PeersInGroup->Peers, Data, Config);
+    }
+}
+
+void FENetManager::SendPacketToGroups(const TArray<FName>& GroupNames, const TArray<uint8>& Data, ENetPacketFlag Flags)
+{
+    SendPacketToGroups(GroupNames, Data, FENetTrafficClassConfig(0, Flags));
+}
+
+void FENetManager::SendPacketToGroups(const TArray<FName>& GroupNames, const TArray<uint8>& Data, EENetTrafficClass TrafficClass)
+{
+    SendPacketToGroups(GroupNames, Data, GetTrafficClassConfig(TrafficClass));
+}
+
+void FENetManager::SendPacketToGroups(const TArray<FName>& GroupNames, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config)
+{
+    TArray<ENetPeer*> Peers;
+    CollectGroupPeers(GroupNames, Peers);
+    SendPacketToPeers(Peers, Data, Config);
+}
+
+void FENetManager::CollectGroupPeers(const TArray<FName>& GroupNames, TArray<ENetPeer*>& OutPeers)
+{
+    if (!Host) return;
+
+    // Peer는 호스트의 peers 배열 안에 있으므로 인덱스 비트셋으로 중복을 거름.
+    // 비트셋은 호스트 크기가 바뀔 때만 다시 만들고, 끝에서 이번에 세운 비트만 지움
+    if (PeerMarks.Num() != (int32)Host->peerCount)
+    {
+        PeerMarks.Init(false, (int32)Host->peerCount);
+    }
+    const int32 FirstAdded = OutPeers.Num();
+
+    // 하위 그룹까지 펼침. 여러 경로로 닿는 그룹은 한 번만 순회
+    TArray<FName, TInlineAllocator<16>> PendingGroups(GroupNames);
+    TSet<FName, DefaultKeyFuncs<FName>, TInlineSetAllocator<16>> VisitedGroups;
+    while (PendingGroups.Num() > 0)
+    {
+        const FName GroupName = PendingGroups.Pop();
+        bool bAlreadyVisited = false;
+        VisitedGroups.Add(GroupName, &bAlreadyVisited);
+        if (bAlreadyVisited)
+        {
+            continue;
+        }
+
+        if (const FENetGroup* PeersInGroup = ClientGroups.Find(GroupName))
+        {
+            for (ENetPeer* Peer : PeersInGroup->Peers)
+            {
+                const int32 PeerIndex = (int32)(Peer - Host->peers);
+                if (!PeerMarks[PeerIndex])
+                {
+                    PeerMarks[PeerIndex] = true;
+                    OutPeers.Add(Peer);
+                }
+            }
+        }
+        if (const TArray<FName>* Children = Subgroups.Find(GroupName))
+        {
+            PendingGroups.Append(*Children);
+        }
+    }
+
+    for (int32 Index = FirstAdded; Index < OutPeers.Num(); ++Index)
+    {
+        PeerMarks[(int32)(OutPeers[Index] - Host->peers)] = false;
+    }
+}
+
+bool FENetManager::AddSubgroup(const FName& ParentGroupName, const FName& ChildGroupName)
+{
+    // 하위 그룹에서 상위 그룹으로 닿을 수 있다면 순환이 생김
+    if (ParentGroupName == ChildGroupName || IsSubgroupReachable(ChildGroupName, ParentGroupName))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Adding group %s under group %s would create a cycle."), *ChildGroupName.ToString(), *ParentGroupName.ToString());
+        return false;
+    }
+    Subgroups.FindOrAdd(ParentGroupName).AddUnique(ChildGroupName);
+    return true;
+}
+
+void FENetManager::RemoveSubgroup(const FName& ParentGroupName, const FName& ChildGroupName)
+{
+    if (TArray<FName>* Children = Subgroups.Find(ParentGroupName))
+    {
+        Children->Remove(ChildGroupName);
+        if (Children->Num() == 0)
         {
-            SendPacketToPeer(Peer, Data, Flags);
+            Subgroups.Remove(ParentGroupName);
         }
     }
 }
 
+bool FENetManager::IsSubgroupReachable(const FName& From, const FName& To) const
+{
+    TArray<FName, TInlineAllocator<16>> PendingGroups;
+    PendingGroups.Add(From);
+    TSet<FName, DefaultKeyFuncs<FName>, TInlineSetAllocator<16>> VisitedGroups;
+    while (PendingGroups.Num() > 0)
+    {
+        const FName GroupName = PendingGroups.Pop();
+        if (GroupName == To)
+        {
+            return true;
+        }
+        bool bAlreadyVisited = false;
+        VisitedGroups.Add(GroupName, &bAlreadyVisited);
+        if (!bAlreadyVisited)
+        {
+            if (const TArray<FName>* Children = Subgroups.Find(GroupName))
+            {
+                PendingGroups.Append(*Children);
+            }
+        }
+    }
+    return false;
+}
+
+void FENetManager::InitPeerStates()
+{
+    // 한 번에 할당하므로 이후 상태 객체의 주소가 바뀌지 않음
+    PeerStates.Reset();
+    PeerStates.SetNum((int32)Host->peerCount);
+    for (size_t PeerIndex = 0; PeerIndex < Host->peerCount; ++PeerIndex)
+    {
+        Host->peers[PeerIndex].data = &PeerStates[(int32)PeerIndex];
+    }
+}
+
+FENetManager::FENetPeerState* FENetManager::GetPeerState(ENetPeer* Peer) const
+{
+    if (!Peer || !Host || Peer < Host->peers || Peer >= Host->peers + Host->peerCount)
+    {
+        return nullptr;
+    }
+    return static_cast<FENetPeerState*>(Peer->data);
+}
+
 // [추가] 특정 Peer를 그룹에 추가
 void FENetManager::AddPeerToGroup(ENetPeer* Peer, const FName& GroupName)
 {
-    if (!Peer) return;
-    // FindOrAdd: GroupName에 해당하는 배열이 있으면 반환하고, 없으면 새로 생성해서 반환
-    TArray<ENetPeer*>& PeersInGroup = ClientGroups.FindOrAdd(GroupName);
-    // AddUnique: 배열에 해당 Peer가 없는 경우에만 추가
-    PeersInGroup.AddUnique(Peer);
+    FENetPeerState* State = GetPeerState(Peer);
+    if (!State) return;
+    // 이미 속해 있으면 무시. Peer가 속한 그룹 수만큼만 확인
+    for (const FENetPeerState::FSlot& Slot : State->Slots)
+    {
+        if (Slot.GroupName == GroupName)
+        {
+            return;
+        }
+    }
+
+    FENetGroup& Group = ClientGroups.FindOrAdd(GroupName);
+    FENetPeerState::FSlot& Slot = State->Slots.AddDefaulted_GetRef();
+    Slot.GroupName = GroupName;
+    Slot.IndexInGroup = Group.Peers.Add(Peer);
+    Group.PeerSlots.Add(State->Slots.Num() - 1);
 }
 
 // [추가] 특정 Peer를 그룹에서 제거
 void FENetManager::RemovePeerFromGroup(ENetPeer* Peer, const FName& GroupName)
 {
-    if (!Peer) return;
-    if (TArray<ENetPeer*>* PeersInGroup = ClientGroups.Find(GroupName))
+    FENetPeerState* State = GetPeerState(Peer);
+    if (!State) return;
+    for (int32 SlotIndex = 0; SlotIndex < State->Slots.Num(); ++SlotIndex)
     {
-        PeersInGroup->Remove(Peer);
-        // 그룹이 비었다면 맵에서 해당 그룹 키를 제거할 수도 있습니다 (선택사항)
-        if (PeersInGroup->Num() == 0)
+        if (State->Slots[SlotIndex].GroupName == GroupName)
         {
-            ClientGroups.Remove(GroupName);
+            RemovePeerSlot(Peer, *State, SlotIndex);
+            return;
         }
     }
 }
@@ -212,16 +897,61 @@ void FENetManager::RemovePeerFromGroup(ENetPeer* Peer, const FName& GroupName)
 // [추가] 특정 Peer를 모든 그룹에서 제거 (클라이언트 연결 종료 시 호출)
 void FENetManager::RemovePeerFromAllGroups(ENetPeer* Peer)
 {
-    if (!Peer) return;
-    // 모든 그룹을 순회
-    for (auto It = ClientGroups.CreateIterator(); It; ++It)
+    FENetPeerState* State = GetPeerState(Peer);
+    if (!State) return;
+    // 마지막 소속부터 지우면 Peer 쪽 배열은 옮길 것이 없음
+    while (State->Slots.Num() > 0)
     {
-        It.Value().Remove(Peer);
-        // 만약 그룹이 비게 되면 맵에서 제거
-        if (It.Value().Num() == 0)
+        RemovePeerSlot(Peer, *State, State->Slots.Num() - 1);
+    }
+}
+
+TArrayView<ENetPeer* const> FENetManager::GetGroupMembers(const FName& GroupName) const
+{
+    const FENetGroup* Group = ClientGroups.Find(GroupName);
+    return Group ? TArrayView<ENetPeer* const>(Group->Peers) : TArrayView<ENetPeer* const>();
+}
+
+bool FENetManager::IsPeerInGroup(ENetPeer* Peer, const FName& GroupName) const
+{
+    const FENetPeerState* State = GetPeerState(Peer);
+    if (!State) return false;
+    for (const FENetPeerState::FSlot& Slot : State->Slots)
+    {
+        if (Slot.GroupName == GroupName)
         {
-            It.RemoveCurrent();
+            return true;
         }
     }
+    return false;
 }
 
+void FENetManager::RemovePeerSlot(ENetPeer* Peer, FENetPeerState& State, int32 SlotIndex)
+{
+    const FENetPeerState::FSlot Slot = State.Slots[SlotIndex];
+    FENetGroup* Group = ClientGroups.Find(Slot.GroupName);
+    check(Group && Group->Peers[Slot.IndexInGroup] == Peer);
+
+    // 그룹의 마지막 구성원을 빈자리로 옮기고, 옮겨진 Peer의 소속이 새 위치를 가리키게 함
+    const int32 LastIndex = Group->Peers.Num() - 1;
+    if (Slot.IndexInGroup != LastIndex)
+    {
+        ENetPeer* MovedPeer = Group->Peers[LastIndex];
+        const int32 MovedSlot = Group->PeerSlots[LastIndex];
+        Group->Peers[Slot.IndexInGroup] = MovedPeer;
+        Group->PeerSlots[Slot.IndexInGroup] = MovedSlot;
+        static_cast<FENetPeerState*>(MovedPeer->data)->Slots[MovedSlot].IndexInGroup = Slot.IndexInGroup;
+    }
+    Group->Peers.Pop();
+    Group->PeerSlots.Pop();
+
+    // Peer의 마지막 소속을 빈자리로 옮기고, 그 그룹의 역참조를 고침
+    const int32 LastSlot = State.Slots.Num() - 1;
+    if (SlotIndex != LastSlot)
+    {
+        const FENetPeerState::FSlot& MovedSlot = State.Slots[LastSlot];
+        ClientGroups.FindChecked(MovedSlot.GroupName).PeerSlots[MovedSlot.IndexInGroup] = SlotIndex;
+        State.Slots[SlotIndex] = MovedSlot;
+    }
+    State.Slots.Pop();
+}
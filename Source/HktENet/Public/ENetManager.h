@@ -1,6 +1,10 @@
 #pragma once
 
 #include "CoreMinimal.h" // 델리게이트, TArray, FString 등을 위해 유지
+#include "Containers/CircularQueue.h"
+#include "Containers/LockFreeFixedSizeAllocator.h"
+#include "Containers/Queue.h"
+#include <atomic>
 
 // ENet 헤더 include (컴파일 오류 방지를 위해 전처리)
 #if PLATFORM_WINDOWS
@@ -13,14 +17,175 @@
 #include "Windows/HideWindowsPlatformTypes.h"
 #endif
 
+/**
+ * ENetPacket의 소유권을 가지는 핸들. 소멸하거나 Reset하면 패킷을 해제합니다.
+ * 수신 콜백 밖에서 데이터를 계속 쓰고 싶을 때 FENetManager::TakeReceivedPacket으로 받습니다.
+ * 이동만 가능하며, 패킷을 만든 FENetManager가 소멸하기 전에 해제해야 합니다.
+ */
+class FENetPacketHandle
+{
+public:
+    FENetPacketHandle() = default;
+    explicit FENetPacketHandle(ENetPacket* InPacket) : Packet(InPacket) {}
+    ~FENetPacketHandle() { Reset(); }
+
+    FENetPacketHandle(FENetPacketHandle&& Other) : Packet(Other.Packet) { Other.Packet = nullptr; }
+    FENetPacketHandle& operator=(FENetPacketHandle&& Other)
+    {
+        if (this != &Other)
+        {
+            Reset();
+            Packet = Other.Packet;
+            Other.Packet = nullptr;
+        }
+        return *this;
+    }
+    FENetPacketHandle(const FENetPacketHandle&) = delete;
+    FENetPacketHandle& operator=(const FENetPacketHandle&) = delete;
+
+    bool IsValid() const { return Packet != nullptr; }
+    ENetPacket* Get() const { return Packet; }
+    TArrayView<const uint8> GetData() const
+    {
+        return Packet ? TArrayView<const uint8>(Packet->data, (int32)Packet->dataLength) : TArrayView<const uint8>();
+    }
+
+    // 패킷을 해제
+    void Reset()
+    {
+        if (Packet)
+        {
+            enet_packet_destroy(Packet);
+            Packet = nullptr;
+        }
+    }
+    // 해제하지 않고 소유권만 넘김
+    ENetPacket* Release()
+    {
+        ENetPacket* Result = Packet;
+        Packet = nullptr;
+        return Result;
+    }
+
+private:
+    ENetPacket* Packet = nullptr;
+};
+
 // 델리게이트 선언 (유지)
+// 수신 데이터를 TArray로 복사해서 전달. 바인딩되어 있을 때만 복사함
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnENetPacketReceived, ENetPeer* /*Peer*/, const TArray<uint8>& /*Data*/);
+// 수신 데이터를 복사 없이 ENet 패킷 버퍼 그대로 전달. 뷰는 콜백 안에서만 유효
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnENetPacketViewReceived, ENetPeer* /*Peer*/, TArrayView<const uint8> /*Data*/);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnENetClientConnected, ENetPeer* /*Peer*/);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnENetClientDisconnected, ENetPeer* /*Peer*/);
 
+// 트래픽 종류. 종류마다 ENet 채널을 따로 두면 한 종류의 재전송 대기가 다른 종류의 전달 순서를 막지 않음
+enum class EENetTrafficClass : uint8
+{
+    // 기존 전송 함수(Flags 인자)가 쓰는 채널 0
+    Default,
+    // 플레이어 입력과 행동 요청
+    Input,
+    // 상태 갱신. 최신 값만 의미 있으므로 기본은 비신뢰 순차 전송
+    State,
+    Chat,
+    // 큰 데이터. 다른 트래픽 뒤에서 천천히 전달돼도 됨
+    Bulk,
+    Count
+};
+
+// 트래픽 종류가 쓰는 채널과 패킷 플래그
+struct FENetTrafficClassConfig
+{
+    uint8 ChannelID = 0;
+    ENetPacketFlag Flags = ENET_PACKET_FLAG_RELIABLE;
+
+    FENetTrafficClassConfig() = default;
+    FENetTrafficClassConfig(uint8 InChannelID, ENetPacketFlag InFlags)
+        : ChannelID(InChannelID)
+        , Flags(InFlags)
+    {
+    }
+};
+
+// 채널별 송신 통계. 패킷이 여러 Peer에 공유되면 한 번으로 셈
+struct FENetChannelStats
+{
+    int64 PacketsSent = 0;
+    int64 BytesSent = 0;
+    // 만들었지만 ENet이 아직 놓지 않은 패킷 수 (송신 대기 중이거나 신뢰 전송의 Ack를 기다리는 중)
+    int32 QueuedPackets = 0;
+    // 패킷을 만든 뒤 ENet이 놓기까지 걸린 시간 (초). 신뢰 전송은 Ack까지, 비신뢰 전송은 소켓으로 보낼 때까지
+    double AverageLatency = 0.0;
+    double MaxLatency = 0.0;
+};
+
+// 호스트 패킷 압축 방식. 서버와 클라이언트가 같은 방식을 써야 함
+enum class EENetCompression : uint8
+{
+    None,
+    // ENet 내장 적응형 범위 부호기. 작은 패킷에서도 효과가 있음
+    RangeCoder,
+    // FCompression의 LZ4. 빠르지만 작은 패킷에서는 압축률이 낮음
+    LZ4,
+    // FCompression의 Oodle. Oodle 압축이 없는 빌드에서는 사용할 수 없음
+    Oodle
+};
+
+namespace HktENetCompression
+{
+    // 압축 방식에 맞는 ENetCompressor를 채움. enet_host_compress에 넘기면 호스트가 소유하며 destroy로 해제됨.
+    // None이거나 이 빌드에서 쓸 수 없는 방식이면 false
+    HKTENET_API bool CreateCompressor(EENetCompression Compression, ENetCompressor& OutCompressor);
+}
+
+// ENet 메모리 할당 통계 (프로세스 전체, 누적)
+struct FENetAllocatorStats
+{
+    int64 Allocations = 0;
+    int64 Frees = 0;
+    // 아직 해제되지 않은 할당 수와 요청 바이트 수
+    int64 LiveAllocations = 0;
+    int64 LiveBytes = 0;
+    int64 TotalBytes = 0;
+    // 크기별 풀에서 내준 할당 수. 나머지는 큰 할당이거나 System 모드의 할당
+    int64 PooledAllocations = 0;
+};
+
+/**
+ * ENet이 패킷, Peer, 명령 등을 만들 때 쓰는 메모리 할당기.
+ * FENetManager는 enet_initialize_with_callbacks로 이 할당기를 등록하며, 설정은 프로세스 전체에 적용됩니다.
+ * Pooled 모드는 작은 할당을 크기별 lock-free 풀에서 재사용하여 시스템 malloc의 경합과 단편화를 피합니다.
+ * 각 할당이 자신을 만든 방식을 기록하므로 할당이 남아 있는 중에 모드를 바꿔도 안전합니다.
+ */
+namespace HktENetAllocator
+{
+    enum class EMode : uint8
+    {
+        // 시스템 malloc/free (enet_initialize의 기본 동작과 같음)
+        System,
+        // 크기별 풀. 풀보다 큰 할당은 FMemory
+        Pooled
+    };
+
+    HKTENET_API void SetMode(EMode Mode);
+    HKTENET_API EMode GetMode();
+    HKTENET_API FENetAllocatorStats GetStats();
+    // enet_initialize_with_callbacks에 넘길 콜백
+    HKTENET_API const ENetCallbacks& GetCallbacks();
+}
+
+class FRunnableThread;
+class FENetServiceRunnable;
+
 /**
  * Unreal Engine의 Core모듈에만 의존하는 일반 ENet 관리 클래스입니다.
  * UObject가 아니므로, 직접 생성하고 외부 루프에서 Tick()을 주기적으로 호출해주어야 합니다.
+ *
+ * 서비스 스레드 모드(SetServiceThread)에서는 네트워크 스레드가 ENetHost를 소유하고 짧은 대기 시간으로 계속 서비스하므로
+ * 게임 스레드가 멈춰도 재전송과 타임아웃 처리는 계속 진행됩니다. 전송은 명령 큐로 네트워크 스레드에 넘기고,
+ * 수신 이벤트는 크기가 정해진 이벤트 큐로 돌아와 Tick()에서 델리게이트로 전달됩니다.
+ * 델리게이트와 그룹 관리는 어느 모드든 Tick()을 호출하는 스레드에서만 다룹니다.
  */
 class HKTENET_API FENetManager
 {
@@ -36,6 +201,26 @@ public:
     // 매 틱(또는 주기적으로) 호출되어 네트워크 이벤트를 처리하는 함수
     void Tick();
 
+    // 서비스 스레드 모드 설정. StartServer/StartClient 전에 호출.
+    // ServiceTimeoutMs는 네트워크 스레드가 이벤트를 기다리는 최대 시간이자 전송 명령이 처리되기까지의 최대 지연
+    void SetServiceThread(bool bEnabled, uint32 ServiceTimeoutMs = 1);
+    bool IsServiceThreadRunning() const { return ServiceThread != nullptr; }
+
+    // 트래픽 종류의 채널과 플래그 설정. StartServer/StartClient 전에 호출하며, 서버와 클라이언트가 같은 설정을 써야 함.
+    // 호스트는 설정에 나온 가장 큰 채널 번호까지 채널을 만듦
+    void SetTrafficClass(EENetTrafficClass TrafficClass, uint8 ChannelID, ENetPacketFlag Flags);
+    const FENetTrafficClassConfig& GetTrafficClassConfig(EENetTrafficClass TrafficClass) const { return TrafficClasses[(int32)TrafficClass]; }
+    int32 GetChannelCount() const;
+    // 채널별 송신 통계. 호스트가 실행 중일 때만 유효
+    FENetChannelStats GetChannelStats(uint8 ChannelID) const;
+
+    // 패킷 압축 방식 설정. StartServer/StartClient 전에 호출. 쓸 수 없는 방식이면 압축하지 않음
+    void SetCompression(EENetCompression InCompression);
+    EENetCompression GetCompression() const { return Compression; }
+    // 호스트가 지금까지 소켓으로 보낸/받은 바이트 수 (압축 후, ENet 헤더 포함)
+    uint32 GetTotalSentBytes() const { return Host ? Host->totalSentData : 0; }
+    uint32 GetTotalReceivedBytes() const { return Host ? Host->totalReceivedData : 0; }
+
     // 서버 시작
     bool StartServer(uint16 Port, int32 MaxClients = 32);
     // 클라이언트 시작 및 서버에 연결
@@ -49,17 +234,40 @@ public:
     void SendPacketToServer(const TArray<uint8>& Data, ENetPacketFlag Flags = ENET_PACKET_FLAG_RELIABLE);
     // [추가] 특정 그룹에 속한 모든 클라이언트에게 데이터 전송
     void SendPacketToGroup(const FName& GroupName, const TArray<uint8>& Data, ENetPacketFlag Flags = ENET_PACKET_FLAG_RELIABLE);
+    // 여러 그룹의 구성원 합집합에 전송. 여러 그룹에 속한 Peer도 한 번만 받으며 하위 그룹의 구성원도 포함
+    void SendPacketToGroups(const TArray<FName>& GroupNames, const TArray<uint8>& Data, ENetPacketFlag Flags = ENET_PACKET_FLAG_RELIABLE);
+    // 트래픽 종류에 설정된 채널과 플래그로 전송
+    void SendPacketToPeer(ENetPeer* Peer, const TArray<uint8>& Data, EENetTrafficClass TrafficClass);
+    void BroadcastPacketToClients(const TArray<uint8>& Data, EENetTrafficClass TrafficClass);
+    void SendPacketToServer(const TArray<uint8>& Data, EENetTrafficClass TrafficClass);
+    void SendPacketToGroup(const FName& GroupName, const TArray<uint8>& Data, EENetTrafficClass TrafficClass);
+    void SendPacketToGroups(const TArray<FName>& GroupNames, const TArray<uint8>& Data, EENetTrafficClass TrafficClass);
 
     // --- 그룹 관리 함수 ---
+    // 각 Peer의 그룹 소속은 ENetPeer::data에 연결된 상태 객체에 기록하므로 data는 FENetManager가 사용함.
+    // 참여/탈퇴/연결 종료 정리는 그룹 크기와 무관하게 상수 시간이며, 소속 그룹이 적으면 메모리 할당도 없음
     // [추가] 특정 Peer를 그룹에 추가
     void AddPeerToGroup(ENetPeer* Peer, const FName& GroupName);
     // [추가] 특정 Peer를 그룹에서 제거
     void RemovePeerFromGroup(ENetPeer* Peer, const FName& GroupName);
     // [추가] 특정 Peer를 모든 그룹에서 제거
     void RemovePeerFromAllGroups(ENetPeer* Peer);
+    // 그룹의 현재 구성원. 순서는 참여/탈퇴에 따라 바뀌며, 뷰는 다음 그룹 변경 전까지만 유효
+    TArrayView<ENetPeer* const> GetGroupMembers(const FName& GroupName) const;
+    // Peer가 그룹에 직접 속해 있는지 여부 (하위 그룹을 통한 소속은 포함하지 않음). Peer가 속한 그룹 수만큼만 확인
+    bool IsPeerInGroup(ENetPeer* Peer, const FName& GroupName) const;
+    // 그룹 계층 설정. Child 그룹(과 그 하위 그룹)의 Peer는 Parent로 보내는 패킷도 받음 (월드 > 지역 > 파티).
+    // 구성원을 복사하지 않고 관계만 기록하며, 한 그룹이 여러 상위 그룹을 가질 수 있음. 순환이 생기면 false
+    bool AddSubgroup(const FName& ParentGroupName, const FName& ChildGroupName);
+    void RemoveSubgroup(const FName& ParentGroupName, const FName& ChildGroupName);
+
+    // OnPacketViewReceived 콜백 안에서 호출하면 지금 전달 중인 패킷의 소유권을 가져감.
+    // 가져간 패킷은 Tick이 해제하지 않으므로 핸들이 해제할 때까지 데이터가 유효함. 콜백 밖이거나 이미 가져갔으면 빈 핸들
+    FENetPacketHandle TakeReceivedPacket();
 
     // 델리게이트 인스턴스
     FOnENetPacketReceived OnPacketReceived;
+    FOnENetPacketViewReceived OnPacketViewReceived;
     FOnENetClientConnected OnClientConnected;
     FOnENetClientDisconnected OnClientDisconnected;
 
@@ -71,7 +279,135 @@ private:
 
     bool bIsInitialized = false;
 
-    // [추가] 그룹명과 해당 그룹에 속한 Peer들의 배열을 매핑하는 TMap
-    TMap<FName, TArray<ENetPeer*>> ClientGroups;
+    friend class FENetServiceRunnable;
+
+    // 네트워크 스레드에 넘기는 전송 명령. 패킷은 보내는 쪽에서 만들어 두고 네트워크 스레드가 큐에 넣음
+    struct FENetCommand
+    {
+        ENetPacket* Packet = nullptr;
+        uint8 ChannelID = 0;
+        TArray<ENetPeer*> Peers;
+        // 명령을 만들 때 Tick 스레드가 알던 각 Peer의 connectID. 그 사이 연결이 끊기고 같은 자리에 새 연결이 들어왔으면 보내지 않음
+        TArray<enet_uint32> ConnectIDs;
+        // Peers 대신 연결된 모든 Peer에 보냄
+        bool bBroadcast = false;
+    };
+    // 네트워크 스레드 -> Tick으로 넘기는 이벤트. Peer 자리가 재사용돼도 어느 연결의 이벤트인지 알 수 있도록 connectID를 함께 담음
+    struct FENetQueuedEvent
+    {
+        ENetEvent Event;
+        enet_uint32 ConnectID = 0;
+    };
+    // 이벤트 큐 크기. 가득 차면 네트워크 스레드가 따로 모아 두었다가 자리가 나면 넘김
+    static constexpr uint32 EventQueueCapacity = 4096;
+
+    bool bUseServiceThread = false;
+    uint32 ServiceTimeoutMs = 1;
+    TUniquePtr<FENetServiceRunnable> ServiceRunnable;
+    FRunnableThread* ServiceThread = nullptr;
+    std::atomic<bool> bStopServiceThread{ false };
+    // 여러 스레드 -> 네트워크 스레드
+    TQueue<FENetCommand, EQueueMode::Mpsc> Commands;
+    // 네트워크 스레드 -> Tick
+    TCircularQueue<FENetQueuedEvent> Events{ EventQueueCapacity };
+    // 이벤트 큐가 가득 찼을 때 네트워크 스레드가 순서대로 모아 두는 이벤트. 네트워크 스레드만 사용
+    TArray<FENetQueuedEvent> OverflowEvents;
+
+    // 수신 콜백에 전달 중인 패킷. TakeReceivedPacket이 가져가면 nullptr
+    ENetPacket* ReceivingPacket = nullptr;
+
+    // 그룹 구성원. Peers[i]의 FENetPeerState::Slots[PeerSlots[i]]가 이 그룹 소속을 가리킴
+    struct FENetGroup
+    {
+        TArray<ENetPeer*> Peers;
+        TArray<int32> PeerSlots;
+    };
+    // Peer의 그룹 소속. ENetPeer::data가 가리킴
+    struct FENetPeerState
+    {
+        struct FSlot
+        {
+            FName GroupName;
+            // FENetGroup::Peers 안의 위치
+            int32 IndexInGroup = INDEX_NONE;
+        };
+        TArray<FSlot, TInlineAllocator<4>> Slots;
+        // Tick 스레드가 마지막으로 받은 연결 이벤트의 connectID. 연결되지 않았으면 0
+        enet_uint32 ConnectID = 0;
+    };
+
+    // [추가] 그룹명과 해당 그룹에 속한 Peer들을 매핑하는 TMap.
+    // 빈 그룹도 배열을 재사용하기 위해 Stop까지 남겨 둠
+    TMap<FName, FENetGroup> ClientGroups;
+    // Host->peers와 같은 순서의 Peer별 상태. 호스트를 만들 때 한 번만 할당
+    TArray<FENetPeerState> PeerStates;
+    // 그룹 계층 (상위 그룹명 -> 하위 그룹명 목록)
+    TMap<FName, TArray<FName>> Subgroups;
+    // 합집합을 구할 때 이미 고른 Peer 표시 (Host->peers 배열의 인덱스). 호출이 끝나면 세운 비트만 지워 항상 비어 있음
+    TBitArray<> PeerMarks;
+
+    // 트래픽 종류별 설정
+    FENetTrafficClassConfig TrafficClasses[(int32)EENetTrafficClass::Count];
+    EENetCompression Compression = EENetCompression::None;
+    // 새로 만든 호스트에 압축 방식 적용
+    void ApplyCompression();
+
+    // 채널별 통계 카운터. 패킷 해제 콜백이 네트워크 스레드에서도 불리므로 원자적으로 갱신
+    struct FChannelCounters
+    {
+        std::atomic<int64> PacketsSent{ 0 };
+        std::atomic<int64> BytesSent{ 0 };
+        std::atomic<int32> QueuedPackets{ 0 };
+        std::atomic<int64> ReleasedPackets{ 0 };
+        std::atomic<int64> TotalLatencyCycles{ 0 };
+        std::atomic<int64> MaxLatencyCycles{ 0 };
+    };
+    // 호스트를 만들 때 채널 수만큼 할당하고 호스트를 없앤 뒤 해제
+    TUniquePtr<FChannelCounters[]> ChannelCounters;
+    int32 NumChannelCounters = 0;
+    // 보낸 패킷의 userData. 패킷이 해제될 때 지연 시간을 계산
+    struct FPacketStamp
+    {
+        uint64 CreatedCycles = 0;
+        FChannelCounters* Counters = nullptr;
+        FENetManager* Manager = nullptr;
+    };
+    // 패킷마다 힙 할당을 하지 않도록 스탬프를 재사용
+    TLockFreeFixedSizeAllocator<sizeof(FPacketStamp), PLATFORM_CACHE_LINE_SIZE> PacketStampAllocator;
+
+    void InitChannelCounters();
+    // 패킷을 만들고 채널 통계에 기록
+    ENetPacket* CreatePacket(const TArray<uint8>& Data, uint8 ChannelID, ENetPacketFlag Flags);
+    // 패킷 해제 시 지연 시간을 기록하는 ENet 콜백
+    static void ENET_CALLBACK OnPacketFreed(ENetPacket* Packet);
+
+    void SendPacketToPeer(ENetPeer* Peer, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config);
+    void BroadcastPacketToClients(const TArray<uint8>& Data, const FENetTrafficClassConfig& Config);
+    void SendPacketToGroup(const FName& GroupName, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config);
+    void SendPacketToGroups(const TArray<FName>& GroupNames, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config);
+    // 패킷을 한 번만 만들어 여러 Peer에 보냄. ENet 패킷은 참조 카운트로 공유되므로 구성원 수와 무관하게 복사는 한 번
+    void SendPacketToPeers(TArrayView<ENetPeer* const> Peers, const TArray<uint8>& Data, const FENetTrafficClassConfig& Config);
+    // 만든 패킷을 바로 보내거나, 서비스 스레드 모드면 명령 큐에 넣음
+    void DispatchPacket(ENetPacket* Packet, uint8 ChannelID, TArrayView<ENetPeer* const> Peers);
+    // 패킷을 Peer들의 송신 큐에 넣음. ConnectIDs가 있으면 지금 connectID가 다른 Peer는 건너뜀. 아무 Peer에도 들어가지 않았으면 해제
+    static void SendPacketNow(ENetPacket* Packet, uint8 ChannelID, TArrayView<ENetPeer* const> Peers, TArrayView<const enet_uint32> ConnectIDs = {});
+    // 수신 이벤트를 델리게이트로 전달. ConnectID는 이벤트가 생긴 시점의 Peer connectID
+    void HandleEvent(const ENetEvent& Event, enet_uint32 ConnectID);
+
+    void StartServiceThread();
+    void StopServiceThread();
+    // 네트워크 스레드 루프
+    void RunServiceThread();
+    void ExecuteCommands();
+    void PushEvent(const ENetEvent& Event);
+    // 호스트의 Peer들을 상태 객체와 연결
+    void InitPeerStates();
+    FENetPeerState* GetPeerState(ENetPeer* Peer) const;
+    // Peer의 SlotIndex번째 그룹 소속을 제거. 양쪽 배열에서 마지막 원소를 빈자리로 옮기고 역참조를 고침
+    void RemovePeerSlot(ENetPeer* Peer, FENetPeerState& State, int32 SlotIndex);
+    // 여러 그룹과 그 하위 그룹의 Peer 합집합을 중복 없이 수집
+    void CollectGroupPeers(const TArray<FName>& GroupNames, TArray<ENetPeer*>& OutPeers);
+    // From 그룹에서 하위 그룹을 따라 To 그룹에 닿는지 여부
+    bool IsSubgroupReachable(const FName& From, const FName& To) const;
 };
 